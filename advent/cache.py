@@ -0,0 +1,202 @@
+"""On disk cache of parsed solvers and their answers, keyed by a hash of
+everything that can change them: the input bytes, the source of the solver's
+module and of the rest of the advent package, and the oatmeal extension
+binary. A run where none of those changed loads the answers, or the state the
+solver had after parsing, instead of redoing the work."""
+import functools
+import hashlib
+import logging
+import mmap
+import os
+import pickle
+import sys
+import tempfile
+from typing import TYPE_CHECKING, Any, Optional, Tuple, Type
+
+import oatmeal
+
+from advent.utils import MappedInput, input_path
+
+if TYPE_CHECKING:
+    from advent.solver import AdventDaySolver
+
+# Bump when the layout of cache entries changes.
+CACHE_VERSION = 1
+
+# Cache directory used when `ADVENT_CACHE_DIR` is not set. Setting the variable
+# to an empty string turns the default cache off.
+DEFAULT_CACHE_DIR = ".cache"
+
+# Solver attributes that belong to the run rather than to the parsed input.
+RUN_ATTRIBUTES = {"input", "timings", "_active_phases"}
+
+
+def _file_digest(path: str) -> bytes:
+    with open(path, "rb") as f:
+        return hashlib.file_digest(f, "sha256").digest()
+
+
+@functools.cache
+def oatmeal_build_id() -> str:
+    """Hash of the oatmeal extension binary, which changes with every rebuild
+    that changes the native code."""
+    return _file_digest(oatmeal.__file__).hex()
+
+
+@functools.cache
+def framework_digest() -> bytes:
+    """Hash of every source file in the advent package outside of `days`. The
+    solver base class, this cache and the utils all shape the parse state and
+    answers, so editing any of them invalidates every entry."""
+    package_dir = os.path.dirname(os.path.abspath(__file__))
+    days_dir = os.path.join(package_dir, "days")
+    h = hashlib.sha256()
+
+    for dir_path, dir_names, file_names in os.walk(package_dir):
+        dir_names[:] = sorted(
+            d for d in dir_names if os.path.join(dir_path, d) != days_dir
+        )
+
+        for file_name in sorted(file_names):
+            if file_name.endswith(".py"):
+                source_path = os.path.join(dir_path, file_name)
+                h.update(os.path.relpath(source_path, package_dir).encode())
+                h.update(_file_digest(source_path))
+
+    return h.digest()
+
+
+def _write_atomic(path: str, data: bytes) -> None:
+    """Write a file so readers, including other workers sharing the cache, only
+    ever see it complete."""
+    fd, tmp_path = tempfile.mkstemp(dir=os.path.dirname(path))
+
+    try:
+        with os.fdopen(fd, "wb") as f:
+            f.write(data)
+        os.replace(tmp_path, path)
+    except BaseException:
+        os.unlink(tmp_path)
+        raise
+
+
+def _map_buffer(path: str) -> memoryview:
+    """Map a file copy on write, so native types can share its pages without
+    their writes reaching the file."""
+    with open(path, "rb") as f:
+        if os.fstat(f.fileno()).st_size == 0:
+            return memoryview(bytearray())
+
+        return memoryview(mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY))
+
+
+class SolverCache:
+    """Cache entries live in `root/<key>/`, holding the answers, the pickled
+    parse state and one `.bin` file per out of band pickle buffer. Grids and
+    point arrays in the parse state are loaded straight from those mapped
+    files without copying."""
+
+    def __init__(self, root: str):
+        self.root = root
+
+    @classmethod
+    def default(cls) -> Optional["SolverCache"]:
+        """The cache in `ADVENT_CACHE_DIR`, or `.cache` if it is not set."""
+        root = os.environ.get("ADVENT_CACHE_DIR", DEFAULT_CACHE_DIR)
+        return cls(root) if root else None
+
+    def key(self, solver_type: Type["AdventDaySolver"], path: str) -> str:
+        """Content hash of the input at `path` and the code that solves it."""
+        module = sys.modules[solver_type.__module__]
+        h = hashlib.sha256(f"v{CACHE_VERSION}".encode())
+        h.update(f"{solver_type.__module__}.{solver_type.__qualname__}".encode())
+        h.update(_file_digest(path))
+
+        h.update(_file_digest(module.__file__))
+        h.update(framework_digest())
+
+        h.update(oatmeal_build_id().encode())
+        return h.hexdigest()
+
+    def _entry(self, solver_type: Type["AdventDaySolver"], path: str) -> str:
+        return os.path.join(self.root, self.key(solver_type, path))
+
+    def solve(
+        self, solver_type: Type["AdventDaySolver"], path: Optional[str] = None
+    ) -> Tuple[Tuple[Any, Any], bool]:
+        """Answers for the solver's puzzle input, and whether they came from the
+        cache. Fresh answers are stored for the next run."""
+        path = path or input_path(solver_type.day(), solver_type.year())
+        answers_path = os.path.join(self._entry(solver_type, path), "answers")
+
+        if os.path.exists(answers_path):
+            with open(answers_path, "rb") as f:
+                return (pickle.load(f), True)
+
+        solution = self.load_solver(solver_type, path).solve()
+        _write_atomic(answers_path, pickle.dumps(solution))
+        return (solution, False)
+
+    def load_solver(
+        self, solver_type: Type["AdventDaySolver"], path: Optional[str] = None
+    ) -> "AdventDaySolver":
+        """Solver for the puzzle input, restored from its cached parse state if
+        there is one. Otherwise the input is parsed and the resulting state
+        stored, unless it cannot be pickled."""
+        path = path or input_path(solver_type.day(), solver_type.year())
+        entry = self._entry(solver_type, path)
+        input = MappedInput(path)
+        state_path = os.path.join(entry, "parsed")
+
+        if os.path.exists(state_path):
+            try:
+                return self._restore(solver_type, input, entry)
+            except Exception as e:
+                logging.warning(f"ignoring cached {solver_type.__name__}: {e}")
+
+        solver = solver_type(input)
+        os.makedirs(entry, exist_ok=True)
+
+        # Attributes that are the input itself are rebound on load rather than
+        # pickled as a copy of every line.
+        aliases = [k for k, v in vars(solver).items() if v is input]
+        state = {
+            k: v
+            for k, v in vars(solver).items()
+            if k not in RUN_ATTRIBUTES and k not in aliases
+        }
+        buffers: list[pickle.PickleBuffer] = []
+
+        try:
+            data = pickle.dumps(
+                (aliases, state), protocol=5, buffer_callback=buffers.append
+            )
+        except (pickle.PicklingError, TypeError, AttributeError) as e:
+            logging.debug(f"not caching parsed {solver_type.__name__}: {e}")
+            return solver
+
+        for i, buffer in enumerate(buffers):
+            _write_atomic(os.path.join(entry, f"{i}.bin"), buffer.raw())
+
+        _write_atomic(state_path, data)
+        return solver
+
+    def _restore(
+        self, solver_type: Type["AdventDaySolver"], input: Any, entry: str
+    ) -> "AdventDaySolver":
+        with open(os.path.join(entry, "parsed"), "rb") as f:
+            data = f.read()
+
+        # Buffers are written before the state, so they are all there.
+        count = sum(name.endswith(".bin") for name in os.listdir(entry))
+        buffers = [_map_buffer(os.path.join(entry, f"{i}.bin")) for i in range(count)]
+
+        aliases, state = pickle.loads(data, buffers=buffers)
+        solver = solver_type.__new__(solver_type)
+        solver.input = input
+
+        for name in aliases:
+            setattr(solver, name, input)
+
+        vars(solver).update(state)
+        return solver
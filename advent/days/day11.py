@@ -1,129 +1,65 @@
 #!/usr/bin/env python3
-from typing import Iterable, Optional
+from typing import Iterable
 import unittest
 
 from advent.solver import AdventDaySolver, AdventDayTestCase, solver_main
-from advent.utils import (
-    Grid,
-    new_grid_from_input_lines,
-    count_if,
-    all_pairs,
-    astar_search,
-    manhattan_distance,
-    Point,
-)
+from advent.utils import Point, WeightedAxes
 
 
-class Tile:
-    __slots__ = ("galaxy_id", "cost")
-    galaxy_id: Optional[int]
-    cost: int
+def find_galaxies(lines: Iterable[str]) -> tuple[list[Point], int, int]:
+    """Returns the galaxy positions along with the width and height of the
+    image."""
+    galaxies = []
+    x_count = 0
+    y_count = 0
 
-    def __init__(self):
-        self.galaxy_id = None
-        self.cost = 1
+    for y, line in enumerate(lines):
+        x_count = len(line)
+        y_count = y + 1
+        galaxies.extend(Point(x, y) for x, c in enumerate(line) if c == "#")
 
-    def __str__(self):
-        if self.galaxy_id:
-            return str(self.galaxy_id)
-        else:
-            return "."
+    return galaxies, x_count, y_count
 
 
-def parse_input(lines: Iterable[Iterable[str]]) -> Grid[Tile]:
-    char_grid = new_grid_from_input_lines(lines)
-    tile_grid: Grid[Tile] = Grid(char_grid.x_count, char_grid.y_count, Tile)
-    next_galaxy_id = 1
+def expanded_axes(
+    galaxies: list[Point], x_count: int, y_count: int, factor: int
+) -> WeightedAxes:
+    """Weigh every column and row without a galaxy by the expansion factor,
+    rather than inserting copies of them into a grid."""
+    occupied_cols = {p.x for p in galaxies}
+    occupied_rows = {p.y for p in galaxies}
 
-    for y in range(char_grid.y_count):
-        for x, c in enumerate(char_grid.row(y)):
-            pos = Point(x, y)
+    return WeightedAxes(
+        [1 if x in occupied_cols else factor for x in range(x_count)],
+        [1 if y in occupied_rows else factor for y in range(y_count)],
+    )
 
-            if c == "#":
-                tile_grid[pos].galaxy_id = next_galaxy_id
-                next_galaxy_id += 1
 
-    return tile_grid
-
-
-def apply_space_expansion(grid: Grid[Tile]) -> None:
-    # Check all columns to see if they are totally empty, and if so apply an
-    # expansion cost.
-    num_cols_expanded = 0
-    num_rows_expanded = 0
-
-    for i in range(grid.col_count()):
-        xi = i + num_cols_expanded
-
-        if count_if(grid.col(xi), lambda x: x.galaxy_id is not None) == 0:
-            grid.insert_col(xi, Tile)
-            num_cols_expanded += 1
-
-    for i in range(grid.row_count()):
-        xi = i + num_rows_expanded
-
-        if count_if(grid.row(xi), lambda x: x.galaxy_id is not None) == 0:
-            grid.insert_row(xi, Tile)
-            num_rows_expanded += 1
-
-
-class Solver(AdventDaySolver, day=11, year=2023, name="", solution=(None, None)):
-    def __init__(self, input: Iterable[Iterable[str]]):
+class Solver(
+    AdventDaySolver, day=11, year=2023, name="", solution=(9947476, 519939907614)
+):
+    def __init__(self, input: Iterable[str]):
         super().__init__(input)
-        self.tile_grid = parse_input(input)
-        apply_space_expansion(self.tile_grid)
+        self.galaxies, self.x_count, self.y_count = find_galaxies(input)
 
     def solve(self):
-        return (self.solve_1(), None)
+        return (self.solve_1(), self.solve_2())
 
     def solve_1(self) -> int:
-        # Collect all the galaxies and generate a pairing between all galaxies
-        # without repeats.
-        galaxy_tiles: dict[int, Point] = dict()
-
-        for y in range(self.tile_grid.y_count):
-            for x, tile in enumerate(self.tile_grid.row(y)):
-                if tile.galaxy_id is not None:
-                    galaxy_tiles[tile.galaxy_id] = Point(x, y)
-
-        galaxies = [
-            tile.galaxy_id for tile in self.tile_grid if tile.galaxy_id is not None
-        ]
-        total_cost = 0
-
-        counter = 50
-
-        for a, b in all_pairs(galaxies):
-            if counter > 0:
-                counter -= 1
-            else:
-                return total_cost
+        return self.total_distance(2)
 
-            path = astar_search(
-                self.tile_grid,
-                galaxy_tiles[a],
-                galaxy_tiles[b],
-                lambda grid, ta, tb: grid[tb].cost,
-                manhattan_distance,
-            )
+    def solve_2(self) -> int:
+        return self.total_distance(1_000_000)
 
-            if path is None:
-                raise Exception("path should be valid")
-
-            cost = len(path) - 1
-            total_cost += cost
-            print(f"{a} -> {b} is {cost}")
-
-        return total_cost
+    def total_distance(self, factor: int) -> int:
+        """Sum of the shortest paths between every pair of galaxies once each
+        empty column and row has grown `factor` times wider."""
+        axes = expanded_axes(self.galaxies, self.x_count, self.y_count, factor)
+        return axes.total_distance(self.galaxies)
 
 
 class Tests(AdventDayTestCase):
-    def setUp(self):
-        super().setUp(Solver)
-
-    def test_sample(self):
-        d = self._create_sample_solver(
-            """...#......
+    SAMPLE = """...#......
 .......#..
 #.........
 ..........
@@ -133,10 +69,22 @@ class Tests(AdventDayTestCase):
 ..........
 .......#..
 #...#....."""
-        )
 
-        self.assertEqual(374, s[0])
-        self.assertEqual(None, s[1])
+    def setUp(self):
+        super().setUp(Solver)
+
+    def test_sample(self):
+        d = self._create_sample_solver(self.SAMPLE)
+        self.assertEqual(374, d.total_distance(2))
+        self.assertEqual(1030, d.total_distance(10))
+        self.assertEqual(8410, d.total_distance(100))
+
+    def test_single_pair(self):
+        d = self._create_sample_solver(self.SAMPLE)
+        axes = expanded_axes(d.galaxies, d.x_count, d.y_count, 2)
+
+        # Galaxies 5 and 9 from the puzzle description are 9 steps apart.
+        self.assertEqual(9, axes.distance(Point(1, 5), Point(4, 9)))
 
 
 if __name__ == "__main__":
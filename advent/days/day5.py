@@ -2,9 +2,10 @@ import re
 import unittest
 
 from enum import Enum
-from multiprocessing import Pool
+from functools import reduce
 
 from advent.solver import AdventDaySolver, AdventDayTestCase, solver_main
+from advent.utils import IntArray, IntervalMap, parse_ints
 
 
 def merge_ranges(ranges):
@@ -36,7 +37,7 @@ def parse_input(input):
     for line in input:
         if state == ParserState.EXPECT_SEEDS:
             _, list_input = line.split(":")
-            seeds = [int(s) for s in list_input.split()]
+            seeds = parse_ints(list_input).tolist()
             state = ParserState.EXPECT_BLANK
         elif state == ParserState.EXPECT_BLANK:
             assert line == ""
@@ -56,16 +57,9 @@ def parse_input(input):
             if line == "":
                 state = ParserState.EXPECT_MAP_NAME
             else:
-                range_extractor = re.search("(\\d+) (\\d+) (\\d+)", line)
-                assert range_extractor
+                dest_start, source_start, range_length = parse_ints(line)
 
-                dest_start = int(range_extractor.group(1))
-                source_start = int(range_extractor.group(2))
-                range_length = int(range_extractor.group(3))
-
-                maps[last_map_name].add(
-                    RangeEntry(source_start, dest_start, range_length)
-                )
+                maps[last_map_name].add(source_start, dest_start, range_length)
 
         else:
             raise Exception("unknown state in parser")
@@ -77,34 +71,13 @@ class RangeMap:
     def __init__(self, from_name, to_name):
         self.from_name = from_name
         self.to_name = to_name
-        self.entries = []
+        self.intervals = IntervalMap()
 
-    def add(self, range):
-        self.entries.append(range)
+    def add(self, source_start, dest_start, length):
+        self.intervals.add(source_start, dest_start, length)
 
     def transform(self, v):
-        for r in self.entries:
-            v_new = r.map(v)
-            if v_new is not None:
-                return v_new
-
-        return v
-
-
-class RangeEntry:
-    def __init__(self, source_start, dest_start, length):
-        self.source_start = source_start
-        self.dest_start = dest_start
-        self.length = length
-
-    def is_in_range(self, v):
-        return v >= self.source_start and v < (self.source_start + self.length)
-
-    def map(self, v):
-        if self.is_in_range(v):
-            return v - self.source_start + self.dest_start
-        else:
-            return None
+        return self.intervals.map(v)
 
 
 class Solver(AdventDaySolver, day=5, year=2023, name="", solution=(3374647, 6082852)):
@@ -122,7 +95,7 @@ class Solver(AdventDaySolver, day=5, year=2023, name="", solution=(3374647, 6082
         super().__init__(input)
 
     def transform_seed_to_location(self, seed):
-        return self.transform_seed(seed, self.fast_forward_xform_chain)
+        return self.seed_to_location.map(seed)
 
     def transform_seed(self, seed, chain):
         for m in chain:
@@ -132,52 +105,28 @@ class Solver(AdventDaySolver, day=5, year=2023, name="", solution=(3374647, 6082
     def solve(self):
         self.seeds, self.maps = parse_input(self.input)
 
-        # Asssemble a faster map transform chain w/out needing hashtables.
-        self.fast_forward_xform_chain = [self.maps[n] for n in self.map_chain]
-
-        # Part #1: Find the lowest location number of any initial seed.
-        part_1 = min([self.transform_seed_to_location(s) for s in self.seeds])
+        # Flatten the whole seed to location chain into a single map, so each
+        # seed is one binary search rather than a walk through every map.
+        self.seed_to_location = reduce(
+            lambda a, b: a.then(b),
+            (self.maps[n].intervals for n in self.map_chain),
+        )
 
-        # Part #2: Same but with seed ranges.
-        # range_count = len(self.seeds) / 2
-        part_2 = None
+        # Part #1: Find the lowest location number of any initial seed, mapping
+        # and reducing every seed in a single native pass.
+        part_1 = self.seed_to_location.map_min(IntArray(self.seeds))
 
+        # Part #2: Same but with seed ranges. Mapping the ranges as a whole
+        # returns sorted location ranges, so the first one starts at the lowest
+        # location.
         seed_ranges = [
             (self.seeds[i], self.seeds[i] + self.seeds[i + 1])
             for i in range(0, len(self.seeds), 2)
         ]
-
-        with Pool(8) as p:
-            part2_mins = p.map(self.find_min_for_seed_range, seed_ranges)
-            print(part2_mins)
-            part_2 = min(part2_mins)
-            print(part_2)
+        part_2 = self.seed_to_location.map_ranges(seed_ranges)[0][0]
 
         return (part_1, part_2)
 
-    def find_min_for_seed_range(self, seed_range):
-        start_seed = seed_range[0]
-        end_seed = seed_range[1]
-        total = end_seed - start_seed
-        min_location = None
-
-        for x in range(start_seed, end_seed):
-            if (x - start_seed) % 1000000 == 0:
-                percent = ((x - start_seed) * 100) / (end_seed - start_seed)
-                remaining = end_seed - x
-
-                print(
-                    f"search seed range: [{start_seed}-{end_seed}] {end_seed-start_seed} seeds, {total} total, {remaining} remaining, {percent}% done"
-                )
-
-            location = self.transform_seed_to_location(x)
-
-            if min_location is None or location < min_location:
-                min_location = location
-
-        print(f"potential min: {min_location}")
-        return min_location
-
 
 class Tests(AdventDayTestCase):
     def setUp(self):
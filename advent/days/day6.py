@@ -5,6 +5,7 @@ import unittest
 from functools import reduce
 
 from advent.solver import AdventDaySolver, AdventDayTestCase, solver_main
+from advent.utils import parse_ints
 
 
 def parse_input_line(input):
@@ -12,7 +13,7 @@ def parse_input_line(input):
     assert input_matcher
 
     field_name = input_matcher.group(1)
-    values = [int(s) for s in input_matcher.group(2).split()]
+    values = parse_ints(input_matcher.group(2)).tolist()
 
     return (field_name, values)
 
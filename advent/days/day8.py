@@ -3,9 +3,11 @@ import logging
 import re
 import unittest
 
-from math import lcm
+from itertools import product
+from math import gcd, lcm
 
 from advent.solver import AdventDaySolver, AdventDayTestCase, solver_main
+from advent.utils import Network
 
 
 class Node:
@@ -42,40 +44,53 @@ def parse_input(input_lines):
     return (commands, nodes)
 
 
-def solve_path(commands, nodes, start_node_name, end_node_name):
-    def is_target(node, end_node_name):
-        if end_node_name:
-            return node.name == end_node_name
+def first_common_step(cycles):
+    """Find the first step where every walk stands on a target, given each
+    walk's `(tail, period, offsets)` from `Network.cycle`. Returns None if the
+    walks never line up."""
+
+    def hits(cycle, step):
+        tail, period, offsets = cycle
+        if step < tail + period:
+            return step in offsets
+        return any((step - o) % period == 0 for o in offsets if o >= tail)
+
+    # Steps before every walk is inside its cycle are checked one at a time,
+    # using the hits of the first walk as candidates.
+    bound = max(tail + period for tail, period, _ in cycles)
+    tail, period, offsets = cycles[0]
+    early = [o for o in offsets if o < tail] + [
+        step
+        for o in offsets
+        if o >= tail
+        for step in range(o, bound, period)
+    ]
+
+    for step in sorted(early):
+        if all(hits(c, step) for c in cycles[1:]):
+            return step
+
+    # Past the bound each walk hits on `o mod period` for its cycle offsets,
+    # so every combination of offsets is a congruence system solved with the
+    # Chinese remainder theorem.
+    best = None
+    cyclic = [[(o, p) for o in offs if o >= t] for t, p, offs in cycles]
+
+    for system in product(*cyclic):
+        step, modulus = 0, 1
+        for offset, period in system:
+            g = gcd(modulus, period)
+            if (offset - step) % g != 0:
+                break
+            k = (offset - step) // g * pow(modulus // g, -1, period // g)
+            step += modulus * (k % (period // g))
+            modulus = modulus // g * period
         else:
-            return node.name.endswith("Z")
+            if step < bound:
+                step += (bound - step + modulus - 1) // modulus * modulus
+            best = step if best is None else min(best, step)
 
-    n = nodes[start_node_name]
-    i = 0
-    steps = 0
-
-    while not is_target(n, end_node_name):
-        # Infinite loop check:
-        # if steps > 10:
-        #    raise Exception("solver hit too many steps - infinite loop?")
-
-        # Perform requested move.
-        command = commands[i]
-        next_node_name = n.go(command)
-
-        # logging.debug(
-        #    f"{command}: {n.name}, {n.left}, {n.right} -> {next_node_name} step {steps}"
-        # )
-        assert next_node_name in nodes
-
-        n = nodes[next_node_name]
-        steps += 1
-
-        # Move to next command.
-        i += 1
-        if i >= len(commands):
-            i = 0
-
-    return steps
+    return best
 
 
 class Solver(
@@ -88,6 +103,10 @@ class Solver(
     def __init__(self, input):
         super().__init__(input)
         self.commands, self.nodes = parse_input(input)
+        self.network = Network(
+            self.commands,
+            ((n.name, n.left, n.right) for n in self.nodes.values()),
+        )
 
         self.has_aaa = "AAA" in self.nodes
         self.has_end_a = any(n for n in self.nodes if n.endswith("A"))
@@ -99,7 +118,7 @@ class Solver(
 
     def solve_1(self):
         assert "AAA" in self.nodes
-        return solve_path(self.commands, self.nodes, "AAA", "ZZZ")
+        return self.network.walk("AAA", "ZZZ")
 
     def solve_2(self):
         # This one is a bit nasty. My initial solution was to copy the solution
@@ -113,17 +132,23 @@ class Solver(
         # solution is similiar to problems in AoC question in part years. A more
         # generic solution would be to use the Chinese remainder theorem (CRT).
         #
-        # Using LCM works because the input is constructed in a specific manner
-        # such that the number of nodes BEFORE the "head" of the cycle is
-        # exactly same as the number of nodes IN the cycle.
-        start_nodes = [self.nodes[n] for n in self.nodes if n.endswith("A")]
-        end_nodes = [
-            solve_path(self.commands, self.nodes, n.name, None) for n in start_nodes
-        ]
+        # Using LCM only works when the input is constructed so that each
+        # ghost's first target is exactly one cycle length from the start, and
+        # the cycle holds no other target. That is checked here rather than
+        # assumed, with a general CRT search as the fallback.
+        start_nodes = [n for n in self.nodes if n.endswith("A")]
+        end_nodes = [n for n in self.nodes if n.endswith("Z")]
+        cycles = [self.network.cycle(n, end_nodes) for n in start_nodes]
+
+        logging.debug(f"cycles: {cycles}")
 
-        logging.debug(f"ends: {end_nodes}")
+        if all(
+            offsets == [period] and period >= tail
+            for tail, period, offsets in cycles
+        ):
+            return lcm(*(period for _, period, _ in cycles))
 
-        return lcm(*end_nodes)
+        return first_common_step(cycles)
 
 
 class Tests(AdventDayTestCase):
@@ -174,6 +199,40 @@ XXX = (XXX, XXX)"""
         s = d.solve()
 
         self.assertEqual(6, s[1])
+        self.assertEqual((1, 2, [2]), d.network.cycle("11A", ["11Z", "22Z"]))
+        self.assertEqual((1, 6, [3, 6]), d.network.cycle("22A", ["11Z", "22Z"]))
+
+    def test_target_in_tail_does_not_repeat(self):
+        d = self._create_sample_solver(
+            """L
+
+11A = (11B, 11B)
+11B = (11Z, 11Z)
+11Z = (11C, 11C)
+11C = (11D, 11D)
+11D = (11E, 11E)
+11E = (11D, 11D)
+22A = (22B, 22B)
+22B = (22C, 22C)
+22C = (22D, 22D)
+22D = (22Z, 22Z)
+22Z = (22B, 22B)"""
+        )
+
+        # 11A only reaches a target at step 2, before its cycle starts, so the
+        # LCM of the periods would wrongly answer 4.
+        self.assertEqual((4, 2, [2]), d.network.cycle("11A", ["11Z", "22Z"]))
+        self.assertEqual((1, 4, [4]), d.network.cycle("22A", ["11Z", "22Z"]))
+        self.assertEqual(None, d.solve()[1])
+
+    def test_first_common_step(self):
+        # Hits in the tail only count once.
+        self.assertEqual(4, first_common_step([(5, 3, [4]), (0, 2, [0])]))
+        self.assertEqual(None, first_common_step([(5, 3, [4]), (0, 2, [1])]))
+
+        # Cycles that never line up, and ones that only do after both tails.
+        self.assertEqual(None, first_common_step([(0, 2, [0]), (0, 4, [1])]))
+        self.assertEqual(23, first_common_step([(0, 4, [3]), (20, 5, [23])]))
 
 
 if __name__ == "__main__":
@@ -2,31 +2,16 @@
 import unittest
 
 from advent.solver import AdventDaySolver, AdventDayTestCase, solver_main
-from advent.utils import unzip
-
-
-def parse_inputs(input_lines):
-    entries = []
-    for line in input_lines:
-        entries.append([int(s) for s in line.split()])
-
-    return entries
+from advent.utils import extrapolate_rows, parse_int_rows, unzip
 
 
 def reduce(entry):
     # reduce the entry to zero, and return an array containing the last col
     # of each row starting from the bottom (but not including the zero).
-    # logging.debug(f"REDUCE: {entry}")
     first_cols = []
     placeholder_sum = 0
-    steps = 0
 
     while not all(x == 0 for x in entry):
-        if steps > 100:
-            raise Exception("debug tripwire")
-
-        steps += 1
-
         # save the first column
         first_cols.append(entry[0])
 
@@ -58,11 +43,19 @@ class Solver(
 ):
     def __init__(self, input):
         super().__init__(input)
-        self.entries = parse_inputs(input)
+        self.values, self.offsets = parse_int_rows(input)
+
+    @property
+    def entries(self):
+        return [
+            self.values[self.offsets[i] : self.offsets[i + 1]].tolist()
+            for i in range(len(self.offsets) - 1)
+        ]
 
     def solve(self):
-        part_1, part_2 = unzip(reduce(e) for e in self.entries)
-        return (sum(part_1), sum(part_2))
+        # Every row is extrapolated in both directions in one native pass.
+        next_values, previous_values = extrapolate_rows(self.values, self.offsets)
+        return (sum(next_values), sum(previous_values))
 
 
 class Tests(AdventDayTestCase):
@@ -106,6 +99,10 @@ class Tests(AdventDayTestCase):
         self.assertEqual(114, s[0])
         self.assertEqual(2, s[1])
 
+        # The native kernel agrees with the pure Python reduction.
+        part_1, part_2 = unzip(reduce(e) for e in d.entries)
+        self.assertEqual((sum(part_1), sum(part_2)), s)
+
 
 if __name__ == "__main__":
     solver_main(unittest.TestProgram(exit=False), Solver)
@@ -0,0 +1,86 @@
+"""Per day timing and allocation profiles for the solvers, used by the
+`--profile` mode of `main.py`."""
+import json
+import time
+from dataclasses import asdict, dataclass
+from typing import Any, Iterable, Tuple, Type
+
+import oatmeal
+
+from advent.solver import AdventDaySolver
+from advent.utils import load_input
+
+# Phases shown in the profile table, in the order they run.
+TABLE_PHASES = ["load", "parse", "solve", "part_1", "part_2"]
+
+# Allocation counters shown in the profile table, with their column headings.
+TABLE_COUNTERS = {
+    "points_created": "points",
+    "point_free_list_hits": "free list",
+    "frozen_point_intern_hits": "interned",
+    "grids_created": "grids",
+}
+
+
+@dataclass
+class DayProfile:
+    """Timings and allocations from one solver run."""
+
+    day: int
+    year: int
+    name: str
+    # Nanoseconds spent in each phase, including loading the input.
+    timings: dict[str, int]
+    # Objects oatmeal allocated during the run, from `oatmeal.alloc_stats`.
+    allocations: dict[str, int]
+    solution: Tuple[Any, Any]
+
+
+def profile_solver(solver_type: Type[AdventDaySolver]) -> DayProfile:
+    """Load the puzzle input and solve it, recording where the time went and
+    how many objects were allocated."""
+    oatmeal.reset_alloc_stats()
+
+    start = time.perf_counter_ns()
+    input = load_input(day=solver_type.day(), year=solver_type.year())
+    load_ns = time.perf_counter_ns() - start
+
+    solver = solver_type(input)
+    solution = solver.solve()
+
+    return DayProfile(
+        day=solver_type.day(),
+        year=solver_type.year(),
+        name=solver_type.name(),
+        timings={"load": load_ns, **solver.timings},
+        allocations=oatmeal.alloc_stats(),
+        solution=solution,
+    )
+
+
+def print_profile_table(profiles: Iterable[DayProfile]) -> None:
+    """Print one row per day with phase times in milliseconds followed by the
+    allocation counters. Phases a solver does not have are shown as `-`."""
+    headings = ["year", "day"] + TABLE_PHASES + list(TABLE_COUNTERS.values())
+    rows = [headings]
+
+    for p in profiles:
+        times = [
+            f"{p.timings[phase] / 1e6:.2f}" if phase in p.timings else "-"
+            for phase in TABLE_PHASES
+        ]
+        counts = [str(p.allocations.get(c, 0)) for c in TABLE_COUNTERS]
+        rows.append([str(p.year), str(p.day)] + times + counts)
+
+    widths = [max(len(row[i]) for row in rows) for i in range(len(headings))]
+
+    for row in rows:
+        print("  ".join(cell.rjust(width) for cell, width in zip(row, widths)))
+
+
+def write_profile_json(path: str, profiles: Iterable[DayProfile]) -> None:
+    """Write the profiles to `path` as JSON so runs can be compared later.
+    Answers that are not plain JSON values are written as strings."""
+    with open(path, "w") as f:
+        json.dump([asdict(p) for p in profiles], f, indent=2, default=str)
+        f.write("\n")
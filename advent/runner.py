@@ -0,0 +1,126 @@
+"""Runs many solvers at once on a worker pool, yielding each result as soon as
+its day finishes so slow days do not hold back the rest."""
+import json
+import os
+import time
+import traceback
+from concurrent.futures import (
+    Executor,
+    ProcessPoolExecutor,
+    ThreadPoolExecutor,
+    as_completed,
+)
+from dataclasses import dataclass
+from typing import Any, Iterator, Optional, Tuple, Type
+
+from advent.cache import SolverCache
+from advent.solver import AdventDaySolver
+from advent.utils import load_input
+
+
+@dataclass
+class DayResult:
+    """The outcome of solving one day."""
+
+    day: int
+    year: int
+    solution: Optional[Tuple[Any, Any]]
+    # Wall clock seconds spent loading and solving the input.
+    seconds: float
+    # Formatted traceback if the solver raised instead of returning.
+    error: Optional[str] = None
+    # True if the solution was read from the cache rather than solved.
+    cached: bool = False
+
+
+def solve_day(day: int, year: int, cache: Optional[SolverCache] = None) -> DayResult:
+    """Load and solve a single day, or read its answers from `cache`. This runs
+    inside the workers, so it looks the solver up by day and year rather than
+    being handed the class. Worker processes see the same solvers as the caller
+    because they either fork from it or re-import its main module, which
+    registers them."""
+    start = time.perf_counter()
+
+    try:
+        solver_type = AdventDaySolver.get_solver(day, year)
+
+        if cache is None:
+            solution = solver_type(load_input(day=day, year=year)).solve()
+            cached = False
+        else:
+            solution, cached = cache.solve(solver_type)
+
+        elapsed = time.perf_counter() - start
+        return DayResult(day, year, solution, elapsed, cached=cached)
+    except Exception:
+        elapsed = time.perf_counter() - start
+        return DayResult(day, year, None, elapsed, error=traceback.format_exc())
+
+
+def load_expected_times(path: Optional[str]) -> dict[Tuple[int, int], float]:
+    """Read the nanoseconds each day took from a `--profile` JSON file, keyed
+    by `(year, day)`. Returns an empty dict if there is no such file."""
+    if path is None or not os.path.exists(path):
+        return dict()
+
+    with open(path) as f:
+        profiles = json.load(f)
+
+    return {(p["year"], p["day"]): sum(p["timings"].values()) for p in profiles}
+
+
+def longest_first(
+    solver_types: list[Type[AdventDaySolver]],
+    expected_times: dict[Tuple[int, int], float],
+) -> list[Type[AdventDaySolver]]:
+    """Order solvers so the slowest start first, which keeps a slow day from
+    being the last thing left running. Days without a timing are assumed to be
+    slow, since nothing is known about them."""
+
+    def expected(solver_type):
+        key = (solver_type.year(), solver_type.day())
+        return expected_times.get(key, float("inf"))
+
+    return sorted(solver_types, key=expected, reverse=True)
+
+
+def run_days(
+    solver_types: list[Type[AdventDaySolver]],
+    jobs: Optional[int] = None,
+    threads: bool = False,
+    timings_path: Optional[str] = None,
+    cache: Optional[SolverCache] = None,
+) -> Iterator[DayResult]:
+    """Solve every day on a pool of `jobs` workers, one per core by default,
+    yielding results in the order they finish.
+
+    Workers are processes unless `threads` is set. Threads share one
+    interpreter, so they only run in parallel inside oatmeal kernels that
+    release the GIL. oatmeal keeps the GIL enabled even on free-threaded
+    Python builds. Days with answers in `cache` are read back instead of
+    solved."""
+    jobs = jobs or os.cpu_count() or 1
+    ordered = longest_first(solver_types, load_expected_times(timings_path))
+
+    # A single worker gains nothing from a pool, and running inline keeps
+    # tracebacks and debuggers simple.
+    if jobs == 1:
+        for solver_type in ordered:
+            yield solve_day(solver_type.day(), solver_type.year(), cache)
+        return
+
+    pool: Executor = (
+        ThreadPoolExecutor(max_workers=jobs)
+        if threads
+        else ProcessPoolExecutor(max_workers=jobs)
+    )
+
+    # Pools hand out work in submission order, so submitting longest first is
+    # enough to schedule longest first.
+    with pool:
+        futures = [
+            pool.submit(solve_day, s.day(), s.year(), cache) for s in ordered
+        ]
+
+        for future in as_completed(futures):
+            yield future.result()
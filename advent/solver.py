@@ -1,4 +1,7 @@
+import functools
 import logging
+import time
+from contextlib import contextmanager
 from typing import (
     Self,
     TypeVar,
@@ -9,15 +12,37 @@ from typing import (
     Union,
     Optional,
     Type,
+    Callable,
+    Iterator,
     Tuple,
     cast,
 )
 import unittest
 
 from advent import utils
+from advent.cache import SolverCache
 
 AdventDay = TypeVar("AdventDay", bound="AdventDaySolver")
 
+# Solver methods that are timed automatically, and the phase each one records.
+TIMED_PHASES = {
+    "__init__": "parse",
+    "solve": "solve",
+    "solve_1": "part_1",
+    "solve_2": "part_2",
+}
+
+
+def _timed_method(phase: str, method: Callable[..., Any]) -> Callable[..., Any]:
+    """Wrap a solver method so each call adds its run time to `phase`."""
+
+    @functools.wraps(method)
+    def wrapper(self, *args, **kwargs):
+        with self.timed(phase):
+            return method(self, *args, **kwargs)
+
+    return wrapper
+
 
 # TODO: Move the factory functions for tracking subclasses out of AdventDaySolver
 #       because its mixing in factory stuff and makes the API confusing.
@@ -30,9 +55,40 @@ class AdventDaySolver:
 
     day_classes: ClassVar[Dict[int, Dict[int, Any]]] = dict()
 
+    # Nanoseconds spent in each phase of this solver, keyed by phase name.
+    timings: Dict[str, int]
+
     def __init__(self, input: Iterable[Iterable[str]]):
         self.input = input
 
+    # ==========================================================================#
+    # Phase timing                                                             #
+    # ==========================================================================#
+    @contextmanager
+    def timed(self, phase: str) -> Iterator[None]:
+        """Add the time spent inside the `with` block to `phase`. Parsing and
+        solving are timed automatically, and solvers can use this to time any
+        other step worth seeing in a profile."""
+        # Timers can run before a subclass `__init__` reaches this class.
+        timings = self.__dict__.setdefault("timings", dict())
+        active = self.__dict__.setdefault("_active_phases", set())
+
+        # Overrides calling `super()` nest the same phase, which only the
+        # outermost call should count.
+        if phase in active:
+            yield
+            return
+
+        active.add(phase)
+        start = time.perf_counter_ns()
+
+        try:
+            yield
+        finally:
+            elapsed = time.perf_counter_ns() - start
+            timings[phase] = timings.get(phase, 0) + elapsed
+            active.discard(phase)
+
     # ==========================================================================#
     # Subclass registration                                                    #
     # ==========================================================================#
@@ -43,6 +99,13 @@ class AdventDaySolver:
         name: str,
         solution: Optional[Tuple[Any, Any]],
     ) -> None:
+        # Wrap the methods this class defines. Inherited ones are already
+        # wrapped by the class that defined them.
+        for method_name, phase in TIMED_PHASES.items():
+            method = cls.__dict__.get(method_name)
+            if method is not None:
+                setattr(cls, method_name, _timed_method(phase, method))
+
         AdventDaySolver._add_day_class(cls, day, year, name, solution)
 
     @classmethod
@@ -119,6 +182,13 @@ class AdventDayTestCase(unittest.TestCase):
         self.solver = solver
 
     def _create_real_solver(self):
+        # Parsed input is shared through the cache, but every test still runs
+        # the solver itself.
+        cache = SolverCache.default()
+
+        if cache is not None:
+            return cache.load_solver(self.solver)
+
         return self.solver(
             utils.load_input(day=self.solver.day(), year=self.solver.year())
         )
@@ -173,9 +243,14 @@ def solver_main(
 
         # Test passed! Try running the solver to see what happens.
         expected = solver_class.solution()
-        actual = solver_class(input_lines).solve()
+
+        solver = solver_class(input_lines)
+        actual = solver.solve()
 
         print_part_solution(expected[0], actual[0], 1)
         print_part_solution(expected[1], actual[1], 2)
+
+        for phase, elapsed in solver.timings.items():
+            logging.debug(f"{phase}: {elapsed / 1e6:.3f} ms")
     else:
         logging.warning("unit tests did not pass, will skip actual puzzle input")
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Benchmark for `oatmeal.parse_ints` and `oatmeal.parse_int_rows`.
+
+Parses a generated input shaped like the 2023 day 9 puzzle (rows of signed
+integers separated by spaces) with `split` and `int`, with one `parse_ints`
+call per line, and with a single `parse_int_rows` call over a `MappedInput`
+of the same text.
+
+Run with `python3 -m benchmarks.parse_ints`.
+"""
+import os
+import random
+import tempfile
+import timeit
+
+from oatmeal import MappedInput, parse_int_rows, parse_ints
+
+ROWS = 20_000
+COLUMNS = 21
+REPEATS = 5
+
+
+def best_of(stmt: str, setup: str, number: int) -> float:
+    """Returns the fastest time per run in milliseconds."""
+    timings = timeit.repeat(
+        stmt, setup=setup, number=number, repeat=REPEATS, globals=globals()
+    )
+    return min(timings) / number * 1e3
+
+
+def main():
+    rng = random.Random(2023)
+    lines = [
+        " ".join(str(rng.randint(-10_000_000, 10_000_000)) for _ in range(COLUMNS))
+        for _ in range(ROWS)
+    ]
+
+    handle, path = tempfile.mkstemp(suffix=".txt")
+    with os.fdopen(handle, "w") as file:
+        file.write("\n".join(lines))
+
+    try:
+        setup = f"lines = {lines!r}\nmapped = MappedInput({path!r})"
+        cases = [
+            ("split + int", "[[int(s) for s in line.split()] for line in lines]"),
+            ("parse_ints per line", "[parse_ints(line) for line in lines]"),
+            ("parse_int_rows(list)", "parse_int_rows(lines)"),
+            ("parse_int_rows(mapped)", "parse_int_rows(mapped)"),
+        ]
+
+        print(f"{'operation':<26}{'ms/run':>10}")
+        for name, stmt in cases:
+            print(f"{name:<26}{best_of(stmt, setup, 5):>10.2f}")
+    finally:
+        os.remove(path)
+
+
+if __name__ == "__main__":
+    main()
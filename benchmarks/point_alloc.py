@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Microbenchmark for `oatmeal.Point` allocation.
+
+Compares the direct allocation path used by the arithmetic operators (which
+allocate with `tp_alloc` or recycle from the free list) against calling the
+`Point` type. Calling the type goes through `Point_vectorcall`, which parses
+the arguments off the stack. The `__new__` / `__init__` case is the old
+path: build an argument tuple, dispatch through `tp_new` / `tp_init`, and
+parse the tuple. Frozen points inside the intern window come back from a
+cache without allocating at all.
+
+Run with `python3 -m benchmarks.point_alloc`.
+"""
+import timeit
+
+from oatmeal import FrozenPoint, Point
+
+ITERATIONS = 1_000_000
+REPEATS = 5
+
+
+def best_of(stmt: str, setup: str) -> float:
+    """Returns the fastest per-operation time in nanoseconds."""
+    timings = timeit.repeat(
+        stmt, setup=setup, number=ITERATIONS, repeat=REPEATS, globals=globals()
+    )
+    return min(timings) / ITERATIONS * 1e9
+
+
+def main():
+    setup = "a = Point(3, -4); b = Point(1, 2); f = FrozenPoint(3, 4)"
+    cases = [
+        ("type call Point(x, y)", "Point(4, -2)"),
+        ("__new__ + __init__", "p = Point.__new__(Point); p.__init__(4, -2)"),
+        ("Point.EAST", "Point.EAST"),
+        ("FrozenPoint(x, y)", "FrozenPoint(4, 2)"),
+        ("frozen + Point.EAST", "f + Point.EAST"),
+        ("clone()", "a.clone()"),
+        ("a + b", "a + b"),
+        ("a - b", "a - b"),
+        ("a * 3", "a * 3"),
+        ("-a", "-a"),
+        ("abs(a)", "abs(a)"),
+    ]
+
+    baseline = best_of(cases[0][1], setup)
+
+    print(f"{'operation':<24}{'ns/op':>10}{'vs type call':>16}")
+    for name, stmt in cases:
+        ns = best_of(stmt, setup)
+        print(f"{name:<24}{ns:>10.1f}{baseline / ns:>15.2f}x")
+
+
+if __name__ == "__main__":
+    main()
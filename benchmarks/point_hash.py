@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Benchmark for `oatmeal.Point` hashing and the native point tables.
+
+The first part replays CPython's dict probe sequence for a few typical point
+workloads, once with the old `x ^ (y << 1)` hash and once with the current
+`hash(Point)`, and reports how many slots each insert had to probe. A chain
+length of 1 means the point landed in an empty slot first time.
+
+The second part times building and querying a `set` / `dict` of points
+against `oatmeal.PointSet` / `oatmeal.PointMap`.
+
+Run with `python3 -m benchmarks.point_hash`.
+"""
+import timeit
+
+from oatmeal import Point, PointMap, PointSet
+
+MASK_64 = (1 << 64) - 1
+REPEATS = 5
+
+
+def old_point_hash(x: int, y: int) -> int:
+    """The previous `Point_hash`, which was `std::hash<long>` (the identity)."""
+    h = (x ^ (y << 1)) & MASK_64
+    return h - (1 << 64) if h >= 1 << 63 else h
+
+
+def dict_probe_lengths(hashes: list[int]) -> list[int]:
+    """Number of slots probed inserting each hash into a CPython style dict."""
+    size = 8
+    while size * 2 // 3 < len(hashes):
+        size *= 2
+
+    mask = size - 1
+    used = [False] * size
+    lengths = []
+
+    for h in hashes:
+        perturb = h & MASK_64
+        i = perturb & mask
+        probes = 1
+
+        while used[i]:
+            perturb >>= 5
+            i = (i * 5 + perturb + 1) & mask
+            probes += 1
+
+        used[i] = True
+        lengths.append(probes)
+
+    return lengths
+
+
+def workloads() -> dict[str, list[tuple[int, int]]]:
+    return {
+        "140x140 grid": [(x, y) for y in range(140) for x in range(140)],
+        "diagonal band": [(i + d, i) for i in range(5000) for d in range(-2, 3)],
+        "centred square": [(x, y) for y in range(-70, 70) for x in range(-70, 70)],
+    }
+
+
+def print_chain_lengths():
+    print(f"{'workload':<18}{'hash':<8}{'mean probes':>12}{'max probes':>12}")
+
+    for name, coords in workloads().items():
+        for label, fn in [
+            ("old", lambda c: old_point_hash(*c)),
+            ("new", lambda c: hash(Point(*c))),
+        ]:
+            lengths = dict_probe_lengths([fn(c) for c in coords])
+            mean = sum(lengths) / len(lengths)
+            print(f"{name:<18}{label:<8}{mean:>12.2f}{max(lengths):>12}")
+
+
+def best_of(stmt: str, setup: str, number: int) -> float:
+    """Returns the fastest time per run in milliseconds."""
+    timings = timeit.repeat(
+        stmt, setup=setup, number=number, repeat=REPEATS, globals=globals()
+    )
+    return min(timings) / number * 1e3
+
+
+def print_table_timings():
+    setup = "points = [Point(x, y) for y in range(140) for x in range(140)]"
+    cases = [
+        ("set build", "set(points)"),
+        ("PointSet build", "PointSet(points)"),
+        ("set contains", "s = set(points)\nfor p in points: p in s"),
+        ("PointSet contains", "s = PointSet(points)\nfor p in points: p in s"),
+        ("dict[int] fill", "d = {}\nfor p in points: d[p] = 1"),
+        ("PointMap[int64] fill", "m = PointMap('int64')\nfor p in points: m[p] = 1"),
+    ]
+
+    print(f"\n{'operation':<24}{'ms/run':>10}")
+    for name, stmt in cases:
+        print(f"{name:<24}{best_of(stmt, setup, 20):>10.2f}")
+
+
+def main():
+    print_chain_lengths()
+    print_table_timings()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,352 @@
+#!/usr/bin/env python3
+"""Benchmark suite covering every solver and the core oatmeal primitives.
+
+Each solver runs on its puzzle input scaled up by repeating the parts of the
+input that can be repeated without making it invalid, and each primitive runs
+on a generated workload sized by the same scale factor. A benchmark reports
+the best time over several runs, the throughput that time gives, and the peak
+memory traced during one extra untimed run.
+
+Results can be saved as a baseline, and later runs flag any benchmark that is
+slower than its baseline by more than a tolerance. Timings only compare on the
+same machine, so baselines are not checked in.
+
+Run with `python3 main.py bench` or `python3 -m benchmarks.suite`.
+"""
+import argparse
+import gc
+import importlib
+import itertools
+import json
+import os
+import tempfile
+import time
+import tracemalloc
+from dataclasses import asdict, dataclass
+from typing import Callable, Iterable, Optional
+
+import advent.days
+from advent.solver import AdventDaySolver
+from advent.utils import (
+    Grid,
+    MappedInput,
+    Point,
+    astar_search,
+    bfs_distances,
+    match_counts,
+)
+
+DEFAULT_SCALES = [1, 10, 100, 1000]
+DEFAULT_BASELINE = os.path.join(os.path.dirname(__file__), "baseline.json")
+
+# Largest useful scale for solvers whose run time grows faster than their
+# input, or whose input cannot be scaled at all.
+MAX_SCALE = {3: 100, 6: 1, 8: 100, 10: 1}
+
+
+@dataclass
+class BenchResult:
+    """Timings for one benchmark at one scale."""
+
+    name: str
+    scale: int
+    # Fastest run in seconds.
+    seconds: float
+    # Work done per second of the fastest run, counted in `unit`.
+    throughput: float
+    unit: str
+    # Peak bytes allocated through the Python allocators during a run.
+    peak_bytes: int
+
+
+@dataclass
+class Bench:
+    """A benchmark body along with the amount of work one run does."""
+
+    name: str
+    run: Callable[[], object]
+    work: float
+    unit: str
+    cleanup: Optional[Callable[[], None]] = None
+
+
+# ==============================================================================
+# Scaled solver inputs
+# ==============================================================================
+def repeat_lines(lines: list[str], scale: int) -> list[str]:
+    """Inputs where every line is independent of the others."""
+    return lines * scale
+
+
+def repeat_cards(lines: list[str], scale: int) -> list[str]:
+    """Day 4: repeat the cards, numbering each block on from the last. Cards
+    that would win copies past the end of a block are followed by cards that
+    win nothing, so no block adds copies to the next one and the cascade does
+    the same work in every block."""
+    matches = list(match_counts(lines))
+    bodies = [line.split(":", 1)[1] for line in lines]
+    overhang = max(i + m for i, m in enumerate(matches)) - (len(lines) - 1)
+
+    if overhang > 0:
+        if 0 not in matches:
+            raise ValueError("day 4 input has no losing card to pad blocks with")
+
+        bodies += [bodies[matches.index(0)]] * overhang
+
+    return [
+        f"Card {number}:{body}"
+        for number, body in enumerate(bodies * scale, start=1)
+    ]
+
+
+def repeat_seeds(lines: list[str], scale: int) -> list[str]:
+    """Day 5: repeat the seed numbers and keep the maps as they are."""
+    label, seeds = lines[0].split(":")
+    return [f"{label}:{seeds * scale}"] + lines[1:]
+
+
+def repeat_turns(lines: list[str], scale: int) -> list[str]:
+    """Day 8: repeat the turns, which keeps every node valid."""
+    return [lines[0] * scale] + lines[1:]
+
+
+SCALERS: dict[int, Callable[[list[str], int], list[str]]] = {
+    4: repeat_cards,
+    5: repeat_seeds,
+    8: repeat_turns,
+}
+
+
+def solver_bench(solver_type, scale: int) -> Optional[Bench]:
+    """Write the scaled input of a solver to a file and benchmark solving it
+    through a `MappedInput`, as `load_input` would. Returns None if the solver
+    does not run at this scale."""
+    day, year = solver_type.day(), solver_type.year()
+
+    if scale > MAX_SCALE.get(day, scale):
+        return None
+
+    with open(f"inputs/{year}/day{day}.txt") as f:
+        lines = f.read().splitlines()
+
+    text = "\n".join(SCALERS.get(day, repeat_lines)(lines, scale))
+    handle, path = tempfile.mkstemp(suffix=".txt")
+
+    with os.fdopen(handle, "w") as f:
+        f.write(text)
+
+    def run():
+        with MappedInput(path) as input:
+            return solver_type(input).solve()
+
+    return Bench(
+        name=f"day{day}",
+        run=run,
+        work=len(text) / 1e6,
+        unit="MB/s",
+        cleanup=lambda: os.remove(path),
+    )
+
+
+# ==============================================================================
+# Primitive workloads
+# ==============================================================================
+def primitive_benches(scale: int) -> list[Bench]:
+    """Benchmarks for the oatmeal primitives, doing `scale` times the work of
+    the smallest run."""
+    count = 10_000 * scale
+    side = int((10_000 * scale) ** 0.5)
+    grid = Grid(side, side, ".", dtype="char")
+
+    def point_ops():
+        p = Point(0, 0)
+        step = Point(1, -1)
+        for _ in range(count):
+            p = p + step
+        return p
+
+    def grid_access():
+        return sum(
+            1 for y in range(side) for x in range(side) if grid[Point(x, y)] == "."
+        )
+
+    def bfs():
+        return bfs_distances(grid, Point(0, 0), passable=".")
+
+    def astar():
+        goal = Point(side - 1, side - 1)
+        return astar_search(grid, Point(0, 0), goal, None, "manhattan")
+
+    cells = side * side
+    return [
+        Bench("point_ops", point_ops, count, "ops/s"),
+        Bench("grid_access", grid_access, cells, "cells/s"),
+        Bench("bfs", bfs, cells, "cells/s"),
+        Bench("astar", astar, cells, "cells/s"),
+    ]
+
+
+# ==============================================================================
+# Running and reporting
+# ==============================================================================
+def measure(bench: Bench, scale: int, repeat: int) -> BenchResult:
+    """Time `repeat` runs and trace the memory of one more."""
+    best = float("inf")
+
+    for _ in range(repeat):
+        gc.collect()
+        start = time.perf_counter_ns()
+        bench.run()
+        best = min(best, (time.perf_counter_ns() - start) / 1e9)
+
+    # Tracing slows allocations down, so it gets a run of its own.
+    gc.collect()
+    tracemalloc.start()
+    bench.run()
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+
+    return BenchResult(
+        name=bench.name,
+        scale=scale,
+        seconds=best,
+        throughput=bench.work / best if best > 0 else float("inf"),
+        unit=bench.unit,
+        peak_bytes=peak,
+    )
+
+
+def load_solvers() -> None:
+    """Import every day module so its solver registers itself. This happens
+    when the suite runs rather than on import, so tests can use the helpers
+    here without registering the real solvers."""
+    for name in advent.days.__all__:
+        importlib.import_module(f"advent.days.{name}")
+
+
+def run_suite(
+    scales: Iterable[int], repeat: int, only: Optional[list[str]] = None
+) -> list[BenchResult]:
+    """Run every benchmark, or only those named in `only`, at each scale."""
+    load_solvers()
+    results = []
+    solver_types = [
+        AdventDaySolver.get_solver(day, year)
+        for year in AdventDaySolver.years()
+        for day in AdventDaySolver.days(year)
+        if not only or f"day{day}" in only
+    ]
+
+    for scale in scales:
+        # Solver inputs are written out one at a time, just before they run.
+        benches = (solver_bench(s, scale) for s in solver_types)
+        primitives = [b for b in primitive_benches(scale) if not only or b.name in only]
+
+        for bench in itertools.chain(benches, primitives):
+            if bench is None:
+                continue
+
+            try:
+                result = measure(bench, scale, repeat)
+            finally:
+                if bench.cleanup:
+                    bench.cleanup()
+
+            print_result(result)
+            results.append(result)
+
+    return results
+
+
+def print_result(r: BenchResult) -> None:
+    print(
+        f"{r.name:<12}{r.scale:>6}x{r.seconds * 1e3:>12.2f} ms"
+        f"{r.throughput:>14.3g} {r.unit:<8}{r.peak_bytes / 1e6:>10.2f} MB"
+    )
+
+
+def find_regressions(
+    results: list[BenchResult], baseline: list[dict], tolerance: float
+) -> list[tuple[BenchResult, float]]:
+    """Results slower than their baseline by more than `tolerance`, along with
+    the baseline time. Benchmarks missing from the baseline are skipped."""
+    expected = {(b["name"], b["scale"]): b["seconds"] for b in baseline}
+    return [
+        (r, expected[(r.name, r.scale)])
+        for r in results
+        if (r.name, r.scale) in expected
+        and r.seconds > expected[(r.name, r.scale)] * (1 + tolerance)
+    ]
+
+
+def add_arguments(parser: argparse.ArgumentParser) -> None:
+    """Add the suite options to `parser`, shared with `main.py bench`."""
+    parser.add_argument(
+        "--scales",
+        type=int,
+        nargs="+",
+        default=DEFAULT_SCALES,
+        help="input scale factors, such as 1 10 100 1000 (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--repeat", type=int, default=3, help="timed runs per benchmark"
+    )
+    parser.add_argument(
+        "--only", nargs="+", help="benchmark names to run, such as day5 or bfs"
+    )
+    parser.add_argument("--output", help="write the results to this JSON file")
+    parser.add_argument(
+        "--baseline",
+        default=DEFAULT_BASELINE,
+        help="baseline JSON to compare against (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--update-baseline",
+        action="store_true",
+        help="save the results as the new baseline instead of comparing",
+    )
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=0.2,
+        help="fraction slower than the baseline that counts as a regression",
+    )
+
+
+def main(args: argparse.Namespace) -> int:
+    """Run the suite as configured by `args`, returning a non zero exit status
+    if any benchmark regressed."""
+    print(f"{'benchmark':<12}{'scale':>7}{'best':>15}{'throughput':>23}{'peak':>13}")
+    results = run_suite(args.scales, args.repeat, args.only)
+    data = [asdict(r) for r in results]
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(data, f, indent=2)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(data, f, indent=2)
+        print(f"Saved baseline to {args.baseline}")
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print(f"No baseline at {args.baseline}, run with --update-baseline")
+        return 0
+
+    with open(args.baseline) as f:
+        regressions = find_regressions(results, json.load(f), args.tolerance)
+
+    for r, seconds in regressions:
+        print(
+            f"REGRESSION {r.name} {r.scale}x: {r.seconds * 1e3:.2f} ms, "
+            f"baseline {seconds * 1e3:.2f} ms"
+        )
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    add_arguments(parser)
+    raise SystemExit(main(parser.parse_args()))
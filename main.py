@@ -1,38 +1,75 @@
 #!/usr/bin/env python3
 import argparse
+import sys
+import time
 
+from advent.cache import DEFAULT_CACHE_DIR, SolverCache
 from advent.days import *  # noqa: F403
+from advent.profile import print_profile_table, profile_solver, write_profile_json
+from advent.runner import run_days
 from advent.utils import load_input
 from advent.solver import AdventDaySolver
+from benchmarks import suite
 from oatmeal import inc
 
-def solve(day, year):
+def solve(day, year, cache):
     solver_type = AdventDaySolver.get_solver(day, year)
-    solver = solver_type(load_input(day=day, year=year))
-    solution = solver.solve()
+
+    if cache is None:
+        solution = solver_type(load_input(day=day, year=year)).solve()
+    else:
+        solution, _ = cache.solve(solver_type)
 
     print(f"Solution for day {day} {year}")
     print(f"    part 1: {solution[0]}")
     print(f"    part 2: {solution[1]}")
 
 
-def solve_all():
-    for year in AdventDaySolver.years():
-        for day in AdventDaySolver.days(year):
-            solver_type = AdventDaySolver.get_solver(day, year)
-            solver = solver_type(load_input(day=day, year=year))
-            solution = solver.solve()
+def all_solvers():
+    return [
+        AdventDaySolver.get_solver(day, year)
+        for year in AdventDaySolver.years()
+        for day in AdventDaySolver.days(year)
+    ]
+
+
+def solve_all(jobs, threads, timings_path, cache):
+    start = time.perf_counter()
+
+    # Days are printed as they finish, so they can arrive in any order.
+    for result in run_days(all_solvers(), jobs, threads, timings_path, cache):
+        solver_type = AdventDaySolver.get_solver(result.day, result.year)
+        title = f"Day {result.day} {result.year} - {solver_type.name()}"
+
+        if result.error is not None:
+            print(f"{title}: 💥 ({result.seconds:.2f}s)\n{result.error}")
+            continue
+
+        expected = solver_type.solution() or (None, None)
+        part_1 = format_answer(result.solution[0], expected[0])
+        part_2 = format_answer(result.solution[1], expected[1])
 
-            part_1 = format_answer(solution[0], solver_type.solution()[0])
-            part_2 = format_answer(solution[0], solver_type.solution()[0])
+        cached = ", cached" if result.cached else ""
+        print(f"{title}: {part_1}, {part_2} ({result.seconds:.2f}s{cached})")
 
-            print(f"Day {solver_type.day()} - {solver_type.name()}: {part_1}, {part_2}")
+    print(f"Solved every day in {time.perf_counter() - start:.2f}s")
+
+
+def profile(solver_types, json_path):
+    profiles = [profile_solver(solver_type) for solver_type in solver_types]
+
+    print_profile_table(profiles)
+    write_profile_json(json_path, profiles)
+    print(f"Wrote profile to {json_path}")
 
 
 def format_answer(actual, expected):
     if actual is None:
         # Answer is missing - the solver has not been completed.
         return "❗"
+    elif expected is None:
+        # No known answer to check against yet.
+        return f"{actual} 🤔"
     elif actual != expected:
         return f"{actual} ❌"
     else:
@@ -52,22 +89,67 @@ def main():
 
     # Parse arguments.
     parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--profile",
+        action="store_true",
+        help="print per phase timings and allocation counts instead of answers",
+    )
+    parser.add_argument(
+        "--profile-json",
+        default="profile.json",
+        help="file the profile is written to, and read by solve_all to start "
+        "the slowest days first (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--jobs",
+        type=int,
+        default=None,
+        help="number of days to solve at once (default: one per core)",
+    )
+    parser.add_argument(
+        "--threads",
+        action="store_true",
+        help="solve days on threads rather than processes, which only runs in "
+        "parallel inside the oatmeal kernels that release the GIL",
+    )
+    parser.add_argument(
+        "--no-cache",
+        action="store_true",
+        help="solve every day from scratch rather than reading answers cached "
+        "for unchanged inputs and solvers (set by ADVENT_CACHE_DIR, default: "
+        f"{DEFAULT_CACHE_DIR})",
+    )
     subparsers = parser.add_subparsers(help="", dest="action")
 
     solve_subparser = subparsers.add_parser("solve", help="run a solver")
-    solve_subparser.add_argument("day")
-    solve_subparser.add_argument("year", default=default_year)
+    solve_subparser.add_argument("day", type=int)
+    solve_subparser.add_argument("year", type=int, nargs="?", default=default_year)
+
+    bench_subparser = subparsers.add_parser(
+        "bench", help="benchmark the solvers and primitives on scaled inputs"
+    )
+    suite.add_arguments(bench_subparser)
 
     list_subparser = subparsers.add_parser("list", help="list of solvers")
-    list_subparser.add_argument("year", nargs="?", default=default_year)
+    list_subparser.add_argument("year", type=int, nargs="?", default=default_year)
 
     # Dispatch to a solver if requested otherwise print out a list of available
     # solvers.
     args = parser.parse_args()
+    cache = None if args.no_cache else SolverCache.default()
+
+    if args.profile and args.action in ("solve", None):
+        if args.action == "solve":
+            solver_types = [AdventDaySolver.get_solver(args.day, args.year)]
+        else:
+            solver_types = all_solvers()
 
-    if args.action == "solve":
+        profile(solver_types, args.profile_json)
+    elif args.action == "solve":
         # Solve the request day.
-        solve(args.day, args.year)
+        solve(args.day, args.year, cache)
+    elif args.action == "bench":
+        sys.exit(suite.main(args))
     elif args.action == "list":
         # Print a list of available days.
         if args.year is None:
@@ -76,7 +158,7 @@ def main():
         else:
             pretty_print_year(args.year)
     else:
-        solve_all()
+        solve_all(args.jobs, args.threads, args.profile_json, cache)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,461 @@
+#include "bfs.h"
+#include "containers.h"
+#include "grid.h"
+#include "point.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace {
+  /** Which cells can be entered and which neighbours connect to each other. */
+  struct Connectivity {
+    Py_ssize_t x_count;
+    Py_ssize_t y_count;
+    /** Set for every cell that can be entered. */
+    Bitset passable;
+    /** Per cell direction bits, or empty if every side is open. */
+    std::vector<uint8_t> edges;
+
+    Connectivity(Py_ssize_t x_count, Py_ssize_t y_count)
+        : x_count(x_count), y_count(y_count), passable(x_count * y_count) {}
+
+    /** Returns true if a move from `from` to `to` heading `dir` is valid. */
+    bool can_move(Py_ssize_t from, Py_ssize_t to, int dir) const {
+      if (!passable.test(to)) {
+        return false;
+      } else if (edges.empty()) {
+        return true;
+      } else {
+        return ((edges[from] >> dir) & 1) != 0 &&
+               ((edges[to] >> ((dir + 2) & 3)) & 1) != 0;
+      }
+    }
+  };
+
+  /** Check `other` is an integer grid with the same size as `grid`. */
+  bool check_integer_grid_arg(Grid* grid, PyObject* other, const char* name) {
+    auto* other_grid = reinterpret_cast<Grid*>(other);
+
+    if (!Grid_is_integer(other_grid)) {
+      PyErr_Format(
+          PyExc_TypeError, "`%s` grid must have an integer dtype", name);
+      return false;
+    }
+
+    if (other_grid->x_count != grid->x_count ||
+        other_grid->y_count != grid->y_count) {
+      PyErr_Format(
+          PyExc_ValueError, "`%s` grid must be the same size as `grid`", name);
+      return false;
+    }
+
+    return true;
+  }
+
+  /** Build the passable cell set from a `passable` argument. */
+  bool build_passable(
+      OatmealState* st,
+      Grid* grid,
+      PyObject* passable,
+      Connectivity& out) {
+    const auto count = grid->x_count * grid->y_count;
+
+    if (passable == Py_None) {
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        out.passable.set(i);
+      }
+    } else if (PyObject_TypeCheck(passable, st->grid_type) != 0) {
+      if (!check_integer_grid_arg(grid, passable, "passable")) {
+        return false;
+      }
+
+      auto* mask = reinterpret_cast<Grid*>(passable);
+
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        if (Grid_integer_at(mask, i) != 0) {
+          out.passable.set(i);
+        }
+      }
+    } else if (PyUnicode_Check(passable)) {
+      if (grid->cell_type != CellType::Char) {
+        PyErr_SetString(
+            PyExc_TypeError, "a `str` of passable chars needs a char grid");
+        return false;
+      }
+
+      std::array<bool, 256> is_passable{};
+
+      for (Py_ssize_t i = 0; i < PyUnicode_GET_LENGTH(passable); ++i) {
+        const auto c = PyUnicode_READ_CHAR(passable, i);
+
+        if (c < is_passable.size()) {
+          is_passable[c] = true;
+        }
+      }
+
+      const auto* cells = Grid_cells_as<unsigned char>(grid);
+
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        if (is_passable[cells[i]]) {
+          out.passable.set(i);
+        }
+      }
+    } else if (PyCallable_Check(passable)) {
+      // The predicate runs once per cell up front rather than once per edge.
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* value = grid->ops->get(Grid_cell(grid, i));
+        PyObject* result =
+            value != nullptr ? PyObject_CallOneArg(passable, value) : nullptr;
+        Py_XDECREF(value);
+
+        const int truth = result != nullptr ? PyObject_IsTrue(result) : -1;
+        Py_XDECREF(result);
+
+        if (truth < 0) {
+          return false;
+        } else if (truth > 0) {
+          out.passable.set(i);
+        }
+      }
+    } else {
+      PyErr_SetString(
+          PyExc_TypeError,
+          "argument `passable` must be None, a Grid, a str or callable");
+      return false;
+    }
+
+    return true;
+  }
+
+  /** Build the connectivity rules from `passable` and `edges` arguments. */
+  bool build_connectivity(
+      OatmealState* st,
+      Grid* grid,
+      PyObject* passable,
+      PyObject* edges,
+      Connectivity& out) {
+    if (!build_passable(st, grid, passable, out)) {
+      return false;
+    }
+
+    if (edges == Py_None) {
+      return true;
+    } else if (PyObject_TypeCheck(edges, st->grid_type) == 0) {
+      PyErr_SetString(
+          PyExc_TypeError, "argument `edges` must be None or a Grid");
+      return false;
+    } else if (!check_integer_grid_arg(grid, edges, "edges")) {
+      return false;
+    }
+
+    auto* edge_grid = reinterpret_cast<Grid*>(edges);
+    const auto count = grid->x_count * grid->y_count;
+    out.edges.resize(count);
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+      out.edges[i] = static_cast<uint8_t>(Grid_integer_at(edge_grid, i) & 0xF);
+    }
+
+    return true;
+  }
+
+  /**
+   * Convert a `start` argument holding a point or an iterable of points into
+   * cell indices. Impassable starting cells are skipped.
+   */
+  bool parse_starts(
+      OatmealState* st,
+      Grid* grid,
+      PyObject* start,
+      const Connectivity& connectivity,
+      std::vector<Py_ssize_t>& out) {
+    auto add_start = [&](PyObject* obj_pt) {
+      if (PyObject_TypeCheck(obj_pt, st->point_type) == 0) {
+        PyErr_SetString(
+            PyExc_TypeError, "argument `start` must contain `Point` values");
+        return false;
+      }
+
+      const auto* pt = reinterpret_cast<Point*>(obj_pt);
+
+      if (pt->x < 0 || pt->y < 0 || pt->x >= grid->x_count ||
+          pt->y >= grid->y_count) {
+        PyErr_Format(PyExc_ValueError, "start point %R is out of bounds", obj_pt);
+        return false;
+      }
+
+      const auto cell = pt->y * grid->x_count + pt->x;
+
+      if (connectivity.passable.test(cell)) {
+        out.push_back(cell);
+      }
+
+      return true;
+    };
+
+    if (PyObject_TypeCheck(start, st->point_type) != 0) {
+      return add_start(start);
+    }
+
+    PyObject* itr = PyObject_GetIter(start);
+
+    if (itr == nullptr) {
+      return false;
+    }
+
+    bool ok = true;
+    PyObject* item = nullptr;
+
+    while (ok && (item = PyIter_Next(itr)) != nullptr) {
+      ok = add_start(item);
+      Py_DECREF(item);
+    }
+
+    Py_DECREF(itr);
+    return ok && !PyErr_Occurred();
+  }
+
+  /**
+   * Expand every cell in `queue` breadth first, calling `on_reach(from, to)`
+   * the first time each cell is reached.
+   */
+  template <typename OnReach>
+  void breadth_first(
+      const Connectivity& connectivity,
+      RingQueue& queue,
+      Bitset& visited,
+      OnReach&& on_reach) {
+    const auto x_count = connectivity.x_count;
+    const auto y_count = connectivity.y_count;
+
+    while (!queue.empty()) {
+      const auto cell = queue.pop();
+      const auto x = cell % x_count;
+      const auto y = cell / x_count;
+
+      for (int dir = 0; dir < 4; ++dir) {
+        const auto nx = x + kDirectionX[dir];
+        const auto ny = y + kDirectionY[dir];
+
+        if (nx < 0 || ny < 0 || nx >= x_count || ny >= y_count) {
+          continue;
+        }
+
+        const auto neighbor = ny * x_count + nx;
+
+        if (!visited.test(neighbor) &&
+            connectivity.can_move(cell, neighbor, dir)) {
+          visited.set(neighbor);
+          on_reach(cell, neighbor);
+          queue.push(neighbor);
+        }
+      }
+    }
+  }
+
+  /** Arguments shared by the kernels that search from start cells. */
+  struct SearchArgs {
+    OatmealState* st = nullptr;
+    Grid* grid = nullptr;
+    PyObject* start = nullptr;
+    PyObject* passable = Py_None;
+    PyObject* edges = Py_None;
+  };
+
+  /** Shared argument parsing for the kernels taking a `start` argument. */
+  bool parse_search_args(
+      PyObject* module,
+      PyObject* args,
+      PyObject* kwds,
+      SearchArgs& out) {
+    const char* kwlist[] = {"grid", "start", "passable", "edges", nullptr};
+    PyObject* grid_obj = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args,
+            kwds,
+            "OO|OO",
+            const_cast<char**>(kwlist),
+            &grid_obj,
+            &out.start,
+            &out.passable,
+            &out.edges)) {
+      return false;
+    }
+
+    out.st = Oatmeal_state(module);
+
+    if (PyObject_TypeCheck(grid_obj, out.st->grid_type) == 0) {
+      PyErr_SetString(PyExc_TypeError, "argument `grid` must be of type `Grid`");
+      return false;
+    }
+
+    out.grid = reinterpret_cast<Grid*>(grid_obj);
+    return true;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* bfs_distances(PyObject* module, PyObject* args, PyObject* kwds) {
+  SearchArgs search_args;
+
+  if (!parse_search_args(module, args, kwds, search_args)) {
+    return nullptr;
+  }
+
+  auto* st = search_args.st;
+  auto* grid = search_args.grid;
+  Connectivity connectivity(grid->x_count, grid->y_count);
+  std::vector<Py_ssize_t> starts;
+
+  if (!build_connectivity(
+          st, grid, search_args.passable, search_args.edges, connectivity) ||
+      !parse_starts(st, grid, search_args.start, connectivity, starts)) {
+    return nullptr;
+  }
+
+  Grid* distances =
+      Grid_create(st, grid->x_count, grid->y_count, CellType::Int64);
+
+  if (distances != nullptr) {
+    auto* dist = Grid_cells_as<int64_t>(distances);
+    std::fill(dist, dist + grid->x_count * grid->y_count, -1);
+
+    Bitset visited(grid->x_count * grid->y_count);
+    RingQueue queue;
+
+    for (const auto cell : starts) {
+      if (!visited.test(cell)) {
+        visited.set(cell);
+        dist[cell] = 0;
+        queue.push(cell);
+      }
+    }
+
+    // The search only reads connectivity copied out of the arguments and
+    // writes to a grid no other thread can see yet, so it runs without the
+    // GIL. The other kernels below do the same.
+    Py_BEGIN_ALLOW_THREADS;
+    breadth_first(connectivity, queue, visited, [&](auto from, auto to) {
+      dist[to] = dist[from] + 1;
+    });
+    Py_END_ALLOW_THREADS;
+  }
+
+  return reinterpret_cast<PyObject*>(distances);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* flood_fill(PyObject* module, PyObject* args, PyObject* kwds) {
+  SearchArgs search_args;
+
+  if (!parse_search_args(module, args, kwds, search_args)) {
+    return nullptr;
+  }
+
+  auto* st = search_args.st;
+  auto* grid = search_args.grid;
+  Connectivity connectivity(grid->x_count, grid->y_count);
+  std::vector<Py_ssize_t> starts;
+
+  if (!build_connectivity(
+          st, grid, search_args.passable, search_args.edges, connectivity) ||
+      !parse_starts(st, grid, search_args.start, connectivity, starts)) {
+    return nullptr;
+  }
+
+  Grid* filled =
+      Grid_create(st, grid->x_count, grid->y_count, CellType::Int8);
+
+  if (filled != nullptr) {
+    auto* mask = Grid_cells_as<int8_t>(filled);
+    Bitset visited(grid->x_count * grid->y_count);
+    RingQueue queue;
+
+    for (const auto cell : starts) {
+      if (!visited.test(cell)) {
+        visited.set(cell);
+        mask[cell] = 1;
+        queue.push(cell);
+      }
+    }
+
+    Py_BEGIN_ALLOW_THREADS;
+    breadth_first(
+        connectivity, queue, visited, [&](auto, auto to) { mask[to] = 1; });
+    Py_END_ALLOW_THREADS;
+  }
+
+  return reinterpret_cast<PyObject*>(filled);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* label_components(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"grid", "passable", "edges", nullptr};
+
+  PyObject* grid_obj = nullptr;
+  PyObject* passable = Py_None;
+  PyObject* edges = Py_None;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "O|OO",
+          const_cast<char**>(kwlist),
+          &grid_obj,
+          &passable,
+          &edges)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_state(module);
+
+  if (PyObject_TypeCheck(grid_obj, st->grid_type) == 0) {
+    PyErr_SetString(PyExc_TypeError, "argument `grid` must be of type `Grid`");
+    return nullptr;
+  }
+
+  auto* grid = reinterpret_cast<Grid*>(grid_obj);
+  Connectivity connectivity(grid->x_count, grid->y_count);
+
+  if (!build_connectivity(st, grid, passable, edges, connectivity)) {
+    return nullptr;
+  }
+
+  Grid* labels_grid =
+      Grid_create(st, grid->x_count, grid->y_count, CellType::Int32);
+
+  if (labels_grid == nullptr) {
+    return nullptr;
+  }
+
+  // Start a new search from every passable cell that an earlier search did
+  // not reach, and tag everything it reaches with the same label.
+  const auto count = grid->x_count * grid->y_count;
+  auto* labels = Grid_cells_as<int32_t>(labels_grid);
+  Bitset visited(count);
+  RingQueue queue;
+  int32_t label_count = 0;
+
+  Py_BEGIN_ALLOW_THREADS;
+
+  for (Py_ssize_t cell = 0; cell < count; ++cell) {
+    if (visited.test(cell) || !connectivity.passable.test(cell)) {
+      continue;
+    }
+
+    const auto label = ++label_count;
+
+    visited.set(cell);
+    labels[cell] = label;
+    queue.push(cell);
+
+    breadth_first(
+        connectivity, queue, visited, [&](auto, auto to) { labels[to] = label; });
+  }
+
+  Py_END_ALLOW_THREADS;
+
+  return Py_BuildValue("Ni", labels_grid, label_count);
+}
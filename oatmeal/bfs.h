@@ -0,0 +1,55 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/*
+ * Breadth first search kernels over a `Grid`. None of these call back into
+ * Python while searching.
+ *
+ * Every kernel takes the same optional connectivity arguments:
+ *
+ *  `passable`: which cells can be entered. Either `None` for every cell, a
+ *   numeric grid of the same size where non-zero cells are passable, a `str`
+ *   of passable characters for char grids, or a predicate called once per
+ *   cell value before the search starts.
+ *
+ *  `edges`: an optional numeric grid of per cell connection bits, where bit
+ *   `1 << Direction` marks an opening on that side of the cell (east = 0,
+ *   north = 1, west = 2, south = 3). A move is only allowed when both cells
+ *   have an opening facing each other, like connected pipes.
+ */
+
+/**
+ * bfs_distances(
+ *  grid: Grid,
+ *  start: Point | Iterable[Point],
+ *  passable=None,
+ *  edges=None
+ * ) -> Grid[int]
+ *
+ * Returns an int64 grid holding the number of steps from the nearest start
+ * cell to every cell, or -1 for cells that cannot be reached.
+ */
+PyObject* bfs_distances(PyObject* module, PyObject* args, PyObject* kwds);
+
+/**
+ * flood_fill(
+ *  grid: Grid,
+ *  start: Point | Iterable[Point],
+ *  passable=None,
+ *  edges=None
+ * ) -> Grid[int]
+ *
+ * Returns an int8 grid where reachable cells are 1 and all other cells are 0.
+ */
+PyObject* flood_fill(PyObject* module, PyObject* args, PyObject* kwds);
+
+/**
+ * label_components(grid: Grid, passable=None, edges=None)
+ *  -> Tuple[Grid[int], int]
+ *
+ * Labels each connected region of passable cells with a distinct id starting
+ * at 1, and returns an int32 grid of labels (0 for impassable cells) along
+ * with the number of regions found.
+ */
+PyObject* label_components(PyObject* module, PyObject* args, PyObject* kwds);
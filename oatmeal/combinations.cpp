@@ -0,0 +1,265 @@
+#include "combinations.h"
+#include "int_array.h"
+
+#include <new>
+
+//--------------------------------------------------------------------------------------------------
+// CombinationIterator python type definition.
+//--------------------------------------------------------------------------------------------------
+namespace {
+  void CombinationIterator_dealloc(PyObject* obj_self) {
+    auto* self = reinterpret_cast<CombinationIterator*>(obj_self);
+    PyObject_GC_UnTrack(obj_self);
+    Py_XDECREF(self->items);
+    self->indices.~vector();
+    Oatmeal_free(obj_self);
+  }
+
+  int CombinationIterator_traverse(
+      PyObject* obj_self,
+      visitproc visit,
+      void* arg) {
+    Py_VISIT(reinterpret_cast<CombinationIterator*>(obj_self)->items);
+    Py_VISIT(Py_TYPE(obj_self));
+    return 0;
+  }
+
+  /**
+   * Step `indices` to the next combination, or return false after the last.
+   * The rightmost index that can still grow is bumped and every index after
+   * it restarts just above it.
+   */
+  bool next_combination(std::vector<Py_ssize_t>& indices, Py_ssize_t n) {
+    const auto k = static_cast<Py_ssize_t>(indices.size());
+    auto i = k - 1;
+
+    while (i >= 0 && indices[i] == n - k + i) {
+      i--;
+    }
+
+    if (i < 0) {
+      return false;
+    }
+
+    indices[i]++;
+
+    for (auto j = i + 1; j < k; ++j) {
+      indices[j] = indices[j - 1] + 1;
+    }
+
+    return true;
+  }
+
+  /** List or tuple of the items at the current indices. */
+  PyObject* gather_items(CombinationIterator* self) {
+    const auto k = static_cast<Py_ssize_t>(self->indices.size());
+    const bool as_list = self->output == CombinationOutput::List;
+    PyObject* out = as_list ? PyList_New(k) : PyTuple_New(k);
+
+    if (out == nullptr) {
+      return nullptr;
+    }
+
+    for (Py_ssize_t i = 0; i < k; ++i) {
+      PyObject* item = PyTuple_GET_ITEM(self->items, self->indices[i]);
+      Py_INCREF(item);
+
+      if (as_list) {
+        PyList_SET_ITEM(out, i, item);
+      } else {
+        PyTuple_SET_ITEM(out, i, item);
+      }
+    }
+
+    return out;
+  }
+
+  /** Up to `batch` rows of indices, starting at the current combination. */
+  PyObject* gather_batch(CombinationIterator* self) {
+    const auto k = static_cast<Py_ssize_t>(self->indices.size());
+    auto* batch = IntArray_create(Oatmeal_type_state(Py_TYPE(self)), 0);
+
+    if (batch == nullptr) {
+      return nullptr;
+    } else if (!IntArray_reserve(batch, self->batch * k)) {
+      Py_DECREF(batch);
+      return PyErr_NoMemory();
+    }
+
+    for (Py_ssize_t row = 0; row < self->batch && !self->done; ++row) {
+      for (const auto index : self->indices) {
+        batch->values[batch->count++] = index;
+      }
+
+      self->done = !next_combination(self->indices, self->n);
+    }
+
+    return reinterpret_cast<PyObject*>(batch);
+  }
+
+  PyObject* CombinationIterator_next(PyObject* obj_self) {
+    auto* self = reinterpret_cast<CombinationIterator*>(obj_self);
+
+    if (self->done) {
+      return nullptr;
+    } else if (self->output == CombinationOutput::IndexBatch) {
+      return gather_batch(self);
+    }
+
+    PyObject* out = gather_items(self);
+
+    if (out != nullptr) {
+      self->done = !next_combination(self->indices, self->n);
+    }
+
+    return out;
+  }
+
+  /**
+   * Create an iterator over the `k` combinations of `n` indices, which is
+   * empty if `k` is larger than `n`. Takes a new reference to `items`.
+   */
+  PyObject* create_iterator(
+      OatmealState* st,
+      PyObject* items,
+      Py_ssize_t n,
+      Py_ssize_t k,
+      CombinationOutput output,
+      Py_ssize_t batch) {
+    auto* self =
+        PyObject_GC_New(CombinationIterator, st->combination_iterator_type);
+
+    if (self == nullptr) {
+      Py_XDECREF(items);
+      return nullptr;
+    }
+
+    new (&self->indices) std::vector<Py_ssize_t>();
+    self->items = items;
+    self->n = n;
+    self->batch = batch;
+    self->output = output;
+    self->done = k > n;
+
+    if (!self->done) {
+      self->indices.resize(k);
+
+      for (Py_ssize_t i = 0; i < k; ++i) {
+        self->indices[i] = i;
+      }
+    }
+
+    PyObject_GC_Track(self);
+    return reinterpret_cast<PyObject*>(self);
+  }
+
+  /** Snapshot a list argument as a tuple, raising TypeError otherwise. */
+  PyObject* items_tuple(PyObject* items) {
+    if (!PyList_Check(items)) {
+      PyErr_SetString(PyExc_TypeError, "argument `items` must be type `list`");
+      return nullptr;
+    }
+
+    return PyList_AsTuple(items);
+  }
+} // namespace
+
+PyType_Slot CombinationIterator_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(CombinationIterator_dealloc)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Iterator over every k sized combination of items"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(CombinationIterator_traverse)},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(CombinationIterator_next)},
+    {0, nullptr}};
+
+PyType_Spec CombinationIterator_Spec = {
+    .name = "oatmeal.CombinationIterator",
+    .basicsize = sizeof(CombinationIterator),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+             Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = CombinationIterator_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// Combination method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* all_pairs(PyObject* module, PyObject* obj_items) {
+  PyObject* items = items_tuple(obj_items);
+
+  if (items == nullptr) {
+    return nullptr;
+  }
+
+  const auto n = PyTuple_GET_SIZE(items);
+  return create_iterator(
+      Oatmeal_state(module), items, n, 2, CombinationOutput::Tuple, 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* combinations(PyObject* module, PyObject* args) {
+  Py_ssize_t k = 0;
+  PyObject* obj_items = nullptr;
+
+  if (!PyArg_ParseTuple(args, "nO", &k, &obj_items)) {
+    return nullptr;
+  }
+
+  PyObject* items = items_tuple(obj_items);
+
+  if (items == nullptr) {
+    return nullptr;
+  }
+
+  const auto n = PyTuple_GET_SIZE(items);
+
+  if (k < 1) {
+    PyErr_SetString(PyExc_ValueError, "`k` must be larger than zero");
+    Py_DECREF(items);
+    return nullptr;
+  } else if (k > n) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "`k` must be smaller than the length of the items list");
+    Py_DECREF(items);
+    return nullptr;
+  }
+
+  return create_iterator(
+      Oatmeal_state(module), items, n, k, CombinationOutput::List, 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* combination_indices(
+    PyObject* module,
+    PyObject* args,
+    PyObject* kwds) {
+  const char* kwlist[] = {"n", "k", "batch", nullptr};
+  Py_ssize_t n = 0;
+  Py_ssize_t k = 0;
+  Py_ssize_t batch = 65536;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "nn|n", const_cast<char**>(kwlist), &n, &k, &batch)) {
+    return nullptr;
+  }
+
+  if (n < 0 || k < 1) {
+    PyErr_SetString(
+        PyExc_ValueError, "`n` must not be negative and `k` must be positive");
+    return nullptr;
+  } else if (batch < 1 || batch > PY_SSIZE_T_MAX / k) {
+    PyErr_SetString(PyExc_ValueError, "`batch` rows must fit in an IntArray");
+    return nullptr;
+  }
+
+  return create_iterator(
+      Oatmeal_state(module),
+      nullptr,
+      n,
+      k,
+      CombinationOutput::IndexBatch,
+      batch);
+}
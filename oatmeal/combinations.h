@@ -0,0 +1,53 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <vector>
+
+/** What a `CombinationIterator` yields for each step. */
+enum class CombinationOutput { List, Tuple, IndexBatch };
+
+/**
+ * Iterator over every `k` sized combination of `0..n`, stepping the indices
+ * to their lexicographic successor in place rather than recursing. Each
+ * combination is either mapped through `items` into a list or tuple, or many
+ * of them are written as rows of indices into one `IntArray`.
+ */
+typedef struct {
+  PyObject_HEAD PyObject* items;
+  std::vector<Py_ssize_t> indices;
+  Py_ssize_t n;
+  Py_ssize_t batch;
+  CombinationOutput output;
+  bool done;
+} CombinationIterator;
+
+/** Python type spec for `CombinationIterator`. */
+extern PyType_Spec CombinationIterator_Spec;
+
+/**
+ * all_pairs(items: list[T]) -> Iterator[tuple[T, T]]
+ *
+ * Every pair of items, with each pair only yielded once in the order it
+ * appears in `items`.
+ */
+PyObject* all_pairs(PyObject* module, PyObject* items);
+
+/**
+ * combinations(k: int, items: list[T]) -> Iterator[list[T]]
+ *
+ * Every combination of `k` items in lexicographic order of their positions.
+ * Raises ValueError unless `1 <= k <= len(items)`.
+ */
+PyObject* combinations(PyObject* module, PyObject* args);
+
+/**
+ * combination_indices(n: int, k: int, batch: int = 65536)
+ *  -> Iterator[IntArray]
+ *
+ * Every combination of `k` indices from `0` to `n - 1`, written as rows of
+ * `k` values into int64 arrays of up to `batch` rows each. Together the
+ * arrays form the `C(n, k) x k` index table in the same order `combinations`
+ * uses, without creating an object per combination.
+ */
+PyObject* combination_indices(PyObject* module, PyObject* args, PyObject* kwds);
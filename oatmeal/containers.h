@@ -0,0 +1,69 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/** Fixed size set of bits, used for visited markers in grid searches. */
+class Bitset {
+public:
+  explicit Bitset(size_t count) : words_((count + 63) / 64, 0) {}
+
+  /** Returns true if bit `i` is set. */
+  bool test(size_t i) const { return ((words_[i >> 6] >> (i & 63)) & 1) != 0; }
+
+  /** Set bit `i`. */
+  void set(size_t i) { words_[i >> 6] |= uint64_t{1} << (i & 63); }
+
+  /** Clear every bit. */
+  void reset() { std::fill(words_.begin(), words_.end(), 0); }
+
+private:
+  std::vector<uint64_t> words_;
+};
+
+/**
+ * First in first out queue of cell indices stored in a power of two sized ring
+ * buffer that doubles when full, so pops never shift the remaining entries.
+ */
+class RingQueue {
+public:
+  RingQueue() : slots_(64) {}
+
+  /** Returns true if there are no queued entries. */
+  bool empty() const { return head_ == tail_; }
+
+  /** Add `value` to the back of the queue. */
+  void push(Py_ssize_t value) {
+    if (tail_ - head_ == slots_.size()) {
+      grow();
+    }
+
+    slots_[tail_++ & (slots_.size() - 1)] = value;
+  }
+
+  /** Remove and return the entry at the front of the queue. */
+  Py_ssize_t pop() { return slots_[head_++ & (slots_.size() - 1)]; }
+
+  /** Remove every entry. */
+  void clear() { head_ = tail_ = 0; }
+
+private:
+  void grow() {
+    std::vector<Py_ssize_t> bigger(slots_.size() * 2);
+
+    for (size_t i = head_; i < tail_; ++i) {
+      bigger[i - head_] = slots_[i & (slots_.size() - 1)];
+    }
+
+    tail_ -= head_;
+    head_ = 0;
+    slots_.swap(bigger);
+  }
+
+  std::vector<Py_ssize_t> slots_;
+  size_t head_ = 0;
+  size_t tail_ = 0;
+};
@@ -0,0 +1,272 @@
+#include "direction.h"
+#include "grid.h"
+#include "point.h"
+
+//--------------------------------------------------------------------------------------------------
+// Direction python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef Direction_Methods[] = {
+    {"to_point",
+     (PyCFunction)Direction_to_point,
+     METH_NOARGS,
+     "Unit point with the same heading"},
+    {"reverse",
+     (PyCFunction)Direction_reverse,
+     METH_NOARGS,
+     "Direction with the opposite heading"},
+    {"is_diagonal",
+     (PyCFunction)Direction_is_diagonal,
+     METH_NOARGS,
+     "Test if the direction is one of the four diagonals"},
+    {"cardinal_dirs",
+     (PyCFunction)Direction_cardinal_dirs,
+     METH_NOARGS | METH_CLASS,
+     "The four cardinal directions, counter clockwise from east"},
+    {"diagonal_dirs",
+     (PyCFunction)Direction_diagonal_dirs,
+     METH_NOARGS | METH_CLASS,
+     "The four diagonal directions, counter clockwise from north east"},
+    {"from_point",
+     (PyCFunction)Direction_from_point,
+     METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+     "Direction of a unit point"},
+    {"__reduce__",
+     (PyCFunction)Direction_reduce,
+     METH_NOARGS,
+     "pickle the direction by its value"},
+    {nullptr}};
+
+PyGetSetDef Direction_GetSet[] = {
+    {"name",
+     (getter)Direction_get_name,
+     nullptr,
+     "name of the direction",
+     nullptr},
+    {"value",
+     (getter)Direction_get_value,
+     nullptr,
+     "integer value of the direction",
+     nullptr},
+    {nullptr}};
+
+PyType_Slot Direction_Slots[] = {
+    {Py_tp_repr, reinterpret_cast<void*>(Direction_repr)},
+    {Py_tp_str, reinterpret_cast<void*>(Direction_str)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("A cardinal or diagonal heading on a grid"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(Direction_traverse)},
+    {Py_tp_methods, Direction_Methods},
+    {Py_tp_getset, Direction_GetSet},
+    {Py_tp_new, reinterpret_cast<void*>(Direction_new)},
+    {0, nullptr}};
+
+// The members are held by the module state, so directions are tracked by the
+// garbage collector to let it break the cycle through their type and module.
+PyType_Spec Direction_Spec = {
+    .name = "oatmeal.Direction",
+    .basicsize = 0,
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Direction_Slots,
+};
+
+namespace {
+  /** Name of each direction, in `Direction` order. */
+  constexpr const char* kDirectionNames[] = {
+      "East",
+      "North",
+      "West",
+      "South",
+      "NorthEast",
+      "NorthWest",
+      "SouthWest",
+      "SouthEast"};
+
+  /** Opposite of each direction, in `Direction` order. */
+  constexpr int kReverse[] = {2, 3, 0, 1, 6, 7, 4, 5};
+
+  /** Number of cardinal directions, which come before the diagonals. */
+  constexpr int kCardinalCount = 4;
+
+  /** Value of a direction, which is always in range. */
+  int direction_value(PyObject* self) {
+    return static_cast<int>(PyLong_AsLong(self));
+  }
+
+  /** Tuple of the members `[first, first + 4)`. */
+  PyObject* member_tuple(PyObject* cls, int first) {
+    const auto* members =
+        Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(cls))
+            ->direction_members;
+
+    return PyTuple_Pack(
+        4,
+        members[first],
+        members[first + 1],
+        members[first + 2],
+        members[first + 3]);
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// Direction method definitions.
+//--------------------------------------------------------------------------------------------------
+bool Direction_add_members(OatmealState* st) {
+  for (int dir = 0; dir < kDirectionCount; ++dir) {
+    // Go through the `int` constructor, since `Direction_new` only ever hands
+    // out the members being created here.
+    PyObject* args = Py_BuildValue("(i)", dir);
+
+    if (args == nullptr) {
+      return false;
+    }
+
+    st->direction_members[dir] =
+        PyLong_Type.tp_new(st->direction_type, args, nullptr);
+    Py_DECREF(args);
+
+    if (st->direction_members[dir] == nullptr ||
+        PyDict_SetItemString(
+            st->direction_type->tp_dict,
+            kDirectionNames[dir],
+            st->direction_members[dir]) < 0) {
+      return false;
+    }
+  }
+
+  PyType_Modified(st->direction_type);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_member(OatmealState* st, int dir) {
+  return st->direction_members[dir];
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"value", nullptr};
+  PyObject* value = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O", const_cast<char**>(kwlist), &value)) {
+    return nullptr;
+  }
+
+  const long dir = PyLong_Check(value) ? PyLong_AsLong(value) : -1;
+
+  if (dir == -1 && PyErr_Occurred()) {
+    return nullptr;
+  } else if (dir < 0 || dir >= kDirectionCount) {
+    PyErr_Format(PyExc_ValueError, "%R is not a valid Direction", value);
+    return nullptr;
+  }
+
+  PyObject* member = Oatmeal_type_state(type)->direction_members[dir];
+  Py_INCREF(member);
+  return member;
+}
+
+//--------------------------------------------------------------------------------------------------
+int Direction_traverse(PyObject* self, visitproc visit, void* arg) {
+  Py_VISIT(Py_TYPE(self));
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_repr(PyObject* self) {
+  const int dir = direction_value(self);
+  return PyUnicode_FromFormat("<Direction.%s: %d>", kDirectionNames[dir], dir);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_str(PyObject* self) {
+  return PyUnicode_FromString(kDirectionNames[direction_value(self)]);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_get_name(PyObject* self, void*) {
+  return Direction_str(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_get_value(PyObject* self, void*) {
+  return PyLong_FromLong(direction_value(self));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_to_point(PyObject* self, PyObject*) {
+  PyObject* pt =
+      Point_direction(Oatmeal_object_state(self), direction_value(self));
+  Py_INCREF(pt);
+  return pt;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_reverse(PyObject* self, PyObject*) {
+  PyObject* reversed = Direction_member(
+      Oatmeal_object_state(self), kReverse[direction_value(self)]);
+  Py_INCREF(reversed);
+  return reversed;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_is_diagonal(PyObject* self, PyObject*) {
+  return PyBool_FromLong(direction_value(self) >= kCardinalCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_cardinal_dirs(PyObject* cls, PyObject*) {
+  return member_tuple(cls, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_diagonal_dirs(PyObject* cls, PyObject*) {
+  return member_tuple(cls, kCardinalCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_from_point(PyObject* cls, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"pt", "diagonals", nullptr};
+  PyObject* obj_pt = nullptr;
+  int diagonals = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "O|p",
+          const_cast<char**>(kwlist),
+          &obj_pt,
+          &diagonals)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(cls));
+
+  if (PyObject_TypeCheck(obj_pt, st->point_type) == 0) {
+    PyErr_SetString(
+        PyExc_NotImplementedError, "argument `pt` must be type `Point`");
+    return nullptr;
+  }
+
+  const auto* pt = reinterpret_cast<Point*>(obj_pt);
+  const int count = diagonals ? kDirectionCount : kCardinalCount;
+
+  for (int dir = 0; dir < count; ++dir) {
+    if (pt->x == kDirectionX[dir] && pt->y == kDirectionY[dir]) {
+      Py_INCREF(st->direction_members[dir]);
+      return st->direction_members[dir];
+    }
+  }
+
+  PyErr_Format(
+      PyExc_ValueError,
+      "Expected a unit point but got %R when converting to Direction",
+      obj_pt);
+  return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Direction_reduce(PyObject* self, PyObject*) {
+  return Py_BuildValue("O(i)", Py_TYPE(self), direction_value(self));
+}
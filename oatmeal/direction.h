@@ -0,0 +1,82 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/** `dirs` flag for the four cardinal neighbours of a cell. */
+inline constexpr int kCardinalDirs = 1 << 0;
+
+/** `dirs` flag for the four diagonal neighbours of a cell. */
+inline constexpr int kDiagonalDirs = 1 << 1;
+
+/**
+ * Heading on a grid. `Direction` is an `int` subclass whose value indexes
+ * `kDirectionX` and `kDirectionY`, with the cardinal directions `East = 0`,
+ * `North = 1`, `West = 2` and `South = 3` followed by the diagonals
+ * `NorthEast = 4`, `NorthWest = 5`, `SouthWest = 6` and `SouthEast = 7`.
+ * Only these eight instances exist, so `Direction(value)` returns one of them
+ * and directions can be compared with `is`.
+ */
+extern PyType_Spec Direction_Spec;
+
+/**
+ * Create the direction instances of a new module object, and add them to its
+ * type as `Direction.East` and so on. Returns false with an exception set on
+ * failure.
+ */
+bool Direction_add_members(OatmealState* st);
+
+/**
+ * Borrowed reference to the instance for direction `dir`, which is only valid
+ * after `Direction_add_members` succeeded.
+ */
+PyObject* Direction_member(OatmealState* st, int dir);
+
+/** __new__(type, value: int) -> Direction */
+PyObject* Direction_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** GC traversal, which only visits the type. */
+int Direction_traverse(PyObject* self, visitproc visit, void* arg);
+
+/** repr(self) -> str */
+PyObject* Direction_repr(PyObject* self);
+
+/** str(self) -> str */
+PyObject* Direction_str(PyObject* self);
+
+/** name -> str */
+PyObject* Direction_get_name(PyObject* self, void*);
+
+/** value -> int */
+PyObject* Direction_get_value(PyObject* self, void*);
+
+/**
+ * to_point(self) -> FrozenPoint
+ *
+ * Unit point with the same heading. The point is one of the shared constants
+ * such as `Point.EAST`, so it cannot be modified.
+ */
+PyObject* Direction_to_point(PyObject* self, PyObject*);
+
+/** reverse(self) -> Direction */
+PyObject* Direction_reverse(PyObject* self, PyObject*);
+
+/** is_diagonal(self) -> bool */
+PyObject* Direction_is_diagonal(PyObject* self, PyObject*);
+
+/** cardinal_dirs(cls) -> tuple[Direction, ...] */
+PyObject* Direction_cardinal_dirs(PyObject* cls, PyObject*);
+
+/** diagonal_dirs(cls) -> tuple[Direction, ...] */
+PyObject* Direction_diagonal_dirs(PyObject* cls, PyObject*);
+
+/**
+ * from_point(cls, pt: Point, diagonals: bool = False) -> Direction
+ *
+ * Direction of a unit point, which may also be a diagonal one when
+ * `diagonals` is set. Raises ValueError for any other point, and
+ * NotImplementedError if `pt` is not a `Point`.
+ */
+PyObject* Direction_from_point(PyObject* cls, PyObject* args, PyObject* kwds);
+
+/** pickle as `Direction(value)` so unpickling returns the shared instance. */
+PyObject* Direction_reduce(PyObject* self, PyObject*);
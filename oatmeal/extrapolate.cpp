@@ -0,0 +1,195 @@
+#include "extrapolate.h"
+#include "int_array.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+  /** Rows extrapolated by one task when rows are split across threads. */
+  constexpr size_t kRowsPerTask = 4096;
+
+  /** Returned for rows that extrapolated without overflowing. */
+  constexpr size_t kNoOverflow = SIZE_MAX;
+
+  /**
+   * Add `a` and `b` into `out`, returning false if the sum overflows. Wrapping
+   * unsigned arithmetic keeps this free of signed overflow on every compiler.
+   */
+  bool checked_add(int64_t a, int64_t b, int64_t* out) {
+    const auto sum = static_cast<uint64_t>(a) + static_cast<uint64_t>(b);
+    *out = static_cast<int64_t>(sum);
+    return ((static_cast<uint64_t>(a) ^ sum) &
+            (static_cast<uint64_t>(b) ^ sum)) >> 63 == 0;
+  }
+
+  /** Subtract `b` from `a` into `out`, returning false on overflow. */
+  bool checked_sub(int64_t a, int64_t b, int64_t* out) {
+    const auto diff = static_cast<uint64_t>(a) - static_cast<uint64_t>(b);
+    *out = static_cast<int64_t>(diff);
+    return ((static_cast<uint64_t>(a) ^ static_cast<uint64_t>(b)) &
+            (static_cast<uint64_t>(a) ^ diff)) >> 63 == 0;
+  }
+
+  /**
+   * Replace the first `count - 1` values with the differences between each
+   * adjacent pair. Returns false if a difference overflows, and sets
+   * `nonzero` to say whether any difference is not zero.
+   *
+   * The overflow and zero checks are folded into bitwise accumulators rather
+   * than branches so the loop vectorizes.
+   */
+  bool adjacent_differences(int64_t* values, size_t count, bool* nonzero) {
+    uint64_t overflow = 0;
+    uint64_t any = 0;
+
+    for (size_t i = 0; i + 1 < count; ++i) {
+      const auto a = static_cast<uint64_t>(values[i + 1]);
+      const auto b = static_cast<uint64_t>(values[i]);
+      const auto diff = a - b;
+
+      overflow |= (a ^ b) & (a ^ diff);
+      any |= diff;
+      values[i] = static_cast<int64_t>(diff);
+    }
+
+    *nonzero = any != 0;
+    return overflow >> 63 == 0;
+  }
+
+  /**
+   * Extrapolate one row forwards and backwards, using `scratch` for the
+   * difference table. Returns false on overflow.
+   */
+  bool extrapolate(
+      const int64_t* row,
+      size_t count,
+      std::vector<int64_t>& scratch,
+      int64_t* next,
+      int64_t* previous) {
+    scratch.assign(row, row + count);
+
+    // The next value is the sum of the last value on every level, and the
+    // previous value is the alternating sum of the first values.
+    int64_t forward = 0;
+    int64_t backward = 0;
+    bool nonzero = std::any_of(row, row + count, [](auto v) { return v != 0; });
+
+    for (size_t n = count; n > 0 && nonzero; --n) {
+      const bool even = (count - n) % 2 == 0;
+
+      if (!checked_add(forward, scratch[n - 1], &forward) ||
+          !(even ? checked_add(backward, scratch[0], &backward)
+                 : checked_sub(backward, scratch[0], &backward)) ||
+          !adjacent_differences(scratch.data(), n, &nonzero)) {
+        return false;
+      }
+    }
+
+    *next = forward;
+    *previous = backward;
+    return true;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* extrapolate_rows(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"values", "offsets", "threads", nullptr};
+  PyObject* obj_values = nullptr;
+  PyObject* obj_offsets = nullptr;
+  Py_ssize_t threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "OO|n",
+          const_cast<char**>(kwlist),
+          &obj_values,
+          &obj_offsets,
+          &threads)) {
+    return nullptr;
+  }
+
+  Int64Buffer values;
+  Int64Buffer offsets;
+
+  if (!values.open(obj_values, "values", false) ||
+      !offsets.open(obj_offsets, "offsets", false)) {
+    return nullptr;
+  }
+
+  if (offsets.size() == 0) {
+    PyErr_SetString(
+        PyExc_ValueError, "argument `offsets` must hold at least one value");
+    return nullptr;
+  }
+
+  // Check the offsets up front so the workers can trust them.
+  const auto* bounds = offsets.data();
+  const auto row_count = offsets.size() - 1;
+
+  for (size_t i = 0; i < row_count; ++i) {
+    if (bounds[i] < 0 || bounds[i] > bounds[i + 1] ||
+        static_cast<size_t>(bounds[i + 1]) > values.size()) {
+      PyErr_SetString(
+          PyExc_ValueError,
+          "argument `offsets` must be sorted and within `values`");
+      return nullptr;
+    }
+  }
+
+  auto* st = Oatmeal_state(module);
+  auto* next = IntArray_create(st, static_cast<Py_ssize_t>(row_count));
+  auto* previous = IntArray_create(st, static_cast<Py_ssize_t>(row_count));
+
+  if (next == nullptr || previous == nullptr) {
+    Py_XDECREF(next);
+    Py_XDECREF(previous);
+    return nullptr;
+  }
+
+  const auto* in = values.data();
+  const auto task_count = (row_count + kRowsPerTask - 1) / kRowsPerTask;
+  std::vector<size_t> failed(task_count, kNoOverflow);
+
+  Py_BEGIN_ALLOW_THREADS;
+  parallel_for(
+      task_count,
+      worker_count(threads),
+      []() { return std::vector<int64_t>(); },
+      [&](std::vector<int64_t>& scratch, size_t task) {
+        const auto end = std::min(row_count, (task + 1) * kRowsPerTask);
+
+        for (auto row = task * kRowsPerTask; row < end; ++row) {
+          if (!extrapolate(
+                  in + bounds[row],
+                  static_cast<size_t>(bounds[row + 1] - bounds[row]),
+                  scratch,
+                  next->values + row,
+                  previous->values + row)) {
+            failed[task] = row;
+            return;
+          }
+        }
+      });
+  Py_END_ALLOW_THREADS;
+
+  const auto first_failed = std::min_element(failed.begin(), failed.end());
+
+  if (first_failed != failed.end() && *first_failed != kNoOverflow) {
+    PyErr_Format(
+        PyExc_OverflowError,
+        "row %zu does not extrapolate within int64",
+        *first_failed);
+    Py_DECREF(next);
+    Py_DECREF(previous);
+    return nullptr;
+  }
+
+  PyObject* result = PyTuple_Pack(2, next, previous);
+  Py_DECREF(next);
+  Py_DECREF(previous);
+
+  return result;
+}
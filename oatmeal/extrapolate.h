@@ -0,0 +1,20 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * extrapolate_rows(
+ *  values: Buffer,
+ *  offsets: Buffer,
+ *  threads: int = 0,
+ * ) -> Tuple[IntArray, IntArray]
+ *
+ * Extrapolate every row of a ragged int64 array, laid out as returned by
+ * `parse_int_rows`, one value forwards and one value backwards. Each row is
+ * reduced to a table of adjacent differences until a level is all zeros, and
+ * the result is `(next, previous)` with one value per row. Rows are split
+ * across `threads` worker threads without holding the GIL, where zero picks
+ * one thread per core, and OverflowError is raised if any difference or
+ * extrapolated value does not fit in an int64.
+ */
+PyObject* extrapolate_rows(PyObject* module, PyObject* args, PyObject* kwds);
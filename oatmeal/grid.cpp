@@ -0,0 +1,1710 @@
+#include "grid.h"
+#include "direction.h"
+#include "point.h"
+#include "shared_buffer.h"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <structmember.h>
+
+namespace {
+  //------------------------------------------------------------------------------------------------
+  // Cell conversion traits.
+  //------------------------------------------------------------------------------------------------
+  /** Converts between a native cell value of type `T` and Python objects. */
+  template <typename T> struct CellTraits;
+
+  template <> struct CellTraits<PyObject*> {
+    static constexpr const char* name = "object";
+    static constexpr const char* format = "O";
+
+    static PyObject* get(PyObject* const& cell) {
+      // Cells that were never assigned (eg a factory raised part way through
+      // filling the grid) read back as `None`.
+      PyObject* value = cell != nullptr ? cell : Py_None;
+      Py_INCREF(value);
+      return value;
+    }
+
+    static int set(PyObject*& cell, PyObject* value) {
+      Py_INCREF(value);
+      Py_XSETREF(cell, value);
+      return 0;
+    }
+
+    static void clear(PyObject*& cell) { Py_CLEAR(cell); }
+  };
+
+  /** Shared conversion rules for all of the integer cell types. */
+  template <typename I> struct IntCellTraits {
+    static PyObject* get(const I& cell) { return PyLong_FromLongLong(cell); }
+
+    static int set(I& cell, PyObject* value) {
+      if (!PyLong_Check(value)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "grid cell value must be an int but was `%s`",
+            Py_TYPE(value)->tp_name);
+        return -1;
+      }
+
+      int overflow = 0;
+      const auto v = PyLong_AsLongLongAndOverflow(value, &overflow);
+
+      if (v == -1 && PyErr_Occurred()) {
+        return -1;
+      }
+
+      if (overflow != 0 || v < std::numeric_limits<I>::min() ||
+          v > std::numeric_limits<I>::max()) {
+        PyErr_Format(
+            PyExc_OverflowError, "value %R does not fit in the cell type", value);
+        return -1;
+      }
+
+      cell = static_cast<I>(v);
+      return 0;
+    }
+
+    static void clear(I&) {}
+  };
+
+  template <> struct CellTraits<int8_t> : IntCellTraits<int8_t> {
+    static constexpr const char* name = "int8";
+    static constexpr const char* format = "b";
+  };
+
+  template <> struct CellTraits<int32_t> : IntCellTraits<int32_t> {
+    static constexpr const char* name = "int32";
+    static constexpr const char* format = "i";
+  };
+
+  template <> struct CellTraits<int64_t> : IntCellTraits<int64_t> {
+    static constexpr const char* name = "int64";
+    static constexpr const char* format = "q";
+  };
+
+  /** Single byte character cells that read and write as 1 character `str`. */
+  template <> struct CellTraits<char> {
+    static constexpr const char* name = "char";
+    static constexpr const char* format = "c";
+
+    static PyObject* get(const char& cell) {
+      return PyUnicode_FromOrdinal(static_cast<unsigned char>(cell));
+    }
+
+    static int set(char& cell, PyObject* value) {
+      if (!PyUnicode_Check(value) || PyUnicode_GetLength(value) != 1 ||
+          PyUnicode_ReadChar(value, 0) > 0xFF) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "char grid cell value must be a single latin-1 character but was "
+            "%R",
+            value);
+        return -1;
+      }
+
+      cell = static_cast<char>(PyUnicode_ReadChar(value, 0));
+      return 0;
+    }
+
+    static void clear(char&) {}
+  };
+
+  /** Generate the type erased `CellOps` table entry for cell type `T`. */
+  template <typename T> constexpr CellOps make_cell_ops() {
+    return CellOps{
+        .name = CellTraits<T>::name,
+        .format = CellTraits<T>::format,
+        .item_size = sizeof(T),
+        .get = [](const char* cell) -> PyObject* {
+          return CellTraits<T>::get(*reinterpret_cast<const T*>(cell));
+        },
+        .set = [](char* cell, PyObject* value) -> int {
+          return CellTraits<T>::set(*reinterpret_cast<T*>(cell), value);
+        },
+        .clear =
+            [](char* cell) {
+              CellTraits<T>::clear(*reinterpret_cast<T*>(cell));
+            },
+    };
+  }
+
+  /** Cell operations indexed by `CellType`. */
+  constexpr CellOps kCellOps[] = {
+      make_cell_ops<PyObject*>(),
+      make_cell_ops<int8_t>(),
+      make_cell_ops<int32_t>(),
+      make_cell_ops<int64_t>(),
+      make_cell_ops<char>(),
+  };
+
+  /** State of the module that defined the grid's type. */
+  OatmealState* grid_state(Grid* self) {
+    return Oatmeal_object_state(reinterpret_cast<PyObject*>(self));
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // Cell value sources.
+  //------------------------------------------------------------------------------------------------
+  /** Returns true if values of this type never need to be deep copied. */
+  bool is_immutable_value(PyObject* value) {
+    return value == Py_None || PyLong_CheckExact(value) ||
+           PyBool_Check(value) || PyFloat_CheckExact(value) ||
+           PyUnicode_CheckExact(value) || PyBytes_CheckExact(value);
+  }
+
+  /**
+   * Produces values for new cells from either a list of values, a factory
+   * callable or a single value that is deep copied into each cell.
+   */
+  class CellSource {
+  public:
+    /**
+     * Create a source that reads from `source`. When `source` is a list and
+     * `row_width` is non-zero the list is treated as a list of rows. Copies
+     * are made with the `copy.deepcopy` cached in the module state `st`.
+     */
+    CellSource(
+        OatmealState* st,
+        PyObject* source,
+        Py_ssize_t row_width,
+        bool copy_values)
+        : st_(st),
+          source_(source),
+          row_width_(row_width),
+          is_list_(PyList_Check(source)),
+          is_callable_(!is_list_ && PyCallable_Check(source)),
+          copy_values_(copy_values && !is_immutable_value(source)) {}
+
+    /** Returns a new reference to the value for the i'th new cell. */
+    PyObject* value_at(Py_ssize_t i) {
+      if (is_list_) {
+        PyObject* value = nullptr;
+
+        if (row_width_ > 0) {
+          value = PyList_GET_ITEM(
+              PyList_GET_ITEM(source_, i / row_width_), i % row_width_);
+        } else {
+          value = PyList_GET_ITEM(source_, i);
+        }
+
+        Py_INCREF(value);
+        return value;
+      } else if (is_callable_) {
+        return PyObject_CallNoArgs(source_);
+      } else if (copy_values_) {
+        return deep_copy(source_);
+      } else {
+        Py_INCREF(source_);
+        return source_;
+      }
+    }
+
+    /**
+     * Convert `count` values from this source into `dest` cells, which must
+     * be zeroed. Returns -1 and releases any converted cells on error.
+     */
+    int fill(const CellOps* ops, char* dest, Py_ssize_t count) {
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* value = value_at(i);
+
+        if (value == nullptr || ops->set(dest + i * ops->item_size, value) < 0) {
+          Py_XDECREF(value);
+
+          for (Py_ssize_t j = 0; j < i; ++j) {
+            ops->clear(dest + j * ops->item_size);
+          }
+
+          return -1;
+        }
+
+        Py_DECREF(value);
+      }
+
+      return 0;
+    }
+
+  private:
+    PyObject* deep_copy(PyObject* value) {
+      if (st_->deepcopy_func == nullptr) {
+        PyObject* copy_module = PyImport_ImportModule("copy");
+
+        if (copy_module == nullptr) {
+          return nullptr;
+        }
+
+        st_->deepcopy_func = PyObject_GetAttrString(copy_module, "deepcopy");
+        Py_DECREF(copy_module);
+
+        if (st_->deepcopy_func == nullptr) {
+          return nullptr;
+        }
+      }
+
+      return PyObject_CallOneArg(st_->deepcopy_func, value);
+    }
+
+    OatmealState* st_;
+    PyObject* source_;
+    Py_ssize_t row_width_;
+    bool is_list_;
+    bool is_callable_;
+    bool copy_values_;
+  };
+
+  //------------------------------------------------------------------------------------------------
+  // Helpers.
+  //------------------------------------------------------------------------------------------------
+  /**
+   * Convert a `Point` argument to a cell index. Sets a `TypeError` or
+   * `IndexError` and returns false if the argument is not a valid position.
+   */
+  bool cell_index_from_point(Grid* self, PyObject* obj_pt, Py_ssize_t* out) {
+    if (PyObject_TypeCheck(obj_pt, grid_state(self)->point_type) == 0) {
+      PyErr_SetString(PyExc_TypeError, "argument `pt` must be type `Point`");
+      return false;
+    }
+
+    const auto* pt = reinterpret_cast<Point*>(obj_pt);
+
+    if (pt->x < 0 || pt->y < 0 || pt->x >= self->x_count ||
+        pt->y >= self->y_count) {
+      PyErr_Format(
+          PyExc_IndexError,
+          "Point out of bounds; x: 0<=%ld<%zd, y: 0<=%ld<%zd",
+          pt->x,
+          self->x_count,
+          pt->y,
+          self->y_count);
+      return false;
+    }
+
+    *out = pt->y * self->x_count + pt->x;
+    return true;
+  }
+
+  /**
+   * Swap in new cell storage, freeing the old storage or releasing the buffer
+   * it was shared with. Any object references must already have moved.
+   */
+  void replace_cells(Grid* self, char* cells) {
+    SharedBuffer_free(self->base, self->cells);
+    self->base = nullptr;
+    self->cells = cells;
+  }
+
+  /** Release every cell in the grid along with the cell storage. */
+  void free_cells(Grid* self) {
+    if (self->cells != nullptr) {
+      Grid_clear(reinterpret_cast<PyObject*>(self));
+      replace_cells(self, nullptr);
+    }
+  }
+
+  /**
+   * Returns true if the grid's cell storage can be reallocated, otherwise sets
+   * a `BufferError` because a buffer consumer still points at the cells.
+   */
+  bool check_resizable(Grid* self) {
+    if (self->exports > 0) {
+      PyErr_SetString(
+          PyExc_BufferError,
+          "cannot resize a grid while its cells are exported as a buffer");
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Parse the `(at_index: int, value)` fast call arguments shared by
+   * `insert_row` and `insert_col`, returning false with an exception set.
+   */
+  bool parse_insert_args(
+      const char* method,
+      PyObject* const* args,
+      Py_ssize_t nargs,
+      Py_ssize_t* at_index,
+      PyObject** value) {
+    if (nargs != 2) {
+      PyErr_Format(
+          PyExc_TypeError,
+          "%s() takes exactly 2 arguments (%zd given)",
+          method,
+          nargs);
+      return false;
+    }
+
+    *at_index = PyNumber_AsSsize_t(args[0], PyExc_OverflowError);
+
+    if (*at_index == -1 && PyErr_Occurred()) {
+      return false;
+    }
+
+    *value = args[1];
+    return true;
+  }
+
+  /**
+   * Parse an integer argument named `name` into `out`, and verify it lies in
+   * `[0, count)`. Sets a `TypeError` or `ValueError` and returns false if not.
+   */
+  bool parse_axis_index(
+      PyObject* obj_index,
+      const char* name,
+      const char* axis,
+      Py_ssize_t count,
+      Py_ssize_t* out) {
+    if (!PyLong_Check(obj_index)) {
+      PyErr_Format(PyExc_TypeError, "argument `%s` must be type `int`", name);
+      return false;
+    }
+
+    const auto index = PyLong_AsSsize_t(obj_index);
+
+    if (index == -1 && PyErr_Occurred()) {
+      return false;
+    }
+
+    if (index < 0 || index >= count) {
+      PyErr_Format(PyExc_ValueError, "%s %zd is out of bounds", axis, index);
+      return false;
+    }
+
+    *out = index;
+    return true;
+  }
+
+  /**
+   * Fill in a buffer request for `ndim` dimensions of grid cells starting at
+   * `buf`. The `shape` and `strides` arrays must outlive the export.
+   */
+  int fill_cell_buffer(
+      PyObject* exporter,
+      Grid* grid,
+      Py_buffer* view,
+      int flags,
+      char* buf,
+      int ndim,
+      Py_ssize_t* shape,
+      Py_ssize_t* strides) {
+    const auto* ops = grid->ops;
+
+    if (grid->cell_type == CellType::Object) {
+      PyErr_SetString(
+          PyExc_BufferError, "object grids do not support the buffer protocol");
+      view->obj = nullptr;
+      return -1;
+    }
+
+    // Work out which memory layouts the cells satisfy so requests that need
+    // contiguous memory can be refused for strided views like columns.
+    Py_ssize_t count = 1;
+    bool c_contiguous = true;
+    bool f_contiguous = true;
+
+    for (int i = 0; i < ndim; ++i) {
+      count *= shape[i];
+    }
+
+    if (ndim == 1) {
+      c_contiguous = f_contiguous = strides[0] == ops->item_size;
+    } else {
+      f_contiguous = shape[0] == 1 || shape[1] == 1;
+    }
+
+    const bool wants_strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES;
+
+    if ((!wants_strides && !c_contiguous) ||
+        ((flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS && !c_contiguous) ||
+        ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS && !f_contiguous) ||
+        ((flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS &&
+         !c_contiguous && !f_contiguous)) {
+      PyErr_SetString(PyExc_BufferError, "grid cells are not contiguous");
+      view->obj = nullptr;
+      return -1;
+    }
+
+    Py_INCREF(exporter);
+    view->obj = exporter;
+    view->buf = buf;
+    view->len = count * ops->item_size;
+    view->itemsize = ops->item_size;
+    view->readonly = 0;
+    // Without a shape, consumers treat the buffer as `len / itemsize` items.
+    view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? ndim : 1;
+    view->format =
+        (flags & PyBUF_FORMAT) != 0 ? const_cast<char*>(ops->format) : nullptr;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? shape : nullptr;
+    view->strides = wants_strides ? strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+
+    return 0;
+  }
+
+  /** Create a memoryview over `length` cells starting at `offset`. */
+  PyObject* create_view(
+      Grid* grid,
+      Py_ssize_t offset,
+      Py_ssize_t length,
+      Py_ssize_t stride);
+
+  /** Create an iterator over `count` cells starting at `index`. */
+  PyObject* create_cell_iterator(
+      Grid* grid,
+      Py_ssize_t index,
+      Py_ssize_t stride,
+      Py_ssize_t count);
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// Grid iterator python type definitions.
+//--------------------------------------------------------------------------------------------------
+/** Iterator over a strided run of cells, used for rows, columns and `iter`. */
+typedef struct {
+  PyObject_HEAD Grid* grid;
+  Py_ssize_t index;
+  Py_ssize_t stride;
+  Py_ssize_t remaining;
+} GridCellIterator;
+
+/** Iterator yielding a `GridCellIterator` for each row in a grid. */
+typedef struct {
+  PyObject_HEAD Grid* grid;
+  Py_ssize_t row;
+} GridRowsIterator;
+
+/** Iterator yielding `(Direction, Point)` for each neighbour of a cell. */
+typedef struct {
+  PyObject_HEAD Grid* grid;
+  long x;
+  long y;
+  int dir;
+  int dirs;
+} GridNeighborIterator;
+
+namespace {
+  void GridCellIterator_dealloc(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridCellIterator*>(obj_self);
+    PyObject_GC_UnTrack(obj_self);
+    Py_XDECREF(self->grid);
+    Oatmeal_free(obj_self);
+  }
+
+  int GridCellIterator_traverse(PyObject* obj_self, visitproc visit, void* arg) {
+    Py_VISIT(Py_TYPE(obj_self));
+    Py_VISIT(reinterpret_cast<GridCellIterator*>(obj_self)->grid);
+    return 0;
+  }
+
+  PyObject* GridCellIterator_next(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridCellIterator*>(obj_self);
+    auto* grid = self->grid;
+
+    // Stop early if the grid shrank or was reshaped underneath the iterator.
+    if (self->remaining <= 0 ||
+        self->index >= grid->x_count * grid->y_count) {
+      return nullptr;
+    }
+
+    PyObject* value = grid->ops->get(Grid_cell(grid, self->index));
+    self->index += self->stride;
+    self->remaining--;
+
+    return value;
+  }
+
+  PyObject* GridCellIterator_length_hint(PyObject* obj_self, PyObject*) {
+    auto* self = reinterpret_cast<GridCellIterator*>(obj_self);
+    return PyLong_FromSsize_t(self->remaining);
+  }
+
+  PyMethodDef GridCellIterator_Methods[] = {
+      {"__length_hint__",
+       (PyCFunction)GridCellIterator_length_hint,
+       METH_NOARGS,
+       "Number of cells remaining"},
+      {nullptr}};
+
+  void GridRowsIterator_dealloc(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridRowsIterator*>(obj_self);
+    PyObject_GC_UnTrack(obj_self);
+    Py_XDECREF(self->grid);
+    Oatmeal_free(obj_self);
+  }
+
+  int GridRowsIterator_traverse(PyObject* obj_self, visitproc visit, void* arg) {
+    Py_VISIT(Py_TYPE(obj_self));
+    Py_VISIT(reinterpret_cast<GridRowsIterator*>(obj_self)->grid);
+    return 0;
+  }
+
+  PyObject* GridRowsIterator_next(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridRowsIterator*>(obj_self);
+    auto* grid = self->grid;
+
+    if (self->row >= grid->y_count) {
+      return nullptr;
+    }
+
+    const auto row = self->row++;
+    return create_cell_iterator(grid, row * grid->x_count, 1, grid->x_count);
+  }
+
+  void GridNeighborIterator_dealloc(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridNeighborIterator*>(obj_self);
+    PyObject_GC_UnTrack(obj_self);
+    Py_XDECREF(self->grid);
+    Oatmeal_free(obj_self);
+  }
+
+  int GridNeighborIterator_traverse(
+      PyObject* obj_self,
+      visitproc visit,
+      void* arg) {
+    Py_VISIT(Py_TYPE(obj_self));
+    Py_VISIT(reinterpret_cast<GridNeighborIterator*>(obj_self)->grid);
+    return 0;
+  }
+
+  PyObject* GridNeighborIterator_next(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridNeighborIterator*>(obj_self);
+    const auto* grid = self->grid;
+
+    // Bounds are read on every step so a resized grid is never overrun.
+    for (; self->dir < kDirectionCount; ++self->dir) {
+      const int group = self->dir < 4 ? kCardinalDirs : kDiagonalDirs;
+      const auto x = self->x + kDirectionX[self->dir];
+      const auto y = self->y + kDirectionY[self->dir];
+
+      if ((self->dirs & group) == 0 || x < 0 || y < 0 ||
+          x >= grid->x_count || y >= grid->y_count) {
+        continue;
+      }
+
+      auto* st = Oatmeal_object_state(obj_self);
+      PyObject* pt = Point_create(st, x, y);
+
+      if (pt == nullptr) {
+        return nullptr;
+      }
+
+      PyObject* dir = Direction_member(st, self->dir++);
+      Py_INCREF(dir);
+
+      PyObject* pair = PyTuple_New(2);
+
+      if (pair == nullptr) {
+        Py_DECREF(dir);
+        Py_DECREF(pt);
+        return nullptr;
+      }
+
+      PyTuple_SET_ITEM(pair, 0, dir);
+      PyTuple_SET_ITEM(pair, 1, pt);
+      return pair;
+    }
+
+    return nullptr;
+  }
+} // namespace
+
+PyType_Slot GridCellIterator_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(GridCellIterator_dealloc)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Iterator over a row, column or all cells of a grid"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(GridCellIterator_traverse)},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(GridCellIterator_next)},
+    {Py_tp_methods, GridCellIterator_Methods},
+    {0, nullptr}};
+
+PyType_Spec GridCellIterator_Spec = {
+    .name = "oatmeal.GridCellIterator",
+    .basicsize = sizeof(GridCellIterator),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+             Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = GridCellIterator_Slots,
+};
+
+PyType_Slot GridRowsIterator_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(GridRowsIterator_dealloc)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("Iterator over each row of a grid"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(GridRowsIterator_traverse)},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(GridRowsIterator_next)},
+    {0, nullptr}};
+
+PyType_Spec GridRowsIterator_Spec = {
+    .name = "oatmeal.GridRowsIterator",
+    .basicsize = sizeof(GridRowsIterator),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+             Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = GridRowsIterator_Slots,
+};
+
+PyType_Slot GridNeighborIterator_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(GridNeighborIterator_dealloc)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Iterator over the in bounds neighbours of a cell"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(GridNeighborIterator_traverse)},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(GridNeighborIterator_next)},
+    {0, nullptr}};
+
+PyType_Spec GridNeighborIterator_Spec = {
+    .name = "oatmeal.GridNeighborIterator",
+    .basicsize = sizeof(GridNeighborIterator),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+             Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = GridNeighborIterator_Slots,
+};
+
+namespace {
+  PyObject* create_cell_iterator(
+      Grid* grid,
+      Py_ssize_t index,
+      Py_ssize_t stride,
+      Py_ssize_t count) {
+    auto* itr = PyObject_GC_New(
+        GridCellIterator, grid_state(grid)->grid_cell_iterator_type);
+
+    if (itr == nullptr) {
+      return nullptr;
+    }
+
+    Py_INCREF(grid);
+    itr->grid = grid;
+    itr->index = index;
+    itr->stride = stride;
+    itr->remaining = count;
+
+    PyObject_GC_Track(itr);
+    return reinterpret_cast<PyObject*>(itr);
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// Grid view python type definition.
+//--------------------------------------------------------------------------------------------------
+namespace {
+  void GridView_dealloc(PyObject* obj_self) {
+    auto* self = reinterpret_cast<GridView*>(obj_self);
+
+    if (self->grid != nullptr) {
+      self->grid->exports--;
+      Py_DECREF(self->grid);
+    }
+
+    Oatmeal_free(obj_self);
+  }
+
+  int GridView_getbuffer(PyObject* obj_self, Py_buffer* view, int flags) {
+    auto* self = reinterpret_cast<GridView*>(obj_self);
+    auto* grid = self->grid;
+
+    // The view holds its own export on the grid, so there is nothing to track
+    // per consumer.
+    return fill_cell_buffer(
+        obj_self,
+        grid,
+        view,
+        flags,
+        Grid_cell(grid, self->offset),
+        1,
+        &self->length,
+        &self->stride);
+  }
+} // namespace
+
+PyType_Slot GridView_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(GridView_dealloc)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(GridView_getbuffer)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Buffer exporter for a row or column of a grid"))},
+    {0, nullptr}};
+
+PyType_Spec GridView_Spec = {
+    .name = "oatmeal.GridView",
+    .basicsize = sizeof(GridView),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE |
+             Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = GridView_Slots,
+};
+
+namespace {
+  PyObject* create_view(
+      Grid* grid,
+      Py_ssize_t offset,
+      Py_ssize_t length,
+      Py_ssize_t stride) {
+    if (grid->cell_type == CellType::Object) {
+      PyErr_SetString(
+          PyExc_BufferError, "object grids do not support the buffer protocol");
+      return nullptr;
+    }
+
+    auto* view = PyObject_New(GridView, grid_state(grid)->grid_view_type);
+
+    if (view == nullptr) {
+      return nullptr;
+    }
+
+    Py_INCREF(grid);
+    grid->exports++;
+
+    // Views are exported in bytes so the stride is scaled by the cell size.
+    view->grid = grid;
+    view->offset = offset;
+    view->length = length;
+    view->stride = stride * grid->ops->item_size;
+
+    PyObject* memory_view = PyMemoryView_FromObject(
+        reinterpret_cast<PyObject*>(view));
+    Py_DECREF(view);
+
+    return memory_view;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// Grid python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMemberDef Grid_Members[] = {
+    {"x_count",
+     T_PYSSIZET,
+     offsetof(Grid, x_count),
+     READONLY,
+     "number of columns"},
+    {"y_count", T_PYSSIZET, offsetof(Grid, y_count), READONLY, "number of rows"},
+    {nullptr}};
+
+PyGetSetDef Grid_GetSet[] = {
+    {"cells",
+     (getter)Grid_get_cells,
+     nullptr,
+     "list of all cells in row major order",
+     nullptr},
+    {"dtype", (getter)Grid_get_dtype, nullptr, "cell storage type", nullptr},
+    {nullptr}};
+
+PyMethodDef Grid_Methods[] = {
+    {"from_lines",
+     (PyCFunction)Grid_from_lines,
+     METH_O | METH_CLASS,
+     "Create a char grid from a list of equal length strings"},
+    {"from_buffer",
+     (PyCFunction)Grid_from_buffer,
+     METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+     "Create a numeric or char grid over the row major cells in a buffer"},
+    {"__reduce_ex__",
+     (PyCFunction)Grid_reduce_ex,
+     METH_O,
+     "pickle the cells as one buffer, out of band for protocol 5"},
+    {"check_in_bounds",
+     (PyCFunction)Grid_check_in_bounds,
+     METH_O,
+     "Test if a point is a valid cell position"},
+    {"neighbors",
+     (PyCFunction)Grid_neighbors,
+     METH_VARARGS | METH_KEYWORDS,
+     "Returns an iterator over the in bounds neighbours of a cell"},
+    {"col",
+     (PyCFunction)Grid_col,
+     METH_O,
+     "Returns an iterator across all the cells in column `x_col`"},
+    {"row",
+     (PyCFunction)Grid_row,
+     METH_O,
+     "Returns an iterator across all the cells in row `y_row`"},
+    {"rows",
+     (PyCFunction)Grid_rows,
+     METH_NOARGS,
+     "Returns an iterator that yields each row in the grid"},
+    {"row_view",
+     (PyCFunction)Grid_row_view,
+     METH_O,
+     "Returns a writable memoryview over the cells in row `y_row`"},
+    {"col_view",
+     (PyCFunction)Grid_col_view,
+     METH_O,
+     "Returns a writable strided memoryview over the cells in col `x_col`"},
+    {"row_count",
+     (PyCFunction)Grid_row_count,
+     METH_NOARGS,
+     "Returns the number of rows in the grid"},
+    {"col_count",
+     (PyCFunction)Grid_col_count,
+     METH_NOARGS,
+     "Returns the number of cols in the grid"},
+    {"insert_row",
+     (PyCFunction)Grid_insert_row,
+     METH_FASTCALL,
+     "Inserts `row` before the grid row `at_index`"},
+    {"insert_col",
+     (PyCFunction)Grid_insert_col,
+     METH_FASTCALL,
+     "Inserts `col` before the grid col `at_index`"},
+    {"__class_getitem__",
+     (PyCFunction)Py_GenericAlias,
+     METH_O | METH_CLASS,
+     "Support `Grid[T]` type annotations"},
+    {nullptr}};
+
+PyType_Slot Grid_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(Grid_dealloc)},
+    {Py_sq_contains, reinterpret_cast<void*>(Grid_contains)},
+    {Py_mp_length, reinterpret_cast<void*>(Grid_len)},
+    {Py_mp_subscript, reinterpret_cast<void*>(Grid_get)},
+    {Py_mp_ass_subscript, reinterpret_cast<void*>(Grid_set)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_tp_str, reinterpret_cast<void*>(Grid_str)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(Grid_getbuffer)},
+    {Py_bf_releasebuffer, reinterpret_cast<void*>(Grid_releasebuffer)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("2d grid of cells stored in row major order"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(Grid_traverse)},
+    {Py_tp_clear, reinterpret_cast<void*>(Grid_clear)},
+    {Py_tp_iter, reinterpret_cast<void*>(Grid_iter)},
+    {Py_tp_methods, Grid_Methods},
+    {Py_tp_members, Grid_Members},
+    {Py_tp_getset, Grid_GetSet},
+    {Py_tp_init, reinterpret_cast<void*>(Grid_init)},
+    {Py_tp_new, reinterpret_cast<void*>(Grid_new)},
+    {0, nullptr}};
+
+PyType_Spec Grid_Spec = {
+    .name = "oatmeal.Grid",
+    .basicsize = sizeof(Grid),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Grid_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// Grid method definitions.
+//--------------------------------------------------------------------------------------------------
+const CellOps* CellOps_for(CellType cell_type) {
+  return &kCellOps[static_cast<int>(cell_type)];
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CellType_from_name(const char* name, CellType* out) {
+  for (size_t i = 0; i < std::size(kCellOps); ++i) {
+    if (std::strcmp(kCellOps[i].name, name) == 0) {
+      *out = static_cast<CellType>(i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+Grid* Grid_create(
+    OatmealState* st,
+    Py_ssize_t x_count,
+    Py_ssize_t y_count,
+    CellType cell_type) {
+  // Numeric and char grids are zero filled when no initial value is given,
+  // and object grids are filled with `None`.
+  return reinterpret_cast<Grid*>(PyObject_CallFunction(
+      reinterpret_cast<PyObject*>(st->grid_type),
+      "nnOs",
+      x_count,
+      y_count,
+      Py_None,
+      CellOps_for(cell_type)->name));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<Grid*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    self->cell_type = CellType::Object;
+    self->ops = CellOps_for(CellType::Object);
+    self->x_count = 0;
+    self->y_count = 0;
+    self->cells = nullptr;
+    self->base = nullptr;
+    self->exports = 0;
+    Oatmeal_type_state(type)->alloc_stats.grids_created++;
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int Grid_init(Grid* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"x_count", "y_count", "initial", "dtype", nullptr};
+
+  Py_ssize_t x_count = 0;
+  Py_ssize_t y_count = 0;
+  PyObject* initial = Py_None;
+  const char* dtype = "object";
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "nn|Os",
+          const_cast<char**>(kwlist),
+          &x_count,
+          &y_count,
+          &initial,
+          &dtype)) {
+    return -1;
+  }
+
+  if (!check_resizable(self)) {
+    return -1;
+  }
+
+  if (x_count < 1) {
+    PyErr_SetString(
+        PyExc_ValueError, "Column count `x_count` must be larger than zero");
+    return -1;
+  }
+
+  if (y_count < 1) {
+    PyErr_SetString(
+        PyExc_ValueError, "Row count `y_count` must be larger than zero");
+    return -1;
+  }
+
+  CellType cell_type = CellType::Object;
+
+  if (!CellType_from_name(dtype, &cell_type)) {
+    PyErr_Format(PyExc_ValueError, "unknown grid dtype `%s`", dtype);
+    return -1;
+  }
+
+  // Numeric grids default to zero filled cells rather than `None`.
+  const bool zero_fill = initial == Py_None && cell_type != CellType::Object;
+
+  if (PyList_Check(initial)) {
+    if (PyList_GET_SIZE(initial) != y_count) {
+      PyErr_SetString(
+          PyExc_ValueError, "Grid initial rows list len must equal `y_count`");
+      return -1;
+    }
+
+    // Verify all rows are lists of cells and of uniform size.
+    for (Py_ssize_t y = 0; y < y_count; ++y) {
+      PyObject* row = PyList_GET_ITEM(initial, y);
+
+      if (!PyList_Check(row)) {
+        PyErr_SetString(
+            PyExc_TypeError,
+            "Grid initial rows must all be lists of column value");
+        return -1;
+      }
+
+      if (PyList_GET_SIZE(row) != x_count) {
+        PyErr_SetString(
+            PyExc_ValueError, "Grid initial rows be consistent length");
+        return -1;
+      }
+    }
+  }
+
+  const auto* ops = CellOps_for(cell_type);
+  auto* cells =
+      static_cast<char*>(PyMem_Calloc(x_count * y_count, ops->item_size));
+
+  if (cells == nullptr) {
+    PyErr_NoMemory();
+    return -1;
+  }
+
+  if (!zero_fill) {
+    CellSource source(grid_state(self), initial, x_count, true);
+
+    if (source.fill(ops, cells, x_count * y_count) < 0) {
+      PyMem_Free(cells);
+      return -1;
+    }
+  }
+
+  free_cells(self);
+
+  self->cell_type = cell_type;
+  self->ops = ops;
+  self->x_count = x_count;
+  self->y_count = y_count;
+  replace_cells(self, cells);
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Grid_dealloc(PyObject* obj_self) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+
+  PyObject_GC_UnTrack(obj_self);
+  free_cells(self);
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int Grid_traverse(PyObject* obj_self, visitproc visit, void* arg) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+  Py_VISIT(Py_TYPE(obj_self));
+
+  if (self->cell_type == CellType::Object && self->cells != nullptr) {
+    auto* cells = Grid_cells_as<PyObject*>(self);
+
+    for (Py_ssize_t i = 0; i < self->x_count * self->y_count; ++i) {
+      Py_VISIT(cells[i]);
+    }
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+int Grid_clear(PyObject* obj_self) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+
+  if (self->cell_type == CellType::Object && self->cells != nullptr) {
+    auto* cells = Grid_cells_as<PyObject*>(self);
+
+    for (Py_ssize_t i = 0; i < self->x_count * self->y_count; ++i) {
+      Py_CLEAR(cells[i]);
+    }
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_from_lines(PyObject* cls, PyObject* lines) {
+  PyObject* lines_list = PySequence_List(lines);
+
+  if (lines_list == nullptr) {
+    return nullptr;
+  }
+
+  const auto y_count = PyList_GET_SIZE(lines_list);
+  Py_ssize_t x_count = 0;
+
+  for (Py_ssize_t y = 0; y < y_count; ++y) {
+    PyObject* line = PyList_GET_ITEM(lines_list, y);
+
+    if (!PyUnicode_Check(line)) {
+      PyErr_SetString(PyExc_TypeError, "grid lines must all be type `str`");
+      Py_DECREF(lines_list);
+      return nullptr;
+    }
+
+    if (y == 0) {
+      x_count = PyUnicode_GET_LENGTH(line);
+    } else if (PyUnicode_GET_LENGTH(line) != x_count) {
+      PyErr_SetString(
+          PyExc_ValueError, "grid lines must all be the same length");
+      Py_DECREF(lines_list);
+      return nullptr;
+    }
+
+    if (PyUnicode_KIND(line) != PyUnicode_1BYTE_KIND) {
+      PyErr_SetString(
+          PyExc_ValueError, "grid lines must only contain latin-1 characters");
+      Py_DECREF(lines_list);
+      return nullptr;
+    }
+  }
+
+  auto* st = Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(cls));
+  auto* grid_obj = reinterpret_cast<PyObject*>(
+      Grid_create(st, x_count, y_count, CellType::Char));
+
+  if (grid_obj != nullptr) {
+    auto* grid = reinterpret_cast<Grid*>(grid_obj);
+
+    for (Py_ssize_t y = 0; y < y_count; ++y) {
+      std::memcpy(
+          Grid_cell(grid, y * x_count),
+          PyUnicode_1BYTE_DATA(PyList_GET_ITEM(lines_list, y)),
+          x_count);
+    }
+  }
+
+  Py_DECREF(lines_list);
+  return grid_obj;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_from_buffer(PyObject* cls, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"buffer", "x_count", "dtype", nullptr};
+  PyObject* buffer = nullptr;
+  Py_ssize_t x_count = 0;
+  const char* dtype = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "Ons",
+          const_cast<char**>(kwlist),
+          &buffer,
+          &x_count,
+          &dtype)) {
+    return nullptr;
+  }
+
+  CellType cell_type = CellType::Object;
+
+  if (!CellType_from_name(dtype, &cell_type)) {
+    PyErr_Format(PyExc_ValueError, "unknown grid dtype `%s`", dtype);
+    return nullptr;
+  } else if (cell_type == CellType::Object) {
+    PyErr_SetString(
+        PyExc_ValueError, "object grids cannot be created from a buffer");
+    return nullptr;
+  } else if (x_count < 1) {
+    PyErr_SetString(
+        PyExc_ValueError, "Column count `x_count` must be larger than zero");
+    return nullptr;
+  }
+
+  const auto* ops = CellOps_for(cell_type);
+  SharedBuffer storage;
+
+  if (!SharedBuffer_open(buffer, x_count * ops->item_size, &storage)) {
+    return nullptr;
+  } else if (storage.size == 0) {
+    SharedBuffer_free(storage.base, storage.data);
+    PyErr_SetString(PyExc_ValueError, "buffer must hold at least one row");
+    return nullptr;
+  }
+
+  auto* type = reinterpret_cast<PyTypeObject*>(cls);
+  auto* self = reinterpret_cast<Grid*>(Grid_new(type, nullptr, nullptr));
+
+  if (self == nullptr) {
+    SharedBuffer_free(storage.base, storage.data);
+    return nullptr;
+  }
+
+  self->cell_type = cell_type;
+  self->ops = ops;
+  self->x_count = x_count;
+  self->y_count = storage.size / (x_count * ops->item_size);
+  self->cells = storage.data;
+  self->base = storage.base;
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_reduce_ex(Grid* self, PyObject* obj_protocol) {
+  const long protocol = PyLong_AsLong(obj_protocol);
+
+  if (protocol == -1 && PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  auto* obj_self = reinterpret_cast<PyObject*>(self);
+
+  if (self->cell_type != CellType::Object) {
+    PyObject* cells = SharedBuffer_pickle(
+        obj_self,
+        self->cells,
+        self->x_count * self->y_count * self->ops->item_size,
+        static_cast<int>(protocol));
+
+    if (cells == nullptr) {
+      return nullptr;
+    }
+
+    return Py_BuildValue(
+        "N(Nns)",
+        PyObject_GetAttrString(
+            reinterpret_cast<PyObject*>(Py_TYPE(self)), "from_buffer"),
+        cells,
+        self->x_count,
+        self->ops->name);
+  }
+
+  PyObject* rows = PyList_New(self->y_count);
+
+  for (Py_ssize_t y = 0; rows != nullptr && y < self->y_count; ++y) {
+    PyObject* row = PyList_New(self->x_count);
+
+    for (Py_ssize_t x = 0; row != nullptr && x < self->x_count; ++x) {
+      PyObject* value = Grid_cells_as<PyObject*>(self)[y * self->x_count + x];
+      Py_INCREF(value);
+      PyList_SET_ITEM(row, x, value);
+    }
+
+    if (row == nullptr) {
+      Py_CLEAR(rows);
+    } else {
+      PyList_SET_ITEM(rows, y, row);
+    }
+  }
+
+  if (rows == nullptr) {
+    return nullptr;
+  }
+
+  return Py_BuildValue(
+      "O(nnN)", Py_TYPE(self), self->x_count, self->y_count, rows);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_check_in_bounds(Grid* self, PyObject* obj_pt) {
+  const int result = Grid_contains(reinterpret_cast<PyObject*>(self), obj_pt);
+
+  if (result < 0) {
+    return nullptr;
+  }
+
+  return PyBool_FromLong(result);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_neighbors(Grid* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"pt", "dirs", nullptr};
+  PyObject* obj_pt = nullptr;
+  int dirs = kCardinalDirs;
+  Py_ssize_t index = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|i", const_cast<char**>(kwlist), &obj_pt, &dirs)) {
+    return nullptr;
+  }
+
+  if (dirs == 0 || (dirs & ~(kCardinalDirs | kDiagonalDirs)) != 0) {
+    PyErr_SetString(
+        PyExc_ValueError, "`dirs` must be CARDINAL, DIAGONAL or both");
+    return nullptr;
+  } else if (!cell_index_from_point(self, obj_pt, &index)) {
+    return nullptr;
+  }
+
+  auto* itr = PyObject_GC_New(
+      GridNeighborIterator, grid_state(self)->grid_neighbor_iterator_type);
+
+  if (itr == nullptr) {
+    return nullptr;
+  }
+
+  const auto* pt = reinterpret_cast<Point*>(obj_pt);
+
+  Py_INCREF(self);
+  itr->grid = self;
+  itr->x = pt->x;
+  itr->y = pt->y;
+  itr->dir = 0;
+  itr->dirs = dirs;
+
+  PyObject_GC_Track(itr);
+  return reinterpret_cast<PyObject*>(itr);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_col(Grid* self, PyObject* obj_x_col) {
+  Py_ssize_t x_col = 0;
+
+  if (!parse_axis_index(obj_x_col, "x_col", "col", self->x_count, &x_col)) {
+    return nullptr;
+  }
+
+  return create_cell_iterator(self, x_col, self->x_count, self->y_count);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_row(Grid* self, PyObject* obj_y_row) {
+  Py_ssize_t y_row = 0;
+
+  if (!parse_axis_index(obj_y_row, "y_row", "row", self->y_count, &y_row)) {
+    return nullptr;
+  }
+
+  return create_cell_iterator(self, y_row * self->x_count, 1, self->x_count);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_rows(Grid* self, PyObject*) {
+  auto* itr = PyObject_GC_New(
+      GridRowsIterator, grid_state(self)->grid_rows_iterator_type);
+
+  if (itr == nullptr) {
+    return nullptr;
+  }
+
+  Py_INCREF(self);
+  itr->grid = self;
+  itr->row = 0;
+
+  PyObject_GC_Track(itr);
+  return reinterpret_cast<PyObject*>(itr);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_row_count(Grid* self, PyObject*) {
+  return PyLong_FromSsize_t(self->y_count);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_col_count(Grid* self, PyObject*) {
+  return PyLong_FromSsize_t(self->x_count);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_insert_row(
+    Grid* self,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  Py_ssize_t at_index = 0;
+  PyObject* row = nullptr;
+
+  if (!parse_insert_args("insert_row", args, nargs, &at_index, &row)) {
+    return nullptr;
+  }
+
+  if (!check_resizable(self)) {
+    return nullptr;
+  }
+
+  // New row must be same size as rows in this grid and the index to be
+  // inserted at must be within range.
+  if (PyList_Check(row) && PyList_GET_SIZE(row) != self->x_count) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "`row` to be inserted must be same length as grid col count");
+    return nullptr;
+  }
+
+  if (at_index < 0 || at_index > self->y_count) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "`at_index` must be within the row range of existing grid");
+    return nullptr;
+  }
+
+  // Convert the new row's values up front so a failure leaves the grid as it
+  // was. Rows are contiguous so the existing cells are moved with two copies.
+  const auto item_size = self->ops->item_size;
+  const auto row_bytes = self->x_count * item_size;
+  auto* cells =
+      static_cast<char*>(PyMem_Calloc(self->x_count * (self->y_count + 1), item_size));
+
+  if (cells == nullptr) {
+    return PyErr_NoMemory();
+  }
+
+  CellSource source(grid_state(self), row, 0, true);
+
+  if (source.fill(self->ops, cells + at_index * row_bytes, self->x_count) < 0) {
+    PyMem_Free(cells);
+    return nullptr;
+  }
+
+  std::memcpy(cells, self->cells, at_index * row_bytes);
+  std::memcpy(
+      cells + (at_index + 1) * row_bytes,
+      self->cells + at_index * row_bytes,
+      (self->y_count - at_index) * row_bytes);
+
+  // Ownership of any object references moved to the new cell storage.
+  replace_cells(self, cells);
+  self->y_count += 1;
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_insert_col(
+    Grid* self,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  Py_ssize_t at_index = 0;
+  PyObject* col = nullptr;
+
+  if (!parse_insert_args("insert_col", args, nargs, &at_index, &col)) {
+    return nullptr;
+  }
+
+  if (!check_resizable(self)) {
+    return nullptr;
+  }
+
+  // New col must be same size as cols in this grid, and the index to be
+  // inserted at must be within range.
+  if (PyList_Check(col) && PyList_GET_SIZE(col) != self->y_count) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "`col` to be inserted must be same size as grid row count");
+    return nullptr;
+  }
+
+  if (at_index < 0 || at_index > self->x_count) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "`at_index` must be within the col range of existing grid");
+    return nullptr;
+  }
+
+  // Convert the new column's values into a scratch buffer first so a failure
+  // leaves the grid as it was.
+  const auto item_size = self->ops->item_size;
+  std::vector<char> new_col(self->y_count * item_size, 0);
+  CellSource source(grid_state(self), col, 0, true);
+
+  if (source.fill(self->ops, new_col.data(), self->y_count) < 0) {
+    return nullptr;
+  }
+
+  const auto new_x_count = self->x_count + 1;
+  auto* cells =
+      static_cast<char*>(PyMem_Calloc(new_x_count * self->y_count, item_size));
+
+  if (cells == nullptr) {
+    for (Py_ssize_t y = 0; y < self->y_count; ++y) {
+      self->ops->clear(new_col.data() + y * item_size);
+    }
+
+    return PyErr_NoMemory();
+  }
+
+  for (Py_ssize_t y = 0; y < self->y_count; ++y) {
+    const char* src_row = self->cells + y * self->x_count * item_size;
+    char* dest_row = cells + y * new_x_count * item_size;
+
+    std::memcpy(dest_row, src_row, at_index * item_size);
+    std::memcpy(
+        dest_row + at_index * item_size,
+        new_col.data() + y * item_size,
+        item_size);
+    std::memcpy(
+        dest_row + (at_index + 1) * item_size,
+        src_row + at_index * item_size,
+        (self->x_count - at_index) * item_size);
+  }
+
+  // Ownership of any object references moved to the new cell storage.
+  replace_cells(self, cells);
+  self->x_count = new_x_count;
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_row_view(Grid* self, PyObject* obj_y_row) {
+  Py_ssize_t y_row = 0;
+
+  if (!parse_axis_index(obj_y_row, "y_row", "row", self->y_count, &y_row)) {
+    return nullptr;
+  }
+
+  return create_view(self, y_row * self->x_count, self->x_count, 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_col_view(Grid* self, PyObject* obj_x_col) {
+  Py_ssize_t x_col = 0;
+
+  if (!parse_axis_index(obj_x_col, "x_col", "col", self->x_count, &x_col)) {
+    return nullptr;
+  }
+
+  return create_view(self, x_col, self->y_count, self->x_count);
+}
+
+//--------------------------------------------------------------------------------------------------
+int Grid_getbuffer(PyObject* obj_self, Py_buffer* view, int flags) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+
+  self->buffer_shape[0] = self->y_count;
+  self->buffer_shape[1] = self->x_count;
+  self->buffer_strides[0] = self->x_count * self->ops->item_size;
+  self->buffer_strides[1] = self->ops->item_size;
+
+  if (fill_cell_buffer(
+          obj_self,
+          self,
+          view,
+          flags,
+          self->cells,
+          2,
+          self->buffer_shape,
+          self->buffer_strides) < 0) {
+    return -1;
+  }
+
+  self->exports++;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Grid_releasebuffer(PyObject* obj_self, Py_buffer*) {
+  reinterpret_cast<Grid*>(obj_self)->exports--;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_get_cells(Grid* self, void*) {
+  const auto count = self->x_count * self->y_count;
+  PyObject* cells = PyList_New(count);
+
+  if (cells == nullptr) {
+    return nullptr;
+  }
+
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    PyObject* value = self->ops->get(Grid_cell(self, i));
+
+    if (value == nullptr) {
+      Py_DECREF(cells);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(cells, i, value);
+  }
+
+  return cells;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_get_dtype(Grid* self, void*) {
+  return PyUnicode_FromString(self->ops->name);
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t Grid_len(PyObject* obj_self) {
+  const auto* self = reinterpret_cast<Grid*>(obj_self);
+  return self->x_count * self->y_count;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_get(PyObject* obj_self, PyObject* obj_pt) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+  Py_ssize_t index = 0;
+
+  if (!cell_index_from_point(self, obj_pt, &index)) {
+    return nullptr;
+  }
+
+  return self->ops->get(Grid_cell(self, index));
+}
+
+//--------------------------------------------------------------------------------------------------
+int Grid_set(PyObject* obj_self, PyObject* obj_pt, PyObject* value) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+
+  if (value == nullptr) {
+    PyErr_SetString(PyExc_NotImplementedError, "grid cells cannot be deleted");
+    return -1;
+  }
+
+  Py_ssize_t index = 0;
+
+  if (!cell_index_from_point(self, obj_pt, &index)) {
+    return -1;
+  }
+
+  return self->ops->set(Grid_cell(self, index), value);
+}
+
+//--------------------------------------------------------------------------------------------------
+int Grid_contains(PyObject* obj_self, PyObject* obj_pt) {
+  const auto* self = reinterpret_cast<Grid*>(obj_self);
+  const auto* st = Oatmeal_object_state(obj_self);
+
+  if (PyObject_TypeCheck(obj_pt, st->point_type) == 0) {
+    PyErr_SetString(PyExc_TypeError, "argument `pt` must be type `Point`");
+    return -1;
+  }
+
+  const auto* pt = reinterpret_cast<Point*>(obj_pt);
+  return pt->x >= 0 && pt->y >= 0 && pt->x < self->x_count &&
+         pt->y < self->y_count;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_iter(PyObject* obj_self) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+  return create_cell_iterator(self, 0, 1, self->x_count * self->y_count);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Grid_str(PyObject* obj_self) {
+  auto* self = reinterpret_cast<Grid*>(obj_self);
+
+  // Char grids are already a block of text, so only the newlines need adding.
+  if (self->cell_type == CellType::Char) {
+    std::vector<char> text;
+    text.reserve((self->x_count + 1) * self->y_count);
+
+    for (Py_ssize_t y = 0; y < self->y_count; ++y) {
+      if (y > 0) {
+        text.push_back('\n');
+      }
+
+      const char* row = Grid_cell(self, y * self->x_count);
+      text.insert(text.end(), row, row + self->x_count);
+    }
+
+    return PyUnicode_DecodeLatin1(text.data(), text.size(), nullptr);
+  }
+
+  PyObject* empty = PyUnicode_FromString("");
+  PyObject* newline = PyUnicode_FromString("\n");
+  PyObject* rows = PyList_New(self->y_count);
+  PyObject* result = nullptr;
+
+  if (empty == nullptr || newline == nullptr || rows == nullptr) {
+    goto done;
+  }
+
+  for (Py_ssize_t y = 0; y < self->y_count; ++y) {
+    PyObject* row = PyList_New(self->x_count);
+
+    if (row == nullptr) {
+      goto done;
+    }
+
+    PyList_SET_ITEM(rows, y, row);
+
+    for (Py_ssize_t x = 0; x < self->x_count; ++x) {
+      PyObject* value = self->ops->get(Grid_cell(self, y * self->x_count + x));
+      PyObject* value_str = value != nullptr ? PyObject_Str(value) : nullptr;
+      Py_XDECREF(value);
+
+      if (value_str == nullptr) {
+        goto done;
+      }
+
+      PyList_SET_ITEM(row, x, value_str);
+    }
+
+    PyObject* row_str = PyUnicode_Join(empty, row);
+
+    if (row_str == nullptr) {
+      goto done;
+    }
+
+    PyList_SetItem(rows, y, row_str);
+  }
+
+  result = PyUnicode_Join(newline, rows);
+
+done:
+  Py_XDECREF(empty);
+  Py_XDECREF(newline);
+  Py_XDECREF(rows);
+  return result;
+}
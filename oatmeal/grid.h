@@ -0,0 +1,244 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstdint>
+
+/** Unit x offset for each direction, in `Direction` order. */
+inline constexpr long kDirectionX[] = {1, 0, -1, 0, 1, -1, -1, 1};
+
+/** Unit y offset for each direction, in `Direction` order. */
+inline constexpr long kDirectionY[] = {0, -1, 0, 1, -1, -1, 1, 1};
+
+/** Native storage type used for every cell in a `Grid`. */
+enum class CellType { Object, Int8, Int32, Int64, Char };
+
+/**
+ * Per cell type operations used to move values between a grid's native cell
+ * storage and Python objects.
+ */
+typedef struct {
+  /** Name of the cell type as accepted by the `dtype` argument. */
+  const char* name;
+  /** `struct` module format character describing a single cell. */
+  const char* format;
+  /** Size of a single cell in bytes. */
+  Py_ssize_t item_size;
+  /** Return a new reference to a Python object holding the cell's value. */
+  PyObject* (*get)(const char* cell);
+  /** Store `value` into the cell, returning -1 with an exception on error. */
+  int (*set)(char* cell, PyObject* value);
+  /** Release anything held by the cell (a no-op for numeric cells). */
+  void (*clear)(char* cell);
+} CellOps;
+
+/**
+ * 2d grid of cells stored contiguously in row major order. Cells are either
+ * `PyObject*` references or one of several unboxed numeric types.
+ */
+typedef struct {
+  PyObject_HEAD CellType cell_type;
+  const CellOps* ops;
+  Py_ssize_t x_count;
+  Py_ssize_t y_count;
+  char* cells;
+  /** memoryview that owns `cells` when they are shared with a buffer. */
+  PyObject* base;
+  /** Number of live buffer exports. Cells cannot be reallocated while > 0. */
+  Py_ssize_t exports;
+  /** Shape handed out to buffer consumers as `(y_count, x_count)`. */
+  Py_ssize_t buffer_shape[2];
+  /** Strides in bytes handed out to buffer consumers. */
+  Py_ssize_t buffer_strides[2];
+} Grid;
+
+/**
+ * Buffer exporter for a strided 1d run of cells in a grid, such as a single
+ * row or column. Holds an export on the grid for as long as it is alive.
+ */
+typedef struct {
+  PyObject_HEAD Grid* grid;
+  Py_ssize_t offset;
+  Py_ssize_t length;
+  Py_ssize_t stride;
+} GridView;
+
+/** Python type spec for `Grid`. */
+extern PyType_Spec Grid_Spec;
+
+/** Python type spec for `GridView`. */
+extern PyType_Spec GridView_Spec;
+
+/** Python type spec for the iterator returned by `row()` and `col()`. */
+extern PyType_Spec GridCellIterator_Spec;
+
+/** Python type spec for the iterator returned by `rows()`. */
+extern PyType_Spec GridRowsIterator_Spec;
+
+/** Python type spec for the iterator returned by `neighbors()`. */
+extern PyType_Spec GridNeighborIterator_Spec;
+
+/** Get a pointer to the cell at `index` in the grid's row major storage. */
+inline char* Grid_cell(Grid* self, Py_ssize_t index) {
+  return self->cells + index * self->ops->item_size;
+}
+
+/** Get the cells of a grid as an array of `T`, which must match cell_type. */
+template <typename T> T* Grid_cells_as(Grid* self) {
+  return reinterpret_cast<T*>(self->cells);
+}
+
+/** Returns true if the grid's cells are one of the integer types. */
+inline bool Grid_is_integer(const Grid* self) {
+  return self->cell_type == CellType::Int8 ||
+         self->cell_type == CellType::Int32 ||
+         self->cell_type == CellType::Int64;
+}
+
+/** Read cell `index` of an integer grid. */
+inline int64_t Grid_integer_at(Grid* self, Py_ssize_t index) {
+  switch (self->cell_type) {
+    case CellType::Int8:
+      return Grid_cells_as<int8_t>(self)[index];
+    case CellType::Int32:
+      return Grid_cells_as<int32_t>(self)[index];
+    default:
+      return Grid_cells_as<int64_t>(self)[index];
+  }
+}
+
+/** Get the operations table for a cell type. */
+const CellOps* CellOps_for(CellType cell_type);
+
+/** Find the cell type matching a `dtype` name, or return false. */
+bool CellType_from_name(const char* name, CellType* out);
+
+/**
+ * Create a new zero filled grid (or `None` filled for object grids) of the
+ * module with state `st`. Returns a new reference, or null with an exception
+ * set on failure.
+ */
+Grid* Grid_create(
+    OatmealState* st,
+    Py_ssize_t x_count,
+    Py_ssize_t y_count,
+    CellType cell_type);
+
+/** __new__(type, *args, **kwds) -> Grid */
+PyObject* Grid_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/**
+ * __init__(
+ *  self,
+ *  x_count: int,
+ *  y_count: int,
+ *  initial: T | Callable[[], T] | list[list[T]] = None,
+ *  dtype: str = "object")
+ */
+int Grid_init(Grid* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the grid and release all cells. */
+void Grid_dealloc(PyObject* self);
+
+/** GC traversal of object cells. */
+int Grid_traverse(PyObject* self, visitproc visit, void* arg);
+
+/** GC clear of object cells. */
+int Grid_clear(PyObject* self);
+
+/** from_lines(cls, lines: Iterable[str]) -> Grid[str] */
+PyObject* Grid_from_lines(PyObject* cls, PyObject* lines);
+
+/**
+ * from_buffer(cls, buffer: Buffer, x_count: int, dtype: str) -> Grid
+ *
+ * Create a numeric or char grid whose row major cells are the bytes of
+ * `buffer`, with as many rows as the buffer holds. The cells share the
+ * buffer's memory when it is writable, and are copied otherwise.
+ */
+PyObject* Grid_from_buffer(PyObject* cls, PyObject* args, PyObject* kwds);
+
+/**
+ * __reduce_ex__(self, protocol: int) -> tuple
+ *
+ * Pickle numeric and char grids through `from_buffer`, passing the cells as a
+ * `PickleBuffer` for protocol 5 so they can be sent out of band. Object grids
+ * pickle their cells as nested lists.
+ */
+PyObject* Grid_reduce_ex(Grid* self, PyObject* protocol);
+
+/** check_in_bounds(self, pt: Point) -> bool */
+PyObject* Grid_check_in_bounds(Grid* self, PyObject* pt);
+
+/**
+ * neighbors(self, pt: Point, dirs: int = CARDINAL)
+ *  -> Iterator[tuple[Direction, Point]]
+ *
+ * Iterate over the neighbours of the cell at `pt` that are inside the grid,
+ * in `Direction` order. `dirs` is `CARDINAL`, `DIAGONAL` or both or-ed
+ * together.
+ */
+PyObject* Grid_neighbors(Grid* self, PyObject* args, PyObject* kwds);
+
+/** col(self, x_col: int) -> Iterator[T] */
+PyObject* Grid_col(Grid* self, PyObject* x_col);
+
+/** row(self, y_row: int) -> Iterator[T] */
+PyObject* Grid_row(Grid* self, PyObject* y_row);
+
+/** rows(self) -> Iterator[Iterator[T]] */
+PyObject* Grid_rows(Grid* self, PyObject*);
+
+/** row_count(self) -> int */
+PyObject* Grid_row_count(Grid* self, PyObject*);
+
+/** col_count(self) -> int */
+PyObject* Grid_col_count(Grid* self, PyObject*);
+
+/** insert_row(self, at_index: int, row: T | Callable[[], T] | list[T]) */
+PyObject* Grid_insert_row(
+    Grid* self,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+
+/** insert_col(self, at_index: int, col: T | Callable[[], T] | list[T]) */
+PyObject* Grid_insert_col(
+    Grid* self,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+
+/** row_view(self, y_row: int) -> memoryview */
+PyObject* Grid_row_view(Grid* self, PyObject* y_row);
+
+/** col_view(self, x_col: int) -> memoryview */
+PyObject* Grid_col_view(Grid* self, PyObject* x_col);
+
+/** Buffer protocol export as a 2d `(y_count, x_count)` array of cells. */
+int Grid_getbuffer(PyObject* self, Py_buffer* view, int flags);
+
+/** Buffer protocol release. */
+void Grid_releasebuffer(PyObject* self, Py_buffer* view);
+
+/** cells -> list[T] */
+PyObject* Grid_get_cells(Grid* self, void*);
+
+/** dtype -> str */
+PyObject* Grid_get_dtype(Grid* self, void*);
+
+/** len(self) -> int */
+Py_ssize_t Grid_len(PyObject* self);
+
+/** __getitem__(self, pt: Point) -> T */
+PyObject* Grid_get(PyObject* self, PyObject* pt);
+
+/** __setitem__(self, pt: Point, value: T) */
+int Grid_set(PyObject* self, PyObject* pt, PyObject* value);
+
+/** __contains__(self, pt: Point) -> bool */
+int Grid_contains(PyObject* self, PyObject* pt);
+
+/** iter(self) -> Iterator[T] */
+PyObject* Grid_iter(PyObject* self);
+
+/** str(self) -> str */
+PyObject* Grid_str(PyObject* self);
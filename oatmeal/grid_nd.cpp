@@ -0,0 +1,617 @@
+#include "grid_nd.h"
+#include "shared_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace {
+  /** Argument names of the count along each axis, starting with x. */
+  constexpr const char* kCountNames[] = {
+      "x_count", "y_count", "z_count", "w_count"};
+
+  //------------------------------------------------------------------------------------------------
+  // GridND implementation shared by every instantiation.
+  //------------------------------------------------------------------------------------------------
+  template <int N> struct GridOps {
+    using Self = GridND<N>;
+
+    static Self* cast(PyObject* obj) { return reinterpret_cast<Self*>(obj); }
+
+    static const std::string& name() {
+      static const std::string text = "Grid" + std::to_string(N);
+      return text;
+    }
+
+    static Py_ssize_t cell_count(const Self* self) {
+      Py_ssize_t count = 1;
+
+      for (int i = 0; i < N; ++i) {
+        count *= self->counts[i];
+      }
+
+      return count;
+    }
+
+    static char* cell(Self* self, Py_ssize_t index) {
+      return self->cells + index * self->ops->item_size;
+    }
+
+    static bool in_bounds(const Self* self, const int64_t* pt) {
+      for (int i = 0; i < N; ++i) {
+        if (pt[i] < 0 || pt[i] >= self->counts[i]) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    /** Read an `N` dimensional point, raising TypeError for anything else. */
+    static bool point_arg(PyObject* self, PyObject* obj, int64_t* out) {
+      if (!PointND_components<N>(Oatmeal_object_state(self), obj, out)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "`%s` is indexed by %d dimensional points but got `%s`",
+            name().c_str(),
+            N,
+            Py_TYPE(obj)->tp_name);
+        return false;
+      }
+
+      return true;
+    }
+
+    /** Cell index of a point, raising IndexError if it is out of bounds. */
+    static bool cell_index(Self* self, PyObject* obj_pt, Py_ssize_t* out) {
+      int64_t pt[N];
+
+      if (!point_arg(reinterpret_cast<PyObject*>(self), obj_pt, pt)) {
+        return false;
+      } else if (!in_bounds(self, pt)) {
+        PyErr_Format(PyExc_IndexError, "%R is outside the grid", obj_pt);
+        return false;
+      }
+
+      *out = 0;
+
+      for (int i = N - 1; i >= 0; --i) {
+        *out = *out * self->counts[i] + pt[i];
+      }
+
+      return true;
+    }
+
+    static PyObject* tp_new(PyTypeObject* type, PyObject*, PyObject*) {
+      auto* self = cast(type->tp_alloc(type, 0));
+
+      if (self != nullptr) {
+        self->cell_type = CellType::Int64;
+        self->ops = CellOps_for(CellType::Int64);
+        std::fill(self->counts, self->counts + N, 0);
+        self->cells = nullptr;
+        self->base = nullptr;
+        self->exports = 0;
+      }
+
+      return reinterpret_cast<PyObject*>(self);
+    }
+
+    static int init(PyObject* obj_self, PyObject* args, PyObject* kwds) {
+      auto* self = cast(obj_self);
+      Py_ssize_t counts[4] = {};
+      PyObject* initial = Py_None;
+      const char* dtype = "int64";
+      int parsed = 0;
+
+      if constexpr (N == 3) {
+        const char* kwlist[] = {
+            kCountNames[0],
+            kCountNames[1],
+            kCountNames[2],
+            "initial",
+            "dtype",
+            nullptr};
+        parsed = PyArg_ParseTupleAndKeywords(
+            args,
+            kwds,
+            "nnn|Os",
+            const_cast<char**>(kwlist),
+            &counts[0],
+            &counts[1],
+            &counts[2],
+            &initial,
+            &dtype);
+      } else {
+        const char* kwlist[] = {
+            kCountNames[0],
+            kCountNames[1],
+            kCountNames[2],
+            kCountNames[3],
+            "initial",
+            "dtype",
+            nullptr};
+        parsed = PyArg_ParseTupleAndKeywords(
+            args,
+            kwds,
+            "nnnn|Os",
+            const_cast<char**>(kwlist),
+            &counts[0],
+            &counts[1],
+            &counts[2],
+            &counts[3],
+            &initial,
+            &dtype);
+      }
+
+      if (!parsed) {
+        return -1;
+      } else if (self->exports > 0) {
+        PyErr_SetString(
+            PyExc_BufferError,
+            "cannot resize a grid while it is exported as a buffer");
+        return -1;
+      }
+
+      CellType cell_type = CellType::Int64;
+
+      if (!CellType_from_name(dtype, &cell_type) ||
+          cell_type == CellType::Object) {
+        PyErr_Format(
+            PyExc_ValueError,
+            "unsupported `%s` dtype '%s'",
+            name().c_str(),
+            dtype);
+        return -1;
+      }
+
+      for (int i = 0; i < N; ++i) {
+        if (counts[i] < 1) {
+          PyErr_Format(
+              PyExc_ValueError,
+              "`%s` must be larger than zero",
+              kCountNames[i]);
+          return -1;
+        }
+      }
+
+      const auto* ops = CellOps_for(cell_type);
+      Py_ssize_t cell_count = 1;
+
+      for (int i = 0; i < N; ++i) {
+        if (cell_count > PY_SSIZE_T_MAX / ops->item_size / counts[i]) {
+          PyErr_NoMemory();
+          return -1;
+        }
+
+        cell_count *= counts[i];
+      }
+
+      auto* cells =
+          static_cast<char*>(PyMem_Calloc(cell_count, ops->item_size));
+
+      if (cells == nullptr) {
+        PyErr_NoMemory();
+        return -1;
+      }
+
+      if (initial != Py_None) {
+        if (ops->set(cells, initial) < 0) {
+          PyMem_Free(cells);
+          return -1;
+        }
+
+        for (Py_ssize_t i = 1; i < cell_count; ++i) {
+          std::memcpy(cells + i * ops->item_size, cells, ops->item_size);
+        }
+      }
+
+      SharedBuffer_free(self->base, self->cells);
+      self->base = nullptr;
+      self->cell_type = cell_type;
+      self->ops = ops;
+      std::copy(counts, counts + N, self->counts);
+      self->cells = cells;
+      return 0;
+    }
+
+    static void dealloc(PyObject* self) {
+      SharedBuffer_free(cast(self)->base, cast(self)->cells);
+      Oatmeal_free(self);
+    }
+
+    /**
+     * Grid sharing a buffer of cells. Every count but the slowest axis is
+     * given, and that one is however many fit in the buffer.
+     */
+    static PyObject*
+        from_buffer(PyObject* cls, PyObject* args, PyObject* kwds) {
+      PyObject* buffer = nullptr;
+      Py_ssize_t counts[4] = {};
+      const char* dtype = nullptr;
+      int parsed = 0;
+
+      if constexpr (N == 3) {
+        const char* kwlist[] = {
+            "buffer", kCountNames[0], kCountNames[1], "dtype", nullptr};
+        parsed = PyArg_ParseTupleAndKeywords(
+            args,
+            kwds,
+            "Onns",
+            const_cast<char**>(kwlist),
+            &buffer,
+            &counts[0],
+            &counts[1],
+            &dtype);
+      } else {
+        const char* kwlist[] = {
+            "buffer",
+            kCountNames[0],
+            kCountNames[1],
+            kCountNames[2],
+            "dtype",
+            nullptr};
+        parsed = PyArg_ParseTupleAndKeywords(
+            args,
+            kwds,
+            "Onnns",
+            const_cast<char**>(kwlist),
+            &buffer,
+            &counts[0],
+            &counts[1],
+            &counts[2],
+            &dtype);
+      }
+
+      if (!parsed) {
+        return nullptr;
+      }
+
+      CellType cell_type = CellType::Int64;
+
+      if (!CellType_from_name(dtype, &cell_type) ||
+          cell_type == CellType::Object) {
+        PyErr_Format(
+            PyExc_ValueError,
+            "unsupported `%s` dtype '%s'",
+            name().c_str(),
+            dtype);
+        return nullptr;
+      }
+
+      const auto* ops = CellOps_for(cell_type);
+      Py_ssize_t layer_size = ops->item_size;
+
+      for (int i = 0; i < N - 1; ++i) {
+        if (counts[i] < 1) {
+          PyErr_Format(
+              PyExc_ValueError,
+              "`%s` must be larger than zero",
+              kCountNames[i]);
+          return nullptr;
+        } else if (layer_size > PY_SSIZE_T_MAX / counts[i]) {
+          PyErr_NoMemory();
+          return nullptr;
+        }
+
+        layer_size *= counts[i];
+      }
+
+      SharedBuffer storage;
+
+      if (!SharedBuffer_open(buffer, layer_size, &storage)) {
+        return nullptr;
+      } else if (storage.size == 0) {
+        SharedBuffer_free(storage.base, storage.data);
+        PyErr_SetString(
+            PyExc_ValueError, "buffer must hold at least one layer of cells");
+        return nullptr;
+      }
+
+      auto* type = reinterpret_cast<PyTypeObject*>(cls);
+      auto* self = cast(tp_new(type, nullptr, nullptr));
+
+      if (self == nullptr) {
+        SharedBuffer_free(storage.base, storage.data);
+        return nullptr;
+      }
+
+      counts[N - 1] = storage.size / layer_size;
+
+      self->cell_type = cell_type;
+      self->ops = ops;
+      std::copy(counts, counts + N, self->counts);
+      self->cells = storage.data;
+      self->base = storage.base;
+
+      return reinterpret_cast<PyObject*>(self);
+    }
+
+    /** pickle the cells as one buffer, out of band for protocol 5. */
+    static PyObject* reduce_ex(PyObject* obj_self, PyObject* obj_protocol) {
+      auto* self = cast(obj_self);
+      const long protocol = PyLong_AsLong(obj_protocol);
+
+      if (protocol == -1 && PyErr_Occurred()) {
+        return nullptr;
+      }
+
+      PyObject* cells = SharedBuffer_pickle(
+          obj_self,
+          self->cells,
+          cell_count(self) * self->ops->item_size,
+          static_cast<int>(protocol));
+
+      if (cells == nullptr) {
+        return nullptr;
+      }
+
+      PyObject* from_buffer = PyObject_GetAttrString(
+          reinterpret_cast<PyObject*>(Py_TYPE(obj_self)), "from_buffer");
+
+      if constexpr (N == 3) {
+        return Py_BuildValue(
+            "N(Nnns)",
+            from_buffer,
+            cells,
+            self->counts[0],
+            self->counts[1],
+            self->ops->name);
+      } else {
+        return Py_BuildValue(
+            "N(Nnnns)",
+            from_buffer,
+            cells,
+            self->counts[0],
+            self->counts[1],
+            self->counts[2],
+            self->ops->name);
+      }
+    }
+
+    static PyObject* get_count(PyObject* self, void* axis) {
+      return PyLong_FromSsize_t(
+          cast(self)->counts[reinterpret_cast<intptr_t>(axis)]);
+    }
+
+    static PyObject* get_dtype(PyObject* self, void*) {
+      return PyUnicode_FromString(cast(self)->ops->name);
+    }
+
+    static Py_ssize_t len(PyObject* self) { return cell_count(cast(self)); }
+
+    static PyObject* get(PyObject* obj_self, PyObject* obj_pt) {
+      auto* self = cast(obj_self);
+      Py_ssize_t index = 0;
+
+      if (!cell_index(self, obj_pt, &index)) {
+        return nullptr;
+      }
+
+      return self->ops->get(cell(self, index));
+    }
+
+    static int set(PyObject* obj_self, PyObject* obj_pt, PyObject* value) {
+      auto* self = cast(obj_self);
+      Py_ssize_t index = 0;
+
+      if (value == nullptr) {
+        PyErr_SetString(
+            PyExc_NotImplementedError, "grid cells cannot be deleted");
+        return -1;
+      } else if (!cell_index(self, obj_pt, &index)) {
+        return -1;
+      }
+
+      return self->ops->set(cell(self, index), value);
+    }
+
+    static int contains(PyObject* self, PyObject* obj_pt) {
+      int64_t pt[N];
+      return point_arg(self, obj_pt, pt) ? in_bounds(cast(self), pt) : -1;
+    }
+
+    static PyObject* check_in_bounds(PyObject* self, PyObject* obj_pt) {
+      const int result = contains(self, obj_pt);
+      return result < 0 ? nullptr : PyBool_FromLong(result);
+    }
+
+    /** Point of the same type as `like` with components `v`. */
+    static PyObject*
+        point_like(const OatmealState* st, PyObject* like, const int64_t* v) {
+      if (Py_TYPE(like) == PointND_type<N, int32_t>(st)) {
+        int32_t narrow[N];
+        std::copy(v, v + N, narrow);
+        return PointND_create<N, int32_t>(st, narrow);
+      }
+
+      return PointND_create<N, int64_t>(st, v);
+    }
+
+    /**
+     * List the in bounds neighbours of a point that differ by one along a
+     * single axis, as points of the same type. Neighbours are ordered by
+     * axis, with the lower neighbour first.
+     */
+    static PyObject* neighbors(PyObject* self, PyObject* obj_pt) {
+      const auto* st = Oatmeal_object_state(self);
+      int64_t pt[N];
+
+      if (!point_arg(self, obj_pt, pt)) {
+        return nullptr;
+      } else if (!in_bounds(cast(self), pt)) {
+        PyErr_Format(PyExc_IndexError, "%R is outside the grid", obj_pt);
+        return nullptr;
+      }
+
+      PyObject* result = PyList_New(0);
+
+      for (int axis = 0; result != nullptr && axis < N; ++axis) {
+        for (const int64_t delta : {-1, 1}) {
+          int64_t next[N];
+          std::copy(pt, pt + N, next);
+          next[axis] += delta;
+
+          if (!in_bounds(cast(self), next)) {
+            continue;
+          }
+
+          PyObject* neighbor = point_like(st, obj_pt, next);
+
+          if (neighbor == nullptr || PyList_Append(result, neighbor) < 0) {
+            Py_XDECREF(neighbor);
+            Py_CLEAR(result);
+            break;
+          }
+
+          Py_DECREF(neighbor);
+        }
+      }
+
+      return result;
+    }
+
+    static PyObject* repr(PyObject* obj_self) {
+      auto* self = cast(obj_self);
+      std::string text = name() + "(";
+
+      for (int i = 0; i < N; ++i) {
+        text += kCountNames[i];
+        text += "=" + std::to_string(self->counts[i]) + ", ";
+      }
+
+      text += "dtype='" + std::string(self->ops->name) + "')";
+      return PyUnicode_FromStringAndSize(text.data(), text.size());
+    }
+
+    /**
+     * Buffer export with the slowest axis first, so a `Grid3` is a
+     * `(z_count, y_count, x_count)` array.
+     */
+    static int getbuffer(PyObject* obj_self, Py_buffer* view, int flags) {
+      auto* self = cast(obj_self);
+      const auto item_size = self->ops->item_size;
+      Py_ssize_t stride = item_size;
+
+      for (int i = 0; i < N; ++i) {
+        self->buffer_shape[N - 1 - i] = self->counts[i];
+        self->buffer_strides[N - 1 - i] = stride;
+        stride *= self->counts[i];
+      }
+
+      Py_INCREF(obj_self);
+      view->obj = obj_self;
+      view->buf = self->cells;
+      view->len = cell_count(self) * item_size;
+      view->itemsize = item_size;
+      view->readonly = 0;
+      // Without a shape, consumers treat the buffer as `len / itemsize` items.
+      view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? N : 1;
+      view->format = (flags & PyBUF_FORMAT) != 0
+                         ? const_cast<char*>(self->ops->format)
+                         : nullptr;
+      view->shape =
+          (flags & PyBUF_ND) == PyBUF_ND ? self->buffer_shape : nullptr;
+      view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES
+                          ? self->buffer_strides
+                          : nullptr;
+      view->suboffsets = nullptr;
+      view->internal = nullptr;
+
+      self->exports++;
+      return 0;
+    }
+
+    static void releasebuffer(PyObject* self, Py_buffer*) {
+      cast(self)->exports--;
+    }
+
+    static inline PyGetSetDef getset[] = {
+        {"dtype", get_dtype, nullptr, "cell storage type", nullptr},
+        {kCountNames[0],
+         get_count,
+         nullptr,
+         "number of cells along x",
+         reinterpret_cast<void*>(0)},
+        {kCountNames[1],
+         get_count,
+         nullptr,
+         "number of cells along y",
+         reinterpret_cast<void*>(1)},
+        {kCountNames[2],
+         get_count,
+         nullptr,
+         "number of cells along z",
+         reinterpret_cast<void*>(2)},
+        {N > 3 ? kCountNames[3] : nullptr,
+         get_count,
+         nullptr,
+         "number of cells along w",
+         reinterpret_cast<void*>(3)},
+        {nullptr}};
+
+    static inline PyMethodDef methods[] = {
+        {"from_buffer",
+         (PyCFunction)from_buffer,
+         METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+         "Create a grid sharing a buffer of cells with x varying fastest"},
+        {"__reduce_ex__",
+         (PyCFunction)reduce_ex,
+         METH_O,
+         "pickle the cells as one buffer, out of band for protocol 5"},
+        {"check_in_bounds",
+         (PyCFunction)check_in_bounds,
+         METH_O,
+         "Returns true if the point is inside the grid"},
+        {"neighbors",
+         (PyCFunction)neighbors,
+         METH_O,
+         "List the in bounds neighbours one step along each axis"},
+        {nullptr}};
+
+    static PyType_Spec* spec() {
+      static const std::string qualified = "oatmeal." + name();
+      static const std::string doc =
+          std::to_string(N) + "d grid of unboxed cells with x varying fastest";
+
+      static PyType_Slot slots[] = {
+          {Py_tp_dealloc, reinterpret_cast<void*>(dealloc)},
+          {Py_tp_repr, reinterpret_cast<void*>(repr)},
+          {Py_sq_contains, reinterpret_cast<void*>(contains)},
+          {Py_mp_length, reinterpret_cast<void*>(len)},
+          {Py_mp_subscript, reinterpret_cast<void*>(get)},
+          {Py_mp_ass_subscript, reinterpret_cast<void*>(set)},
+          {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+          {Py_bf_getbuffer, reinterpret_cast<void*>(getbuffer)},
+          {Py_bf_releasebuffer, reinterpret_cast<void*>(releasebuffer)},
+          {Py_tp_doc, const_cast<char*>(doc.c_str())},
+          {Py_tp_methods, methods},
+          {Py_tp_getset, getset},
+          {Py_tp_init, reinterpret_cast<void*>(init)},
+          {Py_tp_new, reinterpret_cast<void*>(tp_new)},
+          {0, nullptr}};
+
+      static PyType_Spec spec = {
+          .name = qualified.c_str(),
+          .basicsize = sizeof(Self),
+          .itemsize = 0,
+          .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+          .slots = slots,
+      };
+
+      return &spec;
+    }
+  };
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// GridND method definitions.
+//--------------------------------------------------------------------------------------------------
+const NamedSpec* GridND_specs() {
+  static const NamedSpec specs[] = {
+      {"Grid3", GridOps<3>::spec(), nullptr},
+      {"Grid4", GridOps<4>::spec(), nullptr}};
+  static_assert(std::size(specs) == kGridNDTypeCount);
+  return specs;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "grid.h"
+#include "oatmeal.h"
+#include "point_nd.h"
+
+/**
+ * `N` dimensional grid of unboxed cells stored contiguously with x varying
+ * fastest, indexed by any `N` dimensional point of the `PointND` family.
+ * Exposed as `Grid{N}` such as `Grid3`. Cells take any of the `Grid` dtypes
+ * except `object`.
+ */
+template <int N> struct GridND {
+  PyObject_HEAD CellType cell_type;
+  const CellOps* ops;
+  /** Number of cells along each axis, starting with x. */
+  Py_ssize_t counts[N];
+  char* cells;
+  /** memoryview that owns `cells` when they are shared with a buffer. */
+  PyObject* base;
+  /** Number of live buffer exports. */
+  Py_ssize_t exports;
+  /** Shape handed out to buffer consumers, slowest axis first. */
+  Py_ssize_t buffer_shape[N];
+  /** Strides in bytes handed out to buffer consumers. */
+  Py_ssize_t buffer_strides[N];
+};
+
+/**
+ * The `kGridNDTypeCount` specs for `Grid{N}` with `N` of 3 and 4, in
+ * `grid_nd_types` order.
+ */
+const NamedSpec* GridND_specs();
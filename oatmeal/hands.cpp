@@ -0,0 +1,426 @@
+#include "hands.h"
+#include "mapped_input.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+  constexpr int kHandSize = 5;
+  constexpr int kCardBits = 4;
+
+  /** Bits in a hand key, which is the hand type above the 20 bit card code. */
+  constexpr int kKeyBits = 3 + kHandSize * kCardBits;
+
+  constexpr uint8_t kNotACard = 0xFF;
+  constexpr int64_t kMaxWinnings = std::numeric_limits<int64_t>::max();
+
+  /** Cards from weakest to strongest. */
+  constexpr char kCards[] = "23456789TJQKA";
+
+  /** Cards from weakest to strongest when `J` is a joker. */
+  constexpr char kJokerCards[] = "J23456789TQKA";
+
+  /** Strength of every card character, or `kNotACard` for anything else. */
+  template <bool kJokers>
+  constexpr std::array<uint8_t, 256> make_card_values() {
+    std::array<uint8_t, 256> values{};
+    const char* cards = kJokers ? kJokerCards : kCards;
+
+    for (auto& value : values) {
+      value = kNotACard;
+    }
+
+    for (uint8_t i = 0; cards[i] != '\0'; ++i) {
+      values[static_cast<unsigned char>(cards[i])] = i;
+    }
+
+    return values;
+  }
+
+  template <bool kJokers>
+  constexpr std::array<uint8_t, 256> kCardValues = make_card_values<kJokers>();
+
+  /** Strength of a joker, which is the weakest card when jokers are wild. */
+  constexpr uint8_t kJoker = 0;
+
+  /**
+   * Group sizes of every hand type from weakest to strongest, where the type
+   * of a hand is the index of its shape plus one.
+   */
+  constexpr int kShapes[][kHandSize] = {
+      {1, 1, 1, 1, 1},
+      {2, 1, 1, 1, 0},
+      {2, 2, 1, 0, 0},
+      {3, 1, 1, 0, 0},
+      {3, 2, 0, 0, 0},
+      {4, 1, 0, 0, 0},
+      {5, 0, 0, 0, 0}};
+
+  /**
+   * `kHandTypes[largest][distinct]` is the type of a hand with `distinct`
+   * different cards whose largest group holds `largest` of them, which is
+   * enough to tell every shape apart. Jokers always join the largest group,
+   * so a hand with jokers has the type of the same lookup after adding them
+   * to `largest`.
+   */
+  constexpr auto kHandTypes = []() {
+    std::array<std::array<uint8_t, kHandSize + 1>, kHandSize + 1> types{};
+    uint8_t type = 1;
+
+    for (const auto& shape : kShapes) {
+      int distinct = 0;
+
+      for (const int size : shape) {
+        distinct += size > 0 ? 1 : 0;
+      }
+
+      types[shape[0]][distinct] = type++;
+    }
+
+    return types;
+  }();
+
+  /** Type of a hand from the strengths of its cards. */
+  template <bool kJokers> uint8_t classify(const uint8_t* values) {
+    int largest = 0;
+    int distinct = 0;
+    int jokers = 0;
+
+    for (int i = 0; i < kHandSize; ++i) {
+      if (kJokers && values[i] == kJoker) {
+        jokers++;
+        continue;
+      }
+
+      int same = 0;
+      bool first = true;
+
+      for (int j = 0; j < kHandSize; ++j) {
+        same += values[j] == values[i] ? 1 : 0;
+        first = first && (j >= i || values[j] != values[i]);
+      }
+
+      largest = same > largest ? same : largest;
+      distinct += first ? 1 : 0;
+    }
+
+    // A hand of only jokers is five of a kind.
+    return kHandTypes[largest + jokers][distinct > 0 ? distinct : 1];
+  }
+
+  /**
+   * Read five cards into their strengths, returning false if there are not
+   * exactly five cards.
+   */
+  template <bool kJokers>
+  bool read_cards(const char* begin, const char* end, uint8_t* values) {
+    if (end - begin != kHandSize) {
+      return false;
+    }
+
+    for (int i = 0; i < kHandSize; ++i) {
+      values[i] = kCardValues<kJokers>[static_cast<unsigned char>(begin[i])];
+
+      if (values[i] == kNotACard) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Sort key of a hand, with the type above a card code holding four bits
+   * per card and the first card highest.
+   */
+  template <bool kJokers> uint32_t hand_key(const uint8_t* values) {
+    uint32_t code = 0;
+
+    for (int i = 0; i < kHandSize; ++i) {
+      code = (code << kCardBits) | values[i];
+    }
+
+    return static_cast<uint32_t>(classify<kJokers>(values))
+               << (kHandSize * kCardBits) |
+           code;
+  }
+
+  /** A ranked hand and its bid. */
+  struct Hand {
+    uint32_t key;
+    int64_t bid;
+  };
+
+  /** Outcome of parsing one line. */
+  enum class LineStatus { Hand, Blank, Invalid };
+
+  bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  /** Parse a `"CARDS BID"` line, skipping lines that are only whitespace. */
+  template <bool kJokers>
+  LineStatus parse_hand(const char* begin, const char* end, Hand* out) {
+    while (begin != end && is_space(*begin)) {
+      begin++;
+    }
+
+    while (begin != end && is_space(end[-1])) {
+      end--;
+    }
+
+    if (begin == end) {
+      return LineStatus::Blank;
+    }
+
+    const char* cards_end = begin;
+
+    while (cards_end != end && !is_space(*cards_end)) {
+      cards_end++;
+    }
+
+    uint8_t values[kHandSize];
+
+    if (!read_cards<kJokers>(begin, cards_end, values)) {
+      return LineStatus::Invalid;
+    }
+
+    const char* digit = cards_end;
+
+    while (digit != end && is_space(*digit)) {
+      digit++;
+    }
+
+    if (digit == cards_end || digit == end) {
+      return LineStatus::Invalid;
+    }
+
+    int64_t bid = 0;
+
+    for (; digit != end; ++digit) {
+      const int d = *digit - '0';
+
+      if (d < 0 || d > 9 || bid > (kMaxWinnings - d) / 10) {
+        return LineStatus::Invalid;
+      }
+
+      bid = bid * 10 + d;
+    }
+
+    *out = {hand_key<kJokers>(values), bid};
+    return LineStatus::Hand;
+  }
+
+  /**
+   * Sum each bid times the rank of its hand, ranking the hands with an LSD
+   * radix sort over their keys. Returns false if the total overflows.
+   */
+  bool total_winnings(const std::vector<Hand>& hands, int64_t* out) {
+    // Sort the keys with the hand index packed below them, eight key bits
+    // per pass. Each pass is stable, so equal hands keep their input order.
+    std::vector<uint64_t> items(hands.size());
+    std::vector<uint64_t> scratch(hands.size());
+
+    for (size_t i = 0; i < hands.size(); ++i) {
+      items[i] = static_cast<uint64_t>(hands[i].key) << 32 | i;
+    }
+
+    for (int shift = 32; shift < 32 + kKeyBits; shift += 8) {
+      std::array<size_t, 257> starts{};
+
+      for (const auto item : items) {
+        starts[((item >> shift) & 0xFF) + 1]++;
+      }
+
+      for (size_t digit = 1; digit < starts.size(); ++digit) {
+        starts[digit] += starts[digit - 1];
+      }
+
+      for (const auto item : items) {
+        scratch[starts[(item >> shift) & 0xFF]++] = item;
+      }
+
+      items.swap(scratch);
+    }
+
+    int64_t total = 0;
+
+    for (size_t i = 0; i < items.size(); ++i) {
+      const auto rank = static_cast<int64_t>(i + 1);
+      const auto bid = hands[items[i] & 0xFFFFFFFF].bid;
+
+      if (bid > (kMaxWinnings - total) / rank) {
+        return false;
+      }
+
+      total += bid * rank;
+    }
+
+    *out = total;
+    return true;
+  }
+
+  /** Parse every line of a mapped input and total it without the GIL. */
+  template <bool kJokers>
+  bool mapped_winnings(MappedInput* lines, int64_t* out) {
+    if (!lines->file.is_open()) {
+      PyErr_SetString(PyExc_ValueError, "I/O operation on closed input");
+      return false;
+    }
+
+    // Hold an export so the file cannot be unmapped while the GIL is released.
+    const MappedLines mapped(lines);
+    std::vector<Hand> hands;
+    Py_ssize_t row = 0;
+    bool valid = true;
+    bool fits = true;
+
+    lines->exports++;
+    Py_BEGIN_ALLOW_THREADS;
+
+    hands.reserve(mapped.indexed());
+    mapped.for_each([&](const char* begin, const char* end) {
+      Hand hand;
+      const auto status = parse_hand<kJokers>(begin, end, &hand);
+
+      if (status == LineStatus::Hand) {
+        hands.push_back(hand);
+      }
+
+      valid = status != LineStatus::Invalid;
+      row += valid ? 1 : 0;
+      return valid;
+    });
+
+    fits = valid && total_winnings(hands, out);
+
+    Py_END_ALLOW_THREADS;
+    lines->exports--;
+
+    if (!valid) {
+      PyErr_Format(
+          PyExc_ValueError, "row %zd is not five cards and a bid", row);
+    } else if (!fits) {
+      PyErr_SetString(PyExc_OverflowError, "winnings overflow int64");
+    }
+
+    return valid && fits;
+  }
+
+  /** Parse each `str` or bytes like line of an iterable, then total them. */
+  template <bool kJokers>
+  bool iterable_winnings(PyObject* lines, int64_t* out) {
+    PyObject* iter = PyObject_GetIter(lines);
+
+    if (iter == nullptr) {
+      return false;
+    }
+
+    std::vector<Hand> hands;
+    Py_ssize_t row = 0;
+
+    while (PyObject* item = PyIter_Next(iter)) {
+      TextSpan text;
+      Hand hand;
+      auto status = LineStatus::Invalid;
+
+      if (text.open(item)) {
+        status = parse_hand<kJokers>(text.begin(), text.end(), &hand);
+      }
+
+      Py_DECREF(item);
+
+      if (status == LineStatus::Invalid) {
+        if (!PyErr_Occurred()) {
+          PyErr_Format(
+              PyExc_ValueError, "row %zd is not five cards and a bid", row);
+        }
+
+        Py_DECREF(iter);
+        return false;
+      } else if (status == LineStatus::Hand) {
+        hands.push_back(hand);
+      }
+
+      row++;
+    }
+
+    Py_DECREF(iter);
+
+    if (PyErr_Occurred()) {
+      return false;
+    }
+
+    bool fits = true;
+
+    Py_BEGIN_ALLOW_THREADS;
+    fits = total_winnings(hands, out);
+    Py_END_ALLOW_THREADS;
+
+    if (!fits) {
+      PyErr_SetString(PyExc_OverflowError, "winnings overflow int64");
+    }
+
+    return fits;
+  }
+
+  template <bool kJokers>
+  bool winnings(OatmealState* st, PyObject* lines, int64_t* out) {
+    return PyObject_TypeCheck(lines, st->mapped_input_type) != 0
+               ? mapped_winnings<kJokers>(
+                     reinterpret_cast<MappedInput*>(lines), out)
+               : iterable_winnings<kJokers>(lines, out);
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* classify_hand(PyObject*, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"cards", "jokers", nullptr};
+  const char* cards = nullptr;
+  Py_ssize_t length = 0;
+  int jokers = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "s#|p",
+          const_cast<char**>(kwlist),
+          &cards,
+          &length,
+          &jokers)) {
+    return nullptr;
+  }
+
+  uint8_t values[kHandSize];
+  const bool ok = jokers ? read_cards<true>(cards, cards + length, values)
+                         : read_cards<false>(cards, cards + length, values);
+
+  if (!ok) {
+    PyErr_Format(PyExc_ValueError, "%s is not a hand of five cards", cards);
+    return nullptr;
+  }
+
+  return PyLong_FromLong(
+      jokers ? classify<true>(values) : classify<false>(values));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* hand_winnings(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"lines", "jokers", nullptr};
+  PyObject* lines = nullptr;
+  int jokers = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|p", const_cast<char**>(kwlist), &lines, &jokers)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_state(module);
+  int64_t total = 0;
+  const bool ok = jokers ? winnings<true>(st, lines, &total)
+                         : winnings<false>(st, lines, &total);
+
+  return ok ? PyLong_FromLongLong(total) : nullptr;
+}
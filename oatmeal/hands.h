@@ -0,0 +1,31 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * classify_hand(cards: str, jokers: bool = False) -> int
+ *
+ * Type of a five card hand from `1` for a high card up to `7` for five of a
+ * kind, ranked high card, one pair, two pair, three of a kind, full house,
+ * four of a kind and five of a kind. Cards are `23456789TJQKA`, and with
+ * `jokers` set each `J` joins whichever group makes the strongest hand.
+ */
+PyObject* classify_hand(PyObject* module, PyObject* args, PyObject* kwds);
+
+/**
+ * hand_winnings(
+ *  lines: MappedInput | Iterable[str | bytes],
+ *  jokers: bool = False,
+ * ) -> int
+ *
+ * Rank every `"CARDS BID"` line from weakest to strongest and return the sum
+ * of each bid times its rank. Hands are ordered by type and then card by card
+ * from the left, where a `J` is the weakest card when `jokers` is set.
+ *
+ * Each hand is packed into a 20 bit code of four bits per card, so the type
+ * and code together form an integer key that is ranked with a radix sort.
+ * Lines of a `MappedInput` are parsed and ranked without holding the GIL.
+ * Raises ValueError for a malformed line and OverflowError if the winnings do
+ * not fit in an int64.
+ */
+PyObject* hand_winnings(PyObject* module, PyObject* args, PyObject* kwds);
@@ -0,0 +1,379 @@
+#include "int_array.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+//--------------------------------------------------------------------------------------------------
+// IntArray python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef IntArray_Methods[] = {
+    {"tolist",
+     (PyCFunction)IntArray_tolist,
+     METH_NOARGS,
+     "Copy the values into a list of ints"},
+    {nullptr}};
+
+PyType_Slot IntArray_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(IntArray_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(IntArray_repr)},
+    {Py_sq_length, reinterpret_cast<void*>(IntArray_len)},
+    {Py_sq_item, reinterpret_cast<void*>(IntArray_get)},
+    {Py_sq_ass_item, reinterpret_cast<void*>(IntArray_set)},
+    {Py_mp_length, reinterpret_cast<void*>(IntArray_len)},
+    {Py_mp_subscript, reinterpret_cast<void*>(IntArray_subscript)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(IntArray_getbuffer)},
+    {Py_bf_releasebuffer, reinterpret_cast<void*>(IntArray_releasebuffer)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("Contiguous array of int64 values"))},
+    {Py_tp_richcompare, reinterpret_cast<void*>(IntArray_compare)},
+    {Py_tp_methods, IntArray_Methods},
+    {Py_tp_init, reinterpret_cast<void*>(IntArray_init)},
+    {Py_tp_new, reinterpret_cast<void*>(IntArray_new)},
+    {0, nullptr}};
+
+PyType_Spec IntArray_Spec = {
+    .name = "oatmeal.IntArray",
+    .basicsize = sizeof(IntArray),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = IntArray_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// IntArray method definitions.
+//--------------------------------------------------------------------------------------------------
+IntArray* IntArray_create(OatmealState* st, Py_ssize_t count) {
+  auto* self = reinterpret_cast<IntArray*>(
+      IntArray_new(st->int_array_type, nullptr, nullptr));
+
+  if (self == nullptr) {
+    return nullptr;
+  }
+
+  if (!IntArray_reserve(self, count)) {
+    Py_DECREF(self);
+    PyErr_NoMemory();
+    return nullptr;
+  }
+
+  std::fill(self->values, self->values + count, 0);
+  self->count = count;
+
+  return self;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool IntArray_reserve(IntArray* self, Py_ssize_t capacity) {
+  if (capacity <= self->capacity) {
+    return true;
+  }
+
+  auto* values = PyMem_RawRealloc(self->values, capacity * sizeof(int64_t));
+
+  if (values == nullptr) {
+    return false;
+  }
+
+  self->values = static_cast<int64_t*>(values);
+  self->capacity = capacity;
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntArray_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<IntArray*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    self->count = 0;
+    self->capacity = 0;
+    self->values = nullptr;
+    self->exports = 0;
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int IntArray_init(IntArray* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"values", nullptr};
+  PyObject* values = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|O", const_cast<char**>(kwlist), &values)) {
+    return -1;
+  }
+
+  if (self->exports > 0) {
+    PyErr_SetString(
+        PyExc_BufferError, "cannot reinitialize IntArray while it is exported");
+    return -1;
+  }
+
+  self->count = 0;
+
+  if (values == nullptr) {
+    return 0;
+  }
+
+  const auto size_hint = PyObject_LengthHint(values, 0);
+
+  if (size_hint < 0) {
+    return -1;
+  }
+
+  if (!IntArray_reserve(self, size_hint)) {
+    PyErr_NoMemory();
+    return -1;
+  }
+
+  PyObject* iter = PyObject_GetIter(values);
+
+  if (iter == nullptr) {
+    return -1;
+  }
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    const auto value = PyLong_AsLongLong(item);
+    Py_DECREF(item);
+
+    if (value == -1 && PyErr_Occurred()) {
+      Py_DECREF(iter);
+      return -1;
+    }
+
+    if (!IntArray_push_back(self, value)) {
+      Py_DECREF(iter);
+      PyErr_NoMemory();
+      return -1;
+    }
+  }
+
+  Py_DECREF(iter);
+  return PyErr_Occurred() ? -1 : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void IntArray_dealloc(PyObject* obj_self) {
+  PyMem_RawFree(reinterpret_cast<IntArray*>(obj_self)->values);
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntArray_tolist(IntArray* self, PyObject*) {
+  PyObject* result = PyList_New(self->count);
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (Py_ssize_t i = 0; i < self->count; ++i) {
+    PyObject* value = PyLong_FromLongLong(self->values[i]);
+
+    if (value == nullptr) {
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(result, i, value);
+  }
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntArray_repr(PyObject* obj_self) {
+  const auto* self = reinterpret_cast<IntArray*>(obj_self);
+  std::string text = "IntArray([";
+
+  for (Py_ssize_t i = 0; i < self->count; ++i) {
+    text += i > 0 ? ", " : "";
+    text += std::to_string(self->values[i]);
+  }
+
+  text += "])";
+  return PyUnicode_FromStringAndSize(text.data(), text.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t IntArray_len(PyObject* self) {
+  return reinterpret_cast<IntArray*>(self)->count;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntArray_get(PyObject* obj_self, Py_ssize_t index) {
+  const auto* self = reinterpret_cast<IntArray*>(obj_self);
+
+  // Negative indices were already wrapped by the sequence protocol.
+  if (index < 0 || index >= self->count) {
+    PyErr_SetString(PyExc_IndexError, "int array index out of range");
+    return nullptr;
+  }
+
+  return PyLong_FromLongLong(self->values[index]);
+}
+
+//--------------------------------------------------------------------------------------------------
+int IntArray_set(PyObject* obj_self, Py_ssize_t index, PyObject* obj_value) {
+  auto* self = reinterpret_cast<IntArray*>(obj_self);
+
+  if (obj_value == nullptr) {
+    PyErr_SetString(
+        PyExc_NotImplementedError, "int array does not support deletion");
+    return -1;
+  }
+
+  if (index < 0 || index >= self->count) {
+    PyErr_SetString(PyExc_IndexError, "int array index out of range");
+    return -1;
+  }
+
+  const auto value = PyLong_AsLongLong(obj_value);
+
+  if (value == -1 && PyErr_Occurred()) {
+    return -1;
+  }
+
+  self->values[index] = value;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntArray_subscript(PyObject* obj_self, PyObject* index) {
+  const auto* self = reinterpret_cast<IntArray*>(obj_self);
+
+  if (!PySlice_Check(index)) {
+    auto i = PyNumber_AsSsize_t(index, PyExc_IndexError);
+
+    if (i == -1 && PyErr_Occurred()) {
+      return nullptr;
+    }
+
+    return IntArray_get(obj_self, i < 0 ? i + self->count : i);
+  }
+
+  Py_ssize_t start = 0;
+  Py_ssize_t stop = 0;
+  Py_ssize_t step = 0;
+
+  if (PySlice_Unpack(index, &start, &stop, &step) < 0) {
+    return nullptr;
+  }
+
+  const auto count = PySlice_AdjustIndices(self->count, &start, &stop, step);
+  auto* result = IntArray_create(Oatmeal_object_state(obj_self), count);
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (Py_ssize_t i = 0, from = start; i < count; ++i, from += step) {
+    result->values[i] = self->values[from];
+  }
+
+  return reinterpret_cast<PyObject*>(result);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntArray_compare(PyObject* obj_self, PyObject* obj_other, int op) {
+  if (op != Py_EQ && op != Py_NE) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  const auto* self = reinterpret_cast<IntArray*>(obj_self);
+
+  if (PyObject_TypeCheck(obj_other, Py_TYPE(obj_self)) != 0) {
+    const auto* other = reinterpret_cast<IntArray*>(obj_other);
+    const bool equal =
+        self->count == other->count &&
+        std::equal(self->values, self->values + self->count, other->values);
+
+    return PyBool_FromLong(equal == (op == Py_EQ));
+  }
+
+  // Lists and tuples compare element wise so parsed values can be checked
+  // against literals.
+  if (!PyList_Check(obj_other) && !PyTuple_Check(obj_other)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  bool equal = self->count == PySequence_Fast_GET_SIZE(obj_other);
+
+  for (Py_ssize_t i = 0; equal && i < self->count; ++i) {
+    PyObject* value = PyLong_FromLongLong(self->values[i]);
+
+    if (value == nullptr) {
+      return nullptr;
+    }
+
+    const int result = PyObject_RichCompareBool(
+        value, PySequence_Fast_GET_ITEM(obj_other, i), Py_EQ);
+    Py_DECREF(value);
+
+    if (result < 0) {
+      return nullptr;
+    }
+
+    equal = result == 1;
+  }
+
+  return PyBool_FromLong(equal == (op == Py_EQ));
+}
+
+//--------------------------------------------------------------------------------------------------
+int IntArray_getbuffer(PyObject* obj_self, Py_buffer* view, int flags) {
+  auto* self = reinterpret_cast<IntArray*>(obj_self);
+
+  // Empty arrays have no storage, but buffers still need a valid pointer.
+  static int64_t empty = 0;
+
+  view->obj = Py_NewRef(obj_self);
+  view->buf = self->values != nullptr ? self->values : &empty;
+  view->len = self->count * static_cast<Py_ssize_t>(sizeof(int64_t));
+  view->readonly = 0;
+  view->itemsize = sizeof(int64_t);
+  view->format = (flags & PyBUF_FORMAT) != 0 ? const_cast<char*>("q") : nullptr;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &self->count : nullptr;
+  view->strides =
+      (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &view->itemsize : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+
+  self->exports++;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void IntArray_releasebuffer(PyObject* obj_self, Py_buffer*) {
+  reinterpret_cast<IntArray*>(obj_self)->exports--;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Int64Buffer definitions.
+//--------------------------------------------------------------------------------------------------
+bool Int64Buffer::open(PyObject* obj, const char* name, bool writable) {
+  const int flags =
+      PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+
+  if (PyObject_GetBuffer(obj, &view_, flags) < 0) {
+    return false;
+  }
+
+  // Native and standard size formats both describe an int64 when the item is
+  // eight bytes.
+  const char* format = view_.format != nullptr ? view_.format : "B";
+  format += *format == '@' || *format == '=' ? 1 : 0;
+
+  const std::string_view code(format);
+
+  if (view_.itemsize != sizeof(int64_t) || (code != "q" && code != "l")) {
+    PyErr_Format(
+        PyExc_TypeError, "argument `%s` must be a buffer of int64 values", name);
+    return false;
+  }
+
+  return true;
+}
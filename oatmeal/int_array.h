@@ -0,0 +1,116 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstdint>
+
+/**
+ * Growable contiguous array of int64 values. Storage comes from the raw
+ * allocator so native code can fill an array without holding the GIL.
+ */
+typedef struct {
+  PyObject_HEAD Py_ssize_t count;
+  Py_ssize_t capacity;
+  int64_t* values;
+  /** Number of live buffer exports. Values cannot be reallocated while > 0. */
+  Py_ssize_t exports;
+} IntArray;
+
+/** Python type spec for `IntArray`. */
+extern PyType_Spec IntArray_Spec;
+
+/**
+ * Create a new array of `count` zero values, of the `IntArray` type of the
+ * module with state `st`. Returns a new reference, or null with an exception
+ * set on failure.
+ */
+IntArray* IntArray_create(OatmealState* st, Py_ssize_t count);
+
+/**
+ * Grow the array so it can hold at least `capacity` values. Returns false on
+ * allocation failure without setting an exception, so it is safe to call with
+ * the GIL released.
+ */
+bool IntArray_reserve(IntArray* self, Py_ssize_t capacity);
+
+/**
+ * Add a value to the end of the array, doubling the capacity when full.
+ * Returns false on allocation failure without setting an exception.
+ */
+inline bool IntArray_push_back(IntArray* self, int64_t value) {
+  if (self->count == self->capacity &&
+      !IntArray_reserve(self, self->capacity < 8 ? 8 : self->capacity * 2)) {
+    return false;
+  }
+
+  self->values[self->count++] = value;
+  return true;
+}
+
+/** __new__(type, *args, **kwds) -> IntArray */
+PyObject* IntArray_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, values: Iterable[int] = ()) */
+int IntArray_init(IntArray* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the array and release its storage. */
+void IntArray_dealloc(PyObject* self);
+
+/** tolist(self) -> list[int] */
+PyObject* IntArray_tolist(IntArray* self, PyObject*);
+
+/** repr(self) -> str */
+PyObject* IntArray_repr(PyObject* self);
+
+/** len(self) -> int */
+Py_ssize_t IntArray_len(PyObject* self);
+
+/** __getitem__(self, index: int) -> int */
+PyObject* IntArray_get(PyObject* self, Py_ssize_t index);
+
+/** __setitem__(self, index: int, value: int) */
+int IntArray_set(PyObject* self, Py_ssize_t index, PyObject* value);
+
+/** __getitem__(self, index: int | slice) -> int | IntArray */
+PyObject* IntArray_subscript(PyObject* self, PyObject* index);
+
+/**
+ * __eq__(left: IntArray, right: IntArray | Sequence[int]) -> bool
+ * __ne__(left: IntArray, right: IntArray | Sequence[int]) -> bool
+ */
+PyObject* IntArray_compare(PyObject* self, PyObject* other, int op);
+
+/** Buffer protocol export as a 1d array of int64 values. */
+int IntArray_getbuffer(PyObject* self, Py_buffer* view, int flags);
+
+/** Buffer protocol release. */
+void IntArray_releasebuffer(PyObject* self, Py_buffer* view);
+
+/**
+ * Read only or writable view of any C contiguous buffer of int64 values, such
+ * as an `IntArray`, which is released when it goes out of scope.
+ */
+class Int64Buffer {
+public:
+  Int64Buffer() = default;
+  Int64Buffer(const Int64Buffer&) = delete;
+  Int64Buffer& operator=(const Int64Buffer&) = delete;
+
+  ~Int64Buffer() {
+    if (view_.obj != nullptr) {
+      PyBuffer_Release(&view_);
+    }
+  }
+
+  /**
+   * Acquire the buffer of `obj`, raising TypeError naming the argument `name`
+   * if it does not hold int64 values.
+   */
+  bool open(PyObject* obj, const char* name, bool writable);
+
+  int64_t* data() const { return static_cast<int64_t*>(view_.buf); }
+  size_t size() const { return view_.len / sizeof(int64_t); }
+
+private:
+  Py_buffer view_ = {};
+};
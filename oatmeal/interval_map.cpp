@@ -0,0 +1,675 @@
+#include "interval_map.h"
+#include "int_array.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <string>
+
+namespace {
+  constexpr int64_t kMinValue = std::numeric_limits<int64_t>::min();
+  constexpr int64_t kMaxValue = std::numeric_limits<int64_t>::max();
+
+  /** Add two values modulo 2^64. */
+  int64_t wrapping_add(int64_t a, int64_t b) {
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+  }
+
+  /** Subtract two values modulo 2^64. */
+  int64_t wrapping_sub(int64_t a, int64_t b) {
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// IntervalTable definitions.
+//--------------------------------------------------------------------------------------------------
+bool IntervalTable::add(int64_t start, int64_t end, int64_t offset) {
+  if (start >= end) {
+    return true;
+  }
+
+  const auto next = std::lower_bound(
+      intervals_.begin(),
+      intervals_.end(),
+      start,
+      [](const Interval& interval, int64_t value) {
+        return interval.start < value;
+      });
+
+  if ((next != intervals_.end() && next->start < end) ||
+      (next != intervals_.begin() && std::prev(next)->end > start)) {
+    return false;
+  }
+
+  intervals_.insert(next, Interval{start, end, offset});
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+template <typename Fn>
+void IntervalTable::for_each_piece(int64_t lo, int64_t hi, Fn fn) const {
+  // Intervals never overlap, so they are sorted by end as well as by start.
+  auto itr = std::upper_bound(
+      intervals_.begin(),
+      intervals_.end(),
+      lo,
+      [](int64_t value, const Interval& interval) {
+        return value < interval.end;
+      });
+
+  for (auto pos = lo; pos < hi;) {
+    if (itr == intervals_.end() || itr->start >= hi) {
+      fn(pos, hi, 0);
+      return;
+    }
+
+    if (itr->start > pos) {
+      fn(pos, itr->start, 0);
+      pos = itr->start;
+    }
+
+    const auto end = std::min(itr->end, hi);
+    fn(pos, end, itr->offset);
+
+    pos = end;
+    ++itr;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+int64_t IntervalTable::map(int64_t value) const {
+  // Find the last interval starting at or before the value.
+  const auto next = std::upper_bound(
+      intervals_.begin(),
+      intervals_.end(),
+      value,
+      [](int64_t v, const Interval& interval) { return v < interval.start; });
+
+  if (next == intervals_.begin() || std::prev(next)->end <= value) {
+    return value;
+  }
+
+  return wrapping_add(value, std::prev(next)->offset);
+}
+
+//--------------------------------------------------------------------------------------------------
+void IntervalTable::map_many(
+    const int64_t* values,
+    int64_t* out,
+    size_t count) const {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = map(values[i]);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+int64_t IntervalTable::map_min(const int64_t* values, size_t count) const {
+  auto result = map(values[0]);
+
+  for (size_t i = 1; i < count; ++i) {
+    result = std::min(result, map(values[i]));
+  }
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::vector<IntervalTable::Range> IntervalTable::map_ranges(
+    std::vector<Range> ranges) const {
+  std::vector<Range> mapped;
+
+  for (const auto& [lo, hi] : ranges) {
+    for_each_piece(lo, hi, [&](int64_t start, int64_t end, int64_t offset) {
+      mapped.emplace_back(
+          wrapping_add(start, offset), wrapping_add(end, offset));
+    });
+  }
+
+  std::sort(mapped.begin(), mapped.end());
+
+  // Reuse the input storage for the merged output.
+  ranges.clear();
+
+  for (const auto& range : mapped) {
+    if (!ranges.empty() && range.first <= ranges.back().second) {
+      ranges.back().second = std::max(ranges.back().second, range.second);
+    } else {
+      ranges.push_back(range);
+    }
+  }
+
+  return ranges;
+}
+
+//--------------------------------------------------------------------------------------------------
+IntervalTable IntervalTable::then(const IntervalTable& next) const {
+  IntervalTable result;
+
+  // Every piece of this table, gaps included, maps to a contiguous image that
+  // is split again by the pieces of `next`. Walking the pieces in order keeps
+  // the output sorted, so it can be appended without searching.
+  for_each_piece(
+      kMinValue, kMaxValue, [&](int64_t start, int64_t end, int64_t offset) {
+        next.for_each_piece(
+            wrapping_add(start, offset),
+            wrapping_add(end, offset),
+            [&](int64_t next_start, int64_t next_end, int64_t next_offset) {
+              result.push_back(
+                  wrapping_sub(next_start, offset),
+                  wrapping_sub(next_end, offset),
+                  wrapping_add(offset, next_offset));
+            });
+      });
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+void IntervalTable::push_back(int64_t start, int64_t end, int64_t offset) {
+  // Identity pieces are implied by the gaps between intervals.
+  if (start >= end || offset == 0) {
+    return;
+  }
+
+  if (!intervals_.empty() && intervals_.back().end == start &&
+      intervals_.back().offset == offset) {
+    intervals_.back().end = end;
+  } else {
+    intervals_.push_back({start, end, offset});
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+// IntervalMap python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef IntervalMap_Methods[] = {
+    {"add",
+     (PyCFunction)IntervalMap_add,
+     METH_FASTCALL,
+     "Map `length` values starting at `source_start` onto `dest_start`"},
+    {"map", (PyCFunction)IntervalMap_map, METH_O, "Map a single value"},
+    {"map_many",
+     (PyCFunction)IntervalMap_map_many,
+     METH_VARARGS | METH_KEYWORDS,
+     "Map every value in an int64 buffer, in place unless `out` is given"},
+    {"map_min",
+     (PyCFunction)IntervalMap_map_min,
+     METH_VARARGS | METH_KEYWORDS,
+     "Smallest mapped value of an int64 buffer"},
+    {"map_ranges",
+     (PyCFunction)IntervalMap_map_ranges,
+     METH_O,
+     "Map a set of half open `(start, end)` ranges, returning the sorted and "
+     "merged ranges they map onto"},
+    {"then",
+     (PyCFunction)IntervalMap_then,
+     METH_O,
+     "Single map equivalent to applying this map and then `other`"},
+    {"items",
+     (PyCFunction)IntervalMap_items,
+     METH_NOARGS,
+     "List of `(source_start, dest_start, length)` for each interval"},
+    {nullptr}};
+
+PyType_Slot IntervalMap_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(IntervalMap_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(IntervalMap_repr)},
+    {Py_sq_length, reinterpret_cast<void*>(IntervalMap_len)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("Sorted non overlapping integer intervals, "
+                                 "each shifted by an offset"))},
+    {Py_tp_richcompare, reinterpret_cast<void*>(IntervalMap_compare)},
+    {Py_tp_methods, IntervalMap_Methods},
+    {Py_tp_init, reinterpret_cast<void*>(IntervalMap_init)},
+    {Py_tp_new, reinterpret_cast<void*>(IntervalMap_new)},
+    {0, nullptr}};
+
+PyType_Spec IntervalMap_Spec = {
+    .name = "oatmeal.IntervalMap",
+    .basicsize = sizeof(IntervalMap),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = IntervalMap_Slots,
+};
+
+namespace {
+  /**
+   * Validate an entry and add it to the map, raising ValueError if it is
+   * negative in length, overlaps another entry or runs past the int64 range.
+   */
+  bool add_entry(
+      IntervalMap* self,
+      PyObject* obj_source,
+      PyObject* obj_dest,
+      PyObject* obj_length) {
+    const auto source = PyLong_AsLongLong(obj_source);
+    const auto dest = source == -1 && PyErr_Occurred()
+                          ? -1
+                          : PyLong_AsLongLong(obj_dest);
+    const auto length = dest == -1 && PyErr_Occurred()
+                            ? -1
+                            : PyLong_AsLongLong(obj_length);
+
+    if (PyErr_Occurred()) {
+      return false;
+    }
+
+    if (length < 0) {
+      PyErr_SetString(PyExc_ValueError, "interval length must not be negative");
+      return false;
+    }
+
+    // Both ends must be representable so mapped ranges never overflow.
+    if (source > kMaxValue - length || dest > kMaxValue - length) {
+      PyErr_SetString(PyExc_OverflowError, "interval does not fit in int64");
+      return false;
+    }
+
+    if (!self->table.add(
+            source, source + length, wrapping_sub(dest, source))) {
+      PyErr_Format(
+          PyExc_ValueError,
+          "interval [%lld, %lld) overlaps an existing interval",
+          static_cast<long long>(source),
+          static_cast<long long>(source + length));
+      return false;
+    }
+
+    return true;
+  }
+
+  /** Read a `(start, end)` pair, raising TypeError if it is not one. */
+  bool read_range(PyObject* obj, IntervalTable::Range* out) {
+    PyObject* seq = PySequence_Fast(obj, "ranges must be (start, end) pairs");
+
+    if (seq == nullptr) {
+      return false;
+    }
+
+    if (PySequence_Fast_GET_SIZE(seq) != 2) {
+      PyErr_SetString(PyExc_TypeError, "ranges must be (start, end) pairs");
+      Py_DECREF(seq);
+      return false;
+    }
+
+    out->first = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(seq, 0));
+    out->second = PyErr_Occurred()
+                      ? 0
+                      : PyLong_AsLongLong(PySequence_Fast_GET_ITEM(seq, 1));
+    Py_DECREF(seq);
+
+    return !PyErr_Occurred();
+  }
+
+  /** Values mapped by one task when a buffer is split across threads. */
+  constexpr size_t kChunkSize = size_t{1} << 16;
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// IntervalMap method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<IntervalMap*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    new (&self->table) IntervalTable();
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int IntervalMap_init(IntervalMap* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"entries", nullptr};
+  PyObject* entries = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|O", const_cast<char**>(kwlist), &entries)) {
+    return -1;
+  }
+
+  self->table = IntervalTable();
+
+  if (entries == nullptr) {
+    return 0;
+  }
+
+  PyObject* iter = PyObject_GetIter(entries);
+
+  if (iter == nullptr) {
+    return -1;
+  }
+
+  const char* entry_error =
+      "entries must be (source_start, dest_start, length) tuples";
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    PyObject* entry = PySequence_Fast(item, entry_error);
+    Py_DECREF(item);
+
+    bool added = false;
+
+    if (entry != nullptr && PySequence_Fast_GET_SIZE(entry) != 3) {
+      PyErr_SetString(PyExc_TypeError, entry_error);
+    } else if (entry != nullptr) {
+      added = add_entry(
+          self,
+          PySequence_Fast_GET_ITEM(entry, 0),
+          PySequence_Fast_GET_ITEM(entry, 1),
+          PySequence_Fast_GET_ITEM(entry, 2));
+    }
+
+    Py_XDECREF(entry);
+
+    if (!added) {
+      Py_DECREF(iter);
+      return -1;
+    }
+  }
+
+  Py_DECREF(iter);
+  return PyErr_Occurred() ? -1 : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void IntervalMap_dealloc(PyObject* obj_self) {
+  reinterpret_cast<IntervalMap*>(obj_self)->table.~IntervalTable();
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_add(
+    IntervalMap* self,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  if (nargs != 3) {
+    PyErr_Format(
+        PyExc_TypeError, "add() takes exactly 3 arguments (%zd given)", nargs);
+    return nullptr;
+  }
+
+  if (!add_entry(self, args[0], args[1], args[2])) {
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_map(IntervalMap* self, PyObject* obj_value) {
+  const auto value = PyLong_AsLongLong(obj_value);
+
+  if (value == -1 && PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  return PyLong_FromLongLong(self->table.map(value));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_map_many(
+    IntervalMap* self,
+    PyObject* args,
+    PyObject* kwds) {
+  const char* kwlist[] = {"values", "out", "threads", nullptr};
+  PyObject* obj_values = nullptr;
+  PyObject* obj_out = Py_None;
+  Py_ssize_t threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "O|On",
+          const_cast<char**>(kwlist),
+          &obj_values,
+          &obj_out,
+          &threads)) {
+    return nullptr;
+  }
+
+  const bool in_place = obj_out == Py_None;
+  Int64Buffer values;
+  Int64Buffer out;
+
+  if (!values.open(obj_values, "values", in_place) ||
+      (!in_place && !out.open(obj_out, "out", true))) {
+    return nullptr;
+  }
+
+  if (!in_place && out.size() != values.size()) {
+    PyErr_SetString(
+        PyExc_ValueError, "arguments `values` and `out` must be the same size");
+    return nullptr;
+  }
+
+  // The workers read a copy, so the map can change while they run.
+  const IntervalTable table = self->table;
+  const auto* in = values.data();
+  auto* dest = in_place ? values.data() : out.data();
+  const auto count = values.size();
+
+  Py_BEGIN_ALLOW_THREADS;
+  parallel_for(
+      (count + kChunkSize - 1) / kChunkSize,
+      worker_count(threads),
+      []() { return 0; },
+      [&](int, size_t chunk) {
+        const auto begin = chunk * kChunkSize;
+        const auto size = std::min(kChunkSize, count - begin);
+        table.map_many(in + begin, dest + begin, size);
+      });
+  Py_END_ALLOW_THREADS;
+
+  return Py_NewRef(in_place ? obj_values : obj_out);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_map_min(
+    IntervalMap* self,
+    PyObject* args,
+    PyObject* kwds) {
+  const char* kwlist[] = {"values", "threads", nullptr};
+  PyObject* obj_values = nullptr;
+  Py_ssize_t threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "O|n",
+          const_cast<char**>(kwlist),
+          &obj_values,
+          &threads)) {
+    return nullptr;
+  }
+
+  Int64Buffer values;
+
+  if (!values.open(obj_values, "values", false)) {
+    return nullptr;
+  }
+
+  const auto count = values.size();
+
+  if (count == 0) {
+    PyErr_SetString(PyExc_ValueError, "map_min() of an empty buffer");
+    return nullptr;
+  }
+
+  const IntervalTable table = self->table;
+  const auto* in = values.data();
+  std::vector<int64_t> minimums((count + kChunkSize - 1) / kChunkSize);
+
+  // Each chunk reduces into its own slot, and the slots are reduced at the
+  // end, so the workers never share a running minimum.
+  Py_BEGIN_ALLOW_THREADS;
+  parallel_for(
+      minimums.size(),
+      worker_count(threads),
+      []() { return 0; },
+      [&](int, size_t chunk) {
+        const auto begin = chunk * kChunkSize;
+        const auto size = std::min(kChunkSize, count - begin);
+        minimums[chunk] = table.map_min(in + begin, size);
+      });
+  Py_END_ALLOW_THREADS;
+
+  return PyLong_FromLongLong(
+      *std::min_element(minimums.begin(), minimums.end()));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_map_ranges(IntervalMap* self, PyObject* obj_ranges) {
+  PyObject* iter = PyObject_GetIter(obj_ranges);
+
+  if (iter == nullptr) {
+    return nullptr;
+  }
+
+  std::vector<IntervalTable::Range> ranges;
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    IntervalTable::Range range;
+    const bool ok = read_range(item, &range);
+    Py_DECREF(item);
+
+    if (!ok) {
+      Py_DECREF(iter);
+      return nullptr;
+    }
+
+    ranges.push_back(range);
+  }
+
+  Py_DECREF(iter);
+
+  if (PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  const auto mapped = self->table.map_ranges(std::move(ranges));
+  PyObject* result = PyList_New(static_cast<Py_ssize_t>(mapped.size()));
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < mapped.size(); ++i) {
+    PyObject* range = Py_BuildValue(
+        "(LL)",
+        static_cast<long long>(mapped[i].first),
+        static_cast<long long>(mapped[i].second));
+
+    if (range == nullptr) {
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(result, static_cast<Py_ssize_t>(i), range);
+  }
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_then(IntervalMap* self, PyObject* obj_other) {
+  auto* type = Py_TYPE(self);
+
+  if (PyObject_TypeCheck(obj_other, type) == 0) {
+    PyErr_SetString(
+        PyExc_TypeError, "argument `other` must be of type `IntervalMap`");
+    return nullptr;
+  }
+
+  auto* result =
+      reinterpret_cast<IntervalMap*>(IntervalMap_new(type, nullptr, nullptr));
+
+  if (result != nullptr) {
+    result->table =
+        self->table.then(reinterpret_cast<IntervalMap*>(obj_other)->table);
+  }
+
+  return reinterpret_cast<PyObject*>(result);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_items(IntervalMap* self, PyObject*) {
+  const auto& intervals = self->table.intervals();
+  PyObject* result = PyList_New(static_cast<Py_ssize_t>(intervals.size()));
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < intervals.size(); ++i) {
+    const auto& interval = intervals[i];
+    PyObject* item = Py_BuildValue(
+        "(LLL)",
+        static_cast<long long>(interval.start),
+        static_cast<long long>(wrapping_add(interval.start, interval.offset)),
+        static_cast<long long>(interval.end - interval.start));
+
+    if (item == nullptr) {
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(result, static_cast<Py_ssize_t>(i), item);
+  }
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_repr(PyObject* obj_self) {
+  const auto& intervals =
+      reinterpret_cast<IntervalMap*>(obj_self)->table.intervals();
+  std::string text = "IntervalMap([";
+
+  for (size_t i = 0; i < intervals.size(); ++i) {
+    const auto& interval = intervals[i];
+
+    text += i > 0 ? ", (" : "(";
+    text += std::to_string(interval.start);
+    text += ", ";
+    text += std::to_string(wrapping_add(interval.start, interval.offset));
+    text += ", ";
+    text += std::to_string(interval.end - interval.start);
+    text += ")";
+  }
+
+  text += "])";
+  return PyUnicode_FromStringAndSize(text.data(), text.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t IntervalMap_len(PyObject* self) {
+  return static_cast<Py_ssize_t>(
+      reinterpret_cast<IntervalMap*>(self)->table.intervals().size());
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* IntervalMap_compare(PyObject* obj_self, PyObject* obj_other, int op) {
+  if ((op != Py_EQ && op != Py_NE) ||
+      PyObject_TypeCheck(obj_other, Py_TYPE(obj_self)) == 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  const auto& a = reinterpret_cast<IntervalMap*>(obj_self)->table.intervals();
+  const auto& b = reinterpret_cast<IntervalMap*>(obj_other)->table.intervals();
+
+  const bool equal = std::equal(
+      a.begin(),
+      a.end(),
+      b.begin(),
+      b.end(),
+      [](const auto& x, const auto& y) {
+        return x.start == y.start && x.end == y.end && x.offset == y.offset;
+      });
+
+  return PyBool_FromLong(equal == (op == Py_EQ));
+}
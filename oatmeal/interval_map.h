@@ -0,0 +1,152 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Piecewise shift of the integers. Each interval `[start, end)` maps a value
+ * `v` to `v + offset`, and values outside every interval map to themselves.
+ * Intervals are kept sorted by start and never overlap, so lookups are a
+ * binary search.
+ */
+class IntervalTable {
+public:
+  /** Values in `[start, end)` map to `value + offset`. */
+  struct Interval {
+    int64_t start;
+    int64_t end;
+    /** Stored modulo 2^64 so composing offsets can never overflow. */
+    int64_t offset;
+  };
+
+  /** Half open range of values `[first, second)`. */
+  using Range = std::pair<int64_t, int64_t>;
+
+  /** Sorted, non overlapping intervals. */
+  const std::vector<Interval>& intervals() const { return intervals_; }
+
+  /**
+   * Add an interval. Returns false if it overlaps an existing interval, in
+   * which case the table is unchanged. Empty intervals are ignored.
+   */
+  bool add(int64_t start, int64_t end, int64_t offset);
+
+  /** Map a single value. */
+  int64_t map(int64_t value) const;
+
+  /** Map `count` values into `out`, which may be the same as `values`. */
+  void map_many(const int64_t* values, int64_t* out, size_t count) const;
+
+  /** Smallest of `count` mapped values, where `count` is not zero. */
+  int64_t map_min(const int64_t* values, size_t count) const;
+
+  /**
+   * Map every value in a set of ranges. The result is sorted with touching
+   * and overlapping ranges merged, so it is the smallest set of ranges that
+   * exactly covers every mapped value.
+   */
+  std::vector<Range> map_ranges(std::vector<Range> ranges) const;
+
+  /** Table which maps a value through this table and then through `next`. */
+  IntervalTable then(const IntervalTable& next) const;
+
+private:
+  /**
+   * Call `fn(start, end, offset)` for each piece of `[lo, hi)`, in order,
+   * where a piece is the part of an interval or of a gap between intervals
+   * that lies inside the range. Gaps have an offset of zero.
+   */
+  template <typename Fn>
+  void for_each_piece(int64_t lo, int64_t hi, Fn fn) const;
+
+  /**
+   * Append an interval that starts at or after the end of the last one,
+   * merging it into the last interval when they touch with the same offset.
+   */
+  void push_back(int64_t start, int64_t end, int64_t offset);
+
+  std::vector<Interval> intervals_;
+};
+
+/** Python wrapper around an `IntervalTable`. */
+typedef struct {
+  PyObject_HEAD IntervalTable table;
+} IntervalMap;
+
+/** Python type spec for `IntervalMap`. */
+extern PyType_Spec IntervalMap_Spec;
+
+/** __new__(type, *args, **kwds) -> IntervalMap */
+PyObject* IntervalMap_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, entries: Iterable[Tuple[int, int, int]] = ()) */
+int IntervalMap_init(IntervalMap* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the map. */
+void IntervalMap_dealloc(PyObject* self);
+
+/** add(self, source_start: int, dest_start: int, length: int) */
+PyObject* IntervalMap_add(
+    IntervalMap* self,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+
+/** map(self, value: int) -> int */
+PyObject* IntervalMap_map(IntervalMap* self, PyObject* value);
+
+/**
+ * map_many(
+ *  self,
+ *  values: Buffer,
+ *  out: Buffer | None = None,
+ *  threads: int = 0,
+ * ) -> Buffer
+ *
+ * Map every value in a contiguous int64 buffer such as an `IntArray`, writing
+ * the results to `out` or back into `values` when no `out` is given, and
+ * return the buffer that was written. Large buffers are split into chunks that
+ * are mapped on `threads` worker threads without holding the GIL, where zero
+ * picks one thread per core.
+ */
+PyObject* IntervalMap_map_many(
+    IntervalMap* self,
+    PyObject* args,
+    PyObject* kwds);
+
+/**
+ * map_min(self, values: Buffer, threads: int = 0) -> int
+ *
+ * Smallest mapped value of a contiguous int64 buffer, found in the same pass
+ * that maps the values so nothing is written back. Threads are used as for
+ * `map_many`, and an empty buffer raises ValueError.
+ */
+PyObject* IntervalMap_map_min(
+    IntervalMap* self,
+    PyObject* args,
+    PyObject* kwds);
+
+/**
+ * map_ranges(self, ranges: Iterable[Tuple[int, int]]) -> list[Tuple[int, int]]
+ */
+PyObject* IntervalMap_map_ranges(IntervalMap* self, PyObject* ranges);
+
+/** then(self, other: IntervalMap) -> IntervalMap */
+PyObject* IntervalMap_then(IntervalMap* self, PyObject* other);
+
+/** items(self) -> list[Tuple[int, int, int]] */
+PyObject* IntervalMap_items(IntervalMap* self, PyObject*);
+
+/** repr(self) -> str */
+PyObject* IntervalMap_repr(PyObject* self);
+
+/** len(self) -> int */
+Py_ssize_t IntervalMap_len(PyObject* self);
+
+/**
+ * __eq__(left: IntervalMap, right: IntervalMap) -> bool
+ * __ne__(left: IntervalMap, right: IntervalMap) -> bool
+ */
+PyObject* IntervalMap_compare(PyObject* self, PyObject* other, int op);
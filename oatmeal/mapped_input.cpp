@@ -0,0 +1,785 @@
+#include "mapped_input.h"
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// MappedFile definitions.
+//--------------------------------------------------------------------------------------------------
+#if defined(_WIN32)
+bool MappedFile::open(PyObject* path) {
+  close();
+
+  PyObject* decoded = nullptr;
+
+  if (!PyUnicode_FSDecoder(path, &decoded)) {
+    return false;
+  }
+
+  wchar_t* wide_path = PyUnicode_AsWideCharString(decoded, nullptr);
+  Py_DECREF(decoded);
+
+  if (wide_path == nullptr) {
+    return false;
+  }
+
+  HANDLE file = CreateFileW(
+      wide_path,
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr);
+  PyMem_Free(wide_path);
+
+  LARGE_INTEGER file_size = {};
+
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size)) {
+    PyErr_SetExcFromWindowsErrWithFilenameObject(
+        PyExc_OSError, static_cast<int>(GetLastError()), path);
+
+    if (file != INVALID_HANDLE_VALUE) {
+      CloseHandle(file);
+    }
+
+    return false;
+  }
+
+  file_ = file;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  is_open_ = true;
+
+  if (size_ == 0) {
+    return true;
+  }
+
+  mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  data_ = mapping_ == nullptr ? nullptr
+                              : static_cast<const char*>(MapViewOfFile(
+                                    mapping_, FILE_MAP_READ, 0, 0, 0));
+
+  if (data_ == nullptr) {
+    PyErr_SetExcFromWindowsErrWithFilenameObject(
+        PyExc_OSError, static_cast<int>(GetLastError()), path);
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+
+  if (file_ != nullptr) {
+    CloseHandle(file_);
+  }
+
+  data_ = nullptr;
+  mapping_ = nullptr;
+  file_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+#else
+bool MappedFile::open(PyObject* path) {
+  close();
+
+  PyObject* encoded = nullptr;
+
+  if (!PyUnicode_FSConverter(path, &encoded)) {
+    return false;
+  }
+
+  const int fd = ::open(PyBytes_AS_STRING(encoded), O_RDONLY | O_CLOEXEC);
+  Py_DECREF(encoded);
+
+  struct stat info = {};
+
+  if (fd < 0 || fstat(fd, &info) != 0 || S_ISDIR(info.st_mode)) {
+    if (fd >= 0 && S_ISDIR(info.st_mode)) {
+      errno = EISDIR;
+    }
+
+    PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+
+    if (fd >= 0) {
+      ::close(fd);
+    }
+
+    return false;
+  }
+
+  size_ = static_cast<size_t>(info.st_size);
+
+  if (size_ > 0) {
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data == MAP_FAILED) {
+      PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+      ::close(fd);
+      size_ = 0;
+      return false;
+    }
+
+    // Lines are indexed and read front to back, so ask for aggressive
+    // read ahead. This is only a hint and failing is harmless.
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+  }
+
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  is_open_ = true;
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// TextSpan definitions.
+//--------------------------------------------------------------------------------------------------
+bool TextSpan::open(PyObject* obj) {
+  if (PyUnicode_Check(obj)) {
+    Py_ssize_t size = 0;
+    data_ = PyUnicode_AsUTF8AndSize(obj, &size);
+    size_ = static_cast<size_t>(size);
+    return data_ != nullptr;
+  }
+
+  if (PyObject_GetBuffer(obj, &view_, PyBUF_SIMPLE) < 0) {
+    PyErr_Format(
+        PyExc_TypeError,
+        "expected str or a bytes like object, not %s",
+        Py_TYPE(obj)->tp_name);
+    return false;
+  }
+
+  data_ = static_cast<const char*>(view_.buf);
+  size_ = static_cast<size_t>(view_.len);
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// MappedInputIterator type definition.
+//--------------------------------------------------------------------------------------------------
+/**
+ * Iterator over the lines of a `MappedInput`. `position` is the next line index
+ * for indexed inputs, or the byte offset of the next line for streaming ones.
+ */
+typedef struct {
+  PyObject_HEAD MappedInput* owner;
+  size_t position;
+} MappedInputIterator;
+
+namespace {
+  /** Returns true for the ASCII characters `str.rstrip()` removes. */
+  bool is_trailing_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r') || (c >= '\x1c' && c <= '\x1f');
+  }
+
+  /** Decode a line of the mapped file as a UTF-8 `str`. */
+  PyObject* decode_line(const MappedInput* self, const MappedLine& line) {
+    return PyUnicode_DecodeUTF8(
+        self->file.data() + line.begin,
+        static_cast<Py_ssize_t>(line.end - line.begin),
+        "strict");
+  }
+
+  /** Raise ValueError and return false if the input has been closed. */
+  bool check_open(const MappedInput* self) {
+    if (!self->file.is_open()) {
+      PyErr_SetString(PyExc_ValueError, "I/O operation on closed input");
+      return false;
+    }
+
+    return true;
+  }
+
+  /** Raise and return false unless the input is open and has a line index. */
+  bool check_indexed(const MappedInput* self) {
+    if (!check_open(self)) {
+      return false;
+    }
+
+    if (self->stream) {
+      PyErr_SetString(
+          PyExc_TypeError, "streaming MappedInput does not support indexing");
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Convert `index` to a position in `self->lines`, wrapping negative values.
+   * Returns -1 with an IndexError set if it is out of range.
+   */
+  Py_ssize_t line_index(const MappedInput* self, PyObject* index) {
+    auto i = PyNumber_AsSsize_t(index, PyExc_IndexError);
+
+    if (i == -1 && PyErr_Occurred()) {
+      return -1;
+    }
+
+    const auto count = static_cast<Py_ssize_t>(self->lines.size());
+
+    if (i < 0) {
+      i += count;
+    }
+
+    if (i < 0 || i >= count) {
+      PyErr_SetString(PyExc_IndexError, "MappedInput index out of range");
+      return -1;
+    }
+
+    return i;
+  }
+
+  /** Record the bounds of every line of a mapped file in `lines`. */
+  void build_index(
+      const char* data,
+      size_t size,
+      std::vector<MappedLine>* lines) {
+    for (size_t offset = 0; offset < size;) {
+      MappedLine line;
+      offset = MappedInput_scan_line(data, size, offset, &line);
+      lines->push_back(line);
+    }
+  }
+
+  void MappedInputIterator_dealloc(PyObject* obj_self) {
+    Py_XDECREF(reinterpret_cast<MappedInputIterator*>(obj_self)->owner);
+    Oatmeal_free(obj_self);
+  }
+
+  PyObject* MappedInputIterator_next(PyObject* obj_self) {
+    auto* self = reinterpret_cast<MappedInputIterator*>(obj_self);
+    const auto* owner = self->owner;
+
+    if (!check_open(owner)) {
+      return nullptr;
+    }
+
+    if (!owner->stream) {
+      if (self->position >= owner->lines.size()) {
+        return nullptr;
+      }
+
+      return decode_line(owner, owner->lines[self->position++]);
+    }
+
+    if (self->position >= owner->file.size()) {
+      return nullptr;
+    }
+
+    MappedLine line;
+    self->position = MappedInput_scan_line(
+        owner->file.data(), owner->file.size(), self->position, &line);
+
+    return decode_line(owner, line);
+  }
+} // namespace
+
+PyType_Slot MappedInputIterator_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(MappedInputIterator_dealloc)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("Iterator over the lines of a mapped input"))},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(MappedInputIterator_next)},
+    {0, nullptr}};
+
+PyType_Spec MappedInputIterator_Spec = {
+    .name = "oatmeal.MappedInputIterator",
+    .basicsize = sizeof(MappedInputIterator),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE |
+             Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = MappedInputIterator_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// MappedInput type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef MappedInput_Methods[] = {
+    {"view",
+     (PyCFunction)MappedInput_view,
+     METH_O,
+     "Zero copy memoryview of a line's bytes"},
+    {"pop",
+     (PyCFunction)MappedInput_pop,
+     METH_FASTCALL,
+     "Remove and return the line at `index`, which defaults to the last line"},
+    {"__reduce__",
+     (PyCFunction)MappedInput_reduce,
+     METH_NOARGS,
+     "Pickle as a plain list of lines"},
+    {"close",
+     (PyCFunction)MappedInput_close,
+     METH_NOARGS,
+     "Unmap the file, after which no lines can be read"},
+    {"__enter__", (PyCFunction)MappedInput_enter, METH_NOARGS, nullptr},
+    {"__exit__", (PyCFunction)MappedInput_exit, METH_VARARGS, nullptr},
+    {nullptr}};
+
+PyGetSetDef MappedInput_GetSet[] = {
+    {"closed",
+     (getter)MappedInput_get_closed,
+     nullptr,
+     "True once the file has been unmapped",
+     nullptr},
+    {"stream",
+     (getter)MappedInput_get_stream,
+     nullptr,
+     "True if lines are scanned while iterating rather than indexed up front",
+     nullptr},
+    {nullptr}};
+
+PyType_Slot MappedInput_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(MappedInput_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(MappedInput_repr)},
+    {Py_sq_length, reinterpret_cast<void*>(MappedInput_len)},
+    {Py_mp_length, reinterpret_cast<void*>(MappedInput_len)},
+    {Py_mp_subscript, reinterpret_cast<void*>(MappedInput_get)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(MappedInput_get_buffer)},
+    {Py_bf_releasebuffer, reinterpret_cast<void*>(MappedInput_release_buffer)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("Lines of a memory mapped text file"))},
+    {Py_tp_richcompare, reinterpret_cast<void*>(MappedInput_compare)},
+    {Py_tp_iter, reinterpret_cast<void*>(MappedInput_iter)},
+    {Py_tp_methods, MappedInput_Methods},
+    {Py_tp_getset, MappedInput_GetSet},
+    {Py_tp_init, reinterpret_cast<void*>(MappedInput_init)},
+    {Py_tp_new, reinterpret_cast<void*>(MappedInput_new)},
+    {0, nullptr}};
+
+PyType_Spec MappedInput_Spec = {
+    .name = "oatmeal.MappedInput",
+    .basicsize = sizeof(MappedInput),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = MappedInput_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// MappedInput method definitions.
+//--------------------------------------------------------------------------------------------------
+size_t MappedInput_scan_line(
+    const char* data,
+    size_t size,
+    size_t offset,
+    MappedLine* line) {
+  // memchr is vectorized by every mainstream C library, which makes it the
+  // fastest portable newline scan available.
+  const auto* newline =
+      static_cast<const char*>(std::memchr(data + offset, '\n', size - offset));
+  const auto end = newline == nullptr ? size : newline - data;
+  auto stripped = static_cast<size_t>(end);
+
+  while (stripped > offset && is_trailing_space(data[stripped - 1])) {
+    stripped--;
+  }
+
+  line->begin = offset;
+  line->end = stripped;
+
+  return newline == nullptr ? size : end + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<MappedInput*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    new (&self->file) MappedFile();
+    new (&self->lines) std::vector<MappedLine>();
+    self->exports = 0;
+    self->stream = false;
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int MappedInput_init(MappedInput* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"path", "stream", nullptr};
+  PyObject* path = nullptr;
+  int stream = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|p", const_cast<char**>(kwlist), &path, &stream)) {
+    return -1;
+  }
+
+  if (self->exports > 0) {
+    PyErr_SetString(
+        PyExc_BufferError, "cannot reopen MappedInput while a view exists");
+    return -1;
+  }
+
+  self->lines.clear();
+  self->stream = stream != 0;
+
+  if (!self->file.open(path)) {
+    return -1;
+  }
+
+  if (!self->stream) {
+    // The index is built off to the side while the GIL is released, and the
+    // export pins the mapping so other threads cannot close or reopen it.
+    const auto* data = self->file.data();
+    const auto size = self->file.size();
+    std::vector<MappedLine> lines;
+
+    self->exports++;
+    Py_BEGIN_ALLOW_THREADS;
+    build_index(data, size, &lines);
+    Py_END_ALLOW_THREADS;
+    self->exports--;
+
+    self->lines = std::move(lines);
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void MappedInput_dealloc(PyObject* obj_self) {
+  auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  self->lines.~vector();
+  self->file.~MappedFile();
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_view(MappedInput* self, PyObject* index) {
+  if (!check_indexed(self)) {
+    return nullptr;
+  }
+
+  const auto i = line_index(self, index);
+
+  if (i < 0) {
+    return nullptr;
+  }
+
+  PyObject* whole = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(self));
+
+  if (whole == nullptr) {
+    return nullptr;
+  }
+
+  // Slicing keeps the underlying buffer export, and with it the mapping, alive
+  // for as long as the returned view exists.
+  const auto& line = self->lines[i];
+  PyObject* view = PySequence_GetSlice(
+      whole,
+      static_cast<Py_ssize_t>(line.begin),
+      static_cast<Py_ssize_t>(line.end));
+
+  Py_DECREF(whole);
+
+  return view;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_pop(
+    MappedInput* self,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  if (nargs > 1) {
+    PyErr_Format(
+        PyExc_TypeError, "pop() takes at most 1 argument (%zd given)", nargs);
+    return nullptr;
+  }
+
+  if (!check_indexed(self)) {
+    return nullptr;
+  }
+
+  // Kernels that release the GIL hold an export while they walk the line
+  // index, so it must not shift underneath them.
+  if (self->exports > 0) {
+    PyErr_SetString(
+        PyExc_BufferError, "cannot pop from MappedInput while a view exists");
+    return nullptr;
+  }
+
+  if (self->lines.empty()) {
+    PyErr_SetString(PyExc_IndexError, "pop from empty MappedInput");
+    return nullptr;
+  }
+
+  Py_ssize_t i = static_cast<Py_ssize_t>(self->lines.size()) - 1;
+
+  if (nargs > 0 && (i = line_index(self, args[0])) < 0) {
+    return nullptr;
+  }
+
+  PyObject* text = decode_line(self, self->lines[i]);
+
+  if (text != nullptr) {
+    self->lines.erase(self->lines.begin() + i);
+  }
+
+  return text;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_reduce(MappedInput* self, PyObject*) {
+  // A mapping cannot cross processes, so the lines are sent by value. This
+  // keeps solvers that hand their input to a process pool working.
+  PyObject* lines = PySequence_List(reinterpret_cast<PyObject*>(self));
+
+  if (lines == nullptr) {
+    return nullptr;
+  }
+
+  return Py_BuildValue("(O(N))", &PyList_Type, lines);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_close(MappedInput* self, PyObject*) {
+  if (self->exports > 0) {
+    PyErr_SetString(
+        PyExc_BufferError, "cannot close MappedInput while a view exists");
+    return nullptr;
+  }
+
+  self->file.close();
+  std::vector<MappedLine>().swap(self->lines);
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_enter(MappedInput* self, PyObject*) {
+  if (!check_open(self)) {
+    return nullptr;
+  }
+
+  Py_INCREF(self);
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_exit(MappedInput* self, PyObject*) {
+  PyObject* result = MappedInput_close(self, nullptr);
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  Py_DECREF(result);
+  Py_RETURN_FALSE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_get_closed(MappedInput* self, void*) {
+  return PyBool_FromLong(!self->file.is_open());
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_get_stream(MappedInput* self, void*) {
+  return PyBool_FromLong(self->stream);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_repr(PyObject* obj_self) {
+  const auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  if (!self->file.is_open()) {
+    return PyUnicode_FromString("MappedInput(closed=True)");
+  }
+
+  if (self->stream) {
+    return PyUnicode_FromFormat(
+        "MappedInput(bytes=%zu, stream=True)", self->file.size());
+  }
+
+  return PyUnicode_FromFormat("MappedInput(lines=%zu)", self->lines.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t MappedInput_len(PyObject* obj_self) {
+  const auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  if (!check_indexed(self)) {
+    return -1;
+  }
+
+  return static_cast<Py_ssize_t>(self->lines.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_get(PyObject* obj_self, PyObject* index) {
+  const auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  if (!check_indexed(self)) {
+    return nullptr;
+  }
+
+  if (!PySlice_Check(index)) {
+    const auto i = line_index(self, index);
+    return i < 0 ? nullptr : decode_line(self, self->lines[i]);
+  }
+
+  Py_ssize_t start = 0;
+  Py_ssize_t stop = 0;
+  Py_ssize_t step = 0;
+
+  if (PySlice_Unpack(index, &start, &stop, &step) < 0) {
+    return nullptr;
+  }
+
+  const auto count = PySlice_AdjustIndices(
+      static_cast<Py_ssize_t>(self->lines.size()), &start, &stop, step);
+  PyObject* result = PyList_New(count);
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (Py_ssize_t i = 0, line = start; i < count; ++i, line += step) {
+    PyObject* text = decode_line(self, self->lines[line]);
+
+    if (text == nullptr) {
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(result, i, text);
+  }
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_iter(PyObject* obj_self) {
+  auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  if (!check_open(self)) {
+    return nullptr;
+  }
+
+  auto* itr = PyObject_New(
+      MappedInputIterator,
+      Oatmeal_object_state(obj_self)->mapped_input_iterator_type);
+
+  if (itr == nullptr) {
+    return nullptr;
+  }
+
+  Py_INCREF(self);
+  itr->owner = self;
+  itr->position = 0;
+
+  return reinterpret_cast<PyObject*>(itr);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* MappedInput_compare(PyObject* obj_self, PyObject* other, int op) {
+  const auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  // Compare like a list of lines so inputs can be checked against literals.
+  if ((op != Py_EQ && op != Py_NE) || self->stream ||
+      !(PyList_Check(other) || PyTuple_Check(other) ||
+        PyObject_TypeCheck(other, Py_TYPE(obj_self)))) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  const auto count = MappedInput_len(obj_self);
+  const auto other_count = PyObject_Length(other);
+
+  if (count < 0 || other_count < 0) {
+    return nullptr;
+  }
+
+  bool equal = count == other_count;
+
+  for (Py_ssize_t i = 0; equal && i < count; ++i) {
+    PyObject* text = decode_line(self, self->lines[i]);
+    PyObject* item = text == nullptr ? nullptr : PySequence_GetItem(other, i);
+    const int result =
+        item == nullptr ? -1 : PyObject_RichCompareBool(text, item, Py_EQ);
+
+    Py_XDECREF(text);
+    Py_XDECREF(item);
+
+    if (result < 0) {
+      return nullptr;
+    }
+
+    equal = result == 1;
+  }
+
+  return PyBool_FromLong(equal == (op == Py_EQ));
+}
+
+//--------------------------------------------------------------------------------------------------
+int MappedInput_get_buffer(PyObject* obj_self, Py_buffer* view, int flags) {
+  auto* self = reinterpret_cast<MappedInput*>(obj_self);
+
+  if (!check_open(self)) {
+    view->obj = nullptr;
+    return -1;
+  }
+
+  // Empty files have no mapping, but buffers still need a valid pointer.
+  static char empty = 0;
+  auto* data =
+      self->file.size() > 0 ? const_cast<char*>(self->file.data()) : &empty;
+
+  if (PyBuffer_FillInfo(
+          view,
+          obj_self,
+          data,
+          static_cast<Py_ssize_t>(self->file.size()),
+          1,
+          flags) < 0) {
+    return -1;
+  }
+
+  self->exports++;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void MappedInput_release_buffer(PyObject* obj_self, Py_buffer*) {
+  reinterpret_cast<MappedInput*>(obj_self)->exports--;
+}
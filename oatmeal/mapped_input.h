@@ -0,0 +1,216 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Read only memory mapping of an entire file. Empty files are "mapped" without
+ * touching the OS since zero length mappings are not allowed.
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * Map the file at `path`, which can be any str, bytes or os.PathLike value.
+   * Returns false with an OSError set if the file cannot be opened or mapped.
+   */
+  bool open(PyObject* path);
+
+  /** Unmap the file. Safe to call when nothing is mapped. */
+  void close();
+
+  /** Returns true if a file is currently mapped. */
+  bool is_open() const { return is_open_; }
+
+  /** First byte of the mapped file. */
+  const char* data() const { return data_; }
+
+  /** Size of the mapped file in bytes. */
+  size_t size() const { return size_; }
+
+private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool is_open_ = false;
+#if defined(_WIN32)
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+
+/** Byte range of a single line, excluding the newline and trailing spaces. */
+struct MappedLine {
+  size_t begin;
+  size_t end;
+};
+
+/**
+ * Lines of a memory mapped text file. Line offsets are indexed with a single
+ * scan when the file is opened, and each line is only decoded to a `str` when
+ * it is asked for. Streaming inputs skip the index entirely and can only be
+ * iterated, scanning for each line as it is reached.
+ */
+typedef struct {
+  PyObject_HEAD MappedFile file;
+  std::vector<MappedLine> lines;
+  Py_ssize_t exports;
+  bool stream;
+} MappedInput;
+
+/** Python type spec for `MappedInput`. */
+extern PyType_Spec MappedInput_Spec;
+
+/** Python type spec for the iterator over `MappedInput` lines. */
+extern PyType_Spec MappedInputIterator_Spec;
+
+/**
+ * Find the line starting at byte `offset` of `data`, storing its bounds with
+ * trailing whitespace removed in `line`. Returns the offset of the next line.
+ */
+size_t MappedInput_scan_line(
+    const char* data,
+    size_t size,
+    size_t offset,
+    MappedLine* line);
+
+/**
+ * Snapshot of the lines of a `MappedInput`, which can be read without the GIL
+ * as long as the caller holds an export for the whole time. The index is read
+ * through the snapshot since `pop` only ever shrinks it.
+ */
+class MappedLines {
+public:
+  explicit MappedLines(const MappedInput* input)
+      : data_(input->file.data()), size_(input->file.size()),
+        index_(input->lines.data()), index_count_(input->lines.size()),
+        stream_(input->stream) {}
+
+  /** Number of indexed lines, or zero for a streaming input. */
+  size_t indexed() const { return index_count_; }
+
+  /**
+   * Call `fn(begin, end)` for each line in order until it returns false.
+   * Returns false if `fn` did.
+   */
+  template <typename Fn> bool for_each(Fn&& fn) const {
+    MappedLine line;
+
+    for (size_t cursor = 0;;) {
+      if (!stream_) {
+        if (cursor >= index_count_) {
+          return true;
+        }
+
+        line = index_[cursor++];
+      } else if (cursor < size_) {
+        cursor = MappedInput_scan_line(data_, size_, cursor, &line);
+      } else {
+        return true;
+      }
+
+      if (!fn(data_ + line.begin, data_ + line.end)) {
+        return false;
+      }
+    }
+  }
+
+private:
+  const char* data_;
+  size_t size_;
+  const MappedLine* index_;
+  size_t index_count_;
+  bool stream_;
+};
+
+/** UTF-8 bytes of a `str`, or the contents of a bytes like object. */
+class TextSpan {
+public:
+  TextSpan() = default;
+  TextSpan(const TextSpan&) = delete;
+  TextSpan& operator=(const TextSpan&) = delete;
+
+  ~TextSpan() {
+    if (view_.obj != nullptr) {
+      PyBuffer_Release(&view_);
+    }
+  }
+
+  /** Returns false with a TypeError set if `obj` holds no text. */
+  bool open(PyObject* obj);
+
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+
+private:
+  Py_buffer view_ = {};
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+/** __new__(type, *args, **kwds) -> MappedInput */
+PyObject* MappedInput_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, path: str | os.PathLike, stream: bool = False) */
+int MappedInput_init(MappedInput* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the input and unmap the file. */
+void MappedInput_dealloc(PyObject* self);
+
+/** view(self, index: int) -> memoryview */
+PyObject* MappedInput_view(MappedInput* self, PyObject* index);
+
+/** pop(self, index: int = -1) -> str */
+PyObject* MappedInput_pop(
+    MappedInput* self,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+
+/** __reduce__(self) -> Tuple[type, Tuple[list[str]]] */
+PyObject* MappedInput_reduce(MappedInput* self, PyObject*);
+
+/** close(self) */
+PyObject* MappedInput_close(MappedInput* self, PyObject*);
+
+/** __enter__(self) -> MappedInput */
+PyObject* MappedInput_enter(MappedInput* self, PyObject*);
+
+/** __exit__(self, *args) -> bool */
+PyObject* MappedInput_exit(MappedInput* self, PyObject* args);
+
+/** closed -> bool */
+PyObject* MappedInput_get_closed(MappedInput* self, void*);
+
+/** stream -> bool */
+PyObject* MappedInput_get_stream(MappedInput* self, void*);
+
+/** repr(self) -> str */
+PyObject* MappedInput_repr(PyObject* self);
+
+/** len(self) -> int */
+Py_ssize_t MappedInput_len(PyObject* self);
+
+/** __getitem__(self, index: int | slice) -> str | list[str] */
+PyObject* MappedInput_get(PyObject* self, PyObject* index);
+
+/** iter(self) -> Iterator[str] */
+PyObject* MappedInput_iter(PyObject* self);
+
+/**
+ * __eq__(left: MappedInput, right: Sequence[str]) -> bool
+ * __ne__(left: MappedInput, right: Sequence[str]) -> bool
+ */
+PyObject* MappedInput_compare(PyObject* self, PyObject* other, int op);
+
+/** Export the whole mapped file as a read only buffer. */
+int MappedInput_get_buffer(PyObject* self, Py_buffer* view, int flags);
+
+/** Release a buffer exported by `MappedInput_get_buffer`. */
+void MappedInput_release_buffer(PyObject* self, Py_buffer* view);
@@ -1,39 +1,388 @@
+#include "bfs.h"
+#include "combinations.h"
+#include "direction.h"
+#include "extrapolate.h"
+#include "grid.h"
+#include "grid_nd.h"
+#include "hands.h"
+#include "int_array.h"
+#include "interval_map.h"
+#include "mapped_input.h"
+#include "network.h"
+#include "parse.h"
 #include "oatmeal.h"
+#include "pipes.h"
 #include "point.h"
+#include "point_array.h"
+#include "point_nd.h"
+#include "point_table.h"
+#include "schematic.h"
+#include "scratchcards.h"
+#include "search.h"
+#include "weighted_axes.h"
+
+namespace {
+  /**
+   * Create a heap type from `spec` owned by `mod`, store it in `out` and
+   * optionally add it to the module as `name`.
+   */
+  bool add_type(
+      PyObject* mod,
+      const char* name,
+      PyType_Spec* spec,
+      PyTypeObject* base,
+      PyTypeObject** out) {
+    auto* type = reinterpret_cast<PyTypeObject*>(PyType_FromModuleAndSpec(
+        mod, spec, reinterpret_cast<PyObject*>(base)));
+
+    if (type == nullptr) {
+      return false;
+    }
+
+    *out = type;
+
+    if (name == nullptr) {
+      return true;
+    }
+
+    return PyModule_AddObjectRef(mod, name, (PyObject*)type) == 0;
+  }
+
+  /** Create and add each of `count` named types, storing them in `out`. */
+  bool add_types(
+      PyObject* mod,
+      const NamedSpec* specs,
+      int count,
+      PyTypeObject** out) {
+    for (int i = 0; i < count; ++i) {
+      if (!add_type(mod, specs[i].name, specs[i].spec, nullptr, &out[i])) {
+        return false;
+      }
+
+      if (specs[i].vectorcall != nullptr) {
+        out[i]->tp_vectorcall = specs[i].vectorcall;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Create every type and constant of a new module object. This runs each
+   * time an interpreter imports oatmeal, and the results live in the module
+   * state so nothing is shared between module objects.
+   */
+  int oatmeal_exec(PyObject* mod) {
+    auto* st = Oatmeal_state(mod);
+
+    if (!add_type(mod, "Point", &Point_Spec, nullptr, &st->point_type)) {
+      return -1;
+    }
+
+    st->point_type->tp_vectorcall = Point_vectorcall;
+
+    if (!add_type(
+            mod,
+            "FrozenPoint",
+            &FrozenPoint_Spec,
+            st->point_type,
+            &st->frozen_point_type)) {
+      return -1;
+    }
+
+    st->frozen_point_type->tp_vectorcall = FrozenPoint_vectorcall;
+
+    const bool ok =
+        add_type(
+            mod,
+            "PointArray",
+            &PointArray_Spec,
+            nullptr,
+            &st->point_array_type) &&
+        add_type(
+            mod, "PointSet", &PointSet_Spec, nullptr, &st->point_set_type) &&
+        add_type(
+            mod, "PointMap", &PointMap_Spec, nullptr, &st->point_map_type) &&
+        add_type(
+            mod,
+            nullptr,
+            &PointTableIterator_Spec,
+            nullptr,
+            &st->point_table_iterator_type) &&
+        add_types(
+            mod, PointND_specs(), kPointNDTypeCount, st->point_nd_types) &&
+        add_types(
+            mod,
+            PointArrayND_specs(),
+            kPointNDTypeCount,
+            st->point_array_nd_types) &&
+        Point_add_constants(st) &&
+        add_type(
+            mod,
+            "Direction",
+            &Direction_Spec,
+            &PyLong_Type,
+            &st->direction_type) &&
+        Direction_add_members(st) &&
+        PyModule_AddIntConstant(mod, "CARDINAL", kCardinalDirs) == 0 &&
+        PyModule_AddIntConstant(mod, "DIAGONAL", kDiagonalDirs) == 0 &&
+        add_type(mod, "Grid", &Grid_Spec, nullptr, &st->grid_type) &&
+        add_type(
+            mod, nullptr, &GridView_Spec, nullptr, &st->grid_view_type) &&
+        add_type(
+            mod,
+            nullptr,
+            &GridCellIterator_Spec,
+            nullptr,
+            &st->grid_cell_iterator_type) &&
+        add_type(
+            mod,
+            nullptr,
+            &GridRowsIterator_Spec,
+            nullptr,
+            &st->grid_rows_iterator_type) &&
+        add_type(
+            mod,
+            nullptr,
+            &GridNeighborIterator_Spec,
+            nullptr,
+            &st->grid_neighbor_iterator_type) &&
+        add_types(mod, GridND_specs(), kGridNDTypeCount, st->grid_nd_types) &&
+        add_type(
+            mod,
+            nullptr,
+            &CombinationIterator_Spec,
+            nullptr,
+            &st->combination_iterator_type) &&
+        add_type(
+            mod, "IntArray", &IntArray_Spec, nullptr, &st->int_array_type) &&
+        add_type(
+            mod,
+            "IntervalMap",
+            &IntervalMap_Spec,
+            nullptr,
+            &st->interval_map_type) &&
+        add_type(
+            mod,
+            "MappedInput",
+            &MappedInput_Spec,
+            nullptr,
+            &st->mapped_input_type) &&
+        add_type(
+            mod,
+            nullptr,
+            &MappedInputIterator_Spec,
+            nullptr,
+            &st->mapped_input_iterator_type) &&
+        add_type(mod, "Network", &Network_Spec, nullptr, &st->network_type) &&
+        add_type(
+            mod,
+            "WeightedAxes",
+            &WeightedAxes_Spec,
+            nullptr,
+            &st->weighted_axes_type);
+
+    return ok ? 0 : -1;
+  }
+
+  /** Every type held by the module state, including the nd types. */
+  template <typename Fn> void for_each_type(OatmealState* st, Fn&& fn) {
+    PyTypeObject** types[] = {
+        &st->point_type,
+        &st->frozen_point_type,
+        &st->point_array_type,
+        &st->point_set_type,
+        &st->point_map_type,
+        &st->point_table_iterator_type,
+        &st->direction_type,
+        &st->grid_type,
+        &st->grid_view_type,
+        &st->grid_cell_iterator_type,
+        &st->grid_rows_iterator_type,
+        &st->grid_neighbor_iterator_type,
+        &st->combination_iterator_type,
+        &st->int_array_type,
+        &st->interval_map_type,
+        &st->mapped_input_type,
+        &st->mapped_input_iterator_type,
+        &st->network_type,
+        &st->weighted_axes_type,
+    };
+
+    for (auto** type : types) {
+      fn(type);
+    }
+
+    for (auto*& type : st->point_nd_types) {
+      fn(&type);
+    }
+
+    for (auto*& type : st->point_array_nd_types) {
+      fn(&type);
+    }
+
+    for (auto*& type : st->grid_nd_types) {
+      fn(&type);
+    }
+  }
+
+  /** GC traversal of the types, constants and caches in the module state. */
+  int oatmeal_traverse(PyObject* mod, visitproc visit, void* arg) {
+    auto* st = Oatmeal_state(mod);
+    int result = 0;
+
+    for_each_type(st, [&](PyTypeObject** type) {
+      if (result == 0 && *type != nullptr) {
+        result = visit(reinterpret_cast<PyObject*>(*type), arg);
+      }
+    });
+
+    if (result != 0) {
+      return result;
+    }
+
+    for (int i = 0; i < kDirectionCount; ++i) {
+      Py_VISIT(st->direction_points[i]);
+      Py_VISIT(st->direction_members[i]);
+    }
+
+    Py_VISIT(st->deepcopy_func);
+    return Point_traverse_caches(st, visit, arg);
+  }
+
+  /**
+   * Drop every reference held by the module state. The caches go first since
+   * the free list memory was allocated for the point type.
+   */
+  int oatmeal_clear(PyObject* mod) {
+    auto* st = Oatmeal_state(mod);
+    Point_clear_caches(st);
+
+    for (int i = 0; i < kDirectionCount; ++i) {
+      Py_CLEAR(st->direction_points[i]);
+      Py_CLEAR(st->direction_members[i]);
+    }
+
+    Py_CLEAR(st->deepcopy_func);
+    for_each_type(st, [](PyTypeObject** type) { Py_CLEAR(*type); });
+    return 0;
+  }
+
+  /** Release the module state when the module object is destroyed. */
+  void oatmeal_free(void* mod) { oatmeal_clear(static_cast<PyObject*>(mod)); }
+} // namespace
 
 //--------------------------------------------------------------------------------------------------
 // Oatmeal module definition.
 //--------------------------------------------------------------------------------------------------
-static PyMethodDef oatmeal_methods[] = {{nullptr, nullptr, 0, nullptr}};
+static PyMethodDef oatmeal_methods[] = {
+    {"all_pairs",
+     (PyCFunction)all_pairs,
+     METH_O,
+     "Every pair of items without repeating a pair in either order"},
+    {"alloc_stats",
+     (PyCFunction)alloc_stats,
+     METH_NOARGS,
+     "Counts of the objects oatmeal has allocated, keyed by kind"},
+    {"astar",
+     (PyCFunction)astar,
+     METH_VARARGS | METH_KEYWORDS,
+     "Find the cheapest path between two grid cells with A* search"},
+    {"bfs_distances",
+     (PyCFunction)bfs_distances,
+     METH_VARARGS | METH_KEYWORDS,
+     "Breadth first step counts from one or more start cells"},
+    {"cascade_copies",
+     (PyCFunction)cascade_copies,
+     METH_O,
+     "Instances of each scratchcard once every card has won its copies"},
+    {"classify_hand",
+     (PyCFunction)classify_hand,
+     METH_VARARGS | METH_KEYWORDS,
+     "Type of a five card hand, from 1 for high card to 7 for five of a kind"},
+    {"combination_indices",
+     (PyCFunction)combination_indices,
+     METH_VARARGS | METH_KEYWORDS,
+     "Batches of every k sized combination of indices as int64 rows"},
+    {"combinations",
+     (PyCFunction)combinations,
+     METH_VARARGS,
+     "Every k sized combination of items in lexicographic order"},
+    {"extrapolate_rows",
+     (PyCFunction)extrapolate_rows,
+     METH_VARARGS | METH_KEYWORDS,
+     "Extrapolate every row of a ragged int64 array forwards and backwards"},
+    {"flood_fill",
+     (PyCFunction)flood_fill,
+     METH_VARARGS | METH_KEYWORDS,
+     "Mask of cells reachable from one or more start cells"},
+    {"hand_winnings",
+     (PyCFunction)hand_winnings,
+     METH_VARARGS | METH_KEYWORDS,
+     "Total winnings of ranking every hand and bid line"},
+    {"label_components",
+     (PyCFunction)label_components,
+     METH_VARARGS | METH_KEYWORDS,
+     "Label each connected region of passable cells"},
+    {"inc", (PyCFunction)inc, METH_O, "Returns one more than `value`"},
+    {"match_counts",
+     (PyCFunction)match_counts,
+     METH_VARARGS | METH_KEYWORDS,
+     "Number of winning numbers on every scratchcard line"},
+    {"parse_ints",
+     (PyCFunction)parse_ints,
+     METH_VARARGS | METH_KEYWORDS,
+     "Parse the integers in a line of text into an int64 array"},
+    {"parse_int_rows",
+     (PyCFunction)parse_int_rows,
+     METH_VARARGS | METH_KEYWORDS,
+     "Parse the integers on every line into one ragged int64 array"},
+    {"pairwise_distances",
+     (PyCFunction)pairwise_distances,
+     METH_VARARGS | METH_KEYWORDS,
+     "Matrix of shortest path costs between every pair of source cells"},
+    {"pipe_loop",
+     (PyCFunction)pipe_loop,
+     METH_VARARGS | METH_KEYWORDS,
+     "Length of the pipe loop through the start and the tiles it encloses"},
+    {"reset_alloc_stats",
+     (PyCFunction)reset_alloc_stats,
+     METH_NOARGS,
+     "Reset every allocation counter to zero"},
+    {"schematic_parts",
+     (PyCFunction)schematic_parts,
+     METH_VARARGS | METH_KEYWORDS,
+     "Sums of the part numbers and gear ratios in an engine schematic"},
+    {nullptr, nullptr, 0, nullptr}};
+
+static PyModuleDef_Slot oatmeal_slots[] = {
+    {Py_mod_exec, reinterpret_cast<void*>(oatmeal_exec)},
+#ifdef Py_mod_multiple_interpreters
+    // Types, constants and caches all live in the module state, so each
+    // interpreter gets its own and they can run under their own GILs.
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+#ifdef Py_mod_gil
+    // The point free list, the frozen point intern table, the allocation
+    // counters and container mutation still rely on the GIL, so free threaded
+    // builds keep it enabled while oatmeal is loaded. Long running kernels
+    // release it either way.
+    {Py_mod_gil, Py_MOD_GIL_USED},
+#endif
+    {0, nullptr}};
 
-static PyModuleDef oatmeal_module = {
+PyModuleDef oatmeal_module = {
     PyModuleDef_HEAD_INIT,
     "oatmeal",
     "An assortment of boring but essential tools written in C++ for speed",
-    0,
-    oatmeal_methods};
+    sizeof(OatmealState),
+    oatmeal_methods,
+    oatmeal_slots,
+    oatmeal_traverse,
+    oatmeal_clear,
+    oatmeal_free};
 
 //--------------------------------------------------------------------------------------------------
 // Oatmeal module entry point.
 //--------------------------------------------------------------------------------------------------
-PyMODINIT_FUNC PyInit_oatmeal() {
-  PyObject* mod = PyModule_Create(&oatmeal_module);
-
-  if (mod == nullptr) {
-    return nullptr;
-  }
-
-  if (PyType_Ready(&PointType) < 0) {
-    return nullptr;
-  }
-
-  Py_INCREF(&PointType);
-
-  if (PyModule_AddObject(mod, "Point", (PyObject*)&PointType) < 0) {
-    Py_DECREF(&PointType);
-    Py_DECREF(mod);
-    return nullptr;
-  }
-
-  return mod;
-}
\ No newline at end of file
+PyMODINIT_FUNC PyInit_oatmeal() { return PyModuleDef_Init(&oatmeal_module); }
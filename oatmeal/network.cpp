@@ -0,0 +1,496 @@
+#include "network.h"
+
+#include <memory>
+#include <new>
+#include <utility>
+
+//--------------------------------------------------------------------------------------------------
+// NetworkTable definitions.
+//--------------------------------------------------------------------------------------------------
+int64_t NetworkTable::find(std::string_view name) const {
+  const auto itr = ids_.find(std::string(name));
+  return itr == ids_.end() ? -1 : static_cast<int64_t>(itr->second);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool NetworkTable::set_turns(std::string_view turns) {
+  turns_.clear();
+
+  for (const char c : turns) {
+    if (c != 'L' && c != 'R') {
+      return false;
+    }
+
+    turns_.push_back(c == 'R' ? 1 : 0);
+  }
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool NetworkTable::define(
+    std::string_view name,
+    std::string_view left,
+    std::string_view right) {
+  const auto id = intern(name);
+
+  if (is_defined_[id] != 0) {
+    return false;
+  }
+
+  // Interning the edges can grow the arrays, so look them up afterwards.
+  const auto left_id = intern(left);
+  const auto right_id = intern(right);
+
+  left_[id] = left_id;
+  right_[id] = right_id;
+  is_defined_[id] = 1;
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+int64_t NetworkTable::walk(
+    uint32_t start,
+    const std::vector<uint8_t>& targets) const {
+  // A walk can only visit `turns * nodes` distinct states before it repeats,
+  // so a target not reached by then is never reached.
+  const uint64_t limit =
+      static_cast<uint64_t>(turns_.size()) * static_cast<uint64_t>(size());
+  const auto turn_count = turns_.size();
+
+  auto node = start;
+  size_t turn = 0;
+
+  for (uint64_t steps = 0; steps < limit; ++steps) {
+    if (targets[node] != 0) {
+      return static_cast<int64_t>(steps);
+    }
+
+    node = turns_[turn] != 0 ? right_[node] : left_[node];
+    turn = turn + 1 == turn_count ? 0 : turn + 1;
+  }
+
+  return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+NetworkTable::Cycle NetworkTable::cycle(
+    uint32_t start,
+    const std::vector<uint8_t>& targets) const {
+  const State first{0, start};
+
+  // Brent's algorithm finds the period by racing a hare ahead of a tortoise
+  // that jumps forward at each power of two.
+  uint64_t power = 1;
+  uint64_t period = 1;
+  auto tortoise = first;
+  auto hare = next(first);
+
+  while (!(tortoise == hare)) {
+    if (power == period) {
+      tortoise = hare;
+      power *= 2;
+      period = 0;
+    }
+
+    hare = next(hare);
+    period++;
+  }
+
+  // With the hare a period ahead, both meet where the cycle begins.
+  uint64_t tail = 0;
+  tortoise = first;
+  hare = first;
+
+  for (uint64_t i = 0; i < period; ++i) {
+    hare = next(hare);
+  }
+
+  while (!(tortoise == hare)) {
+    tortoise = next(tortoise);
+    hare = next(hare);
+    tail++;
+  }
+
+  Cycle result{tail, period, {}};
+  auto state = first;
+
+  for (uint64_t steps = 0; steps < tail + period; ++steps) {
+    if (targets[state.node] != 0) {
+      result.offsets.push_back(steps);
+    }
+
+    state = next(state);
+  }
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t NetworkTable::intern(std::string_view name) {
+  const auto [itr, inserted] =
+      ids_.emplace(std::string(name), static_cast<uint32_t>(names_.size()));
+
+  if (inserted) {
+    names_.emplace_back(name);
+    left_.push_back(itr->second);
+    right_.push_back(itr->second);
+    is_defined_.push_back(0);
+  }
+
+  return itr->second;
+}
+
+//--------------------------------------------------------------------------------------------------
+NetworkTable::State NetworkTable::next(State state) const {
+  const auto node =
+      turns_[state.turn] != 0 ? right_[state.node] : left_[state.node];
+  const auto turn = state.turn + 1 == turns_.size() ? 0 : state.turn + 1;
+
+  return {static_cast<uint32_t>(turn), node};
+}
+
+//--------------------------------------------------------------------------------------------------
+// Network python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef Network_Methods[] = {
+    {"walk",
+     (PyCFunction)Network_walk,
+     METH_VARARGS | METH_KEYWORDS,
+     "Number of steps from `start` to the first target node"},
+    {"cycle",
+     (PyCFunction)Network_cycle,
+     METH_VARARGS | METH_KEYWORDS,
+     "Find the `(tail, period, offsets)` cycle of the walk from `start`"},
+    {nullptr}};
+
+PyType_Slot Network_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(Network_dealloc)},
+    {Py_sq_length, reinterpret_cast<void*>(Network_len)},
+    {Py_sq_contains, reinterpret_cast<void*>(Network_contains)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR(
+         "Graph of left and right edges walked by a repeating list of turns"))},
+    {Py_tp_methods, Network_Methods},
+    {Py_tp_init, reinterpret_cast<void*>(Network_init)},
+    {Py_tp_new, reinterpret_cast<void*>(Network_new)},
+    {0, nullptr}};
+
+PyType_Spec Network_Spec = {
+    .name = "oatmeal.Network",
+    .basicsize = sizeof(Network),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Network_Slots,
+};
+
+namespace {
+  /** Read a `str` argument, raising TypeError if it is something else. */
+  bool read_name(PyObject* obj, std::string_view* out) {
+    if (!PyUnicode_Check(obj)) {
+      PyErr_SetString(PyExc_TypeError, "node names must be of type `str`");
+      return false;
+    }
+
+    Py_ssize_t size = 0;
+    const char* text = PyUnicode_AsUTF8AndSize(obj, &size);
+
+    if (text == nullptr) {
+      return false;
+    }
+
+    *out = std::string_view(text, static_cast<size_t>(size));
+    return true;
+  }
+
+  /** Look up a node by name, raising KeyError if it is not in the network. */
+  bool read_node(const NetworkTable& table, PyObject* obj, uint32_t* out) {
+    std::string_view name;
+
+    if (!read_name(obj, &name)) {
+      return false;
+    }
+
+    const auto id = table.find(name);
+
+    if (id < 0) {
+      PyErr_SetObject(PyExc_KeyError, obj);
+      return false;
+    }
+
+    *out = static_cast<uint32_t>(id);
+    return true;
+  }
+
+  /**
+   * Mark the target nodes, which are either a single name or an iterable of
+   * names.
+   */
+  bool read_targets(
+      const NetworkTable& table,
+      PyObject* obj,
+      std::vector<uint8_t>* out) {
+    out->assign(table.size(), 0);
+
+    if (PyUnicode_Check(obj)) {
+      uint32_t id = 0;
+
+      if (!read_node(table, obj, &id)) {
+        return false;
+      }
+
+      (*out)[id] = 1;
+      return true;
+    }
+
+    PyObject* iter = PyObject_GetIter(obj);
+
+    if (iter == nullptr) {
+      return false;
+    }
+
+    while (PyObject* item = PyIter_Next(iter)) {
+      uint32_t id = 0;
+      const bool ok = read_node(table, item, &id);
+      Py_DECREF(item);
+
+      if (!ok) {
+        Py_DECREF(iter);
+        return false;
+      }
+
+      (*out)[id] = 1;
+    }
+
+    Py_DECREF(iter);
+    return !PyErr_Occurred();
+  }
+
+  /** Parse the `(start, targets)` arguments shared by walks. */
+  bool read_walk_args(
+      const NetworkTable& table,
+      PyObject* args,
+      PyObject* kwds,
+      uint32_t* start,
+      std::vector<uint8_t>* targets) {
+    const char* kwlist[] = {"start", "targets", nullptr};
+    PyObject* obj_start = nullptr;
+    PyObject* obj_targets = nullptr;
+
+    return PyArg_ParseTupleAndKeywords(
+               args,
+               kwds,
+               "OO",
+               const_cast<char**>(kwlist),
+               &obj_start,
+               &obj_targets) &&
+           read_node(table, obj_start, start) &&
+           read_targets(table, obj_targets, targets);
+  }
+
+  /** Add a `(name, left, right)` node, raising if it is malformed. */
+  bool define_node(NetworkTable& table, PyObject* obj) {
+    const char* node_error = "nodes must be (name, left, right) tuples";
+    PyObject* node = PySequence_Fast(obj, node_error);
+
+    if (node == nullptr) {
+      return false;
+    }
+
+    std::string_view name;
+    std::string_view left;
+    std::string_view right;
+
+    if (PySequence_Fast_GET_SIZE(node) != 3) {
+      PyErr_SetString(PyExc_TypeError, node_error);
+      Py_DECREF(node);
+      return false;
+    }
+
+    // The names borrow from the tuple items, so define before releasing it.
+    bool ok = read_name(PySequence_Fast_GET_ITEM(node, 0), &name) &&
+              read_name(PySequence_Fast_GET_ITEM(node, 1), &left) &&
+              read_name(PySequence_Fast_GET_ITEM(node, 2), &right);
+
+    if (ok && !table.define(name, left, right)) {
+      PyErr_Format(
+          PyExc_ValueError,
+          "node `%S` is defined more than once",
+          PySequence_Fast_GET_ITEM(node, 0));
+      ok = false;
+    }
+
+    Py_DECREF(node);
+    return ok;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// Network method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* Network_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<Network*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    new (&self->table) std::shared_ptr<const NetworkTable>(
+        std::make_shared<NetworkTable>());
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int Network_init(Network* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"turns", "nodes", nullptr};
+  PyObject* obj_turns = nullptr;
+  PyObject* obj_nodes = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "UO",
+          const_cast<char**>(kwlist),
+          &obj_turns,
+          &obj_nodes)) {
+    return -1;
+  }
+
+  // Build into a fresh table so a failed init leaves the old one intact.
+  NetworkTable table;
+  std::string_view turns;
+
+  if (!read_name(obj_turns, &turns)) {
+    return -1;
+  }
+
+  if (turns.empty() || !table.set_turns(turns)) {
+    PyErr_SetString(
+        PyExc_ValueError, "turns must be a non empty string of `L` and `R`");
+    return -1;
+  }
+
+  PyObject* iter = PyObject_GetIter(obj_nodes);
+
+  if (iter == nullptr) {
+    return -1;
+  }
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    const bool ok = define_node(table, item);
+    Py_DECREF(item);
+
+    if (!ok) {
+      Py_DECREF(iter);
+      return -1;
+    }
+  }
+
+  Py_DECREF(iter);
+
+  if (PyErr_Occurred()) {
+    return -1;
+  }
+
+  // Every edge has to lead somewhere, or walks would fall off the graph.
+  for (uint32_t id = 0; id < table.size(); ++id) {
+    if (!table.defined(id)) {
+      PyErr_Format(
+          PyExc_ValueError,
+          "node `%s` is used by an edge but never defined",
+          table.name(id).c_str());
+      return -1;
+    }
+  }
+
+  self->table = std::make_shared<const NetworkTable>(std::move(table));
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Network_dealloc(PyObject* obj_self) {
+  using TablePtr = std::shared_ptr<const NetworkTable>;
+  reinterpret_cast<Network*>(obj_self)->table.~TablePtr();
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Network_walk(Network* self, PyObject* args, PyObject* kwds) {
+  // Walk a snapshot of the table, which stays alive without the GIL even if
+  // the network is initialized again by another thread.
+  const auto table = self->table;
+  uint32_t start = 0;
+  std::vector<uint8_t> targets;
+  int64_t steps = 0;
+
+  if (!read_walk_args(*table, args, kwds, &start, &targets)) {
+    return nullptr;
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  steps = table->walk(start, targets);
+  Py_END_ALLOW_THREADS;
+
+  if (steps < 0) {
+    PyErr_SetString(PyExc_ValueError, "walk never reaches a target node");
+    return nullptr;
+  }
+
+  return PyLong_FromLongLong(steps);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Network_cycle(Network* self, PyObject* args, PyObject* kwds) {
+  const auto table = self->table;
+  uint32_t start = 0;
+  std::vector<uint8_t> targets;
+  NetworkTable::Cycle cycle;
+
+  if (!read_walk_args(*table, args, kwds, &start, &targets)) {
+    return nullptr;
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  cycle = table->cycle(start, targets);
+  Py_END_ALLOW_THREADS;
+  PyObject* offsets = PyList_New(static_cast<Py_ssize_t>(cycle.offsets.size()));
+
+  if (offsets == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < cycle.offsets.size(); ++i) {
+    PyObject* offset = PyLong_FromUnsignedLongLong(cycle.offsets[i]);
+
+    if (offset == nullptr) {
+      Py_DECREF(offsets);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(offsets, static_cast<Py_ssize_t>(i), offset);
+  }
+
+  return Py_BuildValue(
+      "(KKN)",
+      static_cast<unsigned long long>(cycle.tail),
+      static_cast<unsigned long long>(cycle.period),
+      offsets);
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t Network_len(PyObject* self) {
+  return static_cast<Py_ssize_t>(
+      reinterpret_cast<Network*>(self)->table->size());
+}
+
+//--------------------------------------------------------------------------------------------------
+int Network_contains(PyObject* self, PyObject* obj_name) {
+  std::string_view name;
+
+  if (!read_name(obj_name, &name)) {
+    return -1;
+  }
+
+  return reinterpret_cast<Network*>(self)->table->find(name) >= 0 ? 1 : 0;
+}
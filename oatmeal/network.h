@@ -0,0 +1,141 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Directed graph where every node has a left and a right edge, walked by
+ * repeating a fixed list of left and right turns. Node names are interned to
+ * dense ids so a step is two array reads, and a walk is a sequence of
+ * `(turn index, node)` states that must eventually repeat.
+ */
+class NetworkTable {
+public:
+  /** Cycle reached when walking from a start node. */
+  struct Cycle {
+    /** Steps taken before the walk first enters the cycle. */
+    uint64_t tail;
+    /** Length of the cycle in steps. */
+    uint64_t period;
+    /** Sorted steps in `[0, tail + period)` that stand on a target. */
+    std::vector<uint64_t> offsets;
+  };
+
+  /** Number of nodes, including nodes only referenced by an edge. */
+  size_t size() const { return names_.size(); }
+
+  /** Returns true if node `id` was defined rather than only referenced. */
+  bool defined(uint32_t id) const { return is_defined_[id] != 0; }
+
+  /** Name of node `id`. */
+  const std::string& name(uint32_t id) const { return names_[id]; }
+
+  /** Returns the id of `name`, or -1 if no node has that name. */
+  int64_t find(std::string_view name) const;
+
+  /**
+   * Set the turns, where each character must be `L` or `R`. Returns false if
+   * any other character is found.
+   */
+  bool set_turns(std::string_view turns);
+
+  /**
+   * Define a node and its edges, interning any new names. Returns false if
+   * the node was already defined.
+   */
+  bool define(
+      std::string_view name,
+      std::string_view left,
+      std::string_view right);
+
+  /** Walk from `start`, returning the first step which stands on a target. */
+  int64_t walk(uint32_t start, const std::vector<uint8_t>& targets) const;
+
+  /** Find the cycle of the walk from `start` with Brent's algorithm. */
+  Cycle cycle(uint32_t start, const std::vector<uint8_t>& targets) const;
+
+private:
+  /** Returns the id for `name`, adding an undefined node if it is new. */
+  uint32_t intern(std::string_view name);
+
+  /** Position of a walk, which decides every step that follows it. */
+  struct State {
+    uint32_t turn;
+    uint32_t node;
+
+    bool operator==(const State&) const = default;
+  };
+
+  /** State one step after `state`. */
+  State next(State state) const;
+
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::vector<uint32_t> left_;
+  std::vector<uint32_t> right_;
+  std::vector<uint8_t> is_defined_;
+  std::vector<uint8_t> turns_;
+};
+
+/**
+ * Python wrapper around a `NetworkTable`. The table is shared rather than
+ * owned so walks can keep it alive while they run without the GIL.
+ */
+typedef struct {
+  PyObject_HEAD std::shared_ptr<const NetworkTable> table;
+} Network;
+
+/** Python type spec for `Network`. */
+extern PyType_Spec Network_Spec;
+
+/** __new__(type, *args, **kwds) -> Network */
+PyObject* Network_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/**
+ * __init__(self, turns: str, nodes: Iterable[Tuple[str, str, str]])
+ *
+ * Build the network from `(name, left, right)` nodes. Every name used by an
+ * edge must also be defined, and `turns` must be a non empty string of `L`
+ * and `R` characters.
+ */
+int Network_init(Network* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the network. */
+void Network_dealloc(PyObject* self);
+
+/**
+ * walk(self, start: str, targets: str | Iterable[str]) -> int
+ *
+ * Number of steps taken from `start` until the walk first stands on a target
+ * node, which is zero if `start` is itself a target. Raises ValueError if the
+ * walk never reaches a target.
+ */
+PyObject* Network_walk(Network* self, PyObject* args, PyObject* kwds);
+
+/**
+ * cycle(
+ *  self,
+ *  start: str,
+ *  targets: str | Iterable[str],
+ * ) -> Tuple[int, int, list[int]]
+ *
+ * Find the cycle the walk from `start` falls into as `(tail, period,
+ * offsets)`. The walk enters the cycle after `tail` steps and then repeats
+ * every `period` steps. `offsets` lists the steps before `tail + period`
+ * that stand on a target, so the walk is on a target at step `t` when `t` is
+ * one of the offsets, or when `t` is at least `tail + period` and `t - o` is
+ * a multiple of `period` for an offset `o` of at least `tail`.
+ */
+PyObject* Network_cycle(Network* self, PyObject* args, PyObject* kwds);
+
+/** len(self) -> int */
+Py_ssize_t Network_len(PyObject* self);
+
+/** __contains__(self, name: str) -> bool */
+int Network_contains(PyObject* self, PyObject* name);
@@ -1,7 +1,49 @@
 #include "oatmeal.h"
 
+//--------------------------------------------------------------------------------------------------
+OatmealState* Oatmeal_base_type_state(PyTypeObject* type) {
+  // The same walk as `PyType_GetModuleByDef`, except that a type from outside
+  // oatmeal is not an error.
+  PyObject* mro = type->tp_mro;
+  const auto count = mro != nullptr ? PyTuple_GET_SIZE(mro) : 0;
+
+  for (Py_ssize_t i = 1; i < count; ++i) {
+    auto* base = reinterpret_cast<PyTypeObject*>(PyTuple_GET_ITEM(mro, i));
+
+    if (auto* st = Oatmeal_exact_type_state(base)) {
+      return st;
+    }
+  }
+
+  return nullptr;
+}
+
 //--------------------------------------------------------------------------------------------------
 PyObject* inc(PyObject*, PyObject* value) {
   const double v = PyFloat_AsDouble(value);
   return PyFloat_FromDouble(v + 1.0);
-}
\ No newline at end of file
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* alloc_stats(PyObject* module, PyObject*) {
+  const auto& stats = Oatmeal_state(module)->alloc_stats;
+
+  return Py_BuildValue(
+      "{sKsKsKsKsK}",
+      "points_created",
+      static_cast<unsigned long long>(stats.points_created),
+      "point_free_list_hits",
+      static_cast<unsigned long long>(stats.point_free_list_hits),
+      "frozen_points_created",
+      static_cast<unsigned long long>(stats.frozen_points_created),
+      "frozen_point_intern_hits",
+      static_cast<unsigned long long>(stats.frozen_point_intern_hits),
+      "grids_created",
+      static_cast<unsigned long long>(stats.grids_created));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* reset_alloc_stats(PyObject* module, PyObject*) {
+  Oatmeal_state(module)->alloc_stats = {};
+  Py_RETURN_NONE;
+}
@@ -11,4 +11,167 @@
 #define _DEBUG 1
 #else
 #include <Python.h>
-#endif
\ No newline at end of file
+#endif
+
+#include <cstdint>
+
+/**
+ * Number of `Direction` values. The four cardinal directions come first and
+ * are followed by the four diagonals, each group counter clockwise from east.
+ */
+inline constexpr int kDirectionCount = 8;
+
+/** Number of `Point{N}i{bits}` types, which is also the number of arrays. */
+inline constexpr int kPointNDTypeCount = 6;
+
+/** Number of `Grid{N}` types. */
+inline constexpr int kGridNDTypeCount = 2;
+
+/** Maximum number of deallocated points held for reuse by `Point_create`. */
+inline constexpr int kPointFreeListMax = 256;
+
+/**
+ * Object allocation counters, read by `alloc_stats()`. They are only updated
+ * while holding the GIL so plain integers are enough.
+ */
+struct AllocStats {
+  /** Exact `Point` objects created by native code or by calling `Point`. */
+  uint64_t points_created;
+  /** Points that reused an object from the point free list. */
+  uint64_t point_free_list_hits;
+  /** `FrozenPoint` objects allocated, interned or not. */
+  uint64_t frozen_points_created;
+  /** Frozen points returned from the intern cache without allocating. */
+  uint64_t frozen_point_intern_hits;
+  /** `Grid` objects created. */
+  uint64_t grids_created;
+};
+
+/**
+ * State of an oatmeal module object, created by its exec slot. Each module
+ * object has its own heap types, shared constants, caches and counters, so
+ * interpreters that import oatmeal never see each other's objects.
+ */
+struct OatmealState {
+  PyTypeObject* point_type;
+  PyTypeObject* frozen_point_type;
+  PyTypeObject* point_array_type;
+  PyTypeObject* point_set_type;
+  PyTypeObject* point_map_type;
+  PyTypeObject* point_table_iterator_type;
+  PyTypeObject* direction_type;
+  PyTypeObject* grid_type;
+  PyTypeObject* grid_view_type;
+  PyTypeObject* grid_cell_iterator_type;
+  PyTypeObject* grid_rows_iterator_type;
+  PyTypeObject* grid_neighbor_iterator_type;
+  PyTypeObject* combination_iterator_type;
+  PyTypeObject* int_array_type;
+  PyTypeObject* interval_map_type;
+  PyTypeObject* mapped_input_type;
+  PyTypeObject* mapped_input_iterator_type;
+  PyTypeObject* network_type;
+  PyTypeObject* weighted_axes_type;
+  /** `Point{N}i{bits}` types, in `PointND_specs()` order. */
+  PyTypeObject* point_nd_types[kPointNDTypeCount];
+  /** `PointArray{N}i{bits}` types, in `PointArrayND_specs()` order. */
+  PyTypeObject* point_array_nd_types[kPointNDTypeCount];
+  /** `Grid{N}` types, in `GridND_specs()` order. */
+  PyTypeObject* grid_nd_types[kGridNDTypeCount];
+
+  /** Unit points `Point.EAST` and so on, in `Direction` order. */
+  PyObject* direction_points[kDirectionCount];
+  /** The only `Direction` instances, in `Direction` order. */
+  PyObject* direction_members[kDirectionCount];
+  /** `copy.deepcopy`, imported the first time a grid copies a cell. */
+  PyObject* deepcopy_func;
+
+  /**
+   * Points that were deallocated and are waiting to be recycled. The objects
+   * are uninitialized memory from `tp_alloc` until `PyObject_Init` is called
+   * on them, and hold no reference to the point type.
+   */
+  PyObject* point_free_list[kPointFreeListMax];
+  /** Number of entries in `point_free_list`. */
+  int point_free_list_size;
+  /** Inclusive lower bound of both axes of the frozen point intern window. */
+  long intern_min;
+  /** Inclusive upper bound of both axes of the frozen point intern window. */
+  long intern_max;
+  /**
+   * Interned frozen points for every coordinate in the window, in row major
+   * order. Allocated on first use and filled in lazily, holding a reference
+   * to each entry.
+   */
+  PyObject** intern_table;
+
+  AllocStats alloc_stats;
+};
+
+/** Definition of the oatmeal module, which every oatmeal type belongs to. */
+extern PyModuleDef oatmeal_module;
+
+/** State of an oatmeal module object. */
+inline OatmealState* Oatmeal_state(PyObject* module) {
+  return static_cast<OatmealState*>(PyModule_GetState(module));
+}
+
+/** State of the oatmeal module that defined `type`, or null if it did not. */
+inline OatmealState* Oatmeal_exact_type_state(PyTypeObject* type) {
+  if (!PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE)) {
+    return nullptr;
+  }
+
+  PyObject* mod = reinterpret_cast<PyHeapTypeObject*>(type)->ht_module;
+  return mod != nullptr && PyModule_GetDef(mod) == &oatmeal_module
+             ? Oatmeal_state(mod)
+             : nullptr;
+}
+
+/** `Oatmeal_type_state` for a type that oatmeal did not define itself. */
+OatmealState* Oatmeal_base_type_state(PyTypeObject* type);
+
+/**
+ * State of the oatmeal module that defined `type` or the nearest of its bases
+ * that oatmeal defined. Returns null without an exception for types that are
+ * not oatmeal's, so binary operators can use it to test their operands.
+ */
+inline OatmealState* Oatmeal_type_state(PyTypeObject* type) {
+  // The exact type is almost always oatmeal's, so check it inline before
+  // walking the bases.
+  auto* st = Oatmeal_exact_type_state(type);
+  return st != nullptr ? st : Oatmeal_base_type_state(type);
+}
+
+/** State of the oatmeal module that defined the type of `obj`. */
+inline OatmealState* Oatmeal_object_state(PyObject* obj) {
+  return Oatmeal_type_state(Py_TYPE(obj));
+}
+
+/**
+ * State for a binary operator, which comes from whichever operand oatmeal
+ * defined since Python may call the operator with its own object on the right.
+ */
+inline OatmealState* Oatmeal_operand_state(PyObject* left, PyObject* right) {
+  auto* st = Oatmeal_object_state(left);
+  return st != nullptr ? st : Oatmeal_object_state(right);
+}
+
+/**
+ * Free an instance of an oatmeal type and release the reference the instance
+ * held to its heap type. Used at the end of every `tp_dealloc`.
+ */
+inline void Oatmeal_free(PyObject* self) {
+  PyTypeObject* type = Py_TYPE(self);
+  type->tp_free(self);
+  Py_DECREF(type);
+}
+
+/** inc(value: float) -> float */
+PyObject* inc(PyObject* module, PyObject* value);
+
+/** alloc_stats() -> dict[str, int] */
+PyObject* alloc_stats(PyObject* module, PyObject*);
+
+/** reset_alloc_stats() */
+PyObject* reset_alloc_stats(PyObject* module, PyObject*);
@@ -0,0 +1,155 @@
+#include "parallel.h"
+
+#include <memory>
+#include <system_error>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace {
+  /** Most workers the shared pool starts, however many are asked for. */
+  constexpr size_t kMaxWorkers = 256;
+
+  /** Guards creating and replacing `shared_pool`. */
+  std::mutex shared_pool_mutex;
+
+  /**
+   * The pool returned by `ThreadPool::shared`. It is never destroyed, since
+   * its workers can still be waiting for tasks while the process exits.
+   */
+  ThreadPool* shared_pool = nullptr;
+
+#ifndef _WIN32
+  // Hold the lock across a fork so the child never inherits it locked by a
+  // thread that no longer exists, and leave the child without a pool.
+  void before_fork() { shared_pool_mutex.lock(); }
+
+  void after_fork_in_parent() { shared_pool_mutex.unlock(); }
+
+  void after_fork_in_child() {
+    shared_pool = nullptr;
+    shared_pool_mutex.unlock();
+  }
+#endif
+
+  /** State shared by the calling thread and the helpers of `parallel_run`. */
+  struct ParallelJob {
+    std::mutex mutex;
+    std::condition_variable finished;
+    /** Helpers currently running `work`. */
+    size_t active = 0;
+    /** Set once the caller is done, after which helpers skip `work`. */
+    bool closed = false;
+    /** The caller's task, only valid until `closed` is set. */
+    const std::function<void()>* work = nullptr;
+
+    /** Run the task from a helper unless the caller is already done. */
+    void help() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (closed) {
+          return;
+        }
+
+        active++;
+      }
+
+      (*work)();
+
+      std::lock_guard<std::mutex> lock(mutex);
+
+      if (--active == 0) {
+        finished.notify_all();
+      }
+    }
+
+    /** Stop helpers from starting and wait for the running ones. */
+    void close() {
+      std::unique_lock<std::mutex> lock(mutex);
+      closed = true;
+      finished.wait(lock, [this]() { return active == 0; });
+    }
+  };
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// ThreadPool definitions.
+//--------------------------------------------------------------------------------------------------
+ThreadPool& ThreadPool::shared() {
+  std::lock_guard<std::mutex> lock(shared_pool_mutex);
+
+  if (shared_pool == nullptr) {
+#ifndef _WIN32
+    static const int registered = pthread_atfork(
+        before_fork, after_fork_in_parent, after_fork_in_child);
+    (void)registered;
+#endif
+    shared_pool = new ThreadPool();
+  }
+
+  return *shared_pool;
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t ThreadPool::reserve(size_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  while (workers_.size() < std::min(count, kMaxWorkers)) {
+    try {
+      workers_.emplace_back([this]() { work(); });
+    } catch (const std::system_error&) {
+      // Carry on with however many threads could be started.
+      break;
+    }
+  }
+
+  return workers_.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+
+  ready_.notify_one();
+}
+
+//--------------------------------------------------------------------------------------------------
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this]() { return !tasks_.empty(); });
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Parallel loop definitions.
+//--------------------------------------------------------------------------------------------------
+void parallel_run(size_t helpers, const std::function<void()>& work) {
+  auto& pool = ThreadPool::shared();
+  auto job = std::make_shared<ParallelJob>();
+  job->work = &work;
+
+  // Helpers hold their own reference to the job, since a helper the pool only
+  // gets to after this returns still needs to see that it was closed.
+  helpers = std::min(helpers, pool.reserve(helpers));
+
+  for (size_t i = 0; i < helpers; ++i) {
+    pool.submit([job]() { job->help(); });
+  }
+
+  work();
+  job->close();
+}
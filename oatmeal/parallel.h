@@ -0,0 +1,98 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Number of worker threads to use for a `threads` argument, where zero or
+ * less picks one thread per core.
+ */
+inline size_t worker_count(Py_ssize_t threads) {
+  if (threads > 0) {
+    return static_cast<size_t>(threads);
+  }
+
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Worker threads shared by every parallel kernel. Workers are started the
+ * first time a kernel asks for them and then wait for more tasks, so repeated
+ * kernel calls do not pay for starting threads. The pool never touches Python
+ * objects, so its workers run without the GIL.
+ */
+class ThreadPool {
+public:
+  /**
+   * The process wide pool. A child process forked from this one gets a new
+   * empty pool, since the parent's workers do not exist in the child.
+   */
+  static ThreadPool& shared();
+
+  /**
+   * Start workers until there are at least `count`, returning how many there
+   * are. This can return fewer if `count` is past the pool's limit or the
+   * system refuses to start more threads.
+   */
+  size_t reserve(size_t count);
+
+  /** Queue `task` to run on the next free worker. */
+  void submit(std::function<void()> task);
+
+private:
+  ThreadPool() = default;
+
+  /** Worker thread body, running queued tasks forever. */
+  void work();
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> workers_;
+};
+
+/**
+ * Run `work` on the calling thread and on up to `helpers` pool workers at the
+ * same time, returning once every copy that started has finished. Workers
+ * that only get to the task after the calling thread is done skip it, so
+ * this never waits on a busy pool and is safe to call from a pool worker.
+ */
+void parallel_run(size_t helpers, const std::function<void()>& work);
+
+/**
+ * Run `fn(state, i)` for every `i` in `[0, count)` across up to `threads`
+ * threads, where each thread gets its own `state` from `make_state()`. The
+ * calling thread does a share of the work and the rest goes to the shared
+ * pool, so a single thread never involves the pool at all.
+ */
+template <typename MakeState, typename Fn>
+void parallel_for(
+    size_t count,
+    size_t threads,
+    MakeState&& make_state,
+    Fn&& fn) {
+  std::atomic<size_t> next{0};
+  const std::function<void()> worker = [&]() {
+    auto state = make_state();
+
+    for (size_t i = next++; i < count; i = next++) {
+      fn(state, i);
+    }
+  };
+
+  const auto helpers = std::min(threads, count);
+
+  if (helpers <= 1) {
+    worker();
+  } else {
+    parallel_run(helpers - 1, worker);
+  }
+}
@@ -0,0 +1,526 @@
+#include "parse.h"
+#include "int_array.h"
+#include "mapped_input.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+  /** How `parse_ints` splits text into integers. */
+  struct ParseOptions {
+    /** Field separator, only used when `has_sep` is set. */
+    char sep = 0;
+    bool has_sep = false;
+    bool is_signed = true;
+  };
+
+  enum class ParseStatus { Ok, Invalid, Overflow, NoMemory };
+
+  /** Outcome of parsing one span, with the byte offset of any failure. */
+  struct ParseResult {
+    ParseStatus status = ParseStatus::Ok;
+    size_t offset = 0;
+  };
+
+  /** Text at least this long is parsed with the GIL released. */
+  constexpr size_t kReleaseGilBytes = 1 << 16;
+
+  /** Largest magnitude of a positive int64. */
+  constexpr uint64_t kMaxPositive = std::numeric_limits<int64_t>::max();
+
+  /** Largest magnitude of a negative int64. */
+  constexpr uint64_t kMaxNegative = kMaxPositive + 1;
+
+  /** `kPow10[n]` is ten to the power of `n`. */
+  constexpr uint64_t kPow10[] = {
+      1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+  /**
+   * Values no larger than `kSafeFor[n]` can take `n` more digits without any
+   * risk of overflow. Checking this first keeps the division of the exact
+   * check off the common path.
+   */
+  constexpr uint64_t kSafeFor[] = {
+      kMaxPositive,
+      kMaxPositive / kPow10[1] - 1,
+      kMaxPositive / kPow10[2] - 1,
+      kMaxPositive / kPow10[3] - 1,
+      kMaxPositive / kPow10[4] - 1,
+      kMaxPositive / kPow10[5] - 1,
+      kMaxPositive / kPow10[6] - 1,
+      kMaxPositive / kPow10[7] - 1,
+      kMaxPositive / kPow10[8] - 1};
+
+  constexpr uint64_t kZeroDigits = 0x3030303030303030;
+
+  constexpr uint64_t kHighBits = 0x8080808080808080;
+
+  /** Eight bytes are only scanned as a word on little endian targets. */
+  constexpr bool kWordScan = std::endian::native == std::endian::little;
+
+  bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+  bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+  uint64_t load_word(const char* p) {
+    uint64_t word = 0;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+  }
+
+  /** High bit of each byte of the result is set where `word` holds a digit. */
+  uint64_t digit_bits(uint64_t word) {
+    // Digits become 0 to 9 after the xor. Adding 0x76 to the low 7 bits then
+    // sets the high bit for anything above 9 without carrying into the next
+    // byte, and or-ing `x` back in catches bytes that were already >= 0x80.
+    const uint64_t x = word ^ kZeroDigits;
+    const uint64_t not_digit =
+        ((x & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | x;
+    return ~not_digit & kHighBits;
+  }
+
+  /** Value of eight ASCII digits packed into `word`, first digit lowest. */
+  uint64_t parse_eight_digits(uint64_t word) {
+    // Combine neighbouring digits into pairs, then pairs into groups of four,
+    // then the two groups of four, with one multiply per step.
+    word -= kZeroDigits;
+    word = (word * 10) + (word >> 8);
+    word = (((word & 0x000000FF000000FF) * 0x000F424000000064) +
+            (((word >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >>
+           32;
+    return word;
+  }
+
+  /** First digit at or after `p`, or `end` if there are none. */
+  const char* skip_to_digit(const char* p, const char* end) {
+    if constexpr (kWordScan) {
+      while (end - p >= 8) {
+        const auto digits = digit_bits(load_word(p));
+
+        if (digits != 0) {
+          return p + std::countr_zero(digits) / 8;
+        }
+
+        p += 8;
+      }
+    }
+
+    while (p < end && !is_digit(*p)) {
+      ++p;
+    }
+
+    return p;
+  }
+
+  /**
+   * Read the run of digits starting at `*p`, advancing `*p` past it. Returns
+   * false if the value would be larger than `limit`.
+   */
+  bool parse_digits(
+      const char** p,
+      const char* end,
+      uint64_t limit,
+      uint64_t* out) {
+    const char* cursor = *p;
+    uint64_t value = 0;
+
+    if constexpr (kWordScan) {
+      while (end - cursor >= 8) {
+        // Parse however many leading bytes of the word are digits in one go.
+        // A short run is shifted to the top of the word and padded in front
+        // with '0' characters, which leaves its value unchanged.
+        const auto word = load_word(cursor);
+        const auto not_digits = ~digit_bits(word) & kHighBits;
+        const auto count =
+            not_digits == 0 ? 8 : std::countr_zero(not_digits) / 8;
+
+        if (count == 0) {
+          break;
+        }
+
+        const auto chunk = parse_eight_digits(
+            count == 8 ? word
+                       : (word << (64 - 8 * count)) |
+                             (kZeroDigits >> (8 * count)));
+
+        if (value > kSafeFor[count] &&
+            value > (limit - chunk) / kPow10[count]) {
+          return false;
+        }
+
+        value = value * kPow10[count] + chunk;
+        cursor += count;
+
+        if (count < 8) {
+          *p = cursor;
+          *out = value;
+          return true;
+        }
+      }
+    }
+
+    for (; cursor < end && is_digit(*cursor); ++cursor) {
+      const auto digit = static_cast<uint64_t>(*cursor - '0');
+
+      if (value > kSafeFor[1] && value > (limit - digit) / 10) {
+        return false;
+      }
+
+      value = value * 10 + digit;
+    }
+
+    *p = cursor;
+    *out = value;
+
+    return true;
+  }
+
+  /** Convert a magnitude and sign to an int64 without signed overflow. */
+  int64_t apply_sign(uint64_t magnitude, bool negative) {
+    return static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
+  }
+
+  /** Append every run of digits in `[begin, end)` to `out`. */
+  ParseResult parse_digit_runs(
+      const char* begin,
+      const char* end,
+      const ParseOptions& options,
+      IntArray* out) {
+    for (const char* p = skip_to_digit(begin, end); p < end;
+         p = skip_to_digit(p, end)) {
+      const bool negative = options.is_signed && p > begin && p[-1] == '-';
+      const char* start = negative ? p - 1 : p;
+      uint64_t magnitude = 0;
+
+      if (!parse_digits(
+              &p, end, negative ? kMaxNegative : kMaxPositive, &magnitude)) {
+        return {ParseStatus::Overflow, static_cast<size_t>(start - begin)};
+      }
+
+      if (!IntArray_push_back(out, apply_sign(magnitude, negative))) {
+        return {ParseStatus::NoMemory, 0};
+      }
+    }
+
+    return {};
+  }
+
+  /** Append each `sep` separated field of `[begin, end)` to `out`. */
+  ParseResult parse_fields(
+      const char* begin,
+      const char* end,
+      const ParseOptions& options,
+      IntArray* out) {
+    // Blank text has no fields rather than one empty one, so empty rows parse.
+    const char* first = begin;
+    const char* last = end;
+
+    while (first < last && is_space(*first)) {
+      ++first;
+    }
+
+    while (last > first && is_space(last[-1])) {
+      --last;
+    }
+
+    if (first == last) {
+      return {};
+    }
+
+    for (const char* field = first;;) {
+      const auto* found = static_cast<const char*>(
+          std::memchr(field, options.sep, last - field));
+      const char* field_end = found != nullptr ? found : last;
+      const char* p = field;
+      const char* stop = field_end;
+
+      while (p < stop && is_space(*p)) {
+        ++p;
+      }
+
+      while (stop > p && is_space(stop[-1])) {
+        --stop;
+      }
+
+      const bool negative = options.is_signed && p < stop && *p == '-';
+      p += (negative || (p < stop && *p == '+')) ? 1 : 0;
+
+      const ParseResult invalid = {
+          ParseStatus::Invalid, static_cast<size_t>(field - begin)};
+      uint64_t magnitude = 0;
+
+      if (p == stop || !is_digit(*p)) {
+        return invalid;
+      }
+
+      if (!parse_digits(
+              &p, stop, negative ? kMaxNegative : kMaxPositive, &magnitude)) {
+        return {ParseStatus::Overflow, invalid.offset};
+      }
+
+      if (p != stop) {
+        return invalid;
+      }
+
+      if (!IntArray_push_back(out, apply_sign(magnitude, negative))) {
+        return {ParseStatus::NoMemory, 0};
+      }
+
+      if (found == nullptr) {
+        return {};
+      }
+
+      field = found + 1;
+    }
+  }
+
+  ParseResult parse_span(
+      const char* begin,
+      const char* end,
+      const ParseOptions& options,
+      IntArray* out) {
+    return options.has_sep ? parse_fields(begin, end, options, out)
+                           : parse_digit_runs(begin, end, options, out);
+  }
+
+  /** Set the Python exception for a failed parse. `row` is -1 for no row. */
+  void raise_parse_error(const ParseResult& result, Py_ssize_t row) {
+    if (result.status == ParseStatus::NoMemory) {
+      PyErr_NoMemory();
+      return;
+    }
+
+    auto* type = result.status == ParseStatus::Overflow ? PyExc_OverflowError
+                                                        : PyExc_ValueError;
+    const char* what = result.status == ParseStatus::Overflow
+                           ? "integer does not fit in int64"
+                           : "invalid integer field";
+
+    if (row < 0) {
+      PyErr_Format(type, "%s at offset %zu", what, result.offset);
+    } else {
+      PyErr_Format(
+          type, "%s at offset %zu of row %zd", what, result.offset, row);
+    }
+  }
+
+  /** Read the `sep` and `signed` arguments shared by both parsers. */
+  bool parse_options(PyObject* sep, int is_signed, ParseOptions* out) {
+    out->is_signed = is_signed != 0;
+
+    if (sep == nullptr || sep == Py_None) {
+      return true;
+    }
+
+    Py_ssize_t size = 0;
+    const char* text =
+        PyUnicode_Check(sep) ? PyUnicode_AsUTF8AndSize(sep, &size) : nullptr;
+
+    if (text == nullptr || size != 1 || is_digit(text[0]) || text[0] == '-' ||
+        text[0] == '+' || is_space(text[0])) {
+      PyErr_Clear();
+      PyErr_SetString(
+          PyExc_ValueError,
+          "argument `sep` must be None or a single ASCII character that is "
+          "not a digit, sign or space");
+      return false;
+    }
+
+    out->sep = text[0];
+    out->has_sep = true;
+
+    return true;
+  }
+
+  /** Parse every line of a mapped input with the GIL released. */
+  bool parse_mapped_rows(
+      MappedInput* lines,
+      const ParseOptions& options,
+      IntArray* values,
+      IntArray* offsets) {
+    if (!lines->file.is_open()) {
+      PyErr_SetString(PyExc_ValueError, "I/O operation on closed input");
+      return false;
+    }
+
+    // Hold an export so the file cannot be unmapped while the GIL is released.
+    const MappedLines mapped(lines);
+    ParseResult result;
+    Py_ssize_t row = 0;
+    bool ok = true;
+
+    lines->exports++;
+    Py_BEGIN_ALLOW_THREADS;
+
+    mapped.for_each([&](const char* begin, const char* end) {
+      result = parse_span(begin, end, options, values);
+      ok = result.status == ParseStatus::Ok &&
+           IntArray_push_back(offsets, values->count);
+      row += ok ? 1 : 0;
+      return ok;
+    });
+
+    Py_END_ALLOW_THREADS;
+    lines->exports--;
+
+    if (!ok) {
+      raise_parse_error(
+          result.status == ParseStatus::Ok ? ParseResult{ParseStatus::NoMemory}
+                                           : result,
+          row);
+    }
+
+    return ok;
+  }
+
+  /** Parse each `str` or bytes like item produced by iterating `lines`. */
+  bool parse_iterable_rows(
+      PyObject* lines,
+      const ParseOptions& options,
+      IntArray* values,
+      IntArray* offsets) {
+    PyObject* iter = PyObject_GetIter(lines);
+
+    if (iter == nullptr) {
+      return false;
+    }
+
+    Py_ssize_t row = 0;
+
+    while (PyObject* item = PyIter_Next(iter)) {
+      TextSpan text;
+      const bool opened = text.open(item);
+      Py_DECREF(item);
+
+      if (!opened) {
+        Py_DECREF(iter);
+        return false;
+      }
+
+      const auto result =
+          parse_span(text.begin(), text.end(), options, values);
+
+      if (result.status != ParseStatus::Ok) {
+        raise_parse_error(result, row);
+        Py_DECREF(iter);
+        return false;
+      }
+
+      if (!IntArray_push_back(offsets, values->count)) {
+        PyErr_NoMemory();
+        Py_DECREF(iter);
+        return false;
+      }
+
+      row++;
+    }
+
+    Py_DECREF(iter);
+    return !PyErr_Occurred();
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* parse_ints(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"buf", "sep", "signed", nullptr};
+  PyObject* buf = nullptr;
+  PyObject* sep = nullptr;
+  int is_signed = 1;
+  ParseOptions options;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "O|Op",
+          const_cast<char**>(kwlist),
+          &buf,
+          &sep,
+          &is_signed) ||
+      !parse_options(sep, is_signed, &options)) {
+    return nullptr;
+  }
+
+  TextSpan text;
+
+  if (!text.open(buf)) {
+    return nullptr;
+  }
+
+  auto* values = IntArray_create(Oatmeal_state(module), 0);
+
+  if (values == nullptr) {
+    return nullptr;
+  }
+
+  // Short lines are cheaper to parse than to hand the GIL over for. The text
+  // is either an immutable str or a held buffer export, so it cannot change.
+  ParseResult result;
+
+  if (text.size() < kReleaseGilBytes) {
+    result = parse_span(text.begin(), text.end(), options, values);
+  } else {
+    Py_BEGIN_ALLOW_THREADS;
+    result = parse_span(text.begin(), text.end(), options, values);
+    Py_END_ALLOW_THREADS;
+  }
+
+  if (result.status != ParseStatus::Ok) {
+    raise_parse_error(result, -1);
+    Py_DECREF(values);
+    return nullptr;
+  }
+
+  return reinterpret_cast<PyObject*>(values);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* parse_int_rows(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"lines", "sep", "signed", nullptr};
+  PyObject* lines = nullptr;
+  PyObject* sep = nullptr;
+  int is_signed = 1;
+  ParseOptions options;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "O|Op",
+          const_cast<char**>(kwlist),
+          &lines,
+          &sep,
+          &is_signed) ||
+      !parse_options(sep, is_signed, &options)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_state(module);
+  auto* values = IntArray_create(st, 0);
+  auto* offsets = IntArray_create(st, 0);
+
+  if (values == nullptr || offsets == nullptr ||
+      !IntArray_push_back(offsets, 0)) {
+    Py_XDECREF(values);
+    Py_XDECREF(offsets);
+    return PyErr_Occurred() ? nullptr : PyErr_NoMemory();
+  }
+
+  const bool ok =
+      PyObject_TypeCheck(lines, st->mapped_input_type) != 0
+          ? parse_mapped_rows(
+                reinterpret_cast<MappedInput*>(lines), options, values, offsets)
+          : parse_iterable_rows(lines, options, values, offsets);
+
+  if (!ok) {
+    Py_DECREF(values);
+    Py_DECREF(offsets);
+    return nullptr;
+  }
+
+  PyObject* result = PyTuple_Pack(2, values, offsets);
+  Py_DECREF(values);
+  Py_DECREF(offsets);
+
+  return result;
+}
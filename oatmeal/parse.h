@@ -0,0 +1,33 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * parse_ints(
+ *  buf: str | bytes | Buffer,
+ *  sep: str | None = None,
+ *  signed: bool = True,
+ * ) -> IntArray
+ *
+ * Parse the integers in `buf` into a contiguous int64 array. With no `sep`
+ * every run of digits is read and anything else is skipped, so a line like
+ * `"Card 1: 41 48 | 83"` gives `[1, 41, 48, 83]`. With a single character
+ * `sep` the text is split on it and each field, ignoring surrounding spaces,
+ * must be exactly one integer. A `-` directly before a number negates it
+ * unless `signed` is false, in which case it is treated as a separator.
+ */
+PyObject* parse_ints(PyObject* module, PyObject* args, PyObject* kwds);
+
+/**
+ * parse_int_rows(
+ *  lines: MappedInput | Iterable[str | bytes],
+ *  sep: str | None = None,
+ *  signed: bool = True,
+ * ) -> Tuple[IntArray, IntArray]
+ *
+ * Parse every line with the same rules as `parse_ints` into one ragged array,
+ * returned as `(values, offsets)`. Row `i` is `values[offsets[i]:offsets[i +
+ * 1]]`, and `offsets` holds one more entry than there are rows. Mapped inputs
+ * are read straight from the mapped file without creating any `str` objects.
+ */
+PyObject* parse_int_rows(PyObject* module, PyObject* args, PyObject* kwds);
@@ -0,0 +1,362 @@
+#include "pipes.h"
+#include "grid.h"
+#include "mapped_input.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+  /** Connection bits of a tile, one per direction in `Direction` order. */
+  constexpr uint8_t kEast = 1 << 0;
+  constexpr uint8_t kNorth = 1 << 1;
+  constexpr uint8_t kWest = 1 << 2;
+  constexpr uint8_t kSouth = 1 << 3;
+
+  /** Marks the start tile until its connections are known. */
+  constexpr uint8_t kStart = 1 << 4;
+
+  constexpr uint8_t kNotATile = 0xFF;
+
+  /** Connection bits of every tile character, or `kNotATile`. */
+  constexpr auto kTileBits = []() {
+    std::array<uint8_t, 256> bits{};
+
+    for (auto& b : bits) {
+      b = kNotATile;
+    }
+
+    bits['|'] = kNorth | kSouth;
+    bits['-'] = kEast | kWest;
+    bits['L'] = kNorth | kEast;
+    bits['J'] = kNorth | kWest;
+    bits['7'] = kSouth | kWest;
+    bits['F'] = kSouth | kEast;
+    bits['.'] = 0;
+    bits['S'] = kStart;
+    return bits;
+  }();
+
+  int reverse(int dir) { return (dir + 2) % 4; }
+
+  /** Outcome of decoding a maze or tracing its loop. */
+  enum class MazeStatus {
+    Ok,
+    UnknownTile,
+    Ragged,
+    ExtraStart,
+    NoStart,
+    Broken
+  };
+
+  /** A rectangular maze of packed connection bits. */
+  struct Maze {
+    size_t width = 0;
+    size_t height = 0;
+    std::vector<uint8_t> tiles;
+    size_t start = SIZE_MAX;
+
+    /** Decode the next row, skipping rows that are empty. */
+    MazeStatus push(const char* begin, const char* end) {
+      const auto count = static_cast<size_t>(end - begin);
+
+      if (count == 0) {
+        return MazeStatus::Ok;
+      } else if (height == 0) {
+        width = count;
+      } else if (count != width) {
+        return MazeStatus::Ragged;
+      }
+
+      for (const char* c = begin; c != end; ++c) {
+        const auto bits = kTileBits[static_cast<unsigned char>(*c)];
+
+        if (bits == kNotATile) {
+          return MazeStatus::UnknownTile;
+        } else if (bits == kStart && start != SIZE_MAX) {
+          return MazeStatus::ExtraStart;
+        } else if (bits == kStart) {
+          start = tiles.size();
+        }
+
+        tiles.push_back(bits);
+      }
+
+      height++;
+      return MazeStatus::Ok;
+    }
+
+    /** Tile `dir` of `index`, or false if that is off the maze. */
+    bool step(size_t index, int dir, size_t* out) const {
+      const auto x = static_cast<long>(index % width) + kDirectionX[dir];
+      const auto y = static_cast<long>(index / width) + kDirectionY[dir];
+
+      if (x < 0 || y < 0 || static_cast<size_t>(x) >= width ||
+          static_cast<size_t>(y) >= height) {
+        return false;
+      }
+
+      *out = static_cast<size_t>(y) * width + static_cast<size_t>(x);
+      return true;
+    }
+
+    /**
+     * Connect the start to each neighbour that points back at it. A start
+     * with anything but two such neighbours is not on exactly one loop.
+     */
+    bool connect_start() {
+      uint8_t bits = 0;
+
+      for (int dir = 0; dir < 4; ++dir) {
+        size_t next = 0;
+
+        if (step(start, dir, &next) &&
+            (tiles[next] & (1 << reverse(dir))) != 0) {
+          bits |= 1 << dir;
+        }
+      }
+
+      tiles[start] = bits;
+      return std::popcount(bits) == 2;
+    }
+
+    /**
+     * Follow the pipes from the start back to itself, calling `visit(index)`
+     * for every loop tile. Stores the length of the loop and twice its signed
+     * area, or returns false if a pipe leads off the loop.
+     */
+    template <typename Fn>
+    bool trace(int64_t* length, int64_t* area2, Fn&& visit) const {
+      auto index = start;
+      int dir = std::countr_zero(tiles[start]);
+      int64_t steps = 0;
+      int64_t area = 0;
+
+      do {
+        size_t next = 0;
+
+        if (!step(index, dir, &next) ||
+            (tiles[next] & (1 << reverse(dir))) == 0) {
+          return false;
+        }
+
+        // Shoelace term for the edge between the centres of the two tiles.
+        const auto x = static_cast<int64_t>(index % width);
+        const auto y = static_cast<int64_t>(index / width);
+        const auto nx = static_cast<int64_t>(next % width);
+        const auto ny = static_cast<int64_t>(next / width);
+
+        area += x * ny - nx * y;
+        steps++;
+        visit(next);
+
+        index = next;
+        dir = std::countr_zero(
+            static_cast<unsigned>(tiles[index] & ~(1 << reverse(dir))));
+      } while (index != start);
+
+      *length = steps;
+      *area2 = area;
+      return true;
+    }
+  };
+
+  /** Loop length and enclosed tiles found by either method. */
+  struct LoopSize {
+    int64_t length = 0;
+    int64_t enclosed = 0;
+  };
+
+  /**
+   * Count the enclosed tiles with the shoelace formula and Pick's theorem,
+   * where the loop passes through the centre of `length` tiles that are all
+   * lattice points on its boundary.
+   */
+  bool shoelace_size(const Maze& maze, LoopSize* out) {
+    int64_t area2 = 0;
+
+    if (!maze.trace(&out->length, &area2, [](size_t) {})) {
+      return false;
+    }
+
+    out->enclosed = ((area2 < 0 ? -area2 : area2) - out->length + 2) / 2;
+    return true;
+  }
+
+  /**
+   * Count the enclosed tiles by scanning each row from the left, where a tile
+   * is inside once an odd number of loop tiles with a north connection have
+   * been crossed. Horizontal runs only flip the count if they turn through.
+   */
+  bool scanline_size(const Maze& maze, LoopSize* out) {
+    std::vector<uint8_t> on_loop(maze.tiles.size(), 0);
+    int64_t area2 = 0;
+
+    if (!maze.trace(&out->length, &area2, [&](size_t i) { on_loop[i] = 1; })) {
+      return false;
+    }
+
+    for (size_t i = 0; i < maze.tiles.size(); i += maze.width) {
+      bool inside = false;
+
+      for (size_t x = i; x < i + maze.width; ++x) {
+        if (on_loop[x] != 0) {
+          inside ^= (maze.tiles[x] & kNorth) != 0;
+        } else {
+          out->enclosed += inside ? 1 : 0;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /** Measure the loop of a decoded maze. */
+  MazeStatus measure(Maze* maze, bool scanline, LoopSize* out) {
+    if (maze->start == SIZE_MAX) {
+      return MazeStatus::NoStart;
+    } else if (!maze->connect_start()) {
+      return MazeStatus::Broken;
+    }
+
+    const bool ok =
+        scanline ? scanline_size(*maze, out) : shoelace_size(*maze, out);
+    return ok ? MazeStatus::Ok : MazeStatus::Broken;
+  }
+
+  /** Raise the error for a maze that could not be decoded or measured. */
+  void raise_maze_error(MazeStatus status, Py_ssize_t row) {
+    switch (status) {
+    case MazeStatus::UnknownTile:
+      PyErr_Format(PyExc_ValueError, "row %zd has an unknown tile", row);
+      break;
+    case MazeStatus::Ragged:
+      PyErr_Format(PyExc_ValueError, "row %zd has a different width", row);
+      break;
+    case MazeStatus::ExtraStart:
+      PyErr_Format(PyExc_ValueError, "row %zd has a second start", row);
+      break;
+    case MazeStatus::NoStart:
+      PyErr_SetString(PyExc_ValueError, "maze has no start tile");
+      break;
+    default:
+      PyErr_SetString(
+          PyExc_ValueError, "start is not on exactly one loop of pipes");
+      break;
+    }
+  }
+
+  /** Decode and measure a mapped input without the GIL. */
+  bool mapped_loop(MappedInput* lines, bool scanline, LoopSize* out) {
+    if (!lines->file.is_open()) {
+      PyErr_SetString(PyExc_ValueError, "I/O operation on closed input");
+      return false;
+    }
+
+    // Hold an export so the file cannot be unmapped while the GIL is released.
+    const MappedLines mapped(lines);
+    Maze maze;
+    auto status = MazeStatus::Ok;
+    Py_ssize_t row = 0;
+
+    lines->exports++;
+    Py_BEGIN_ALLOW_THREADS;
+
+    mapped.for_each([&](const char* begin, const char* end) {
+      status = maze.push(begin, end);
+      row += status == MazeStatus::Ok ? 1 : 0;
+      return status == MazeStatus::Ok;
+    });
+
+    if (status == MazeStatus::Ok) {
+      status = measure(&maze, scanline, out);
+    }
+
+    Py_END_ALLOW_THREADS;
+    lines->exports--;
+
+    if (status != MazeStatus::Ok) {
+      raise_maze_error(status, row);
+    }
+
+    return status == MazeStatus::Ok;
+  }
+
+  /** Decode each `str` or bytes like line of an iterable, then measure it. */
+  bool iterable_loop(PyObject* lines, bool scanline, LoopSize* out) {
+    PyObject* iter = PyObject_GetIter(lines);
+
+    if (iter == nullptr) {
+      return false;
+    }
+
+    Maze maze;
+    auto status = MazeStatus::Ok;
+    Py_ssize_t row = 0;
+
+    while (PyObject* item = PyIter_Next(iter)) {
+      TextSpan text;
+      const bool opened = text.open(item);
+
+      status = opened ? maze.push(text.begin(), text.end()) : status;
+      Py_DECREF(item);
+
+      if (!opened || status != MazeStatus::Ok) {
+        break;
+      }
+
+      row++;
+    }
+
+    Py_DECREF(iter);
+
+    if (PyErr_Occurred()) {
+      return false;
+    }
+
+    if (status == MazeStatus::Ok) {
+      Py_BEGIN_ALLOW_THREADS;
+      status = measure(&maze, scanline, out);
+      Py_END_ALLOW_THREADS;
+    }
+
+    if (status != MazeStatus::Ok) {
+      raise_maze_error(status, row);
+    }
+
+    return status == MazeStatus::Ok;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* pipe_loop(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"lines", "method", nullptr};
+  PyObject* lines = nullptr;
+  const char* method = "shoelace";
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|s", const_cast<char**>(kwlist), &lines, &method)) {
+    return nullptr;
+  }
+
+  const bool scanline = std::strcmp(method, "scanline") == 0;
+
+  if (!scanline && std::strcmp(method, "shoelace") != 0) {
+    PyErr_Format(PyExc_ValueError, "unknown pipe loop method `%s`", method);
+    return nullptr;
+  }
+
+  LoopSize size;
+  const bool ok =
+      PyObject_TypeCheck(lines, Oatmeal_state(module)->mapped_input_type) != 0
+          ? mapped_loop(reinterpret_cast<MappedInput*>(lines), scanline, &size)
+          : iterable_loop(lines, scanline, &size);
+
+  if (!ok) {
+    return nullptr;
+  }
+
+  return Py_BuildValue("LL", size.length, size.enclosed);
+}
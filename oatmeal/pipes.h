@@ -0,0 +1,23 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * pipe_loop(
+ *  lines: MappedInput | Iterable[str | bytes],
+ *  method: str = "shoelace",
+ * ) -> tuple[int, int]
+ *
+ * Trace the loop of pipes through the `S` tile of a rectangular pipe maze and
+ * return its length in tiles along with the number of tiles it encloses. The
+ * pipes `|-LJ7F` are packed into four connection bits per tile in `Direction`
+ * order, and `S` takes whichever connections its neighbours point back at.
+ *
+ * The enclosed tiles are counted with the shoelace formula and Pick's theorem
+ * when `method` is `"shoelace"`, or by counting loop crossings along each row
+ * when it is `"scanline"`. Both take O(width * height) time without holding
+ * the GIL once the maze is decoded, and lines of a `MappedInput` are decoded
+ * without it too. Raises ValueError for an unknown tile, a ragged maze or a
+ * start that is not on exactly one loop.
+ */
+PyObject* pipe_loop(PyObject* module, PyObject* args, PyObject* kwds);
@@ -1,18 +1,215 @@
 #include "point.h"
+#include "grid.h"
 
+#include <algorithm>
 #include <cmath>
-#include <functional>
-
-#include <structmember.h>
+#include <iterator>
 
 namespace {
-  /** Create a new Point PyObject and initialize to the given x and y. */
-  PyObject* create_point(long x, long y) {
-    PyObject* init_args = Py_BuildValue("ll", x, y);
-    PyObject* point_obj = PyObject_CallObject((PyObject*)&PointType, init_args);
-    Py_DECREF(init_args);
+  /** Names of the unit direction constants, in `Direction` order. */
+  constexpr const char* kDirectionNames[] = {
+      "EAST",
+      "NORTH",
+      "WEST",
+      "SOUTH",
+      "NORTH_EAST",
+      "NORTH_WEST",
+      "SOUTH_WEST",
+      "SOUTH_EAST"};
+
+  /** Largest number of cells per side allowed in the intern window. */
+  constexpr long kMaxInternSide = 4096;
+
+  /** Intern window bounds that a new module object starts with. */
+  constexpr long kDefaultInternMin = -64;
+  constexpr long kDefaultInternMax = 256;
+
+  /** Number of cells on each side of the intern window. */
+  long intern_side(const OatmealState* st) {
+    return st->intern_max - st->intern_min + 1;
+  }
+
+  /** Release every interned point and the table itself. */
+  void clear_intern_table(OatmealState* st) {
+    if (st->intern_table != nullptr) {
+      for (long i = 0; i < intern_side(st) * intern_side(st); ++i) {
+        Py_CLEAR(st->intern_table[i]);
+      }
 
-    return point_obj;
+      PyMem_Free(st->intern_table);
+      st->intern_table = nullptr;
+    }
+  }
+
+  /** Returns true if `(x, y)` lies inside the intern window. */
+  bool in_intern_window(const OatmealState* st, long x, long y) {
+    return x >= st->intern_min && x <= st->intern_max && y >= st->intern_min &&
+           y <= st->intern_max;
+  }
+
+  /**
+   * Get the intern table slot for a coordinate inside the window, allocating
+   * the table on first use. Returns null with an exception set on failure.
+   */
+  PyObject** intern_slot(OatmealState* st, long x, long y) {
+    const auto side = intern_side(st);
+
+    if (st->intern_table == nullptr) {
+      st->intern_table =
+          static_cast<PyObject**>(PyMem_Calloc(side * side, sizeof(PyObject*)));
+
+      if (st->intern_table == nullptr) {
+        PyErr_NoMemory();
+        return nullptr;
+      }
+    }
+
+    return &st->intern_table
+                [(y - st->intern_min) * side + (x - st->intern_min)];
+  }
+
+  /** Allocate a new frozen point that is not interned. */
+  PyObject* alloc_frozen(OatmealState* st, long x, long y) {
+    auto* type = st->frozen_point_type;
+    auto* self = reinterpret_cast<Point*>(type->tp_alloc(type, 0));
+
+    if (self != nullptr) {
+      self->x = x;
+      self->y = y;
+      st->alloc_stats.frozen_points_created++;
+    }
+
+    return reinterpret_cast<PyObject*>(self);
+  }
+
+  /** Returns true if `obj` is a `Point` of this module, frozen or not. */
+  bool is_point(const OatmealState* st, PyObject* obj) {
+    return PyObject_TypeCheck(obj, st->point_type) != 0;
+  }
+
+  /** Returns true if `self` is a `FrozenPoint` and cannot be modified. */
+  bool is_frozen(const OatmealState* st, const Point* self) {
+    auto* obj = const_cast<PyObject*>(reinterpret_cast<const PyObject*>(self));
+
+    // Check the exact types first so plain points skip the subtype walk.
+    return Py_IS_TYPE(obj, st->frozen_point_type) ||
+           (!Py_IS_TYPE(obj, st->point_type) &&
+            PyObject_TypeCheck(obj, st->frozen_point_type) != 0);
+  }
+
+  /** `is_frozen` for a point whose module state is not at hand. */
+  bool is_frozen(const Point* self) {
+    auto* obj = const_cast<PyObject*>(reinterpret_cast<const PyObject*>(self));
+    return is_frozen(Oatmeal_object_state(obj), self);
+  }
+
+  /** Raise an error for an attempt to modify a frozen point. */
+  void raise_frozen_modified(PyObject* exception) {
+    PyErr_SetString(exception, "frozen points cannot be modified");
+  }
+
+  /**
+   * Create the result of an operator, which is frozen (and possibly interned)
+   * when the left operand is frozen and a plain mutable point otherwise.
+   */
+  PyObject* create_like(OatmealState* st, PyObject* like, long x, long y) {
+    return is_frozen(st, reinterpret_cast<Point*>(like))
+               ? FrozenPoint_create(st, x, y)
+               : Point_create(st, x, y);
+  }
+
+  /** Read a point component argument, returning false with an exception. */
+  bool component_arg(PyObject* obj, const char* name, long* out) {
+    *out = PyLong_AsLong(obj);
+
+    if (*out == -1 && PyErr_Occurred()) {
+      if (PyErr_ExceptionMatches(PyExc_TypeError)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "argument `%s` must be an int but was `%s`",
+            name,
+            Py_TYPE(obj)->tp_name);
+      }
+
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Parse `(x: int = 0, y: int = 0)` vectorcall arguments straight off the
+   * stack, rather than packing them into a tuple and dict.
+   */
+  bool parse_components(
+      const char* type_name,
+      PyObject* const* args,
+      size_t nargsf,
+      PyObject* kwnames,
+      long* x,
+      long* y) {
+    static const char* const kNames[] = {"x", "y"};
+    const auto nargs = PyVectorcall_NARGS(nargsf);
+    const auto nkwargs = kwnames == nullptr ? 0 : PyTuple_GET_SIZE(kwnames);
+    PyObject* values[2] = {nullptr, nullptr};
+
+    if (nargs > 2) {
+      PyErr_Format(
+          PyExc_TypeError,
+          "%s() takes at most 2 arguments (%zd given)",
+          type_name,
+          nargs);
+      return false;
+    }
+
+    for (Py_ssize_t i = 0; i < nargs; ++i) {
+      values[i] = args[i];
+    }
+
+    for (Py_ssize_t i = 0; i < nkwargs; ++i) {
+      PyObject* name = PyTuple_GET_ITEM(kwnames, i);
+      int index = -1;
+
+      for (int j = 0; j < 2; ++j) {
+        if (PyUnicode_CompareWithASCIIString(name, kNames[j]) == 0) {
+          index = j;
+        }
+      }
+
+      if (index < 0) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "%s() got an unexpected keyword argument '%U'",
+            type_name,
+            name);
+        return false;
+      }
+
+      if (values[index] != nullptr) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "argument for %s() given by name ('%s') and position (%d)",
+            type_name,
+            kNames[index],
+            index + 1);
+        return false;
+      }
+
+      values[index] = args[nargs + i];
+    }
+
+    long* components[2] = {x, y};
+
+    for (int i = 0; i < 2; ++i) {
+      *components[i] = 0;
+
+      if (values[i] != nullptr &&
+          !component_arg(values[i], kNames[i], components[i])) {
+        return false;
+      }
+    }
+
+    return true;
   }
 
   /**
@@ -34,80 +231,241 @@ namespace {
 //--------------------------------------------------------------------------------------------------
 // Point python type definition.
 //--------------------------------------------------------------------------------------------------
-PyMemberDef Point_Members[] = {
-    {"x", T_LONG, offsetof(Point, x), 0, "x component"},
-    {"y", T_LONG, offsetof(Point, y), 0, "y component"},
+PyGetSetDef Point_GetSet[] = {
+    {"x",
+     (getter)Point_get_component,
+     (setter)Point_set_component,
+     "x component",
+     reinterpret_cast<void*>(offsetof(Point, x))},
+    {"y",
+     (getter)Point_get_component,
+     (setter)Point_set_component,
+     "y component",
+     reinterpret_cast<void*>(offsetof(Point, y))},
     {nullptr}};
 
-PyMappingMethods Point_MappingMethods = {
-    .mp_length = Point_len,
-    .mp_subscript = Point_get,
-    .mp_ass_subscript = Point_set,
-};
-
-PyNumberMethods Point_NumberMethods = {
-    .nb_add = Point_add,
-    .nb_subtract = Point_sub,
-    .nb_multiply = Point_mul,
-    .nb_true_divide = Point_true_div,
-    .nb_floor_divide = Point_floor_div,
-    .nb_remainder = Point_mod,
-    .nb_negative = Point_negate,
-    .nb_absolute = Point_abs,
-};
-
 PyMethodDef Point_Methods[] = {
     {"clone",
      (PyCFunction)Point_clone,
      METH_NOARGS,
      "Return a copy of the point"},
-    {"__getstate__",
-     (PyCFunction)Point_getstate,
+    {"__reduce__",
+     (PyCFunction)Point_reduce,
      METH_NOARGS,
-     "pickle the point object"},
+     "pickle the point by its components"},
     {"__setstate__",
      (PyCFunction)Point_setstate,
      METH_O,
-     "un-pickle the point object"},
+     "un-pickle a point from the dict state of older pickles"},
     {nullptr}};
 
-PyTypeObject PointType = {
-    .ob_base = PyVarObject_HEAD_INIT(NULL, 0).tp_name = "oatmeal.Point",
-    .tp_doc = PyDoc_STR("2d point"),
-    .tp_basicsize = sizeof(Point),
-    .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT,
-    .tp_new = PyType_GenericNew,
-    .tp_init = (initproc)Point_init,
-    .tp_members = Point_Members,
-    .tp_methods = Point_Methods,
-    .tp_repr = Point_repr,
-    .tp_str = Point_str,
-    .tp_as_mapping = &Point_MappingMethods,
-    .tp_as_number = &Point_NumberMethods,
-    .tp_richcompare = &Point_compare,
-    .tp_hash = &Point_hash,
+PyType_Slot Point_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(Point_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(Point_repr)},
+    {Py_nb_add, reinterpret_cast<void*>(Point_add)},
+    {Py_nb_subtract, reinterpret_cast<void*>(Point_sub)},
+    {Py_nb_multiply, reinterpret_cast<void*>(Point_mul)},
+    {Py_nb_remainder, reinterpret_cast<void*>(Point_mod)},
+    {Py_nb_negative, reinterpret_cast<void*>(Point_negate)},
+    {Py_nb_absolute, reinterpret_cast<void*>(Point_abs)},
+    {Py_nb_floor_divide, reinterpret_cast<void*>(Point_floor_div)},
+    {Py_nb_true_divide, reinterpret_cast<void*>(Point_true_div)},
+    {Py_mp_length, reinterpret_cast<void*>(Point_len)},
+    {Py_mp_subscript, reinterpret_cast<void*>(Point_get)},
+    {Py_mp_ass_subscript, reinterpret_cast<void*>(Point_set)},
+    {Py_tp_hash, reinterpret_cast<void*>(Point_hash)},
+    {Py_tp_str, reinterpret_cast<void*>(Point_str)},
+    {Py_tp_doc, const_cast<char*>(PyDoc_STR("2d point"))},
+    {Py_tp_richcompare, reinterpret_cast<void*>(Point_compare)},
+    {Py_tp_methods, Point_Methods},
+    {Py_tp_getset, Point_GetSet},
+    {Py_tp_init, reinterpret_cast<void*>(Point_init)},
+    {Py_tp_new, reinterpret_cast<void*>(Point_new)},
+    {0, nullptr}};
+
+// `FrozenPoint` derives from `Point`, which makes it a base type.
+PyType_Spec Point_Spec = {
+    .name = "oatmeal.Point",
+    .basicsize = sizeof(Point),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE |
+             Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Point_Slots,
 };
 
 //--------------------------------------------------------------------------------------------------
 // Point method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* Point_create(OatmealState* st, long x, long y) {
+  Point* self = nullptr;
+
+  if (st->point_free_list_size > 0) {
+    self = reinterpret_cast<Point*>(
+        st->point_free_list[--st->point_free_list_size]);
+    PyObject_Init(reinterpret_cast<PyObject*>(self), st->point_type);
+    st->alloc_stats.point_free_list_hits++;
+  } else {
+    self = reinterpret_cast<Point*>(
+        st->point_type->tp_alloc(st->point_type, 0));
+
+    if (self == nullptr) {
+      return nullptr;
+    }
+  }
+
+  self->x = x;
+  self->y = y;
+  st->alloc_stats.points_created++;
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool Point_add_constants(OatmealState* st) {
+  st->intern_min = kDefaultInternMin;
+  st->intern_max = kDefaultInternMax;
+
+  for (int dir = 0; dir < kDirectionCount; ++dir) {
+    st->direction_points[dir] =
+        FrozenPoint_create(st, kDirectionX[dir], kDirectionY[dir]);
+
+    if (st->direction_points[dir] == nullptr ||
+        PyDict_SetItemString(
+            st->point_type->tp_dict,
+            kDirectionNames[dir],
+            st->direction_points[dir]) < 0) {
+      return false;
+    }
+  }
+
+  PyType_Modified(st->point_type);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+int Point_traverse_caches(OatmealState* st, visitproc visit, void* arg) {
+  if (st->intern_table != nullptr) {
+    for (long i = 0; i < intern_side(st) * intern_side(st); ++i) {
+      Py_VISIT(st->intern_table[i]);
+    }
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Point_clear_caches(OatmealState* st) {
+  clear_intern_table(st);
+
+  // Points on the free list were already finalized, so only their memory is
+  // left to release.
+  while (st->point_free_list_size > 0) {
+    PyObject_Free(st->point_free_list[--st->point_free_list_size]);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Point_direction(OatmealState* st, int dir) {
+  return st->direction_points[dir];
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Point_vectorcall(
+    PyObject* type,
+    PyObject* const* args,
+    size_t nargsf,
+    PyObject* kwnames) {
+  long x = 0;
+  long y = 0;
+
+  if (!parse_components("Point", args, nargsf, kwnames, &x, &y)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(type));
+  return Point_create(st, x, y);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* Point_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* st = Oatmeal_type_state(type);
+
+  // Only exact `Point` allocations can come from the free list, any other
+  // type falls back to the default allocator.
+  if (type != st->point_type) {
+    return type->tp_alloc(type, 0);
+  }
+
+  return Point_create(st, 0, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Point_dealloc(PyObject* obj_self) {
+  PyTypeObject* type = Py_TYPE(obj_self);
+  auto* st = Oatmeal_type_state(type);
+
+  if (type == st->point_type &&
+      st->point_free_list_size < kPointFreeListMax) {
+    st->point_free_list[st->point_free_list_size++] = obj_self;
+    Py_DECREF(type);
+  } else {
+    Oatmeal_free(obj_self);
+  }
+}
+
 //--------------------------------------------------------------------------------------------------
 int Point_init(Point* self, PyObject* args, PyObject* kwds) {
-  self->x = 0.0;
-  self->y = 0.0;
+  if (is_frozen(self)) {
+    raise_frozen_modified(PyExc_TypeError);
+    return -1;
+  }
+
+  self->x = 0;
+  self->y = 0;
 
-  char* kwlist[] = {"x", "y", nullptr};
+  const char* kwlist[] = {"x", "y", nullptr};
 
   if (!PyArg_ParseTupleAndKeywords(
-          args, kwds, "|ll", kwlist, &self->x, &self->y)) {
+          args, kwds, "|ll", const_cast<char**>(kwlist), &self->x, &self->y)) {
     return -1;
   }
   return 0;
 }
 
+//--------------------------------------------------------------------------------------------------
+PyObject* Point_get_component(Point* self, void* offset) {
+  return PyLong_FromLong(*reinterpret_cast<long*>(
+      reinterpret_cast<char*>(self) + reinterpret_cast<size_t>(offset)));
+}
+
+//--------------------------------------------------------------------------------------------------
+int Point_set_component(Point* self, PyObject* value, void* offset) {
+  if (value == nullptr) {
+    PyErr_SetString(PyExc_AttributeError, "point components cannot be deleted");
+    return -1;
+  }
+
+  if (is_frozen(self)) {
+    raise_frozen_modified(PyExc_AttributeError);
+    return -1;
+  }
+
+  auto new_value = 0L;
+
+  if (!component_arg(value, "value", &new_value)) {
+    return -1;
+  }
+
+  *reinterpret_cast<long*>(
+      reinterpret_cast<char*>(self) + reinterpret_cast<size_t>(offset)) =
+      new_value;
+  return 0;
+}
+
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_clone(Point* self, PyObject*) {
-  return create_point(self->x, self->y);
+  auto* st = Oatmeal_object_state(reinterpret_cast<PyObject*>(self));
+  return Point_create(st, self->x, self->y);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -166,6 +524,11 @@ int Point_set(PyObject* obj_self, PyObject* obj_index, PyObject* obj_value) {
     return -1;
   }
 
+  if (is_frozen(self)) {
+    raise_frozen_modified(PyExc_TypeError);
+    return -1;
+  }
+
   switch (index) {
     case 0:
       self->x = new_value;
@@ -181,12 +544,13 @@ int Point_set(PyObject* obj_self, PyObject* obj_index, PyObject* obj_value) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_add(PyObject* obj_left, PyObject* obj_right) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0 &&
-      PyObject_TypeCheck(obj_right, &PointType) != 0) {
+  auto* st = Oatmeal_operand_state(obj_left, obj_right);
+
+  if (is_point(st, obj_left) && is_point(st, obj_right)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
     const auto* right = reinterpret_cast<Point*>(obj_right);
 
-    return create_point(left->x + right->x, left->y + right->y);
+    return create_like(st, obj_left, left->x + right->x, left->y + right->y);
   } else {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -195,12 +559,13 @@ PyObject* Point_add(PyObject* obj_left, PyObject* obj_right) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_sub(PyObject* obj_left, PyObject* obj_right) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0 &&
-      PyObject_TypeCheck(obj_right, &PointType) != 0) {
+  auto* st = Oatmeal_operand_state(obj_left, obj_right);
+
+  if (is_point(st, obj_left) && is_point(st, obj_right)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
     const auto* right = reinterpret_cast<Point*>(obj_right);
 
-    return create_point(left->x - right->x, left->y - right->y);
+    return create_like(st, obj_left, left->x - right->x, left->y - right->y);
   } else {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -209,12 +574,13 @@ PyObject* Point_sub(PyObject* obj_left, PyObject* obj_right) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_mul(PyObject* obj_left, PyObject* obj_right) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0 &&
-      PyLong_Check(obj_right)) {
+  auto* st = Oatmeal_operand_state(obj_left, obj_right);
+
+  if (is_point(st, obj_left) && PyLong_Check(obj_right)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
     const auto right = PyLong_AsLong(obj_right);
 
-    return create_point(left->x * right, left->y * right);
+    return create_like(st, obj_left, left->x * right, left->y * right);
   } else {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -223,12 +589,13 @@ PyObject* Point_mul(PyObject* obj_left, PyObject* obj_right) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_true_div(PyObject* obj_left, PyObject* obj_right) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0 &&
-      PyLong_Check(obj_right)) {
+  auto* st = Oatmeal_operand_state(obj_left, obj_right);
+
+  if (is_point(st, obj_left) && PyLong_Check(obj_right)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
     const auto right = PyLong_AsLong(obj_right);
 
-    return create_point(left->x / right, left->y / right);
+    return create_like(st, obj_left, left->x / right, left->y / right);
   } else {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -237,12 +604,15 @@ PyObject* Point_true_div(PyObject* obj_left, PyObject* obj_right) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_floor_div(PyObject* obj_left, PyObject* obj_right) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0 &&
-      PyLong_Check(obj_right)) {
+  auto* st = Oatmeal_operand_state(obj_left, obj_right);
+
+  if (is_point(st, obj_left) && PyLong_Check(obj_right)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
     const auto right = PyLong_AsLong(obj_right);
 
-    return create_point(
+    return create_like(
+        st,
+        obj_left,
         static_cast<long>(std::floor(left->x / right)),
         static_cast<long>(std::floor(left->y / right)));
   } else {
@@ -253,12 +623,15 @@ PyObject* Point_floor_div(PyObject* obj_left, PyObject* obj_right) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_mod(PyObject* obj_left, PyObject* obj_right) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0 &&
-      PyLong_Check(obj_right)) {
+  auto* st = Oatmeal_operand_state(obj_left, obj_right);
+
+  if (is_point(st, obj_left) && PyLong_Check(obj_right)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
     const auto right = PyLong_AsLong(obj_right);
 
-    return create_point(
+    return create_like(
+        st,
+        obj_left,
         static_cast<long>(left->x % right), static_cast<long>(left->y % right));
   } else {
     Py_INCREF(Py_NotImplemented);
@@ -268,9 +641,11 @@ PyObject* Point_mod(PyObject* obj_left, PyObject* obj_right) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_negate(PyObject* obj_left) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0) {
+  auto* st = Oatmeal_object_state(obj_left);
+
+  if (is_point(st, obj_left)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
-    return create_point(-left->x, -left->y);
+    return create_like(st, obj_left, -left->x, -left->y);
   } else {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -279,9 +654,11 @@ PyObject* Point_negate(PyObject* obj_left) {
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_abs(PyObject* obj_left) {
-  if (PyObject_TypeCheck(obj_left, &PointType) != 0) {
+  auto* st = Oatmeal_object_state(obj_left);
+
+  if (is_point(st, obj_left)) {
     const auto* left = reinterpret_cast<Point*>(obj_left);
-    return create_point(std::abs(left->x), std::abs(left->y));
+    return create_like(st, obj_left, std::abs(left->x), std::abs(left->y));
   } else {
     Py_INCREF(Py_NotImplemented);
     return Py_NotImplemented;
@@ -292,8 +669,9 @@ PyObject* Point_abs(PyObject* obj_left) {
 PyObject* Point_compare(PyObject* obj_self, PyObject* obj_other, int op) {
   auto result = Py_NotImplemented;
 
-  if (PyObject_TypeCheck(obj_self, &PointType) != 0 &&
-      PyObject_TypeCheck(obj_other, &PointType) != 0) {
+  auto* st = Oatmeal_operand_state(obj_self, obj_other);
+
+  if (is_point(st, obj_self) && is_point(st, obj_other)) {
     const auto* self = reinterpret_cast<Point*>(obj_self);
     const auto* other = reinterpret_cast<Point*>(obj_other);
 
@@ -333,18 +711,24 @@ PyObject* Point_compare(PyObject* obj_self, PyObject* obj_other, int op) {
 //--------------------------------------------------------------------------------------------------
 Py_hash_t Point_hash(PyObject* obj_self) {
   const auto* self = reinterpret_cast<Point*>(obj_self);
-  const auto h1 = std::hash<long>{}(self->x);
-  const auto h2 = std::hash<long>{}(self->y);
-  return h1 ^ (h2 << 1);
+  const auto h = static_cast<Py_hash_t>(Point_mix_hash(self->x, self->y));
+
+  // -1 is reserved by Python for reporting errors from hash functions.
+  return h == -1 ? -2 : h;
 }
 
 //--------------------------------------------------------------------------------------------------
-PyObject* Point_getstate(Point* self, PyObject*) {
-  return Py_BuildValue("{slsl}", "x", self->x, "y", self->y);
+PyObject* Point_reduce(Point* self, PyObject*) {
+  return Py_BuildValue("O(ll)", Py_TYPE(self), self->x, self->y);
 }
 
 //--------------------------------------------------------------------------------------------------
 PyObject* Point_setstate(Point* self, PyObject* state) {
+  if (is_frozen(self)) {
+    raise_frozen_modified(PyExc_TypeError);
+    return nullptr;
+  }
+
   // https://pythonextensionpatterns.readthedocs.io/en/latest/pickle.html
   // State object must be a dictionary.
   if (!PyDict_CheckExact(state)) {
@@ -367,3 +751,206 @@ PyObject* Point_setstate(Point* self, PyObject* state) {
 
   Py_RETURN_NONE;
 }
+
+//--------------------------------------------------------------------------------------------------
+// FrozenPoint python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef FrozenPoint_Methods[] = {
+    {"__reduce__",
+     (PyCFunction)FrozenPoint_reduce,
+     METH_NOARGS,
+     "pickle the frozen point by its components"},
+    {"set_intern_window",
+     (PyCFunction)FrozenPoint_set_intern_window,
+     METH_FASTCALL | METH_CLASS,
+     "Set the inclusive coordinate range that frozen points are interned for"},
+    {"intern_window",
+     (PyCFunction)FrozenPoint_intern_window,
+     METH_NOARGS | METH_CLASS,
+     "Returns the inclusive coordinate range of interned frozen points"},
+    {nullptr}};
+
+PyType_Slot FrozenPoint_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(FrozenPoint_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(FrozenPoint_repr)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Immutable 2d point, interned for small coordinates"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(FrozenPoint_traverse)},
+    {Py_tp_methods, FrozenPoint_Methods},
+    {Py_tp_init, reinterpret_cast<void*>(FrozenPoint_init)},
+    {Py_tp_new, reinterpret_cast<void*>(FrozenPoint_new)},
+    {0, nullptr}};
+
+// Frozen points are tracked by the garbage collector, unlike plain points,
+// because the module state holds the interned ones. That makes a cycle from
+// the module through an interned point and its type back to the module.
+PyType_Spec FrozenPoint_Spec = {
+    .name = "oatmeal.FrozenPoint",
+    .basicsize = sizeof(Point),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_BASETYPE |
+             Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = FrozenPoint_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// FrozenPoint method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_create(OatmealState* st, long x, long y) {
+  if (!in_intern_window(st, x, y)) {
+    return alloc_frozen(st, x, y);
+  }
+
+  auto** slot = intern_slot(st, x, y);
+
+  if (slot == nullptr) {
+    return nullptr;
+  }
+
+  if (*slot == nullptr) {
+    *slot = alloc_frozen(st, x, y);
+
+    if (*slot == nullptr) {
+      return nullptr;
+    }
+  } else {
+    st->alloc_stats.frozen_point_intern_hits++;
+  }
+
+  Py_INCREF(*slot);
+  return *slot;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_vectorcall(
+    PyObject* type,
+    PyObject* const* args,
+    size_t nargsf,
+    PyObject* kwnames) {
+  long x = 0;
+  long y = 0;
+
+  if (!parse_components("FrozenPoint", args, nargsf, kwnames, &x, &y)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(type));
+  return FrozenPoint_create(st, x, y);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  // Frozen points can't be modified by `__init__`, so the components are
+  // read here instead.
+  const char* kwlist[] = {"x", "y", nullptr};
+  long x = 0;
+  long y = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|ll", const_cast<char**>(kwlist), &x, &y)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_type_state(type);
+
+  if (type == st->frozen_point_type) {
+    return FrozenPoint_create(st, x, y);
+  }
+
+  auto* self = reinterpret_cast<Point*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    self->x = x;
+    self->y = y;
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int FrozenPoint_init(Point*, PyObject*, PyObject*) { return 0; }
+
+//--------------------------------------------------------------------------------------------------
+void FrozenPoint_dealloc(PyObject* self) {
+  PyObject_GC_UnTrack(self);
+  Oatmeal_free(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int FrozenPoint_traverse(PyObject* self, visitproc visit, void* arg) {
+  Py_VISIT(Py_TYPE(self));
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_repr(PyObject* obj_self) {
+  const auto* self = reinterpret_cast<Point*>(obj_self);
+  return PyUnicode_FromFormat("FrozenPoint(x=%ld, y=%ld)", self->x, self->y);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_reduce(Point* self, PyObject*) {
+  return Py_BuildValue("O(ll)", Py_TYPE(self), self->x, self->y);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_set_intern_window(
+    PyObject* cls,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  if (nargs != 2) {
+    PyErr_Format(
+        PyExc_TypeError,
+        "set_intern_window() takes exactly 2 arguments (%zd given)",
+        nargs);
+    return nullptr;
+  }
+
+  long lo = 0;
+  long hi = 0;
+
+  if (!component_arg(args[0], "lo", &lo) || !component_arg(args[1], "hi", &hi)) {
+    return nullptr;
+  }
+
+  if (hi < lo || hi - lo >= kMaxInternSide) {
+    PyErr_Format(
+        PyExc_ValueError,
+        "intern window must satisfy lo <= hi and span at most %ld cells",
+        kMaxInternSide);
+    return nullptr;
+  }
+
+  // Points that were already handed out stay valid, they just stop being the
+  // cached instance for their coordinate. The direction constants are put
+  // back so `FrozenPoint(1, 0) is Point.EAST` keeps holding.
+  auto* st = Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(cls));
+
+  clear_intern_table(st);
+  st->intern_min = lo;
+  st->intern_max = hi;
+
+  for (auto* obj_pt : st->direction_points) {
+    const auto* pt = reinterpret_cast<Point*>(obj_pt);
+
+    if (pt != nullptr && in_intern_window(st, pt->x, pt->y)) {
+      auto** slot = intern_slot(st, pt->x, pt->y);
+
+      if (slot == nullptr) {
+        return nullptr;
+      }
+
+      Py_INCREF(obj_pt);
+      *slot = obj_pt;
+    }
+  }
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* FrozenPoint_intern_window(PyObject* cls, PyObject*) {
+  const auto* st = Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(cls));
+  return Py_BuildValue("(ll)", st->intern_min, st->intern_max);
+}
@@ -1,17 +1,96 @@
+#pragma once
+
 #include "oatmeal.h"
 
+#include <cstdint>
+
 /** 2d cartesian point with x and y components. */
 typedef struct {
   PyObject_HEAD long x;
   long y;
 } Point;
 
-/** Python type definition for `Point`. */
-extern PyTypeObject PointType;
+/** Python type spec for `Point`. */
+extern PyType_Spec Point_Spec;
+
+/**
+ * Python type spec for `FrozenPoint`, an immutable subtype of `Point`.
+ * Frozen points inside a small coordinate window are interned, so creating
+ * one returns a shared cached object instead of allocating.
+ */
+extern PyType_Spec FrozenPoint_Spec;
+
+/**
+ * Mix the components of a point into a well distributed 64 bit hash. Shared by
+ * `Point_hash` and the native point tables so both agree on bucket placement.
+ */
+inline uint64_t Point_mix_hash(long x, long y) {
+  // Scale each component by a different odd constant before combining, so
+  // that sign flips and swapped components don't cancel out, then run the
+  // splitmix64 finalizer so nearby points land in unrelated buckets.
+  auto h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull +
+           static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full;
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  h ^= h >> 31;
+  return h;
+}
+
+/**
+ * Allocate a new `Point` of the module with state `st` directly from the
+ * type allocator, or by recycling a previously freed point. This skips the
+ * argument tuple building and parsing that calling the type would require.
+ * Returns a new reference, or null with an exception set on failure.
+ */
+PyObject* Point_create(OatmealState* st, long x, long y);
+
+/**
+ * Add the shared unit direction constants `Point.EAST`, `Point.NORTH`,
+ * `Point.WEST` and `Point.SOUTH` to the type once it is created, along with
+ * the diagonals `Point.NORTH_EAST`, `Point.NORTH_WEST`, `Point.SOUTH_WEST`
+ * and `Point.SOUTH_EAST`. These are returned by `Direction.to_point()` so
+ * they are `FrozenPoint` instances. This also sets the default intern window,
+ * so it runs before any frozen point is created. Returns false with an
+ * exception set on failure.
+ */
+bool Point_add_constants(OatmealState* st);
+
+/** GC traversal of the interned frozen points held by the module state. */
+int Point_traverse_caches(OatmealState* st, visitproc visit, void* arg);
+
+/** Release the interned frozen points and the memory on the free list. */
+void Point_clear_caches(OatmealState* st);
+
+/**
+ * Borrowed reference to the unit point constant for direction `dir`, which is
+ * only valid after `Point_add_constants` succeeded.
+ */
+PyObject* Point_direction(OatmealState* st, int dir);
+
+/** Point(x: int = 0, y: int = 0) without building an argument tuple. */
+PyObject* Point_vectorcall(
+    PyObject* type,
+    PyObject* const* args,
+    size_t nargsf,
+    PyObject* kwnames);
+
+/** __new__(type, *args, **kwds) -> Point */
+PyObject* Point_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** Destroy the point, or place it on the free list for reuse. */
+void Point_dealloc(PyObject* self);
 
 /** __init__(self, x: int, y: int) */
 int Point_init(Point* self, PyObject* args, PyObject* kwds);
 
+/** x -> int, y -> int */
+PyObject* Point_get_component(Point* self, void* offset);
+
+/** x = int, y = int */
+int Point_set_component(Point* self, PyObject* value, void* offset);
+
 /** clone(self) -> Point */
 PyObject* Point_clone(Point* self, PyObject*);
 
@@ -66,8 +145,49 @@ PyObject* Point_compare(PyObject* self, PyObject* other, int op);
 /** __hash__(self: Point) -> int */
 Py_hash_t Point_hash(PyObject* self);
 
-/** pickle. */
-PyObject* Point_getstate(Point* self, PyObject* unused);
+/** pickle as `Point(x, y)` rather than a dict of the components. */
+PyObject* Point_reduce(Point* self, PyObject* unused);
 
-/** unpickle. */
+/** unpickle the `{"x": x, "y": y}` state written by older pickles. */
 PyObject* Point_setstate(Point* self, PyObject* state);
+
+/**
+ * Get the frozen point for `(x, y)`, which is the interned instance when the
+ * coordinates are inside the intern window. Returns a new reference, or null
+ * with an exception set on failure.
+ */
+PyObject* FrozenPoint_create(OatmealState* st, long x, long y);
+
+/** FrozenPoint(x: int = 0, y: int = 0) without building an argument tuple. */
+PyObject* FrozenPoint_vectorcall(
+    PyObject* type,
+    PyObject* const* args,
+    size_t nargsf,
+    PyObject* kwnames);
+
+/** __new__(type, x: int = 0, y: int = 0) -> FrozenPoint */
+PyObject* FrozenPoint_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, *args, **kwds), which does nothing since `__new__` did it. */
+int FrozenPoint_init(Point* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the frozen point, which is tracked by the garbage collector. */
+void FrozenPoint_dealloc(PyObject* self);
+
+/** GC traversal, which only visits the type. */
+int FrozenPoint_traverse(PyObject* self, visitproc visit, void* arg);
+
+/** repr(self) -> str */
+PyObject* FrozenPoint_repr(PyObject* self);
+
+/** pickle as `FrozenPoint(x, y)` so unpickling goes back through interning. */
+PyObject* FrozenPoint_reduce(Point* self, PyObject*);
+
+/** set_intern_window(cls, lo: int, hi: int) */
+PyObject* FrozenPoint_set_intern_window(
+    PyObject* cls,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+
+/** intern_window(cls) -> Tuple[int, int] */
+PyObject* FrozenPoint_intern_window(PyObject* cls, PyObject*);
@@ -0,0 +1,893 @@
+#include "point_array.h"
+#include "int_array.h"
+#include "point.h"
+#include "shared_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+  /** Smallest capacity allocated once an array holds any points. */
+  constexpr Py_ssize_t kMinCapacity = 8;
+
+  /**
+   * Move both columns into storage for exactly `capacity` points, which must
+   * be at least `count`. Fails with a `BufferError` while the columns are
+   * exported.
+   */
+  bool resize_storage(PointArray* self, Py_ssize_t capacity) {
+    if (self->exports > 0) {
+      PyErr_SetString(
+          PyExc_BufferError,
+          "cannot resize a point array while it is exported as a buffer");
+      return false;
+    }
+
+    long* xs = nullptr;
+
+    if (capacity > 0) {
+      xs = static_cast<long*>(PyMem_Malloc(2 * capacity * sizeof(long)));
+
+      if (xs == nullptr) {
+        PyErr_NoMemory();
+        return false;
+      }
+
+      std::copy(self->xs, self->xs + self->count, xs);
+      std::copy(self->ys, self->ys + self->count, xs + capacity);
+    }
+
+    SharedBuffer_free(self->base, self->xs);
+    self->base = nullptr;
+    self->xs = xs;
+    self->ys = xs + capacity;
+    self->capacity = capacity;
+
+    return true;
+  }
+
+  /** Grow both columns so they can hold at least `capacity` points. */
+  bool reserve(PointArray* self, Py_ssize_t capacity) {
+    return capacity <= self->capacity || resize_storage(self, capacity);
+  }
+
+  /** Add a point to the end of the array, doubling the capacity when full. */
+  bool push_back(PointArray* self, long x, long y) {
+    if (self->count == self->capacity &&
+        !reserve(self, std::max(kMinCapacity, self->capacity * 2))) {
+      return false;
+    }
+
+    self->xs[self->count] = x;
+    self->ys[self->count] = y;
+    self->count++;
+
+    return true;
+  }
+
+  /**
+   * One side of an element wise operation, which is either a whole array of
+   * points or a single value broadcast against every element.
+   */
+  struct Operand {
+    const long* xs = nullptr;
+    const long* ys = nullptr;
+    long x = 0;
+    long y = 0;
+
+    /** Column for `axis` (0 = x, 1 = y), or null when broadcasting a value. */
+    const long* column(int axis) const { return axis == 0 ? xs : ys; }
+
+    /** Broadcast value for `axis`. */
+    long value(int axis) const { return axis == 0 ? x : y; }
+  };
+
+  /** Kinds of scalar values an operation can broadcast. */
+  enum class Broadcast { Point, Int };
+
+  /** Division an operation performs, which decides the divisors it rejects. */
+  enum class Division { None, Remainder, Quotient };
+
+  /**
+   * Read `obj` as an operand against an array of `count` points. Returns 1 on
+   * success, 0 if the operation is not implemented for the type or -1 with an
+   * exception set if the type is right but the value is not.
+   */
+  int parse_operand(
+      const OatmealState* st,
+      PyObject* obj,
+      Py_ssize_t count,
+      Broadcast broadcast,
+      Operand* out) {
+    if (PyObject_TypeCheck(obj, st->point_array_type) != 0) {
+      const auto* array = reinterpret_cast<PointArray*>(obj);
+
+      if (array->count != count) {
+        PyErr_SetString(
+            PyExc_ValueError, "point arrays must be the same length");
+        return -1;
+      }
+
+      out->xs = array->xs;
+      out->ys = array->ys;
+      return 1;
+    }
+
+    if (broadcast == Broadcast::Point &&
+        PyObject_TypeCheck(obj, st->point_type) != 0) {
+      const auto* pt = reinterpret_cast<Point*>(obj);
+      out->x = pt->x;
+      out->y = pt->y;
+      return 1;
+    }
+
+    if (broadcast == Broadcast::Int && PyLong_Check(obj)) {
+      out->x = out->y = PyLong_AsLong(obj);
+      return (out->x == -1 && PyErr_Occurred()) ? -1 : 1;
+    }
+
+    return 0;
+  }
+
+  /** Apply `op` to one column of a pair of operands. */
+  template <typename Out, typename Op>
+  void apply_column(
+      Out* out,
+      const Operand& left,
+      const Operand& right,
+      int axis,
+      Py_ssize_t count,
+      Op op) {
+    const auto* a = left.column(axis);
+    const auto* b = right.column(axis);
+
+    // Each case is a plain loop over contiguous columns so the compiler can
+    // vectorize it.
+    if (a != nullptr && b != nullptr) {
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        out[i] = op(a[i], b[i]);
+      }
+    } else if (a != nullptr) {
+      const auto b_value = right.value(axis);
+
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        out[i] = op(a[i], b_value);
+      }
+    } else {
+      const auto a_value = left.value(axis);
+
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        out[i] = op(a_value, b[i]);
+      }
+    }
+  }
+
+  /** Component `i` of a column of an operand, broadcasting a single value. */
+  long component(const Operand& operand, int axis, Py_ssize_t i) {
+    const auto* column = operand.column(axis);
+    return column != nullptr ? column[i] : operand.value(axis);
+  }
+
+  /**
+   * Returns true if any component of `left` is the smallest long while the
+   * matching divisor in `right` is -1, the one quotient that overflows.
+   */
+  bool has_overflowing_quotient(
+      const Operand& left,
+      const Operand& right,
+      Py_ssize_t count) {
+    for (int axis = 0; axis < 2; ++axis) {
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        if (component(left, axis, i) == std::numeric_limits<long>::min() &&
+            component(right, axis, i) == -1) {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  /** Returns true if any component of the operand is zero. */
+  bool has_zero(const Operand& operand, Py_ssize_t count) {
+    for (int axis = 0; axis < 2; ++axis) {
+      const auto* column = operand.column(axis);
+
+      if (column == nullptr) {
+        if (operand.value(axis) == 0) {
+          return true;
+        }
+      } else if (std::find(column, column + count, 0) != column + count) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Shared implementation of the binary number slots. One of `left` or
+   * `right` is always a `PointArray` since this is only called from its own
+   * slots.
+   */
+  template <typename Op>
+  PyObject* binary_op(
+      PyObject* obj_left,
+      PyObject* obj_right,
+      Broadcast broadcast,
+      Division division,
+      Op op) {
+    auto* st = Oatmeal_operand_state(obj_left, obj_right);
+    const auto count = PyObject_TypeCheck(obj_left, st->point_array_type) != 0
+                           ? reinterpret_cast<PointArray*>(obj_left)->count
+                           : reinterpret_cast<PointArray*>(obj_right)->count;
+
+    Operand left;
+    Operand right;
+
+    const auto left_ok = parse_operand(st, obj_left, count, broadcast, &left);
+
+    if (left_ok < 0) {
+      return nullptr;
+    }
+
+    const auto right_ok =
+        parse_operand(st, obj_right, count, broadcast, &right);
+
+    if (right_ok < 0) {
+      return nullptr;
+    }
+
+    if (left_ok == 0 || right_ok == 0) {
+      Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    if (division != Division::None && has_zero(right, count)) {
+      PyErr_SetString(PyExc_ZeroDivisionError, "point division by zero");
+      return nullptr;
+    } else if (
+        division == Division::Quotient &&
+        has_overflowing_quotient(left, right, count)) {
+      PyErr_SetString(
+          PyExc_OverflowError, "point division result does not fit in a long");
+      return nullptr;
+    }
+
+    auto* result = PointArray_create(st, count);
+
+    if (result == nullptr) {
+      return nullptr;
+    }
+
+    apply_column(result->xs, left, right, 0, count, op);
+    apply_column(result->ys, left, right, 1, count, op);
+
+    return reinterpret_cast<PyObject*>(result);
+  }
+
+  /** Shared implementation of the unary number slots. */
+  template <typename Op> PyObject* unary_op(PyObject* obj_self, Op op) {
+    const auto* self = reinterpret_cast<PointArray*>(obj_self);
+    auto* result =
+        PointArray_create(Oatmeal_object_state(obj_self), self->count);
+
+    if (result == nullptr) {
+      return nullptr;
+    }
+
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+      result->xs[i] = op(self->xs[i]);
+    }
+
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+      result->ys[i] = op(self->ys[i]);
+    }
+
+    return reinterpret_cast<PyObject*>(result);
+  }
+
+  /** Points ordered by row and then by column, matching `Grid` cell order. */
+  std::vector<std::pair<long, long>> sorted_points(const PointArray* self) {
+    std::vector<std::pair<long, long>> points(self->count);
+
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+      points[i] = {self->ys[i], self->xs[i]};
+    }
+
+    std::sort(points.begin(), points.end());
+    return points;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// PointArray python type definition.
+//--------------------------------------------------------------------------------------------------
+
+PyMethodDef PointArray_Methods[] = {
+    {"from_buffer",
+     (PyCFunction)PointArray_from_buffer,
+     METH_O | METH_CLASS,
+     "Create an array from a buffer of x values followed by y values"},
+    {"__reduce_ex__",
+     (PyCFunction)PointArray_reduce_ex,
+     METH_O,
+     "pickle the columns as one buffer, out of band for protocol 5"},
+    {"append",
+     (PyCFunction)PointArray_append,
+     METH_O,
+     "Add a point to the end of the array"},
+    {"manhattan_distance",
+     (PyCFunction)PointArray_manhattan_distance,
+     METH_O,
+     "Manhattan distance from each point to a point or to each point of an "
+     "array, returned as an IntArray"},
+    {"bounding_box",
+     (PyCFunction)PointArray_bounding_box,
+     METH_NOARGS,
+     "Returns the inclusive minimum and maximum corners of the points"},
+    {"sort",
+     (PyCFunction)PointArray_sort,
+     METH_NOARGS,
+     "Sort the points in place by row and then by column"},
+    {"unique",
+     (PyCFunction)PointArray_unique,
+     METH_NOARGS,
+     "Returns a new sorted array with duplicate points removed"},
+    {nullptr}};
+
+PyType_Slot PointArray_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(PointArray_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(PointArray_repr)},
+    {Py_nb_add, reinterpret_cast<void*>(PointArray_add)},
+    {Py_nb_subtract, reinterpret_cast<void*>(PointArray_sub)},
+    {Py_nb_multiply, reinterpret_cast<void*>(PointArray_mul)},
+    {Py_nb_remainder, reinterpret_cast<void*>(PointArray_mod)},
+    {Py_nb_negative, reinterpret_cast<void*>(PointArray_negate)},
+    {Py_nb_absolute, reinterpret_cast<void*>(PointArray_abs)},
+    {Py_nb_floor_divide, reinterpret_cast<void*>(PointArray_floor_div)},
+    {Py_sq_length, reinterpret_cast<void*>(PointArray_len)},
+    {Py_sq_item, reinterpret_cast<void*>(PointArray_get)},
+    {Py_sq_ass_item, reinterpret_cast<void*>(PointArray_set)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(PointArray_getbuffer)},
+    {Py_bf_releasebuffer, reinterpret_cast<void*>(PointArray_releasebuffer)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Array of 2d points stored as x and y columns"))},
+    {Py_tp_richcompare, reinterpret_cast<void*>(PointArray_compare)},
+    {Py_tp_methods, PointArray_Methods},
+    {Py_tp_init, reinterpret_cast<void*>(PointArray_init)},
+    {Py_tp_new, reinterpret_cast<void*>(PointArray_new)},
+    {0, nullptr}};
+
+PyType_Spec PointArray_Spec = {
+    .name = "oatmeal.PointArray",
+    .basicsize = sizeof(PointArray),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = PointArray_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// PointArray method definitions.
+//--------------------------------------------------------------------------------------------------
+PointArray* PointArray_create(OatmealState* st, Py_ssize_t count) {
+  auto* self = reinterpret_cast<PointArray*>(
+      PointArray_new(st->point_array_type, nullptr, nullptr));
+
+  if (self == nullptr) {
+    return nullptr;
+  }
+
+  if (!reserve(self, count)) {
+    Py_DECREF(self);
+    return nullptr;
+  }
+
+  std::fill(self->xs, self->xs + count, 0);
+  std::fill(self->ys, self->ys + count, 0);
+  self->count = count;
+
+  return self;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<PointArray*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    self->count = 0;
+    self->capacity = 0;
+    self->xs = nullptr;
+    self->ys = nullptr;
+    self->base = nullptr;
+    self->exports = 0;
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointArray_init(PointArray* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"points", nullptr};
+  PyObject* points = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|O", const_cast<char**>(kwlist), &points)) {
+    return -1;
+  }
+
+  if (self->exports > 0) {
+    PyErr_SetString(
+        PyExc_BufferError,
+        "cannot reset a point array while it is exported as a buffer");
+    return -1;
+  }
+
+  self->count = 0;
+
+  if (points == nullptr) {
+    return 0;
+  }
+
+  const auto size_hint = PyObject_LengthHint(points, 0);
+
+  if (size_hint < 0 || !reserve(self, size_hint)) {
+    return -1;
+  }
+
+  PyObject* iter = PyObject_GetIter(points);
+
+  if (iter == nullptr) {
+    return -1;
+  }
+
+  auto* st = Oatmeal_type_state(Py_TYPE(self));
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    const bool is_point = PyObject_TypeCheck(item, st->point_type) != 0;
+    const bool added =
+        is_point && push_back(
+                        self,
+                        reinterpret_cast<Point*>(item)->x,
+                        reinterpret_cast<Point*>(item)->y);
+    Py_DECREF(item);
+
+    if (!is_point) {
+      PyErr_SetString(
+          PyExc_TypeError, "`points` must only contain `Point` values");
+    }
+
+    if (!added) {
+      Py_DECREF(iter);
+      return -1;
+    }
+  }
+
+  Py_DECREF(iter);
+  return PyErr_Occurred() ? -1 : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointArray_dealloc(PyObject* obj_self) {
+  auto* self = reinterpret_cast<PointArray*>(obj_self);
+
+  SharedBuffer_free(self->base, self->xs);
+
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_from_buffer(PyObject* cls, PyObject* buffer) {
+  SharedBuffer storage;
+
+  if (!SharedBuffer_open(buffer, 2 * sizeof(long), &storage)) {
+    return nullptr;
+  }
+
+  auto* type = reinterpret_cast<PyTypeObject*>(cls);
+  auto* self =
+      reinterpret_cast<PointArray*>(PointArray_new(type, nullptr, nullptr));
+
+  if (self == nullptr) {
+    SharedBuffer_free(storage.base, storage.data);
+    return nullptr;
+  }
+
+  const auto count =
+      storage.size / static_cast<Py_ssize_t>(2 * sizeof(long));
+
+  self->count = count;
+  self->capacity = count;
+  self->xs = reinterpret_cast<long*>(storage.data);
+  self->ys = self->xs + count;
+  self->base = storage.base;
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_reduce_ex(PointArray* self, PyObject* obj_protocol) {
+  const long protocol = PyLong_AsLong(obj_protocol);
+
+  if (protocol == -1 && PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  // Trimming the spare capacity leaves both columns in one contiguous block.
+  if (self->count != self->capacity && !resize_storage(self, self->count)) {
+    return nullptr;
+  }
+
+  PyObject* columns = SharedBuffer_pickle(
+      reinterpret_cast<PyObject*>(self),
+      self->xs,
+      2 * self->count * static_cast<Py_ssize_t>(sizeof(long)),
+      static_cast<int>(protocol));
+
+  if (columns == nullptr) {
+    return nullptr;
+  }
+
+  return Py_BuildValue(
+      "N(N)",
+      PyObject_GetAttrString(
+          reinterpret_cast<PyObject*>(Py_TYPE(self)), "from_buffer"),
+      columns);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_append(PointArray* self, PyObject* obj_pt) {
+  auto* st = Oatmeal_type_state(Py_TYPE(self));
+
+  if (PyObject_TypeCheck(obj_pt, st->point_type) == 0) {
+    PyErr_SetString(PyExc_TypeError, "argument `pt` must be of type `Point`");
+    return nullptr;
+  }
+
+  const auto* pt = reinterpret_cast<Point*>(obj_pt);
+
+  if (!push_back(self, pt->x, pt->y)) {
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_manhattan_distance(PointArray* self, PyObject* obj_other) {
+  auto* st = Oatmeal_type_state(Py_TYPE(self));
+  Operand other;
+  const auto ok =
+      parse_operand(st, obj_other, self->count, Broadcast::Point, &other);
+
+  if (ok < 0) {
+    return nullptr;
+  } else if (ok == 0) {
+    PyErr_SetString(
+        PyExc_TypeError, "argument `other` must be a `Point` or `PointArray`");
+    return nullptr;
+  }
+
+  IntArray* result = IntArray_create(st, self->count);
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  // Distances along each axis always fit in 64 unsigned bits, and their sum is
+  // checked against the int64 range before it is stored.
+  const auto distance = [](long a, long b) {
+    return a < b ? static_cast<uint64_t>(b) - static_cast<uint64_t>(a)
+                 : static_cast<uint64_t>(a) - static_cast<uint64_t>(b);
+  };
+
+  const Operand points{.xs = self->xs, .ys = self->ys};
+  constexpr auto kMax = static_cast<uint64_t>(INT64_MAX);
+  std::vector<uint64_t> dx(self->count);
+  std::vector<uint64_t> dy(self->count);
+
+  apply_column(dx.data(), points, other, 0, self->count, distance);
+  apply_column(dy.data(), points, other, 1, self->count, distance);
+
+  for (Py_ssize_t i = 0; i < self->count; ++i) {
+    if (dx[i] > kMax || dy[i] > kMax - dx[i]) {
+      Py_DECREF(result);
+      PyErr_SetString(
+          PyExc_OverflowError, "manhattan distance does not fit in int64");
+      return nullptr;
+    }
+
+    result->values[i] = static_cast<int64_t>(dx[i] + dy[i]);
+  }
+
+  return reinterpret_cast<PyObject*>(result);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_bounding_box(PointArray* self, PyObject*) {
+  if (self->count == 0) {
+    PyErr_SetString(PyExc_ValueError, "empty point array has no bounding box");
+    return nullptr;
+  }
+
+  const auto [min_x, max_x] =
+      std::minmax_element(self->xs, self->xs + self->count);
+  const auto [min_y, max_y] =
+      std::minmax_element(self->ys, self->ys + self->count);
+
+  auto* st = Oatmeal_type_state(Py_TYPE(self));
+  PyObject* min_pt = Point_create(st, *min_x, *min_y);
+  PyObject* max_pt = Point_create(st, *max_x, *max_y);
+
+  if (min_pt == nullptr || max_pt == nullptr) {
+    Py_XDECREF(min_pt);
+    Py_XDECREF(max_pt);
+    return nullptr;
+  }
+
+  PyObject* result = PyTuple_Pack(2, min_pt, max_pt);
+  Py_DECREF(min_pt);
+  Py_DECREF(max_pt);
+
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_sort(PointArray* self, PyObject*) {
+  const auto points = sorted_points(self);
+
+  for (Py_ssize_t i = 0; i < self->count; ++i) {
+    self->ys[i] = points[i].first;
+    self->xs[i] = points[i].second;
+  }
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_unique(PointArray* self, PyObject*) {
+  auto points = sorted_points(self);
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+
+  auto* result = PointArray_create(
+      Oatmeal_type_state(Py_TYPE(self)),
+      static_cast<Py_ssize_t>(points.size()));
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    result->ys[i] = points[i].first;
+    result->xs[i] = points[i].second;
+  }
+
+  return reinterpret_cast<PyObject*>(result);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_repr(PyObject* obj_self) {
+  const auto* self = reinterpret_cast<PointArray*>(obj_self);
+  std::string text = "PointArray([";
+
+  for (Py_ssize_t i = 0; i < self->count; ++i) {
+    text += i > 0 ? ", Point(x=" : "Point(x=";
+    text += std::to_string(self->xs[i]);
+    text += ", y=";
+    text += std::to_string(self->ys[i]);
+    text += ")";
+  }
+
+  text += "])";
+  return PyUnicode_FromStringAndSize(text.data(), text.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t PointArray_len(PyObject* self) {
+  return reinterpret_cast<PointArray*>(self)->count;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_get(PyObject* obj_self, Py_ssize_t index) {
+  const auto* self = reinterpret_cast<PointArray*>(obj_self);
+
+  // Negative indices were already wrapped by the sequence protocol.
+  if (index < 0 || index >= self->count) {
+    PyErr_SetString(PyExc_IndexError, "point array index out of range");
+    return nullptr;
+  }
+
+  return Point_create(
+      Oatmeal_object_state(obj_self), self->xs[index], self->ys[index]);
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointArray_set(PyObject* obj_self, Py_ssize_t index, PyObject* obj_pt) {
+  auto* self = reinterpret_cast<PointArray*>(obj_self);
+
+  if (obj_pt == nullptr) {
+    PyErr_SetString(
+        PyExc_NotImplementedError, "point array does not support deletion");
+    return -1;
+  }
+
+  if (index < 0 || index >= self->count) {
+    PyErr_SetString(PyExc_IndexError, "point array index out of range");
+    return -1;
+  }
+
+  auto* st = Oatmeal_object_state(obj_self);
+
+  if (PyObject_TypeCheck(obj_pt, st->point_type) == 0) {
+    PyErr_SetString(PyExc_TypeError, "point array values must be `Point`");
+    return -1;
+  }
+
+  const auto* pt = reinterpret_cast<Point*>(obj_pt);
+  self->xs[index] = pt->x;
+  self->ys[index] = pt->y;
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_add(PyObject* left, PyObject* right) {
+  return binary_op(
+      left,
+      right,
+      Broadcast::Point,
+      Division::None,
+      [](long a, long b) { return a + b; });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_sub(PyObject* left, PyObject* right) {
+  return binary_op(
+      left,
+      right,
+      Broadcast::Point,
+      Division::None,
+      [](long a, long b) { return a - b; });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_mul(PyObject* left, PyObject* right) {
+  // Multiplying two arrays together is not a meaningful point operation.
+  auto* st = Oatmeal_operand_state(left, right);
+
+  if (PyObject_TypeCheck(left, st->point_array_type) != 0 &&
+      PyObject_TypeCheck(right, st->point_array_type) != 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  return binary_op(
+      left,
+      right,
+      Broadcast::Int,
+      Division::None,
+      [](long a, long b) { return a * b; });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_floor_div(PyObject* left, PyObject* right) {
+  auto* st = Oatmeal_operand_state(left, right);
+
+  if (PyObject_TypeCheck(left, st->point_array_type) == 0 ||
+      PyObject_TypeCheck(right, st->point_array_type) != 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  // Rounds toward negative infinity like Python's `//` rather than toward zero
+  // like C++ integer division. Dividing by -1 is a negation, since
+  // `a % -1` traps for the smallest long.
+  return binary_op(
+      left,
+      right,
+      Broadcast::Int,
+      Division::Quotient,
+      [](long a, long b) {
+        if (b == -1) {
+          return -a;
+        }
+
+        const auto q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+      });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_mod(PyObject* left, PyObject* right) {
+  auto* st = Oatmeal_operand_state(left, right);
+
+  if (PyObject_TypeCheck(left, st->point_array_type) == 0 ||
+      PyObject_TypeCheck(right, st->point_array_type) != 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  // The result takes the sign of the divisor like Python's `%`. Anything
+  // modulo -1 is zero, but `a % -1` traps for the smallest long.
+  return binary_op(
+      left,
+      right,
+      Broadcast::Int,
+      Division::Remainder,
+      [](long a, long b) {
+        const auto r = b == -1 ? 0 : a % b;
+        return (r != 0 && ((r < 0) != (b < 0))) ? r + b : r;
+      });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_negate(PyObject* self) {
+  return unary_op(self, [](long a) { return -a; });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_abs(PyObject* self) {
+  return unary_op(self, [](long a) { return std::abs(a); });
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointArray_compare(PyObject* obj_self, PyObject* obj_other, int op) {
+  if ((op != Py_EQ && op != Py_NE) ||
+      PyObject_TypeCheck(obj_other, Py_TYPE(obj_self)) == 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  const auto* self = reinterpret_cast<PointArray*>(obj_self);
+  const auto* other = reinterpret_cast<PointArray*>(obj_other);
+
+  const bool equal =
+      self->count == other->count &&
+      std::equal(self->xs, self->xs + self->count, other->xs) &&
+      std::equal(self->ys, self->ys + self->count, other->ys);
+
+  return PyBool_FromLong(equal == (op == Py_EQ));
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointArray_getbuffer(PyObject* obj_self, Py_buffer* view, int flags) {
+  auto* self = reinterpret_cast<PointArray*>(obj_self);
+
+  if (self->count != self->capacity && !resize_storage(self, self->count)) {
+    view->obj = nullptr;
+    return -1;
+  }
+
+  // An empty array has no storage, but consumers still need a valid pointer.
+  static long empty = 0;
+
+  self->buffer_shape[0] = 2;
+  self->buffer_shape[1] = self->count;
+  self->buffer_strides[0] = self->count * sizeof(long);
+  self->buffer_strides[1] = sizeof(long);
+
+  view->obj = obj_self;
+  view->buf = self->xs != nullptr ? self->xs : &empty;
+  view->len = 2 * self->count * sizeof(long);
+  view->itemsize = sizeof(long);
+  view->readonly = 0;
+  // Without a shape, consumers treat the buffer as `len / itemsize` items.
+  view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? 2 : 1;
+  view->format = (flags & PyBUF_FORMAT) != 0 ? const_cast<char*>("l") : nullptr;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->buffer_shape : nullptr;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES
+                      ? self->buffer_strides
+                      : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+
+  Py_INCREF(obj_self);
+  self->exports++;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointArray_releasebuffer(PyObject* obj_self, Py_buffer*) {
+  reinterpret_cast<PointArray*>(obj_self)->exports--;
+}
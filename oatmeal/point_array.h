@@ -0,0 +1,125 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * Growable array of 2d points stored as separate contiguous x and y columns,
+ * so bulk arithmetic runs as tight loops over unboxed values rather than one
+ * `Point` object per element. Both columns live in one block of storage with
+ * the y column starting `capacity` values after the x column.
+ */
+typedef struct {
+  PyObject_HEAD Py_ssize_t count;
+  Py_ssize_t capacity;
+  long* xs;
+  long* ys;
+  /** memoryview that owns the columns when they are shared with a buffer. */
+  PyObject* base;
+  /** Number of live buffer exports. Columns cannot be reallocated while > 0. */
+  Py_ssize_t exports;
+  /** Shape handed out to buffer consumers as `(2, count)`. */
+  Py_ssize_t buffer_shape[2];
+  /** Strides in bytes handed out to buffer consumers. */
+  Py_ssize_t buffer_strides[2];
+} PointArray;
+
+/** Python type spec for `PointArray`. */
+extern PyType_Spec PointArray_Spec;
+
+/**
+ * Create a new array of `count` zero valued points, of the `PointArray` type
+ * of the module with state `st`. Returns a new reference, or null with an
+ * exception set on failure.
+ */
+PointArray* PointArray_create(OatmealState* st, Py_ssize_t count);
+
+/** __new__(type, *args, **kwds) -> PointArray */
+PyObject* PointArray_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, points: Iterable[Point] = ()) */
+int PointArray_init(PointArray* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the array and release both columns. */
+void PointArray_dealloc(PyObject* self);
+
+/**
+ * from_buffer(cls, buffer: Buffer) -> PointArray
+ *
+ * Create an array from the bytes of `buffer`, which holds every x value
+ * followed by every y value in the native `long` layout that a `PointArray`
+ * exports. The columns share the buffer's memory when it is writable, and
+ * are copied otherwise.
+ */
+PyObject* PointArray_from_buffer(PyObject* cls, PyObject* buffer);
+
+/**
+ * __reduce_ex__(self, protocol: int) -> tuple
+ *
+ * Pickle through `from_buffer`, passing the columns as a `PickleBuffer` for
+ * protocol 5 so they can be sent out of band.
+ */
+PyObject* PointArray_reduce_ex(PointArray* self, PyObject* protocol);
+
+/** append(self, pt: Point) */
+PyObject* PointArray_append(PointArray* self, PyObject* pt);
+
+/** manhattan_distance(self, other: Point | PointArray) -> IntArray */
+PyObject* PointArray_manhattan_distance(PointArray* self, PyObject* other);
+
+/** bounding_box(self) -> Tuple[Point, Point] */
+PyObject* PointArray_bounding_box(PointArray* self, PyObject*);
+
+/** sort(self) */
+PyObject* PointArray_sort(PointArray* self, PyObject*);
+
+/** unique(self) -> PointArray */
+PyObject* PointArray_unique(PointArray* self, PyObject*);
+
+/** repr(self) -> str */
+PyObject* PointArray_repr(PyObject* self);
+
+/** len(self) -> int */
+Py_ssize_t PointArray_len(PyObject* self);
+
+/** __getitem__(self, index: int) -> Point */
+PyObject* PointArray_get(PyObject* self, Py_ssize_t index);
+
+/** __setitem__(self, index: int, pt: Point) */
+int PointArray_set(PyObject* self, Py_ssize_t index, PyObject* pt);
+
+/** __add__(left: PointArray | Point, right: PointArray | Point) -> PointArray */
+PyObject* PointArray_add(PyObject* left, PyObject* right);
+
+/** __sub__(left: PointArray | Point, right: PointArray | Point) -> PointArray */
+PyObject* PointArray_sub(PyObject* left, PyObject* right);
+
+/** __mul__(left: PointArray | int, right: PointArray | int) -> PointArray */
+PyObject* PointArray_mul(PyObject* left, PyObject* right);
+
+/** __floor_div__(left: PointArray, right: int) -> PointArray */
+PyObject* PointArray_floor_div(PyObject* left, PyObject* right);
+
+/** __mod__(left: PointArray, right: int) -> PointArray */
+PyObject* PointArray_mod(PyObject* left, PyObject* right);
+
+/** __neg__(self) -> PointArray */
+PyObject* PointArray_negate(PyObject* self);
+
+/** __abs__(self) -> PointArray */
+PyObject* PointArray_abs(PyObject* self);
+
+/**
+ * __eq__(left: PointArray, right: PointArray) -> bool
+ * __ne__(left: PointArray, right: PointArray) -> bool
+ */
+PyObject* PointArray_compare(PyObject* self, PyObject* other, int op);
+
+/**
+ * Buffer protocol export as a C contiguous `(2, count)` array holding the x
+ * column and then the y column. Any spare capacity is released first so the
+ * columns are adjacent.
+ */
+int PointArray_getbuffer(PyObject* self, Py_buffer* view, int flags);
+
+/** Buffer protocol release. */
+void PointArray_releasebuffer(PyObject* self, Py_buffer* view);
@@ -0,0 +1,1065 @@
+#include "point_nd.h"
+#include "shared_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace {
+  /** Component names, of which an `N` dimensional point uses the first `N`. */
+  constexpr const char* kComponentNames[] = {"x", "y", "z", "w"};
+
+  /**
+   * Odd constant each component is scaled by before hashing, extending the
+   * two used by `Point_mix_hash`.
+   */
+  constexpr uint64_t kHashScales[] = {
+      0x9E3779B97F4A7C15ull,
+      0xC2B2AE3D27D4EB4Full,
+      0x165667B19E3779F9ull,
+      0xD6E8FEB86659FD93ull};
+
+  /** Type name suffix for an instantiation, such as `3i32`. */
+  template <int N, typename T> std::string type_suffix() {
+    return std::to_string(N) + (sizeof(T) == 4 ? "i32" : "i64");
+  }
+
+  /** Position of an instantiation in `OatmealState::point_nd_types`. */
+  template <int N, typename T> constexpr int type_index() {
+    return (N - 2) * 2 + (sizeof(T) == 8 ? 1 : 0);
+  }
+
+  /** `struct` module format character for a component. */
+  template <typename T> const char* component_format() {
+    return sizeof(T) == 4 ? "i" : "q";
+  }
+
+  /**
+   * Arithmetic is done in 64 bits with every operation checked, so overflow is
+   * caught either there or when narrowing the result to the component type.
+   */
+  using Wide = int64_t;
+
+  constexpr Wide kWideMin = std::numeric_limits<Wide>::min();
+  constexpr Wide kWideMax = std::numeric_limits<Wide>::max();
+
+  /** Raise the OverflowError for a component that does not fit `T`. */
+  template <typename T> bool component_overflow() {
+    PyErr_Format(
+        PyExc_OverflowError,
+        "point component does not fit in %d bits",
+        static_cast<int>(sizeof(T) * 8));
+    return false;
+  }
+
+  /**
+   * Narrow a component to `T`, returning false with an OverflowError set if
+   * it does not fit.
+   */
+  template <typename T> bool narrow(Wide value, T* out) {
+    if (value < std::numeric_limits<T>::min() ||
+        value > std::numeric_limits<T>::max()) {
+      return component_overflow<T>();
+    }
+
+    *out = static_cast<T>(value);
+    return true;
+  }
+
+  /** Read a component argument, returning false with an exception set. */
+  template <typename T>
+  bool component_arg(PyObject* obj, const char* name, T* out) {
+    if (!PyLong_Check(obj)) {
+      PyErr_Format(
+          PyExc_TypeError,
+          "argument `%s` must be an int but was `%s`",
+          name,
+          Py_TYPE(obj)->tp_name);
+      return false;
+    }
+
+    const auto value = PyLong_AsLongLong(obj);
+    return !(value == -1 && PyErr_Occurred()) && narrow<T>(value, out);
+  }
+
+  // The checked operations below store `a op b` in `out` and return true, or
+  // return false without an exception if the result does not fit in `Wide`.
+
+  bool checked_add(Wide a, Wide b, Wide* out) {
+    if (b > 0 ? a > kWideMax - b : a < kWideMin - b) {
+      return false;
+    }
+
+    *out = a + b;
+    return true;
+  }
+
+  bool checked_sub(Wide a, Wide b, Wide* out) {
+    if (b < 0 ? a > kWideMax + b : a < kWideMin + b) {
+      return false;
+    }
+
+    *out = a - b;
+    return true;
+  }
+
+  bool checked_mul(Wide a, Wide b, Wide* out) {
+    if (a > 0 ? (b > 0 ? a > kWideMax / b : b < kWideMin / a)
+              : (b > 0 ? a < kWideMin / b : a != 0 && b < kWideMax / a)) {
+      return false;
+    }
+
+    *out = a * b;
+    return true;
+  }
+
+  /** Python's floor division, which rounds towards negative infinity. */
+  bool floor_div(Wide a, Wide b, Wide* out) {
+    if (a == kWideMin && b == -1) {
+      return false;
+    }
+
+    const auto q = a / b;
+    *out = (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    return true;
+  }
+
+  /** Python's modulo, which takes the sign of the divisor. */
+  bool floor_mod(Wide a, Wide b, Wide* out) {
+    // Anything modulo -1 is zero, but `kWideMin % -1` overflows in C++.
+    const auto r = b == -1 ? 0 : a % b;
+    *out = (r != 0 && (r < 0) != (b < 0)) ? r + b : r;
+    return true;
+  }
+
+  /** Append `(x=.., y=..)` style components, read `stride` values apart. */
+  template <int N, typename T>
+  void append_components(std::string* text, const T* v, Py_ssize_t stride) {
+    *text += "(";
+
+    for (int i = 0; i < N; ++i) {
+      *text += i > 0 ? ", " : "";
+      *text += kComponentNames[i];
+      *text += "=";
+      *text += std::to_string(v[i * stride]);
+    }
+
+    *text += ")";
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // PointND implementation shared by every instantiation.
+  //------------------------------------------------------------------------------------------------
+  template <int N, typename T> struct PointOps {
+    using Self = PointND<N, T>;
+
+    static const std::string& name() {
+      static const std::string text = "Point" + type_suffix<N, T>();
+      return text;
+    }
+
+    static Self* cast(PyObject* obj) { return reinterpret_cast<Self*>(obj); }
+
+    static bool check(const OatmealState* st, PyObject* obj) {
+      return Py_TYPE(obj) == PointND_type<N, T>(st);
+    }
+
+    static PyObject* create(const OatmealState* st, const T* v) {
+      auto* type = PointND_type<N, T>(st);
+      auto* self = reinterpret_cast<Self*>(type->tp_alloc(type, 0));
+
+      if (self != nullptr) {
+        std::copy(v, v + N, self->v);
+      }
+
+      return reinterpret_cast<PyObject*>(self);
+    }
+
+    /** Create a point from wide components, checking each one fits. */
+    static PyObject* create_wide(const OatmealState* st, const Wide* wide) {
+      T v[N];
+
+      for (int i = 0; i < N; ++i) {
+        if (!narrow<T>(wide[i], &v[i])) {
+          return nullptr;
+        }
+      }
+
+      return create(st, v);
+    }
+
+    /**
+     * Parse up to `N` components from vectorcall arguments, which default to
+     * zero and can also be passed by name.
+     */
+    static PyObject* vectorcall(
+        PyObject* type,
+        PyObject* const* args,
+        size_t nargsf,
+        PyObject* kwnames) {
+      const auto nargs = PyVectorcall_NARGS(nargsf);
+      const auto nkwargs = kwnames == nullptr ? 0 : PyTuple_GET_SIZE(kwnames);
+      PyObject* values[N] = {};
+
+      if (nargs > N) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "%s() takes at most %d arguments (%zd given)",
+            name().c_str(),
+            N,
+            nargs);
+        return nullptr;
+      }
+
+      std::copy(args, args + nargs, values);
+
+      for (Py_ssize_t i = 0; i < nkwargs; ++i) {
+        PyObject* key = PyTuple_GET_ITEM(kwnames, i);
+        int index = -1;
+
+        for (int j = 0; j < N; ++j) {
+          if (PyUnicode_CompareWithASCIIString(key, kComponentNames[j]) == 0) {
+            index = j;
+          }
+        }
+
+        if (index < 0) {
+          PyErr_Format(
+              PyExc_TypeError,
+              "%s() got an unexpected keyword argument '%U'",
+              name().c_str(),
+              key);
+          return nullptr;
+        } else if (values[index] != nullptr) {
+          PyErr_Format(
+              PyExc_TypeError,
+              "argument for %s() given by name ('%s') and position (%d)",
+              name().c_str(),
+              kComponentNames[index],
+              index + 1);
+          return nullptr;
+        }
+
+        values[index] = args[nargs + i];
+      }
+
+      T v[N] = {};
+
+      for (int i = 0; i < N; ++i) {
+        if (values[i] != nullptr &&
+            !component_arg<T>(values[i], kComponentNames[i], &v[i])) {
+          return nullptr;
+        }
+      }
+
+      const auto* st =
+          Oatmeal_type_state(reinterpret_cast<PyTypeObject*>(type));
+      return create(st, v);
+    }
+
+    /** `__new__` goes through the same argument parsing as calls. */
+    static PyObject*
+        tp_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+      return PyVectorcall_Call(reinterpret_cast<PyObject*>(type), args, kwds);
+    }
+
+    static void dealloc(PyObject* self) { Oatmeal_free(self); }
+
+    static PyObject* get_component(PyObject* self, void* index) {
+      const auto i = reinterpret_cast<intptr_t>(index);
+      return PyLong_FromLongLong(cast(self)->v[i]);
+    }
+
+    static int set_component(PyObject* self, PyObject* value, void* index) {
+      if (value == nullptr) {
+        PyErr_SetString(
+            PyExc_AttributeError, "point components cannot be deleted");
+        return -1;
+      }
+
+      auto* component = &cast(self)->v[reinterpret_cast<intptr_t>(index)];
+      return component_arg<T>(value, "value", component) ? 0 : -1;
+    }
+
+    static Py_ssize_t len(PyObject*) { return N; }
+
+    /** Index of a component, counting from the end if negative. */
+    static bool component_index(PyObject* obj, Py_ssize_t* out) {
+      *out = PyNumber_AsSsize_t(obj, PyExc_IndexError);
+
+      if (*out == -1 && PyErr_Occurred()) {
+        return false;
+      }
+
+      *out += *out < 0 ? N : 0;
+
+      if (*out < 0 || *out >= N) {
+        PyErr_SetString(PyExc_IndexError, "point index out of range");
+        return false;
+      }
+
+      return true;
+    }
+
+    static PyObject* get(PyObject* self, PyObject* obj_index) {
+      Py_ssize_t index = 0;
+
+      if (!component_index(obj_index, &index)) {
+        return nullptr;
+      }
+
+      return PyLong_FromLongLong(cast(self)->v[index]);
+    }
+
+    static int set(PyObject* self, PyObject* obj_index, PyObject* value) {
+      Py_ssize_t index = 0;
+
+      if (value == nullptr) {
+        PyErr_SetString(PyExc_TypeError, "point components cannot be deleted");
+        return -1;
+      } else if (!component_index(obj_index, &index)) {
+        return -1;
+      }
+
+      return component_arg<T>(value, "value", &cast(self)->v[index]) ? 0 : -1;
+    }
+
+    /** Combine two points of this type component by component. */
+    template <typename Fn>
+    static PyObject* combine(PyObject* left, PyObject* right, Fn&& fn) {
+      const auto* st = Oatmeal_operand_state(left, right);
+
+      if (!check(st, left) || !check(st, right)) {
+        Py_RETURN_NOTIMPLEMENTED;
+      }
+
+      Wide wide[N];
+
+      for (int i = 0; i < N; ++i) {
+        if (!fn(cast(left)->v[i], cast(right)->v[i], &wide[i])) {
+          component_overflow<T>();
+          return nullptr;
+        }
+      }
+
+      return create_wide(st, wide);
+    }
+
+    /**
+     * Combine every component of a point with an int. Division by zero raises
+     * ZeroDivisionError when `divides` is set.
+     */
+    template <typename Fn>
+    static PyObject* scale(
+        const OatmealState* st,
+        PyObject* pt,
+        PyObject* obj_scalar,
+        bool divides,
+        Fn&& fn) {
+      if (!check(st, pt) || !PyLong_Check(obj_scalar)) {
+        Py_RETURN_NOTIMPLEMENTED;
+      }
+
+      const int64_t scalar = PyLong_AsLongLong(obj_scalar);
+
+      if (scalar == -1 && PyErr_Occurred()) {
+        return nullptr;
+      } else if (divides && scalar == 0) {
+        PyErr_SetString(PyExc_ZeroDivisionError, "point division by zero");
+        return nullptr;
+      }
+
+      Wide wide[N];
+
+      for (int i = 0; i < N; ++i) {
+        if (!fn(cast(pt)->v[i], scalar, &wide[i])) {
+          component_overflow<T>();
+          return nullptr;
+        }
+      }
+
+      return create_wide(st, wide);
+    }
+
+    static PyObject* add(PyObject* left, PyObject* right) {
+      return combine(left, right, checked_add);
+    }
+
+    static PyObject* sub(PyObject* left, PyObject* right) {
+      return combine(left, right, checked_sub);
+    }
+
+    static PyObject* mul(PyObject* left, PyObject* right) {
+      const auto* st = Oatmeal_operand_state(left, right);
+      return check(st, left) ? scale(st, left, right, false, checked_mul)
+                             : scale(st, right, left, false, checked_mul);
+    }
+
+    static PyObject* floor_divide(PyObject* left, PyObject* right) {
+      const auto* st = Oatmeal_operand_state(left, right);
+      return scale(st, left, right, true, floor_div);
+    }
+
+    static PyObject* remainder(PyObject* left, PyObject* right) {
+      const auto* st = Oatmeal_operand_state(left, right);
+      return scale(st, left, right, true, floor_mod);
+    }
+
+    static PyObject* negative(PyObject* self) {
+      Wide wide[N];
+
+      for (int i = 0; i < N; ++i) {
+        if (!checked_sub(0, cast(self)->v[i], &wide[i])) {
+          component_overflow<T>();
+          return nullptr;
+        }
+      }
+
+      return create_wide(Oatmeal_object_state(self), wide);
+    }
+
+    static PyObject* absolute(PyObject* self) {
+      Wide wide[N];
+
+      for (int i = 0; i < N; ++i) {
+        wide[i] = cast(self)->v[i];
+
+        if (wide[i] < 0 && !checked_sub(0, wide[i], &wide[i])) {
+          component_overflow<T>();
+          return nullptr;
+        }
+      }
+
+      return create_wide(Oatmeal_object_state(self), wide);
+    }
+
+    static PyObject* compare(PyObject* self, PyObject* other, int op) {
+      const auto* st = Oatmeal_operand_state(self, other);
+
+      if (!check(st, self) || !check(st, other) ||
+          (op != Py_EQ && op != Py_NE)) {
+        Py_RETURN_NOTIMPLEMENTED;
+      }
+
+      const bool equal =
+          std::equal(cast(self)->v, cast(self)->v + N, cast(other)->v);
+      return PyBool_FromLong(equal == (op == Py_EQ));
+    }
+
+    /** Same mixing as `Point_mix_hash`, with a scale per component. */
+    static Py_hash_t hash(PyObject* self) {
+      uint64_t h = 0;
+
+      for (int i = 0; i < N; ++i) {
+        h += static_cast<uint64_t>(cast(self)->v[i]) * kHashScales[i];
+      }
+
+      h ^= h >> 30;
+      h *= 0xBF58476D1CE4E5B9ull;
+      h ^= h >> 27;
+      h *= 0x94D049BB133111EBull;
+      h ^= h >> 31;
+
+      // -1 is reserved by Python for reporting errors from hash functions.
+      const auto result = static_cast<Py_hash_t>(h);
+      return result == -1 ? -2 : result;
+    }
+
+    static PyObject* repr(PyObject* self) {
+      std::string text = name();
+      append_components<N, T>(&text, cast(self)->v, 1);
+      return PyUnicode_FromStringAndSize(text.data(), text.size());
+    }
+
+    /** pickle as `Point{N}i{bits}(*components)`. */
+    static PyObject* reduce(PyObject* self, PyObject*) {
+      PyObject* components = PyTuple_New(N);
+
+      for (int i = 0; components != nullptr && i < N; ++i) {
+        PyObject* value = PyLong_FromLongLong(cast(self)->v[i]);
+
+        if (value == nullptr) {
+          Py_CLEAR(components);
+        } else {
+          PyTuple_SET_ITEM(components, i, value);
+        }
+      }
+
+      if (components == nullptr) {
+        return nullptr;
+      }
+
+      return Py_BuildValue("ON", Py_TYPE(self), components);
+    }
+
+    static inline PyGetSetDef getset[] = {
+        {kComponentNames[0],
+         get_component,
+         set_component,
+         "x component",
+         reinterpret_cast<void*>(0)},
+        {kComponentNames[1],
+         get_component,
+         set_component,
+         "y component",
+         reinterpret_cast<void*>(1)},
+        {N > 2 ? kComponentNames[2] : nullptr,
+         get_component,
+         set_component,
+         "z component",
+         reinterpret_cast<void*>(2)},
+        {N > 3 ? kComponentNames[3] : nullptr,
+         get_component,
+         set_component,
+         "w component",
+         reinterpret_cast<void*>(3)},
+        {nullptr}};
+
+    static inline PyMethodDef methods[] = {
+        {"__reduce__",
+         (PyCFunction)reduce,
+         METH_NOARGS,
+         "pickle the point by its components"},
+        {nullptr}};
+
+    static PyType_Spec* spec() {
+      static const std::string qualified = "oatmeal." + name();
+      static const std::string doc =
+          std::to_string(N) + "d point with " +
+          std::to_string(sizeof(T) * 8) + " bit components";
+
+      static PyType_Slot slots[] = {
+          {Py_tp_dealloc, reinterpret_cast<void*>(dealloc)},
+          {Py_tp_repr, reinterpret_cast<void*>(repr)},
+          {Py_nb_add, reinterpret_cast<void*>(add)},
+          {Py_nb_subtract, reinterpret_cast<void*>(sub)},
+          {Py_nb_multiply, reinterpret_cast<void*>(mul)},
+          {Py_nb_remainder, reinterpret_cast<void*>(remainder)},
+          {Py_nb_negative, reinterpret_cast<void*>(negative)},
+          {Py_nb_absolute, reinterpret_cast<void*>(absolute)},
+          {Py_nb_floor_divide, reinterpret_cast<void*>(floor_divide)},
+          {Py_mp_length, reinterpret_cast<void*>(len)},
+          {Py_mp_subscript, reinterpret_cast<void*>(get)},
+          {Py_mp_ass_subscript, reinterpret_cast<void*>(set)},
+          {Py_tp_hash, reinterpret_cast<void*>(hash)},
+          {Py_tp_doc, const_cast<char*>(doc.c_str())},
+          {Py_tp_richcompare, reinterpret_cast<void*>(compare)},
+          {Py_tp_methods, methods},
+          {Py_tp_getset, getset},
+          {Py_tp_new, reinterpret_cast<void*>(tp_new)},
+          {0, nullptr}};
+
+      static PyType_Spec spec = {
+          .name = qualified.c_str(),
+          .basicsize = sizeof(Self),
+          .itemsize = 0,
+          .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+          .slots = slots,
+      };
+
+      return &spec;
+    }
+  };
+
+  //------------------------------------------------------------------------------------------------
+  // PointArrayND implementation shared by every instantiation.
+  //------------------------------------------------------------------------------------------------
+  template <int N, typename T> struct PointArrayOps {
+    using Self = PointArrayND<N, T>;
+    using Point = PointOps<N, T>;
+
+    /** Smallest capacity allocated once an array holds any points. */
+    static constexpr Py_ssize_t kMinCapacity = 8;
+
+    static Self* cast(PyObject* obj) { return reinterpret_cast<Self*>(obj); }
+
+    static const std::string& name() {
+      static const std::string text = "PointArray" + type_suffix<N, T>();
+      return text;
+    }
+
+    /**
+     * Move every column into storage for exactly `capacity` points, which
+     * must be at least `count`. Fails with a `BufferError` while exported.
+     */
+    static bool resize_storage(Self* self, Py_ssize_t capacity) {
+      if (self->exports > 0) {
+        PyErr_SetString(
+            PyExc_BufferError,
+            "cannot resize a point array while it is exported as a buffer");
+        return false;
+      }
+
+      T* values = nullptr;
+
+      if (capacity > 0) {
+        values = static_cast<T*>(PyMem_Malloc(N * capacity * sizeof(T)));
+
+        if (values == nullptr) {
+          PyErr_NoMemory();
+          return false;
+        }
+
+        for (int i = 0; i < N; ++i) {
+          const T* column = self->values + i * self->capacity;
+          std::copy(column, column + self->count, values + i * capacity);
+        }
+      }
+
+      SharedBuffer_free(self->base, self->values);
+      self->base = nullptr;
+      self->values = values;
+      self->capacity = capacity;
+      return true;
+    }
+
+    static bool push_back(Self* self, const T* v) {
+      if (self->count == self->capacity &&
+          !resize_storage(self, std::max(kMinCapacity, self->capacity * 2))) {
+        return false;
+      }
+
+      for (int i = 0; i < N; ++i) {
+        self->values[i * self->capacity + self->count] = v[i];
+      }
+
+      self->count++;
+      return true;
+    }
+
+    /** Read a point of the same dimension into `T` components. */
+    static bool point_arg(const OatmealState* st, PyObject* obj, T* out) {
+      int64_t wide[N];
+
+      if (!PointND_components<N>(st, obj, wide)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "`%s` only holds %d dimensional points",
+            name().c_str(),
+            N);
+        return false;
+      }
+
+      for (int i = 0; i < N; ++i) {
+        if (!narrow<T>(wide[i], &out[i])) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    /** Point `index`, which must be in range. */
+    static PyObject* point_at(Self* self, Py_ssize_t index) {
+      T v[N];
+
+      for (int i = 0; i < N; ++i) {
+        v[i] = self->values[i * self->capacity + index];
+      }
+
+      return Point::create(Oatmeal_type_state(Py_TYPE(self)), v);
+    }
+
+    static PyObject* tp_new(PyTypeObject* type, PyObject*, PyObject*) {
+      auto* self = cast(type->tp_alloc(type, 0));
+
+      if (self != nullptr) {
+        self->count = 0;
+        self->capacity = 0;
+        self->values = nullptr;
+        self->base = nullptr;
+        self->exports = 0;
+      }
+
+      return reinterpret_cast<PyObject*>(self);
+    }
+
+    static int init(PyObject* obj_self, PyObject* args, PyObject* kwds) {
+      const char* kwlist[] = {"points", nullptr};
+      PyObject* points = nullptr;
+      auto* self = cast(obj_self);
+
+      if (!PyArg_ParseTupleAndKeywords(
+              args, kwds, "|O", const_cast<char**>(kwlist), &points)) {
+        return -1;
+      } else if (self->exports > 0) {
+        PyErr_SetString(
+            PyExc_BufferError,
+            "cannot reset a point array while it is exported as a buffer");
+        return -1;
+      }
+
+      self->count = 0;
+
+      if (points == nullptr) {
+        return 0;
+      }
+
+      PyObject* iter = PyObject_GetIter(points);
+
+      if (iter == nullptr) {
+        return -1;
+      }
+
+      const auto* st = Oatmeal_object_state(obj_self);
+
+      while (PyObject* item = PyIter_Next(iter)) {
+        T v[N];
+        const bool added = point_arg(st, item, v) && push_back(self, v);
+        Py_DECREF(item);
+
+        if (!added) {
+          Py_DECREF(iter);
+          return -1;
+        }
+      }
+
+      Py_DECREF(iter);
+      return PyErr_Occurred() ? -1 : 0;
+    }
+
+    static void dealloc(PyObject* self) {
+      SharedBuffer_free(cast(self)->base, cast(self)->values);
+      Oatmeal_free(self);
+    }
+
+    /** Array sharing a buffer of `N` columns laid out one after another. */
+    static PyObject* from_buffer(PyObject* cls, PyObject* buffer) {
+      SharedBuffer storage;
+
+      if (!SharedBuffer_open(buffer, N * sizeof(T), &storage)) {
+        return nullptr;
+      }
+
+      auto* type = reinterpret_cast<PyTypeObject*>(cls);
+      auto* self = cast(tp_new(type, nullptr, nullptr));
+
+      if (self == nullptr) {
+        SharedBuffer_free(storage.base, storage.data);
+        return nullptr;
+      }
+
+      const auto count = storage.size / static_cast<Py_ssize_t>(N * sizeof(T));
+
+      self->count = count;
+      self->capacity = count;
+      self->values = reinterpret_cast<T*>(storage.data);
+      self->base = storage.base;
+
+      return reinterpret_cast<PyObject*>(self);
+    }
+
+    /** pickle the columns as one buffer, out of band for protocol 5. */
+    static PyObject* reduce_ex(PyObject* obj_self, PyObject* obj_protocol) {
+      auto* self = cast(obj_self);
+      const long protocol = PyLong_AsLong(obj_protocol);
+
+      if (protocol == -1 && PyErr_Occurred()) {
+        return nullptr;
+      }
+
+      // Trimming the spare capacity leaves the columns in one contiguous block.
+      if (self->count != self->capacity && !resize_storage(self, self->count)) {
+        return nullptr;
+      }
+
+      PyObject* columns = SharedBuffer_pickle(
+          obj_self,
+          self->values,
+          N * self->count * static_cast<Py_ssize_t>(sizeof(T)),
+          static_cast<int>(protocol));
+
+      if (columns == nullptr) {
+        return nullptr;
+      }
+
+      return Py_BuildValue(
+          "N(N)",
+          PyObject_GetAttrString(
+              reinterpret_cast<PyObject*>(Py_TYPE(obj_self)), "from_buffer"),
+          columns);
+    }
+
+    static PyObject* append(PyObject* self, PyObject* pt) {
+      T v[N];
+
+      if (!point_arg(Oatmeal_object_state(self), pt, v) ||
+          !push_back(cast(self), v)) {
+        return nullptr;
+      }
+
+      Py_RETURN_NONE;
+    }
+
+    static PyObject* bounding_box(PyObject* obj_self, PyObject*) {
+      auto* self = cast(obj_self);
+
+      if (self->count == 0) {
+        PyErr_SetString(
+            PyExc_ValueError, "cannot take the bounding box of no points");
+        return nullptr;
+      }
+
+      T lo[N];
+      T hi[N];
+
+      for (int i = 0; i < N; ++i) {
+        const T* column = self->values + i * self->capacity;
+        const auto [min, max] =
+            std::minmax_element(column, column + self->count);
+        lo[i] = *min;
+        hi[i] = *max;
+      }
+
+      const auto* st = Oatmeal_object_state(obj_self);
+      PyObject* min_pt = Point::create(st, lo);
+      PyObject* max_pt = min_pt != nullptr ? Point::create(st, hi) : nullptr;
+
+      if (max_pt == nullptr) {
+        Py_XDECREF(min_pt);
+        return nullptr;
+      }
+
+      return Py_BuildValue("NN", min_pt, max_pt);
+    }
+
+    static Py_ssize_t len(PyObject* self) { return cast(self)->count; }
+
+    static PyObject* get(PyObject* obj_self, Py_ssize_t index) {
+      auto* self = cast(obj_self);
+
+      if (index < 0 || index >= self->count) {
+        PyErr_SetString(PyExc_IndexError, "point array index out of range");
+        return nullptr;
+      }
+
+      return point_at(self, index);
+    }
+
+    static int set(PyObject* obj_self, Py_ssize_t index, PyObject* pt) {
+      auto* self = cast(obj_self);
+      T v[N];
+
+      if (pt == nullptr) {
+        PyErr_SetString(PyExc_TypeError, "points cannot be deleted");
+        return -1;
+      } else if (index < 0 || index >= self->count) {
+        PyErr_SetString(PyExc_IndexError, "point array index out of range");
+        return -1;
+      } else if (!point_arg(Oatmeal_object_state(obj_self), pt, v)) {
+        return -1;
+      }
+
+      for (int i = 0; i < N; ++i) {
+        self->values[i * self->capacity + index] = v[i];
+      }
+
+      return 0;
+    }
+
+    static PyObject* repr(PyObject* obj_self) {
+      auto* self = cast(obj_self);
+      std::string text = name() + "([";
+
+      for (Py_ssize_t i = 0; i < self->count; ++i) {
+        text += i > 0 ? ", " : "";
+        text += Point::name();
+        append_components<N, T>(&text, self->values + i, self->capacity);
+      }
+
+      text += "])";
+      return PyUnicode_FromStringAndSize(text.data(), text.size());
+    }
+
+    /**
+     * Buffer export as a C contiguous `(N, count)` array with one row per
+     * column. Any spare capacity is released first so the rows are adjacent.
+     */
+    static int getbuffer(PyObject* obj_self, Py_buffer* view, int flags) {
+      auto* self = cast(obj_self);
+
+      if (self->count != self->capacity && !resize_storage(self, self->count)) {
+        view->obj = nullptr;
+        return -1;
+      }
+
+      // An empty array has no storage, but consumers need a valid pointer.
+      static T empty = 0;
+
+      self->buffer_shape[0] = N;
+      self->buffer_shape[1] = self->count;
+      self->buffer_strides[0] = self->count * sizeof(T);
+      self->buffer_strides[1] = sizeof(T);
+
+      Py_INCREF(obj_self);
+      view->obj = obj_self;
+      view->buf = self->values != nullptr ? self->values : &empty;
+      view->len = N * self->count * sizeof(T);
+      view->itemsize = sizeof(T);
+      view->readonly = 0;
+      // Without a shape, consumers treat the buffer as `len / itemsize` items.
+      view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? 2 : 1;
+      view->format = (flags & PyBUF_FORMAT) != 0
+                         ? const_cast<char*>(component_format<T>())
+                         : nullptr;
+      view->shape =
+          (flags & PyBUF_ND) == PyBUF_ND ? self->buffer_shape : nullptr;
+      view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES
+                          ? self->buffer_strides
+                          : nullptr;
+      view->suboffsets = nullptr;
+      view->internal = nullptr;
+
+      self->exports++;
+      return 0;
+    }
+
+    static void releasebuffer(PyObject* self, Py_buffer*) {
+      cast(self)->exports--;
+    }
+
+    static inline PyMethodDef methods[] = {
+        {"from_buffer",
+         (PyCFunction)from_buffer,
+         METH_O | METH_CLASS,
+         "Create an array from a buffer of every column in turn"},
+        {"__reduce_ex__",
+         (PyCFunction)reduce_ex,
+         METH_O,
+         "pickle the columns as one buffer, out of band for protocol 5"},
+        {"append",
+         (PyCFunction)append,
+         METH_O,
+         "Add a point to the end of the array"},
+        {"bounding_box",
+         (PyCFunction)bounding_box,
+         METH_NOARGS,
+         "Returns the inclusive minimum and maximum corners of the points"},
+        {nullptr}};
+
+    static PyType_Spec* spec() {
+      static const std::string qualified = "oatmeal." + name();
+      static const std::string doc =
+          "Array of " + std::to_string(N) + "d points with " +
+          std::to_string(sizeof(T) * 8) + " bit components stored as columns";
+
+      static PyType_Slot slots[] = {
+          {Py_tp_dealloc, reinterpret_cast<void*>(dealloc)},
+          {Py_tp_repr, reinterpret_cast<void*>(repr)},
+          {Py_sq_length, reinterpret_cast<void*>(len)},
+          {Py_sq_item, reinterpret_cast<void*>(get)},
+          {Py_sq_ass_item, reinterpret_cast<void*>(set)},
+          {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+          {Py_bf_getbuffer, reinterpret_cast<void*>(getbuffer)},
+          {Py_bf_releasebuffer, reinterpret_cast<void*>(releasebuffer)},
+          {Py_tp_doc, const_cast<char*>(doc.c_str())},
+          {Py_tp_methods, methods},
+          {Py_tp_init, reinterpret_cast<void*>(init)},
+          {Py_tp_new, reinterpret_cast<void*>(tp_new)},
+          {0, nullptr}};
+
+      static PyType_Spec spec = {
+          .name = qualified.c_str(),
+          .basicsize = sizeof(Self),
+          .itemsize = 0,
+          .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+          .slots = slots,
+      };
+
+      return &spec;
+    }
+  };
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// PointND method definitions.
+//--------------------------------------------------------------------------------------------------
+template <int N, typename T>
+PyTypeObject* PointND_type(const OatmealState* st) {
+  return st->point_nd_types[type_index<N, T>()];
+}
+
+//--------------------------------------------------------------------------------------------------
+template <int N, typename T>
+PyObject* PointND_create(const OatmealState* st, const T* components) {
+  return PointOps<N, T>::create(st, components);
+}
+
+//--------------------------------------------------------------------------------------------------
+template <int N>
+bool PointND_components(const OatmealState* st, PyObject* obj, int64_t* out) {
+  if (Py_TYPE(obj) == PointND_type<N, int32_t>(st)) {
+    const auto* pt = reinterpret_cast<PointND<N, int32_t>*>(obj);
+    std::copy(pt->v, pt->v + N, out);
+    return true;
+  } else if (Py_TYPE(obj) == PointND_type<N, int64_t>(st)) {
+    const auto* pt = reinterpret_cast<PointND<N, int64_t>*>(obj);
+    std::copy(pt->v, pt->v + N, out);
+    return true;
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+const NamedSpec* PointND_specs() {
+  static const NamedSpec specs[] = {
+      {"Point2i32",
+       PointOps<2, int32_t>::spec(),
+       PointOps<2, int32_t>::vectorcall},
+      {"Point2i64",
+       PointOps<2, int64_t>::spec(),
+       PointOps<2, int64_t>::vectorcall},
+      {"Point3i32",
+       PointOps<3, int32_t>::spec(),
+       PointOps<3, int32_t>::vectorcall},
+      {"Point3i64",
+       PointOps<3, int64_t>::spec(),
+       PointOps<3, int64_t>::vectorcall},
+      {"Point4i32",
+       PointOps<4, int32_t>::spec(),
+       PointOps<4, int32_t>::vectorcall},
+      {"Point4i64",
+       PointOps<4, int64_t>::spec(),
+       PointOps<4, int64_t>::vectorcall}};
+  static_assert(std::size(specs) == kPointNDTypeCount);
+  return specs;
+}
+
+//--------------------------------------------------------------------------------------------------
+const NamedSpec* PointArrayND_specs() {
+  static const NamedSpec specs[] = {
+      {"PointArray2i32", PointArrayOps<2, int32_t>::spec(), nullptr},
+      {"PointArray2i64", PointArrayOps<2, int64_t>::spec(), nullptr},
+      {"PointArray3i32", PointArrayOps<3, int32_t>::spec(), nullptr},
+      {"PointArray3i64", PointArrayOps<3, int64_t>::spec(), nullptr},
+      {"PointArray4i32", PointArrayOps<4, int32_t>::spec(), nullptr},
+      {"PointArray4i64", PointArrayOps<4, int64_t>::spec(), nullptr}};
+  static_assert(std::size(specs) == kPointNDTypeCount);
+  return specs;
+}
+
+template PyTypeObject* PointND_type<2, int32_t>(const OatmealState*);
+template PyTypeObject* PointND_type<2, int64_t>(const OatmealState*);
+template PyTypeObject* PointND_type<3, int32_t>(const OatmealState*);
+template PyTypeObject* PointND_type<3, int64_t>(const OatmealState*);
+template PyTypeObject* PointND_type<4, int32_t>(const OatmealState*);
+template PyTypeObject* PointND_type<4, int64_t>(const OatmealState*);
+
+template PyObject*
+PointND_create<2, int32_t>(const OatmealState*, const int32_t*);
+template PyObject*
+PointND_create<2, int64_t>(const OatmealState*, const int64_t*);
+template PyObject*
+PointND_create<3, int32_t>(const OatmealState*, const int32_t*);
+template PyObject*
+PointND_create<3, int64_t>(const OatmealState*, const int64_t*);
+template PyObject*
+PointND_create<4, int32_t>(const OatmealState*, const int32_t*);
+template PyObject*
+PointND_create<4, int64_t>(const OatmealState*, const int64_t*);
+
+template bool PointND_components<2>(const OatmealState*, PyObject*, int64_t*);
+template bool PointND_components<3>(const OatmealState*, PyObject*, int64_t*);
+template bool PointND_components<4>(const OatmealState*, PyObject*, int64_t*);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstdint>
+
+/**
+ * Point with `N` components of scalar type `T`, exposed to Python as
+ * `Point{N}i{bits}` such as `Point3i32`. Unlike `Point`, whose components
+ * are always `long`, the 32 bit variants halve the memory of large point
+ * sets. Every instantiation shares one implementation of construction,
+ * arithmetic and hashing.
+ */
+template <int N, typename T> struct PointND {
+  PyObject_HEAD T v[N];
+};
+
+/**
+ * Growable array of `PointND<N, T>` values stored as `N` columns in one block
+ * of storage, with column `i` starting `i * capacity` values in. Exposed as
+ * `PointArray{N}i{bits}`.
+ */
+template <int N, typename T> struct PointArrayND {
+  PyObject_HEAD Py_ssize_t count;
+  Py_ssize_t capacity;
+  T* values;
+  /** memoryview that owns the columns when they are shared with a buffer. */
+  PyObject* base;
+  /** Number of live buffer exports. Columns cannot be reallocated while > 0. */
+  Py_ssize_t exports;
+  /** Shape handed out to buffer consumers as `(N, count)`. */
+  Py_ssize_t buffer_shape[2];
+  /** Strides in bytes handed out to buffer consumers. */
+  Py_ssize_t buffer_strides[2];
+};
+
+// The templates below are instantiated in point_nd.cpp for `N` of 2, 3 and 4
+// with `int32_t` and `int64_t` components.
+
+/** `PointND<N, T>` type of the module with state `st`. */
+template <int N, typename T> PyTypeObject* PointND_type(const OatmealState* st);
+
+/**
+ * Create a `PointND<N, T>` of the module with state `st` from its components.
+ * Returns a new reference, or null with an exception set on failure.
+ */
+template <int N, typename T>
+PyObject* PointND_create(const OatmealState* st, const T* components);
+
+/**
+ * Read the components of any `N` dimensional point in the family of the
+ * module with state `st`, whatever its scalar type. Returns false without an
+ * exception for anything else.
+ */
+template <int N>
+bool PointND_components(const OatmealState* st, PyObject* obj, int64_t* out);
+
+/**
+ * A generated type spec, the name it is added to the module as and the
+ * vectorcall set on the type once it is created, if any.
+ */
+struct NamedSpec {
+  const char* name;
+  PyType_Spec* spec;
+  vectorcallfunc vectorcall;
+};
+
+/**
+ * The `kPointNDTypeCount` specs for `Point{N}i{bits}` with 2, 3 and 4
+ * dimensions and 32 and 64 bit components, in `point_nd_types` order.
+ */
+const NamedSpec* PointND_specs();
+
+/** The `PointArray{N}i{bits}` specs, in `point_array_nd_types` order. */
+const NamedSpec* PointArrayND_specs();
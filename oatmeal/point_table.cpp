@@ -0,0 +1,794 @@
+#include "point_table.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+//--------------------------------------------------------------------------------------------------
+// PointTable definitions.
+//--------------------------------------------------------------------------------------------------
+namespace {
+  /** Number of slots in a new table. */
+  constexpr size_t kInitialCapacity = 16;
+} // namespace
+
+PointTable::PointTable(size_t value_size)
+    : keys_(kInitialCapacity),
+      used_(kInitialCapacity, 0),
+      values_(kInitialCapacity * value_size, 0),
+      value_size_(value_size) {}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t PointTable::find(long x, long y) const {
+  const auto mask = capacity() - 1;
+
+  // The table is never more than two thirds full so every probe run ends in
+  // an empty slot.
+  for (auto slot = home(x, y);; slot = (slot + 1) & mask) {
+    if (!used(slot)) {
+      return -1;
+    }
+
+    if (keys_[slot].x == x && keys_[slot].y == y) {
+      return static_cast<Py_ssize_t>(slot);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t PointTable::insert(long x, long y, bool* inserted) {
+  if (!fits(count_ + 1, capacity())) {
+    rehash(capacity() * 2);
+  }
+
+  const auto mask = capacity() - 1;
+  auto slot = home(x, y);
+
+  for (; used(slot); slot = (slot + 1) & mask) {
+    if (keys_[slot].x == x && keys_[slot].y == y) {
+      *inserted = false;
+      return slot;
+    }
+  }
+
+  keys_[slot] = {x, y};
+  used_[slot] = 1;
+  count_++;
+  version_++;
+
+  *inserted = true;
+  return slot;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointTable::erase(size_t slot) {
+  const auto mask = capacity() - 1;
+  auto hole = slot;
+
+  // Walk the rest of the probe run and move back any key whose home slot is
+  // not between the hole and its current position, since it would otherwise
+  // become unreachable once the hole is emptied.
+  for (auto next = (hole + 1) & mask; used(next); next = (next + 1) & mask) {
+    const auto next_home = home(keys_[next].x, keys_[next].y);
+    const bool reachable = hole <= next
+                               ? (hole < next_home && next_home <= next)
+                               : (hole < next_home || next_home <= next);
+
+    if (!reachable) {
+      keys_[hole] = keys_[next];
+      std::memcpy(value(hole), value(next), value_size_);
+      hole = next;
+    }
+  }
+
+  used_[hole] = 0;
+  std::memset(value(hole), 0, value_size_);
+  count_--;
+  version_++;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointTable::reserve(size_t count) {
+  auto new_capacity = capacity();
+
+  while (!fits(count, new_capacity)) {
+    new_capacity *= 2;
+  }
+
+  if (new_capacity != capacity()) {
+    rehash(new_capacity);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointTable::clear() {
+  std::fill(used_.begin(), used_.end(), 0);
+  std::fill(values_.begin(), values_.end(), 0);
+  count_ = 0;
+  version_++;
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t PointTable::probe_length(size_t slot) const {
+  return ((slot - home(keys_[slot].x, keys_[slot].y)) & (capacity() - 1)) + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointTable::rehash(size_t new_capacity) {
+  const auto old_keys = std::move(keys_);
+  const auto old_used = std::move(used_);
+  const auto old_values = std::move(values_);
+
+  keys_.assign(new_capacity, Key{});
+  used_.assign(new_capacity, 0);
+  values_.assign(new_capacity * value_size_, 0);
+
+  const auto mask = capacity() - 1;
+
+  for (size_t i = 0; i < old_used.size(); ++i) {
+    if (old_used[i] == 0) {
+      continue;
+    }
+
+    auto slot = home(old_keys[i].x, old_keys[i].y);
+
+    while (used(slot)) {
+      slot = (slot + 1) & mask;
+    }
+
+    keys_[slot] = old_keys[i];
+    used_[slot] = 1;
+    std::memcpy(value(slot), old_values.data() + i * value_size_, value_size_);
+  }
+
+  version_++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Point table iterator python type definition.
+//--------------------------------------------------------------------------------------------------
+/** What a `PointTableIterator` yields for each key. */
+enum class PointTableIterKind { Keys, Values, Items };
+
+/** Iterator over the keys, values or items of a `PointSet` or `PointMap`. */
+typedef struct {
+  PyObject_HEAD PyObject* owner;
+  PointTable* table;
+  const CellOps* ops;
+  PointTableIterKind kind;
+  size_t slot;
+  uint64_t version;
+} PointTableIterator;
+
+namespace {
+  void PointTableIterator_dealloc(PyObject* obj_self) {
+    auto* self = reinterpret_cast<PointTableIterator*>(obj_self);
+    PyObject_GC_UnTrack(obj_self);
+    Py_XDECREF(self->owner);
+    Oatmeal_free(obj_self);
+  }
+
+  int PointTableIterator_traverse(
+      PyObject* obj_self,
+      visitproc visit,
+      void* arg) {
+    Py_VISIT(reinterpret_cast<PointTableIterator*>(obj_self)->owner);
+    Py_VISIT(Py_TYPE(obj_self));
+    return 0;
+  }
+
+  PyObject* PointTableIterator_next(PyObject* obj_self) {
+    auto* self = reinterpret_cast<PointTableIterator*>(obj_self);
+    auto* table = self->table;
+
+    if (table->version() != self->version) {
+      PyErr_Format(
+          PyExc_RuntimeError,
+          "%s changed size during iteration",
+          Py_TYPE(self->owner)->tp_name);
+      return nullptr;
+    }
+
+    while (self->slot < table->capacity() && !table->used(self->slot)) {
+      self->slot++;
+    }
+
+    if (self->slot >= table->capacity()) {
+      return nullptr;
+    }
+
+    const auto slot = self->slot++;
+
+    if (self->kind == PointTableIterKind::Values) {
+      return self->ops->get(table->value(slot));
+    }
+
+    PyObject* key = Point_create(
+        Oatmeal_object_state(obj_self), table->x(slot), table->y(slot));
+
+    if (key == nullptr || self->kind == PointTableIterKind::Keys) {
+      return key;
+    }
+
+    PyObject* value = self->ops->get(table->value(slot));
+
+    if (value == nullptr) {
+      Py_DECREF(key);
+      return nullptr;
+    }
+
+    PyObject* item = PyTuple_Pack(2, key, value);
+    Py_DECREF(key);
+    Py_DECREF(value);
+
+    return item;
+  }
+
+  PyObject* PointTableIterator_length_hint(PyObject* obj_self, PyObject*) {
+    auto* self = reinterpret_cast<PointTableIterator*>(obj_self);
+    Py_ssize_t remaining = 0;
+
+    for (auto slot = self->slot; slot < self->table->capacity(); ++slot) {
+      remaining += self->table->used(slot) ? 1 : 0;
+    }
+
+    return PyLong_FromSsize_t(remaining);
+  }
+
+  PyMethodDef PointTableIterator_Methods[] = {
+      {"__length_hint__",
+       (PyCFunction)PointTableIterator_length_hint,
+       METH_NOARGS,
+       "Number of entries remaining"},
+      {nullptr}};
+} // namespace
+
+PyType_Slot PointTableIterator_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(PointTableIterator_dealloc)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR("Iterator over a point set or map"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(PointTableIterator_traverse)},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(PointTableIterator_next)},
+    {Py_tp_methods, PointTableIterator_Methods},
+    {0, nullptr}};
+
+PyType_Spec PointTableIterator_Spec = {
+    .name = "oatmeal.PointTableIterator",
+    .basicsize = sizeof(PointTableIterator),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+             Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    .slots = PointTableIterator_Slots,
+};
+
+namespace {
+  PyObject* create_iterator(
+      PyObject* owner,
+      PointTable* table,
+      const CellOps* ops,
+      PointTableIterKind kind) {
+    auto* itr = PyObject_GC_New(
+        PointTableIterator,
+        Oatmeal_object_state(owner)->point_table_iterator_type);
+
+    if (itr == nullptr) {
+      return nullptr;
+    }
+
+    Py_INCREF(owner);
+    itr->owner = owner;
+    itr->table = table;
+    itr->ops = ops;
+    itr->kind = kind;
+    itr->slot = 0;
+    itr->version = table->version();
+
+    PyObject_GC_Track(itr);
+    return reinterpret_cast<PyObject*>(itr);
+  }
+
+  /** Read the coordinates of a point key, raising TypeError for non points. */
+  bool point_key(OatmealState* st, PyObject* obj, long* x, long* y) {
+    if (PyObject_TypeCheck(obj, st->point_type) == 0) {
+      PyErr_Format(
+          PyExc_TypeError,
+          "key must be of type `Point` but was `%s`",
+          Py_TYPE(obj)->tp_name);
+      return false;
+    }
+
+    *x = reinterpret_cast<Point*>(obj)->x;
+    *y = reinterpret_cast<Point*>(obj)->y;
+    return true;
+  }
+
+  /** Look up a point key, returning -1 with no exception for non points. */
+  Py_ssize_t find_key(
+      OatmealState* st,
+      const PointTable& table,
+      PyObject* obj) {
+    if (PyObject_TypeCheck(obj, st->point_type) == 0) {
+      return -1;
+    }
+
+    const auto* pt = reinterpret_cast<Point*>(obj);
+    return table.find(pt->x, pt->y);
+  }
+
+  /** Release every value held by a map. */
+  void release_values(PointMap* self) {
+    if (self->value_type != CellType::Object) {
+      return;
+    }
+
+    for (size_t slot = 0; slot < self->table.capacity(); ++slot) {
+      if (self->table.used(slot)) {
+        self->ops->clear(self->table.value(slot));
+      }
+    }
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// PointSet python type definition.
+//--------------------------------------------------------------------------------------------------
+
+PyMethodDef PointSet_Methods[] = {
+    {"add", (PyCFunction)PointSet_add, METH_O, "Add a point to the set"},
+    {"discard",
+     (PyCFunction)PointSet_discard,
+     METH_O,
+     "Remove a point from the set if it is present"},
+    {"remove",
+     (PyCFunction)PointSet_remove,
+     METH_O,
+     "Remove a point from the set, raising KeyError if it is not present"},
+    {"clear",
+     (PyCFunction)PointSet_clear,
+     METH_NOARGS,
+     "Remove every point from the set"},
+    {nullptr}};
+
+PyType_Slot PointSet_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(PointSet_dealloc)},
+    {Py_sq_length, reinterpret_cast<void*>(PointSet_len)},
+    {Py_sq_contains, reinterpret_cast<void*>(PointSet_contains)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Hash set of points stored as unboxed coordinates"))},
+    {Py_tp_iter, reinterpret_cast<void*>(PointSet_iter)},
+    {Py_tp_methods, PointSet_Methods},
+    {Py_tp_init, reinterpret_cast<void*>(PointSet_init)},
+    {Py_tp_new, reinterpret_cast<void*>(PointSet_new)},
+    {0, nullptr}};
+
+PyType_Spec PointSet_Spec = {
+    .name = "oatmeal.PointSet",
+    .basicsize = sizeof(PointSet),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = PointSet_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// PointSet method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* PointSet_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<PointSet*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    new (&self->table) PointTable();
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointSet_init(PointSet* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"points", nullptr};
+  PyObject* points = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|O", const_cast<char**>(kwlist), &points)) {
+    return -1;
+  }
+
+  self->table.clear();
+
+  if (points == nullptr) {
+    return 0;
+  }
+
+  // Size the table up front rather than growing it repeatedly while adding.
+  const auto size_hint = PyObject_LengthHint(points, 0);
+
+  if (size_hint < 0) {
+    return -1;
+  }
+
+  self->table.reserve(size_hint);
+
+  PyObject* iter = PyObject_GetIter(points);
+
+  if (iter == nullptr) {
+    return -1;
+  }
+
+  auto* st = Oatmeal_type_state(Py_TYPE(self));
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    long x = 0;
+    long y = 0;
+    const bool is_point = point_key(st, item, &x, &y);
+    Py_DECREF(item);
+
+    if (!is_point) {
+      Py_DECREF(iter);
+      return -1;
+    }
+
+    bool inserted = false;
+    self->table.insert(x, y, &inserted);
+  }
+
+  Py_DECREF(iter);
+  return PyErr_Occurred() ? -1 : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointSet_dealloc(PyObject* obj_self) {
+  reinterpret_cast<PointSet*>(obj_self)->table.~PointTable();
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointSet_add(PointSet* self, PyObject* pt) {
+  long x = 0;
+  long y = 0;
+
+  if (!point_key(Oatmeal_type_state(Py_TYPE(self)), pt, &x, &y)) {
+    return nullptr;
+  }
+
+  bool inserted = false;
+  self->table.insert(x, y, &inserted);
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointSet_discard(PointSet* self, PyObject* pt) {
+  const auto slot =
+      find_key(Oatmeal_type_state(Py_TYPE(self)), self->table, pt);
+
+  if (slot >= 0) {
+    self->table.erase(slot);
+  }
+
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointSet_remove(PointSet* self, PyObject* pt) {
+  const auto slot =
+      find_key(Oatmeal_type_state(Py_TYPE(self)), self->table, pt);
+
+  if (slot < 0) {
+    PyErr_SetObject(PyExc_KeyError, pt);
+    return nullptr;
+  }
+
+  self->table.erase(slot);
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointSet_clear(PointSet* self, PyObject*) {
+  self->table.clear();
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t PointSet_len(PyObject* self) {
+  return reinterpret_cast<PointSet*>(self)->table.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointSet_contains(PyObject* self, PyObject* pt) {
+  const auto& table = reinterpret_cast<PointSet*>(self)->table;
+  return find_key(Oatmeal_object_state(self), table, pt) >= 0 ? 1 : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointSet_iter(PyObject* self) {
+  return create_iterator(
+      self,
+      &reinterpret_cast<PointSet*>(self)->table,
+      nullptr,
+      PointTableIterKind::Keys);
+}
+
+//--------------------------------------------------------------------------------------------------
+// PointMap python type definition.
+//--------------------------------------------------------------------------------------------------
+
+PyMethodDef PointMap_Methods[] = {
+    {"get",
+     (PyCFunction)PointMap_get_or,
+     METH_FASTCALL,
+     "Returns the value for a point, or `default` if it is not present"},
+    {"clear",
+     (PyCFunction)PointMap_clear,
+     METH_NOARGS,
+     "Remove every entry from the map"},
+    {"keys",
+     (PyCFunction)PointMap_keys,
+     METH_NOARGS,
+     "Returns an iterator over the points in the map"},
+    {"values",
+     (PyCFunction)PointMap_values,
+     METH_NOARGS,
+     "Returns an iterator over the values in the map"},
+    {"items",
+     (PyCFunction)PointMap_items,
+     METH_NOARGS,
+     "Returns an iterator over `(point, value)` pairs in the map"},
+    {nullptr}};
+
+PyGetSetDef PointMap_GetSet[] = {
+    {"dtype",
+     (getter)PointMap_get_dtype,
+     nullptr,
+     "Name of the value storage type",
+     nullptr},
+    {nullptr}};
+
+PyType_Slot PointMap_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(PointMap_dealloc)},
+    {Py_sq_contains, reinterpret_cast<void*>(PointMap_contains)},
+    {Py_mp_length, reinterpret_cast<void*>(PointMap_len)},
+    {Py_mp_subscript, reinterpret_cast<void*>(PointMap_get)},
+    {Py_mp_ass_subscript, reinterpret_cast<void*>(PointMap_set)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_tp_doc,
+     const_cast<char*>(
+         PyDoc_STR("Hash map keyed by points with inline values"))},
+    {Py_tp_traverse, reinterpret_cast<void*>(PointMap_traverse)},
+    {Py_tp_clear, reinterpret_cast<void*>(PointMap_clear_refs)},
+    {Py_tp_iter, reinterpret_cast<void*>(PointMap_iter)},
+    {Py_tp_methods, PointMap_Methods},
+    {Py_tp_getset, PointMap_GetSet},
+    {Py_tp_init, reinterpret_cast<void*>(PointMap_init)},
+    {Py_tp_new, reinterpret_cast<void*>(PointMap_new)},
+    {0, nullptr}};
+
+PyType_Spec PointMap_Spec = {
+    .name = "oatmeal.PointMap",
+    .basicsize = sizeof(PointMap),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = PointMap_Slots,
+};
+
+//--------------------------------------------------------------------------------------------------
+// PointMap method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<PointMap*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    self->value_type = CellType::Object;
+    self->ops = CellOps_for(CellType::Object);
+    new (&self->table) PointTable(self->ops->item_size);
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointMap_init(PointMap* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"dtype", nullptr};
+  const char* dtype = "object";
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|s", const_cast<char**>(kwlist), &dtype)) {
+    return -1;
+  }
+
+  CellType value_type = CellType::Object;
+
+  if (!CellType_from_name(dtype, &value_type)) {
+    PyErr_Format(PyExc_ValueError, "unknown point map dtype `%s`", dtype);
+    return -1;
+  }
+
+  release_values(self);
+
+  self->value_type = value_type;
+  self->ops = CellOps_for(value_type);
+  self->table = PointTable(self->ops->item_size);
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PointMap_dealloc(PyObject* obj_self) {
+  auto* self = reinterpret_cast<PointMap*>(obj_self);
+
+  PyObject_GC_UnTrack(obj_self);
+  release_values(self);
+  self->table.~PointTable();
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointMap_traverse(PyObject* obj_self, visitproc visit, void* arg) {
+  auto* self = reinterpret_cast<PointMap*>(obj_self);
+  Py_VISIT(Py_TYPE(obj_self));
+
+  if (self->value_type == CellType::Object) {
+    for (size_t slot = 0; slot < self->table.capacity(); ++slot) {
+      if (self->table.used(slot)) {
+        Py_VISIT(*reinterpret_cast<PyObject**>(self->table.value(slot)));
+      }
+    }
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointMap_clear_refs(PyObject* obj_self) {
+  auto* self = reinterpret_cast<PointMap*>(obj_self);
+
+  release_values(self);
+  self->table.clear();
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_get_or(
+    PointMap* self,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  if (nargs < 1 || nargs > 2) {
+    PyErr_Format(
+        PyExc_TypeError, "get() takes 1 or 2 arguments (%zd given)", nargs);
+    return nullptr;
+  }
+
+  PyObject* pt = args[0];
+  PyObject* default_value = nargs > 1 ? args[1] : Py_None;
+
+  const auto slot =
+      find_key(Oatmeal_type_state(Py_TYPE(self)), self->table, pt);
+
+  if (slot < 0) {
+    Py_INCREF(default_value);
+    return default_value;
+  }
+
+  return self->ops->get(self->table.value(slot));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_clear(PointMap* self, PyObject*) {
+  PointMap_clear_refs(reinterpret_cast<PyObject*>(self));
+  Py_RETURN_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_keys(PointMap* self, PyObject*) {
+  return create_iterator(
+      reinterpret_cast<PyObject*>(self),
+      &self->table,
+      self->ops,
+      PointTableIterKind::Keys);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_values(PointMap* self, PyObject*) {
+  return create_iterator(
+      reinterpret_cast<PyObject*>(self),
+      &self->table,
+      self->ops,
+      PointTableIterKind::Values);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_items(PointMap* self, PyObject*) {
+  return create_iterator(
+      reinterpret_cast<PyObject*>(self),
+      &self->table,
+      self->ops,
+      PointTableIterKind::Items);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_get_dtype(PointMap* self, void*) {
+  return PyUnicode_FromString(self->ops->name);
+}
+
+//--------------------------------------------------------------------------------------------------
+Py_ssize_t PointMap_len(PyObject* self) {
+  return reinterpret_cast<PointMap*>(self)->table.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_get(PyObject* obj_self, PyObject* pt) {
+  auto* self = reinterpret_cast<PointMap*>(obj_self);
+  long x = 0;
+  long y = 0;
+
+  if (!point_key(Oatmeal_object_state(obj_self), pt, &x, &y)) {
+    return nullptr;
+  }
+
+  const auto slot = self->table.find(x, y);
+
+  if (slot < 0) {
+    PyErr_SetObject(PyExc_KeyError, pt);
+    return nullptr;
+  }
+
+  return self->ops->get(self->table.value(slot));
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointMap_set(PyObject* obj_self, PyObject* pt, PyObject* value) {
+  auto* self = reinterpret_cast<PointMap*>(obj_self);
+  long x = 0;
+  long y = 0;
+
+  if (!point_key(Oatmeal_object_state(obj_self), pt, &x, &y)) {
+    return -1;
+  }
+
+  // A null value means the entry is being deleted.
+  if (value == nullptr) {
+    const auto slot = self->table.find(x, y);
+
+    if (slot < 0) {
+      PyErr_SetObject(PyExc_KeyError, pt);
+      return -1;
+    }
+
+    // Move the value out and erase the entry before releasing it, since
+    // dropping the last reference can run code that reads this map. Every
+    // cell type fits in 8 bytes.
+    int64_t held = 0;
+    std::memcpy(&held, self->table.value(slot), self->ops->item_size);
+    self->table.erase(slot);
+    self->ops->clear(reinterpret_cast<char*>(&held));
+    return 0;
+  }
+
+  bool inserted = false;
+  const auto slot = self->table.insert(x, y, &inserted);
+
+  if (self->ops->set(self->table.value(slot), value) < 0) {
+    // Don't leave a zero filled entry behind for a value that didn't convert.
+    if (inserted) {
+      self->table.erase(slot);
+    }
+
+    return -1;
+  }
+
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+int PointMap_contains(PyObject* self, PyObject* pt) {
+  const auto& table = reinterpret_cast<PointMap*>(self)->table;
+  return find_key(Oatmeal_object_state(self), table, pt) >= 0 ? 1 : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* PointMap_iter(PyObject* self) {
+  return PointMap_keys(reinterpret_cast<PointMap*>(self), nullptr);
+}
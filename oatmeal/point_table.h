@@ -0,0 +1,193 @@
+#pragma once
+
+#include "oatmeal.h"
+#include "grid.h"
+#include "point.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Open addressing hash table keyed by unboxed `(x, y)` pairs with linear
+ * probing. Each slot can carry a fixed size block of value bytes, which is
+ * empty for sets. Keys are never boxed into `Point` objects unless iterated.
+ */
+class PointTable {
+public:
+  explicit PointTable(size_t value_size = 0);
+
+  /** Number of keys in the table. */
+  size_t size() const { return count_; }
+
+  /** Number of slots in the table, always a power of two. */
+  size_t capacity() const { return used_.size(); }
+
+  /** Counter bumped whenever keys are added or removed. */
+  uint64_t version() const { return version_; }
+
+  /** Returns true if `slot` holds a key. */
+  bool used(size_t slot) const { return used_[slot] != 0; }
+
+  /** x component of the key in `slot`. */
+  long x(size_t slot) const { return keys_[slot].x; }
+
+  /** y component of the key in `slot`. */
+  long y(size_t slot) const { return keys_[slot].y; }
+
+  /** Value bytes for `slot`, zero filled when the key was inserted. */
+  char* value(size_t slot) { return values_.data() + slot * value_size_; }
+
+  /** Returns the slot holding `(x, y)`, or -1 if the key is not present. */
+  Py_ssize_t find(long x, long y) const;
+
+  /**
+   * Returns the slot holding `(x, y)`, adding the key if it is missing and
+   * setting `inserted` to say which happened. Slots from before an insert are
+   * invalidated since the table may grow.
+   */
+  size_t insert(long x, long y, bool* inserted);
+
+  /**
+   * Remove the key in `slot`. Any value it holds must already be released.
+   * Later keys in the same probe run are shifted back so lookups never need
+   * tombstones.
+   */
+  void erase(size_t slot);
+
+  /** Grow the table so `count` keys fit without any further rehashing. */
+  void reserve(size_t count);
+
+  /** Remove every key. Any values must already be released. */
+  void clear();
+
+  /** Number of slots a lookup probes to find the key in `slot`. */
+  size_t probe_length(size_t slot) const;
+
+private:
+  struct Key {
+    long x;
+    long y;
+  };
+
+  /** First slot probed for `(x, y)`. */
+  size_t home(long x, long y) const {
+    return Point_mix_hash(x, y) & (capacity() - 1);
+  }
+
+  /** Returns true if `count` keys fit within the maximum load factor. */
+  static bool fits(size_t count, size_t capacity) {
+    return count * 3 <= capacity * 2;
+  }
+
+  /** Move every key into a new table of `new_capacity` slots. */
+  void rehash(size_t new_capacity);
+
+  std::vector<Key> keys_;
+  std::vector<uint8_t> used_;
+  std::vector<char> values_;
+  size_t value_size_;
+  size_t count_ = 0;
+  uint64_t version_ = 0;
+};
+
+/** Set of points stored as unboxed coordinates. */
+typedef struct {
+  PyObject_HEAD PointTable table;
+} PointSet;
+
+/** Dictionary keyed by points, with values stored inline as grid cells. */
+typedef struct {
+  PyObject_HEAD PointTable table;
+  CellType value_type;
+  const CellOps* ops;
+} PointMap;
+
+/** Python type spec for `PointSet`. */
+extern PyType_Spec PointSet_Spec;
+
+/** Python type spec for `PointMap`. */
+extern PyType_Spec PointMap_Spec;
+
+/** Python type spec for the iterators over `PointSet` and `PointMap`. */
+extern PyType_Spec PointTableIterator_Spec;
+
+/** __new__(type, *args, **kwds) -> PointSet */
+PyObject* PointSet_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, points: Iterable[Point] = ()) */
+int PointSet_init(PointSet* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the set. */
+void PointSet_dealloc(PyObject* self);
+
+/** add(self, pt: Point) */
+PyObject* PointSet_add(PointSet* self, PyObject* pt);
+
+/** discard(self, pt: Point) */
+PyObject* PointSet_discard(PointSet* self, PyObject* pt);
+
+/** remove(self, pt: Point) */
+PyObject* PointSet_remove(PointSet* self, PyObject* pt);
+
+/** clear(self) */
+PyObject* PointSet_clear(PointSet* self, PyObject*);
+
+/** len(self) -> int */
+Py_ssize_t PointSet_len(PyObject* self);
+
+/** __contains__(self, pt: Point) -> bool */
+int PointSet_contains(PyObject* self, PyObject* pt);
+
+/** iter(self) -> Iterator[Point] */
+PyObject* PointSet_iter(PyObject* self);
+
+/** __new__(type, *args, **kwds) -> PointMap */
+PyObject* PointMap_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/** __init__(self, dtype: str = "object") */
+int PointMap_init(PointMap* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the map and release all values. */
+void PointMap_dealloc(PyObject* self);
+
+/** GC traversal of the type and object values. */
+int PointMap_traverse(PyObject* self, visitproc visit, void* arg);
+
+/** GC clear of object values. */
+int PointMap_clear_refs(PyObject* self);
+
+/** get(self, pt: Point, default: T | None = None) -> T | None */
+PyObject* PointMap_get_or(
+    PointMap* self,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+
+/** clear(self) */
+PyObject* PointMap_clear(PointMap* self, PyObject*);
+
+/** keys(self) -> Iterator[Point] */
+PyObject* PointMap_keys(PointMap* self, PyObject*);
+
+/** values(self) -> Iterator[T] */
+PyObject* PointMap_values(PointMap* self, PyObject*);
+
+/** items(self) -> Iterator[Tuple[Point, T]] */
+PyObject* PointMap_items(PointMap* self, PyObject*);
+
+/** dtype -> str */
+PyObject* PointMap_get_dtype(PointMap* self, void*);
+
+/** len(self) -> int */
+Py_ssize_t PointMap_len(PyObject* self);
+
+/** __getitem__(self, pt: Point) -> T */
+PyObject* PointMap_get(PyObject* self, PyObject* pt);
+
+/** __setitem__(self, pt: Point, value: T) and __delitem__(self, pt: Point) */
+int PointMap_set(PyObject* self, PyObject* pt, PyObject* value);
+
+/** __contains__(self, pt: Point) -> bool */
+int PointMap_contains(PyObject* self, PyObject* pt);
+
+/** iter(self) -> Iterator[Point] */
+PyObject* PointMap_iter(PyObject* self);
@@ -0,0 +1,354 @@
+#include "schematic.h"
+#include "mapped_input.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+  /** Eight bytes are only classified as a word on little endian targets. */
+  constexpr bool kWordScan = std::endian::native == std::endian::little;
+
+  constexpr uint64_t kLowBits = 0x0101010101010101;
+  constexpr uint64_t kHighBits = 0x8080808080808080;
+  constexpr int64_t kMaxSum = std::numeric_limits<int64_t>::max();
+
+  /** Marks a gear whose ratio does not fit in an int64. */
+  constexpr int64_t kRatioOverflow = -1;
+
+  bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+  /** Anything printable that is not a digit or `.` is a symbol. */
+  bool is_symbol(char c) {
+    return c > ' ' && c < 0x7F && c != '.' && !is_digit(c);
+  }
+
+  uint64_t load_word(const char* p) {
+    uint64_t word = 0;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+  }
+
+  /** High bit of each byte of the result is set where `word` holds `c`. */
+  uint64_t byte_bits(uint64_t word, char c) {
+    const uint64_t x = word ^ (kLowBits * static_cast<unsigned char>(c));
+    return ~(((x & ~kHighBits) + ~kHighBits) | x) & kHighBits;
+  }
+
+  /** High bit of each byte of the result is set where `word` holds a digit. */
+  uint64_t digit_bits(uint64_t word) {
+    // Digits become 0 to 9 after the xor, and adding 0x76 to the low 7 bits
+    // sets the high bit of anything larger.
+    const uint64_t x = word ^ (kLowBits * '0');
+    return ~(((x & ~kHighBits) + 0x7676767676767676) | x) & kHighBits;
+  }
+
+  /** High bit of each byte of the result is set where `word` holds a symbol. */
+  uint64_t symbol_bits(uint64_t word, uint64_t digits) {
+    // Adding 0x5F to the low 7 bits sets the high bit of anything above a
+    // space, and the delete character and bytes >= 0x80 are masked off after.
+    const uint64_t printable =
+        ((word & ~kHighBits) + 0x5F5F5F5F5F5F5F5F) & ~word & kHighBits;
+    return printable & ~digits & ~byte_bits(word, '.') &
+           ~byte_bits(word, 0x7F);
+  }
+
+  /** Pack the high bit of each byte into one bit per byte, first byte low. */
+  uint64_t pack_bits(uint64_t bits) {
+    return ((bits >> 7) * 0x0102040810204080) >> 56;
+  }
+
+  /** Call `fn(column)` for every set bit of `bits` in columns `[lo, hi)`. */
+  template <typename Fn>
+  void for_each_bit(
+      const std::vector<uint64_t>& bits,
+      size_t lo,
+      size_t hi,
+      Fn&& fn) {
+    for (size_t w = lo / 64; w * 64 < hi; ++w) {
+      uint64_t word = bits[w];
+
+      if (w == lo / 64) {
+        word &= ~uint64_t{0} << (lo % 64);
+      }
+
+      if ((w + 1) * 64 > hi) {
+        word &= ~uint64_t{0} >> (64 - hi % 64);
+      }
+
+      for (; word != 0; word &= word - 1) {
+        fn(w * 64 + std::countr_zero(word));
+      }
+    }
+  }
+
+  /** A run of digits in columns `[begin, end)` of a row. */
+  struct Run {
+    size_t begin;
+    size_t end;
+    int64_t value;
+  };
+
+  /** A classified row of the schematic. */
+  struct Row {
+    size_t width = 0;
+    std::vector<uint64_t> symbols;
+    std::vector<uint64_t> gears;
+    std::vector<Run> runs;
+
+    /** Neighbouring numbers and their product for each gear column. */
+    std::vector<uint8_t> gear_counts;
+    std::vector<int64_t> gear_ratios;
+  };
+
+  /**
+   * Streams rows of a schematic through a window of three classified rows.
+   * The numbers of a row are matched once the row below it has been pushed,
+   * and the gears of a row are totalled once every row next to it has been
+   * matched.
+   */
+  class SchematicScanner {
+  public:
+    /** Add the next row, returning false if a sum overflows. */
+    bool push(const char* begin, const char* end) {
+      if (!classify(row(count_), begin, end)) {
+        return false;
+      }
+
+      count_++;
+      return (count_ < 2 || match(count_ - 2)) &&
+             (count_ < 3 || total_gears(count_ - 3));
+    }
+
+    /** Match the rows left in the window, returning false on overflow. */
+    bool finish() {
+      return (count_ < 1 || match(count_ - 1)) &&
+             (count_ < 2 || total_gears(count_ - 2)) &&
+             (count_ < 1 || total_gears(count_ - 1));
+    }
+
+    int64_t part_sum() const { return part_sum_; }
+    int64_t ratio_sum() const { return ratio_sum_; }
+
+  private:
+    Row& row(size_t y) { return rows_[y % rows_.size()]; }
+
+    /** Build the bitmaps and digit runs of a row. */
+    bool classify(Row& out, const char* begin, const char* end) {
+      const auto width = static_cast<size_t>(end - begin);
+      const auto words = (width + 63) / 64;
+
+      out.width = width;
+      out.symbols.assign(words, 0);
+      out.gears.assign(words, 0);
+      out.runs.clear();
+      out.gear_counts.assign(width, 0);
+      out.gear_ratios.assign(width, 0);
+      digits_.assign(words, 0);
+
+      size_t x = 0;
+
+      if constexpr (kWordScan) {
+        for (; width - x >= 8; x += 8) {
+          const auto word = load_word(begin + x);
+          const auto digits = digit_bits(word);
+          const auto shift = x % 64;
+
+          digits_[x / 64] |= pack_bits(digits) << shift;
+          out.symbols[x / 64] |= pack_bits(symbol_bits(word, digits)) << shift;
+          out.gears[x / 64] |= pack_bits(byte_bits(word, '*')) << shift;
+        }
+      }
+
+      for (; x < width; ++x) {
+        const auto bit = uint64_t{1} << (x % 64);
+
+        digits_[x / 64] |= is_digit(begin[x]) ? bit : 0;
+        out.symbols[x / 64] |= is_symbol(begin[x]) ? bit : 0;
+        out.gears[x / 64] |= begin[x] == '*' ? bit : 0;
+      }
+
+      // A run starts at each digit whose left neighbour is not a digit.
+      uint64_t carry = 0;
+
+      for (size_t w = 0; w < words; ++w) {
+        auto starts = digits_[w] & ~(digits_[w] << 1 | carry);
+        carry = digits_[w] >> 63;
+
+        for (; starts != 0; starts &= starts - 1) {
+          const auto start = w * 64 + std::countr_zero(starts);
+          Run run{start, start, 0};
+
+          for (; run.end < width && is_digit(begin[run.end]); ++run.end) {
+            const int d = begin[run.end] - '0';
+
+            if (run.value > (kMaxSum - d) / 10) {
+              return false;
+            }
+
+            run.value = run.value * 10 + d;
+          }
+
+          out.runs.push_back(run);
+        }
+      }
+
+      return true;
+    }
+
+    /** Match the numbers of row `y` against the symbols around them. */
+    bool match(size_t y) {
+      const auto first = y > 0 ? y - 1 : y;
+      const auto last = y + 1 < count_ ? y + 1 : y;
+
+      for (const auto& run : row(y).runs) {
+        const auto lo = run.begin > 0 ? run.begin - 1 : 0;
+        bool is_part = false;
+
+        for (auto ny = first; ny <= last; ++ny) {
+          auto& near = row(ny);
+          const auto hi = run.end + 1 < near.width ? run.end + 1 : near.width;
+
+          for_each_bit(near.symbols, lo, hi, [&](size_t) { is_part = true; });
+          for_each_bit(near.gears, lo, hi, [&](size_t x) {
+            const auto count = near.gear_counts[x];
+            auto& ratio = near.gear_ratios[x];
+
+            if (count == 0) {
+              ratio = run.value;
+            } else if (count == 1 && run.value != 0 &&
+                       ratio > kMaxSum / run.value) {
+              ratio = kRatioOverflow;
+            } else if (count == 1) {
+              ratio *= run.value;
+            }
+
+            // Stop counting at three so busy gears never wrap back to two.
+            near.gear_counts[x] = count < 3 ? count + 1 : 3;
+          });
+        }
+
+        if (is_part && run.value > kMaxSum - part_sum_) {
+          return false;
+        }
+
+        part_sum_ += is_part ? run.value : 0;
+      }
+
+      return true;
+    }
+
+    /** Add the ratio of every gear in row `y` with two neighbouring numbers. */
+    bool total_gears(size_t y) {
+      const auto& gears = row(y);
+      bool fits = true;
+
+      for_each_bit(gears.gears, 0, gears.width, [&](size_t x) {
+        if (gears.gear_counts[x] != 2) {
+          return;
+        }
+
+        const auto ratio = gears.gear_ratios[x];
+        fits = fits && ratio != kRatioOverflow && ratio <= kMaxSum - ratio_sum_;
+        ratio_sum_ += fits ? ratio : 0;
+      });
+
+      return fits;
+    }
+
+    std::array<Row, 3> rows_;
+    std::vector<uint64_t> digits_;
+    size_t count_ = 0;
+    int64_t part_sum_ = 0;
+    int64_t ratio_sum_ = 0;
+  };
+
+  /** Scan every line of a mapped input without the GIL. */
+  bool mapped_scan(MappedInput* lines, SchematicScanner* scanner) {
+    if (!lines->file.is_open()) {
+      PyErr_SetString(PyExc_ValueError, "I/O operation on closed input");
+      return false;
+    }
+
+    // Hold an export so the file cannot be unmapped while the GIL is released.
+    const MappedLines mapped(lines);
+    bool fits = true;
+
+    lines->exports++;
+    Py_BEGIN_ALLOW_THREADS;
+
+    fits = mapped.for_each([&](const char* begin, const char* end) {
+      return scanner->push(begin, end);
+    });
+    fits = fits && scanner->finish();
+
+    Py_END_ALLOW_THREADS;
+    lines->exports--;
+
+    if (!fits) {
+      PyErr_SetString(PyExc_OverflowError, "schematic sum overflows int64");
+    }
+
+    return fits;
+  }
+
+  /** Scan each `str` or bytes like line of an iterable. */
+  bool iterable_scan(PyObject* lines, SchematicScanner* scanner) {
+    PyObject* iter = PyObject_GetIter(lines);
+
+    if (iter == nullptr) {
+      return false;
+    }
+
+    bool fits = true;
+
+    while (PyObject* item = PyIter_Next(iter)) {
+      TextSpan text;
+      const bool opened = text.open(item);
+
+      fits = !opened || scanner->push(text.begin(), text.end());
+      Py_DECREF(item);
+
+      if (!opened || !fits) {
+        break;
+      }
+    }
+
+    Py_DECREF(iter);
+
+    if (PyErr_Occurred()) {
+      return false;
+    } else if (!fits || !scanner->finish()) {
+      PyErr_SetString(PyExc_OverflowError, "schematic sum overflows int64");
+      return false;
+    }
+
+    return true;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* schematic_parts(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"lines", nullptr};
+  PyObject* lines = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O", const_cast<char**>(kwlist), &lines)) {
+    return nullptr;
+  }
+
+  SchematicScanner scanner;
+  const bool ok =
+      PyObject_TypeCheck(lines, Oatmeal_state(module)->mapped_input_type) != 0
+          ? mapped_scan(reinterpret_cast<MappedInput*>(lines), &scanner)
+          : iterable_scan(lines, &scanner);
+
+  if (!ok) {
+    return nullptr;
+  }
+
+  return Py_BuildValue("LL", scanner.part_sum(), scanner.ratio_sum());
+}
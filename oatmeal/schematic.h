@@ -0,0 +1,20 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * schematic_parts(
+ *  lines: MappedInput | Iterable[str | bytes],
+ * ) -> tuple[int, int]
+ *
+ * Scan an engine schematic of digits, `.` and symbols, returning the sum of
+ * every number next to a symbol, including diagonally, and the sum of gear
+ * ratios, which are the products of the two numbers next to a `*` that has
+ * exactly two neighbouring numbers.
+ *
+ * Rows are classified eight bytes at a time into digit, symbol and gear
+ * bitmaps, so only a window of three rows is kept while numbers are matched
+ * against their neighbourhood. Lines of a `MappedInput` are scanned without
+ * holding the GIL. Raises OverflowError if a sum does not fit in an int64.
+ */
+PyObject* schematic_parts(PyObject* module, PyObject* args, PyObject* kwds);
@@ -0,0 +1,295 @@
+#include "scratchcards.h"
+#include "int_array.h"
+#include "mapped_input.h"
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+  /** Largest number a card can hold. */
+  constexpr int kMaxNumber = 127;
+
+  constexpr int64_t kMaxCount = std::numeric_limits<int64_t>::max();
+
+  /** Fixed width set of the numbers 0 to 127. */
+  struct NumberSet {
+    uint64_t words[2] = {0, 0};
+
+    void set(int number) {
+      words[number >> 6] |= uint64_t{1} << (number & 63);
+    }
+
+    int count_common(const NumberSet& other) const {
+      return std::popcount(words[0] & other.words[0]) +
+             std::popcount(words[1] & other.words[1]);
+    }
+  };
+
+  /** Outcome of parsing one line. */
+  enum class CardStatus { Card, Blank, Invalid, OutOfRange };
+
+  bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  /** Parse a card line into the number of winning numbers it has. */
+  CardStatus parse_card(const char* begin, const char* end, int64_t* out) {
+    const char* c = begin;
+
+    while (c != end && is_space(*c)) {
+      c++;
+    }
+
+    if (c == end) {
+      return CardStatus::Blank;
+    }
+
+    // Skip the `Card N:` label, since cards are always listed in order.
+    while (c != end && *c != ':') {
+      c++;
+    }
+
+    if (c == end) {
+      return CardStatus::Invalid;
+    }
+
+    NumberSet sets[2];
+    int side = 0;
+    bool has_number[2] = {false, false};
+
+    for (++c; c != end; ++c) {
+      if (is_space(*c)) {
+        continue;
+      } else if (*c == '|') {
+        if (side++ != 0) {
+          return CardStatus::Invalid;
+        }
+
+        continue;
+      } else if (*c < '0' || *c > '9') {
+        return CardStatus::Invalid;
+      }
+
+      int number = 0;
+
+      for (; c != end && *c >= '0' && *c <= '9'; ++c) {
+        number = number * 10 + (*c - '0');
+
+        if (number > kMaxNumber) {
+          return CardStatus::OutOfRange;
+        }
+      }
+
+      sets[side].set(number);
+      has_number[side] = true;
+
+      if (c == end) {
+        break;
+      } else if (*c == '|') {
+        // Let the outer loop see the separator that ended this number.
+        --c;
+      } else if (!is_space(*c)) {
+        return CardStatus::Invalid;
+      }
+    }
+
+    if (side != 1 || !has_number[0]) {
+      return CardStatus::Invalid;
+    }
+
+    *out = sets[0].count_common(sets[1]);
+    return CardStatus::Card;
+  }
+
+  /** Raise the error for a line that did not parse as a card. */
+  void raise_card_error(CardStatus status, Py_ssize_t row) {
+    if (status == CardStatus::OutOfRange) {
+      PyErr_Format(
+          PyExc_ValueError,
+          "row %zd has a number larger than %d",
+          row,
+          kMaxNumber);
+    } else {
+      PyErr_Format(PyExc_ValueError, "row %zd is not a scratchcard", row);
+    }
+  }
+
+  /** Parse every line of a mapped input without the GIL. */
+  bool mapped_counts(MappedInput* lines, IntArray* counts) {
+    if (!lines->file.is_open()) {
+      PyErr_SetString(PyExc_ValueError, "I/O operation on closed input");
+      return false;
+    }
+
+    // Hold an export so the file cannot be unmapped while the GIL is released.
+    const MappedLines mapped(lines);
+    auto status = CardStatus::Card;
+    Py_ssize_t row = 0;
+    bool ok = true;
+
+    lines->exports++;
+    Py_BEGIN_ALLOW_THREADS;
+
+    ok = IntArray_reserve(counts, static_cast<Py_ssize_t>(mapped.indexed()));
+    ok = ok && mapped.for_each([&](const char* begin, const char* end) {
+      int64_t count = 0;
+      status = parse_card(begin, end, &count);
+
+      if (status == CardStatus::Card && !IntArray_push_back(counts, count)) {
+        return false;
+      }
+
+      row++;
+      return status == CardStatus::Card || status == CardStatus::Blank;
+    });
+
+    Py_END_ALLOW_THREADS;
+    lines->exports--;
+
+    if (!ok && (status == CardStatus::Card || status == CardStatus::Blank)) {
+      PyErr_NoMemory();
+    } else if (!ok) {
+      raise_card_error(status, row);
+    }
+
+    return ok;
+  }
+
+  /** Parse each `str` or bytes like line of an iterable. */
+  bool iterable_counts(PyObject* lines, IntArray* counts) {
+    PyObject* iter = PyObject_GetIter(lines);
+
+    if (iter == nullptr) {
+      return false;
+    }
+
+    Py_ssize_t row = 0;
+
+    while (PyObject* item = PyIter_Next(iter)) {
+      TextSpan text;
+      int64_t count = 0;
+      const bool opened = text.open(item);
+      const auto status = opened ? parse_card(text.begin(), text.end(), &count)
+                                 : CardStatus::Invalid;
+      Py_DECREF(item);
+
+      if (!opened) {
+        Py_DECREF(iter);
+        return false;
+      } else if (status == CardStatus::Card &&
+                 !IntArray_push_back(counts, count)) {
+        PyErr_NoMemory();
+        Py_DECREF(iter);
+        return false;
+      } else if (status != CardStatus::Card && status != CardStatus::Blank) {
+        raise_card_error(status, row);
+        Py_DECREF(iter);
+        return false;
+      }
+
+      row++;
+    }
+
+    Py_DECREF(iter);
+    return !PyErr_Occurred();
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* match_counts(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"cards", nullptr};
+  PyObject* cards = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O", const_cast<char**>(kwlist), &cards)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_state(module);
+  auto* counts = IntArray_create(st, 0);
+
+  if (counts == nullptr) {
+    return nullptr;
+  }
+
+  const bool ok =
+      PyObject_TypeCheck(cards, st->mapped_input_type) != 0
+          ? mapped_counts(reinterpret_cast<MappedInput*>(cards), counts)
+          : iterable_counts(cards, counts);
+
+  if (!ok) {
+    Py_DECREF(counts);
+    return nullptr;
+  }
+
+  return reinterpret_cast<PyObject*>(counts);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* cascade_copies(PyObject* module, PyObject* obj_matches) {
+  Int64Buffer matches;
+
+  if (!matches.open(obj_matches, "matches", false)) {
+    return nullptr;
+  }
+
+  const auto count = matches.size();
+  const auto* wins = matches.data();
+
+  for (size_t i = 0; i < count; ++i) {
+    if (wins[i] < 0) {
+      PyErr_Format(
+          PyExc_ValueError, "card %zu has a negative match count", i);
+      return nullptr;
+    }
+  }
+
+  auto* instances =
+      IntArray_create(Oatmeal_state(module), static_cast<Py_ssize_t>(count));
+
+  if (instances == nullptr) {
+    return nullptr;
+  }
+
+  // `changes[i]` is how much the running number of won copies changes at
+  // card `i`, so a card adds its instances to a whole range of later cards
+  // in two writes.
+  auto* out = instances->values;
+  std::vector<int64_t> changes(count + 1, 0);
+  int64_t copies = 0;
+  bool fits = true;
+
+  Py_BEGIN_ALLOW_THREADS;
+
+  for (size_t i = 0; fits && i < count; ++i) {
+    copies += changes[i];
+    fits = copies < kMaxCount;
+
+    if (fits) {
+      const auto total = copies + 1;
+      const auto remaining = static_cast<int64_t>(count - i - 1);
+      const auto won = wins[i] < remaining ? wins[i] : remaining;
+      const auto last = i + 1 + static_cast<size_t>(won);
+
+      out[i] = total;
+
+      if (last > i + 1) {
+        fits = changes[i + 1] <= kMaxCount - total;
+        changes[i + 1] += fits ? total : 0;
+        changes[last] -= fits ? total : 0;
+      }
+    }
+  }
+
+  Py_END_ALLOW_THREADS;
+
+  if (!fits) {
+    PyErr_SetString(PyExc_OverflowError, "card count overflows int64");
+    Py_DECREF(instances);
+    return nullptr;
+  }
+
+  return reinterpret_cast<PyObject*>(instances);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * match_counts(cards: MappedInput | Iterable[str | bytes]) -> IntArray
+ *
+ * Count the winning numbers on every `"Card N: WINNING | HAVE"` line. Both
+ * lists are read into 128 bit sets, so each count is the popcount of their
+ * intersection and a number that appears twice only matches once. Numbers
+ * must be between 0 and 127. Lines of a `MappedInput` are parsed without
+ * holding the GIL. Blank lines are skipped.
+ */
+PyObject* match_counts(PyObject* module, PyObject* args, PyObject* kwds);
+
+/**
+ * cascade_copies(matches: Buffer) -> IntArray
+ *
+ * Number of instances of each card once every card with `n` matches wins a
+ * copy of each of the next `n` cards, given the int64 match count of each
+ * card in order. Wins past the last card are dropped. The copies are spread
+ * with a difference array, so this is one prefix pass however many matches
+ * each card has. Raises OverflowError if a count does not fit in an int64.
+ */
+PyObject* cascade_copies(PyObject* module, PyObject* matches);
@@ -0,0 +1,1049 @@
+#include "search.h"
+#include "containers.h"
+#include "grid.h"
+#include "parallel.h"
+#include "point.h"
+#include "weighted_axes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace {
+  /** Cost value stored for cells that have not been reached yet. */
+  constexpr double kUnreached = std::numeric_limits<double>::infinity();
+
+  /** An entry in the search frontier. */
+  struct FrontierEntry {
+    /** Estimated total cost of a path through this cell. */
+    double priority;
+    /** Insertion order used to break priority ties first in first out. */
+    uint64_t order;
+    /** Cost from the start to the cell at the time it was queued. */
+    double cost;
+    /** Row major index of the cell. */
+    Py_ssize_t cell;
+
+    bool operator>(const FrontierEntry& other) const {
+      return priority > other.priority ||
+             (priority == other.priority && order > other.order);
+    }
+  };
+
+  /** Binary min heap of frontier entries. */
+  using Frontier = std::priority_queue<
+      FrontierEntry,
+      std::vector<FrontierEntry>,
+      std::greater<FrontierEntry>>;
+
+  /** Convert a numeric Python return value to a double, or set an error. */
+  bool number_from_pyobj(PyObject* value, const char* what, double* out) {
+    if (PyFloat_Check(value)) {
+      *out = PyFloat_AS_DOUBLE(value);
+      return true;
+    } else if (PyLong_Check(value)) {
+      *out = PyLong_AsDouble(value);
+      return !(*out == -1.0 && PyErr_Occurred());
+    } else {
+      PyErr_Format(
+          PyExc_TypeError, "`%s` return value must be of type float or int", what);
+      return false;
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------
+  // Movement costs.
+  //
+  // Each cost functor returns 1 and writes the cost when the move is allowed,
+  // 0 when the move is blocked and -1 with an exception set on error. Functors
+  // set `kCallsPython` when they need the GIL.
+  //------------------------------------------------------------------------------------------------
+  /** Every move costs one. */
+  struct UniformCost {
+    static constexpr bool kCallsPython = false;
+
+    int operator()(Py_ssize_t, Py_ssize_t, double* out) const {
+      *out = 1.0;
+      return 1;
+    }
+  };
+
+  /** Moves cost the value of the destination cell in a numeric grid. */
+  template <typename T> struct CostGridCost {
+    static constexpr bool kCallsPython = false;
+
+    const T* costs;
+
+    int operator()(Py_ssize_t, Py_ssize_t to, double* out) const {
+      if (costs[to] <= 0) {
+        return 0;
+      }
+
+      *out = static_cast<double>(costs[to]);
+      return 1;
+    }
+  };
+
+  /** Copy of the prefix sums of a `WeightedAxes` taken for one search. */
+  struct AxisPositions {
+    std::vector<int64_t> x;
+    std::vector<int64_t> y;
+  };
+
+  /** Moves cost the weight of the column or row crossed between two cells. */
+  struct WeightedAxesCost {
+    static constexpr bool kCallsPython = false;
+
+    const AxisPositions* axes;
+    Py_ssize_t x_count;
+
+    int operator()(Py_ssize_t from, Py_ssize_t to, double* out) const {
+      const auto dx = axes->x[to % x_count] - axes->x[from % x_count];
+      const auto dy = axes->y[to / x_count] - axes->y[from / x_count];
+      *out = static_cast<double>(std::abs(dx) + std::abs(dy));
+      return 1;
+    }
+  };
+
+  /** Moves are priced by calling `cost(grid, from_pt, to_pt)`. */
+  struct CallbackCost {
+    static constexpr bool kCallsPython = true;
+
+    OatmealState* st;
+    PyObject* callback;
+    PyObject* grid;
+    Py_ssize_t x_count;
+
+    int operator()(Py_ssize_t from, Py_ssize_t to, double* out) const {
+      PyObject* from_pt = Point_create(st, from % x_count, from / x_count);
+      PyObject* to_pt = Point_create(st, to % x_count, to / x_count);
+      PyObject* result = nullptr;
+
+      if (from_pt != nullptr && to_pt != nullptr) {
+        result = PyObject_CallFunctionObjArgs(callback, grid, from_pt, to_pt, nullptr);
+      }
+
+      Py_XDECREF(from_pt);
+      Py_XDECREF(to_pt);
+
+      if (result == nullptr) {
+        return -1;
+      }
+
+      // A movement cost of `None` implies the move is not allowed.
+      int status = 1;
+
+      if (result == Py_None) {
+        status = 0;
+      } else if (!number_from_pyobj(result, "cost", out)) {
+        status = -1;
+      } else if (*out <= 0) {
+        PyErr_SetString(
+            PyExc_ValueError, "`cost` return value must be larger than zero");
+        status = -1;
+      }
+
+      Py_DECREF(result);
+      return status;
+    }
+  };
+
+  //------------------------------------------------------------------------------------------------
+  // Heuristics.
+  //
+  // Each heuristic returns 0 and writes the estimated remaining cost, or -1
+  // with an exception set on error. Heuristics set `kCallsPython` the same way
+  // as cost functors.
+  //------------------------------------------------------------------------------------------------
+  /** No estimate, which turns the search into Dijkstra's algorithm. */
+  struct ZeroHeuristic {
+    static constexpr bool kCallsPython = false;
+
+    int operator()(Py_ssize_t, double* out) const {
+      *out = 0.0;
+      return 0;
+    }
+  };
+
+  /** Manhattan distance from the cell to the goal. */
+  struct ManhattanHeuristic {
+    static constexpr bool kCallsPython = false;
+
+    Py_ssize_t x_count;
+    Py_ssize_t goal;
+
+    int operator()(Py_ssize_t at, double* out) const {
+      const auto dx = std::abs(at % x_count - goal % x_count);
+      const auto dy = std::abs(at / x_count - goal / x_count);
+      *out = static_cast<double>(dx + dy);
+      return 0;
+    }
+  };
+
+  /**
+   * Manhattan distance from the cell to the goal in weighted coordinates,
+   * which is exact when a `WeightedAxesCost` prices the moves.
+   */
+  struct WeightedManhattanHeuristic {
+    static constexpr bool kCallsPython = false;
+
+    const AxisPositions* axes;
+    Py_ssize_t x_count;
+    Py_ssize_t goal;
+
+    int operator()(Py_ssize_t at, double* out) const {
+      const auto dx = axes->x[at % x_count] - axes->x[goal % x_count];
+      const auto dy = axes->y[at / x_count] - axes->y[goal / x_count];
+      *out = static_cast<double>(std::abs(dx) + std::abs(dy));
+      return 0;
+    }
+  };
+
+  /** Estimates are made by calling `heuristic(pt, goal_pt)`. */
+  struct CallbackHeuristic {
+    static constexpr bool kCallsPython = true;
+
+    OatmealState* st;
+    PyObject* callback;
+    PyObject* goal_pt;
+    Py_ssize_t x_count;
+
+    int operator()(Py_ssize_t at, double* out) const {
+      PyObject* at_pt = Point_create(st, at % x_count, at / x_count);
+
+      if (at_pt == nullptr) {
+        return -1;
+      }
+
+      PyObject* result =
+          PyObject_CallFunctionObjArgs(callback, at_pt, goal_pt, nullptr);
+      Py_DECREF(at_pt);
+
+      if (result == nullptr) {
+        return -1;
+      }
+
+      int status = 0;
+
+      if (!number_from_pyobj(result, "heuristic", out)) {
+        status = -1;
+      } else if (*out < 0) {
+        PyErr_SetString(
+            PyExc_ValueError, "`heuristic` return value must not be negative");
+        status = -1;
+      }
+
+      Py_DECREF(result);
+      return status;
+    }
+  };
+
+  //------------------------------------------------------------------------------------------------
+  // Search.
+  //------------------------------------------------------------------------------------------------
+  /**
+   * Run A* over an `x_count` by `y_count` grid, filling `parents` with the
+   * previous cell on the cheapest known path to each cell. Returns 1 if the
+   * goal was reached, 0 if not and -1 with an exception set on error.
+   */
+  template <typename CostFn, typename HeuristicFn>
+  int expand_frontier(
+      Py_ssize_t x_count,
+      Py_ssize_t y_count,
+      Py_ssize_t start,
+      Py_ssize_t goal,
+      const CostFn& cost_fn,
+      const HeuristicFn& heuristic_fn,
+      std::vector<Py_ssize_t>& parents) {
+    std::vector<double> cost_so_far(x_count * y_count, kUnreached);
+    Frontier frontier;
+    uint64_t order = 0;
+
+    parents.assign(x_count * y_count, -1);
+    cost_so_far[start] = 0.0;
+    frontier.push({0.0, order++, 0.0, start});
+
+    while (!frontier.empty()) {
+      const auto current = frontier.top();
+      frontier.pop();
+
+      // Skip stale entries that were superseded by a cheaper path after they
+      // were queued.
+      if (current.cost > cost_so_far[current.cell]) {
+        continue;
+      }
+
+      // Stop searching when we reach the goal.
+      if (current.cell == goal) {
+        return 1;
+      }
+
+      const auto x = current.cell % x_count;
+      const auto y = current.cell / x_count;
+
+      // Examine all of the cells that are adjacent to this cell.
+      for (int dir = 0; dir < 4; ++dir) {
+        const auto nx = x + kDirectionX[dir];
+        const auto ny = y + kDirectionY[dir];
+
+        if (nx < 0 || ny < 0 || nx >= x_count || ny >= y_count) {
+          continue;
+        }
+
+        const auto neighbor = ny * x_count + nx;
+        double move_cost = 0.0;
+        const int allowed = cost_fn(current.cell, neighbor, &move_cost);
+
+        if (allowed < 0) {
+          return -1;
+        } else if (allowed == 0) {
+          continue;
+        }
+
+        const auto new_cost = current.cost + move_cost;
+
+        if (new_cost < cost_so_far[neighbor]) {
+          double estimate = 0.0;
+
+          if (heuristic_fn(neighbor, &estimate) < 0) {
+            return -1;
+          }
+
+          cost_so_far[neighbor] = new_cost;
+          parents[neighbor] = current.cell;
+          frontier.push({new_cost + estimate, order++, new_cost, neighbor});
+        }
+      }
+    }
+
+    return 0;
+  }
+
+  /**
+   * Run `expand_frontier`, without the GIL unless a functor calls into
+   * Python. A cost grid is pinned by the caller, so it cannot be resized
+   * while the search reads it.
+   */
+  template <typename CostFn, typename HeuristicFn>
+  int search(
+      Py_ssize_t x_count,
+      Py_ssize_t y_count,
+      Py_ssize_t start,
+      Py_ssize_t goal,
+      const CostFn& cost_fn,
+      const HeuristicFn& heuristic_fn,
+      std::vector<Py_ssize_t>& parents) {
+    if constexpr (CostFn::kCallsPython || HeuristicFn::kCallsPython) {
+      return expand_frontier(
+          x_count, y_count, start, goal, cost_fn, heuristic_fn, parents);
+    } else {
+      int found = 0;
+
+      Py_BEGIN_ALLOW_THREADS;
+      found = expand_frontier(
+          x_count, y_count, start, goal, cost_fn, heuristic_fn, parents);
+      Py_END_ALLOW_THREADS;
+
+      return found;
+    }
+  }
+
+  /**
+   * Select the heuristic functor and run the search. A `"manhattan"` estimate
+   * is measured in the weighted coordinates of `axes` when they are given.
+   */
+  template <typename CostFn>
+  int search_with_heuristic(
+      OatmealState* st,
+      Grid* grid,
+      Py_ssize_t start,
+      Py_ssize_t goal,
+      PyObject* goal_pt,
+      const CostFn& cost_fn,
+      PyObject* heuristic,
+      std::vector<Py_ssize_t>& parents,
+      const AxisPositions* axes = nullptr) {
+    const auto x_count = grid->x_count;
+    const auto y_count = grid->y_count;
+
+    if (heuristic == Py_None) {
+      return search(
+          x_count, y_count, start, goal, cost_fn, ZeroHeuristic{}, parents);
+    } else if (PyUnicode_Check(heuristic)) {
+      if (PyUnicode_CompareWithASCIIString(heuristic, "manhattan") != 0) {
+        PyErr_Format(PyExc_ValueError, "unknown heuristic %R", heuristic);
+        return -1;
+      }
+
+      if (axes != nullptr) {
+        return search(
+            x_count,
+            y_count,
+            start,
+            goal,
+            cost_fn,
+            WeightedManhattanHeuristic{axes, x_count, goal},
+            parents);
+      }
+
+      return search(
+          x_count,
+          y_count,
+          start,
+          goal,
+          cost_fn,
+          ManhattanHeuristic{x_count, goal},
+          parents);
+    } else if (PyCallable_Check(heuristic)) {
+      return search(
+          x_count,
+          y_count,
+          start,
+          goal,
+          cost_fn,
+          CallbackHeuristic{st, heuristic, goal_pt, x_count},
+          parents);
+    } else {
+      PyErr_SetString(
+          PyExc_TypeError,
+          "argument `heuristic` must be callable, a heuristic name or None");
+      return -1;
+    }
+  }
+
+  /** Select the cost functor then the heuristic functor and run the search. */
+  int run_search(
+      OatmealState* st,
+      Grid* grid,
+      Py_ssize_t start,
+      Py_ssize_t goal,
+      PyObject* goal_pt,
+      PyObject* cost,
+      PyObject* heuristic,
+      std::vector<Py_ssize_t>& parents) {
+    if (cost == Py_None) {
+      return search_with_heuristic(
+          st, grid, start, goal, goal_pt, UniformCost{}, heuristic, parents);
+    } else if (PyObject_TypeCheck(cost, st->grid_type) != 0) {
+      auto* cost_grid = reinterpret_cast<Grid*>(cost);
+
+      if (cost_grid->x_count != grid->x_count ||
+          cost_grid->y_count != grid->y_count) {
+        PyErr_SetString(
+            PyExc_ValueError, "`cost` grid must be the same size as `grid`");
+        return -1;
+      }
+
+      switch (cost_grid->cell_type) {
+        case CellType::Int8:
+          return search_with_heuristic(
+              st,
+              grid,
+              start,
+              goal,
+              goal_pt,
+              CostGridCost<int8_t>{Grid_cells_as<int8_t>(cost_grid)},
+              heuristic,
+              parents);
+        case CellType::Int32:
+          return search_with_heuristic(
+              st,
+              grid,
+              start,
+              goal,
+              goal_pt,
+              CostGridCost<int32_t>{Grid_cells_as<int32_t>(cost_grid)},
+              heuristic,
+              parents);
+        case CellType::Int64:
+          return search_with_heuristic(
+              st,
+              grid,
+              start,
+              goal,
+              goal_pt,
+              CostGridCost<int64_t>{Grid_cells_as<int64_t>(cost_grid)},
+              heuristic,
+              parents);
+        default:
+          PyErr_SetString(
+              PyExc_TypeError, "`cost` grid must have a numeric dtype");
+          return -1;
+      }
+    } else if (PyCallable_Check(cost)) {
+      return search_with_heuristic(
+          st,
+          grid,
+          start,
+          goal,
+          goal_pt,
+          CallbackCost{
+              st, cost, reinterpret_cast<PyObject*>(grid), grid->x_count},
+          heuristic,
+          parents);
+    } else if (PyObject_TypeCheck(cost, st->weighted_axes_type) != 0) {
+      auto* weights = reinterpret_cast<WeightedAxes*>(cost);
+
+      if (static_cast<Py_ssize_t>(weights->x_positions.size()) !=
+              grid->x_count ||
+          static_cast<Py_ssize_t>(weights->y_positions.size()) !=
+              grid->y_count) {
+        PyErr_SetString(
+            PyExc_ValueError, "`cost` axes must be the same size as `grid`");
+        return -1;
+      }
+
+      // Search a copy, since the weights can be replaced by calling __init__
+      // again while the search runs without the GIL.
+      const AxisPositions axes{weights->x_positions, weights->y_positions};
+
+      return search_with_heuristic(
+          st,
+          grid,
+          start,
+          goal,
+          goal_pt,
+          WeightedAxesCost{&axes, grid->x_count},
+          heuristic,
+          parents,
+          &axes);
+    } else {
+      PyErr_SetString(
+          PyExc_TypeError,
+          "argument `cost` must be callable, a Grid, WeightedAxes or None");
+      return -1;
+    }
+  }
+
+  /** Convert and bounds check a point argument to a cell index. */
+  bool cell_index_arg(
+      OatmealState* st,
+      Grid* grid,
+      PyObject* obj_pt,
+      const char* name,
+      Py_ssize_t* out) {
+    if (PyObject_TypeCheck(obj_pt, st->point_type) == 0) {
+      PyErr_Format(
+          PyExc_TypeError, "argument `%s` must be of type `Point`", name);
+      return false;
+    }
+
+    const auto* pt = reinterpret_cast<Point*>(obj_pt);
+
+    if (pt->x < 0 || pt->y < 0 || pt->x >= grid->x_count ||
+        pt->y >= grid->y_count) {
+      PyErr_Format(PyExc_ValueError, "argument `%s` is out of bounds", name);
+      return false;
+    }
+
+    *out = pt->y * grid->x_count + pt->x;
+    return true;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* astar(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"grid", "start", "goal", "cost", "heuristic", nullptr};
+
+  PyObject* grid_obj = nullptr;
+  PyObject* start_pt = nullptr;
+  PyObject* goal_pt = nullptr;
+  PyObject* cost = Py_None;
+  PyObject* heuristic = Py_None;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "OOO|OO",
+          const_cast<char**>(kwlist),
+          &grid_obj,
+          &start_pt,
+          &goal_pt,
+          &cost,
+          &heuristic)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_state(module);
+
+  if (PyObject_TypeCheck(grid_obj, st->grid_type) == 0) {
+    PyErr_SetString(PyExc_TypeError, "argument `grid` must be of type `Grid`");
+    return nullptr;
+  }
+
+  auto* grid = reinterpret_cast<Grid*>(grid_obj);
+  Py_ssize_t start = 0;
+  Py_ssize_t goal = 0;
+
+  if (!cell_index_arg(st, grid, start_pt, "start", &start) ||
+      !cell_index_arg(st, grid, goal_pt, "goal", &goal)) {
+    return nullptr;
+  }
+
+  // A cost grid is read directly during the search, so it is pinned the same
+  // way as a buffer export to stop a heuristic callback from resizing it.
+  auto* cost_grid = PyObject_TypeCheck(cost, st->grid_type) != 0
+                        ? reinterpret_cast<Grid*>(cost)
+                        : nullptr;
+  const auto x_count = grid->x_count;
+  std::vector<Py_ssize_t> parents;
+
+  if (cost_grid != nullptr) {
+    cost_grid->exports++;
+  }
+
+  const int found =
+      run_search(st, grid, start, goal, goal_pt, cost, heuristic, parents);
+
+  if (cost_grid != nullptr) {
+    cost_grid->exports--;
+  }
+
+  if (found < 0) {
+    return nullptr;
+  } else if (found == 0) {
+    Py_RETURN_NONE;
+  }
+
+  // Walk backwards from the goal to the start to count the path length, then
+  // fill in the path list from the back.
+  Py_ssize_t length = 1;
+
+  for (auto cell = goal; cell != start; cell = parents[cell]) {
+    length++;
+  }
+
+  PyObject* path = PyList_New(length);
+
+  if (path == nullptr) {
+    return nullptr;
+  }
+
+  auto cell = goal;
+
+  for (auto i = length - 1; i >= 0; --i) {
+    PyObject* pt = Point_create(st, cell % x_count, cell / x_count);
+
+    if (pt == nullptr) {
+      Py_DECREF(path);
+      return nullptr;
+    }
+
+    PyList_SET_ITEM(path, i, pt);
+    cell = parents[cell];
+  }
+
+  return path;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Pairwise distances.
+//--------------------------------------------------------------------------------------------------
+namespace {
+  /**
+   * Read an optional sequence of `count` per row or column weights into
+   * inclusive prefix sums. Missing weights default to one.
+   */
+  bool weight_prefix_sums(
+      PyObject* weights,
+      Py_ssize_t count,
+      const char* name,
+      std::vector<int64_t>& prefix) {
+    prefix.resize(count);
+
+    if (weights == Py_None) {
+      for (Py_ssize_t i = 0; i < count; ++i) {
+        prefix[i] = i + 1;
+      }
+
+      return true;
+    }
+
+    PyObject* fast = PySequence_Fast(weights, "weights must be a sequence");
+
+    if (fast == nullptr) {
+      return false;
+    }
+
+    if (PySequence_Fast_GET_SIZE(fast) != count) {
+      PyErr_Format(
+          PyExc_ValueError, "`%s` must have one weight per %s", name,
+          name[0] == 'r' ? "row" : "column");
+      Py_DECREF(fast);
+      return false;
+    }
+
+    int64_t total = 0;
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+      const auto w = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(fast, i));
+
+      if (w == -1 && PyErr_Occurred()) {
+        Py_DECREF(fast);
+        return false;
+      } else if (w <= 0) {
+        PyErr_Format(
+            PyExc_ValueError, "`%s` must all be larger than zero", name);
+        Py_DECREF(fast);
+        return false;
+      } else if (total > std::numeric_limits<int64_t>::max() - w) {
+        PyErr_Format(PyExc_OverflowError, "`%s` total overflows int64", name);
+        Py_DECREF(fast);
+        return false;
+      }
+
+      total += w;
+      prefix[i] = total;
+    }
+
+    Py_DECREF(fast);
+    return true;
+  }
+
+  /** Entry in the frontier of an integer cost Dijkstra search. */
+  struct DistanceEntry {
+    int64_t cost;
+    Py_ssize_t cell;
+
+    bool operator>(const DistanceEntry& other) const {
+      return cost > other.cost;
+    }
+  };
+
+  /**
+   * Dense single source shortest path search over cells with integer entry
+   * costs. Scratch buffers are kept between searches so a worker thread only
+   * allocates them once.
+   */
+  class DistanceSearch {
+  public:
+    DistanceSearch(
+        const std::vector<int64_t>& costs,
+        Py_ssize_t x_count,
+        Py_ssize_t y_count,
+        bool uniform)
+        : costs_(costs),
+          x_count_(x_count),
+          y_count_(y_count),
+          uniform_(uniform),
+          distances_(costs.size()),
+          settled_(costs.size()) {}
+
+    /**
+     * Find the distance from `source` to every cell in `targets`, writing -1
+     * for unreachable targets. Stops once every target cell is settled.
+     */
+    void run(
+        Py_ssize_t source,
+        const std::vector<Py_ssize_t>& targets,
+        const Bitset& is_target,
+        size_t unique_targets,
+        int64_t* out) {
+      std::fill(distances_.begin(), distances_.end(), -1);
+      settled_.reset();
+
+      size_t remaining = unique_targets;
+      distances_[source] = 0;
+
+      auto settle = [&](Py_ssize_t cell) {
+        settled_.set(cell);
+
+        if (is_target.test(cell)) {
+          remaining--;
+        }
+      };
+
+      if (uniform_) {
+        // Every step costs the same, so a breadth first search settles cells
+        // in order without needing a heap.
+        queue_.clear();
+        queue_.push(source);
+        settle(source);
+
+        while (!queue_.empty() && remaining > 0) {
+          const auto cell = queue_.pop();
+
+          for_each_neighbor(cell, [&](Py_ssize_t neighbor) {
+            if (!settled_.test(neighbor)) {
+              distances_[neighbor] = distances_[cell] + 1;
+              settle(neighbor);
+              queue_.push(neighbor);
+            }
+          });
+        }
+      } else {
+        std::priority_queue<
+            DistanceEntry,
+            std::vector<DistanceEntry>,
+            std::greater<DistanceEntry>>
+            frontier;
+        frontier.push({0, source});
+
+        while (!frontier.empty() && remaining > 0) {
+          const auto current = frontier.top();
+          frontier.pop();
+
+          if (settled_.test(current.cell)) {
+            continue;
+          }
+
+          settle(current.cell);
+
+          for_each_neighbor(current.cell, [&](Py_ssize_t neighbor) {
+            const auto new_cost = current.cost + costs_[neighbor];
+
+            if (!settled_.test(neighbor) &&
+                (distances_[neighbor] < 0 || new_cost < distances_[neighbor])) {
+              distances_[neighbor] = new_cost;
+              frontier.push({new_cost, neighbor});
+            }
+          });
+        }
+      }
+
+      for (size_t i = 0; i < targets.size(); ++i) {
+        out[i] = settled_.test(targets[i]) ? distances_[targets[i]] : -1;
+      }
+    }
+
+  private:
+    /** Call `fn` with each in bounds passable neighbour of `cell`. */
+    template <typename Fn> void for_each_neighbor(Py_ssize_t cell, Fn&& fn) {
+      const auto x = cell % x_count_;
+      const auto y = cell / x_count_;
+
+      for (int dir = 0; dir < 4; ++dir) {
+        const auto nx = x + kDirectionX[dir];
+        const auto ny = y + kDirectionY[dir];
+
+        if (nx >= 0 && ny >= 0 && nx < x_count_ && ny < y_count_) {
+          const auto neighbor = ny * x_count_ + nx;
+
+          if (costs_[neighbor] > 0) {
+            fn(neighbor);
+          }
+        }
+      }
+    }
+
+    const std::vector<int64_t>& costs_;
+    Py_ssize_t x_count_;
+    Py_ssize_t y_count_;
+    bool uniform_;
+    std::vector<int64_t> distances_;
+    Bitset settled_;
+    RingQueue queue_;
+  };
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+PyObject* pairwise_distances(PyObject* module, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {
+      "grid",
+      "sources",
+      "cost",
+      "passable",
+      "row_weights",
+      "col_weights",
+      "threads",
+      nullptr};
+
+  PyObject* grid_obj = nullptr;
+  PyObject* sources_obj = nullptr;
+  PyObject* cost = Py_None;
+  PyObject* passable = Py_None;
+  PyObject* row_weights = Py_None;
+  PyObject* col_weights = Py_None;
+  Py_ssize_t threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "OO|OOOOn",
+          const_cast<char**>(kwlist),
+          &grid_obj,
+          &sources_obj,
+          &cost,
+          &passable,
+          &row_weights,
+          &col_weights,
+          &threads)) {
+    return nullptr;
+  }
+
+  auto* st = Oatmeal_state(module);
+
+  if (PyObject_TypeCheck(grid_obj, st->grid_type) == 0) {
+    PyErr_SetString(PyExc_TypeError, "argument `grid` must be of type `Grid`");
+    return nullptr;
+  }
+
+  auto* grid = reinterpret_cast<Grid*>(grid_obj);
+  const auto x_count = grid->x_count;
+  const auto y_count = grid->y_count;
+
+  // Convert the source points to cell indices.
+  PyObject* sources_fast =
+      PySequence_Fast(sources_obj, "argument `sources` must be a sequence");
+
+  if (sources_fast == nullptr) {
+    return nullptr;
+  }
+
+  std::vector<Py_ssize_t> sources(PySequence_Fast_GET_SIZE(sources_fast));
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    if (!cell_index_arg(
+            st, grid, PySequence_Fast_GET_ITEM(sources_fast, i), "sources",
+            &sources[i])) {
+      Py_DECREF(sources_fast);
+      return nullptr;
+    }
+  }
+
+  Py_DECREF(sources_fast);
+
+  if (sources.empty()) {
+    PyErr_SetString(PyExc_ValueError, "argument `sources` must not be empty");
+    return nullptr;
+  }
+
+  const auto k = static_cast<Py_ssize_t>(sources.size());
+  Grid* result = Grid_create(st, k, k, CellType::Int64);
+
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  auto* out = Grid_cells_as<int64_t>(result);
+
+  // A grid with no cost or passable mask, or with weighted axes as its cost,
+  // has a separable cost field. The distance between two cells is then the
+  // sum of the row and column weights crossed between them.
+  const bool weighted_axes =
+      PyObject_TypeCheck(cost, st->weighted_axes_type) != 0;
+
+  if ((cost == Py_None || weighted_axes) && passable == Py_None) {
+    std::vector<int64_t> x_prefix;
+    std::vector<int64_t> y_prefix;
+
+    if (weighted_axes) {
+      auto* weights = reinterpret_cast<WeightedAxes*>(cost);
+      x_prefix = weights->x_positions;
+      y_prefix = weights->y_positions;
+
+      if (row_weights != Py_None || col_weights != Py_None) {
+        PyErr_SetString(
+            PyExc_ValueError,
+            "row and column weights cannot be combined with weighted axes");
+        Py_DECREF(result);
+        return nullptr;
+      } else if (
+          static_cast<Py_ssize_t>(x_prefix.size()) != x_count ||
+          static_cast<Py_ssize_t>(y_prefix.size()) != y_count) {
+        PyErr_SetString(
+            PyExc_ValueError, "`cost` axes must be the same size as `grid`");
+        Py_DECREF(result);
+        return nullptr;
+      }
+    } else if (
+        !weight_prefix_sums(col_weights, x_count, "col_weights", x_prefix) ||
+        !weight_prefix_sums(row_weights, y_count, "row_weights", y_prefix)) {
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    for (Py_ssize_t j = 0; j < k; ++j) {
+      const auto xj = x_prefix[sources[j] % x_count];
+      const auto yj = y_prefix[sources[j] / x_count];
+
+      for (Py_ssize_t i = 0; i < k; ++i) {
+        const auto xi = x_prefix[sources[i] % x_count];
+        const auto yi = y_prefix[sources[i] / x_count];
+        out[j * k + i] = std::abs(xi - xj) + std::abs(yi - yj);
+      }
+    }
+
+    return reinterpret_cast<PyObject*>(result);
+  }
+
+  if (weighted_axes) {
+    PyErr_SetString(
+        PyExc_ValueError, "weighted axes cannot be combined with `passable`");
+    Py_DECREF(result);
+    return nullptr;
+  } else if (row_weights != Py_None || col_weights != Py_None) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "row and column weights cannot be combined with `cost` or `passable`");
+    Py_DECREF(result);
+    return nullptr;
+  }
+
+  // Flatten the cost grid and passable mask into a single entry cost per cell
+  // where zero marks a cell that cannot be entered.
+  std::vector<int64_t> costs(x_count * y_count, 1);
+
+  for (auto [arg, name] : {std::pair{cost, "cost"}, {passable, "passable"}}) {
+    if (arg == Py_None) {
+      continue;
+    }
+
+    auto* arg_grid = reinterpret_cast<Grid*>(arg);
+
+    if (PyObject_TypeCheck(arg, st->grid_type) == 0 ||
+        !Grid_is_integer(arg_grid)) {
+      PyErr_Format(PyExc_TypeError, "`%s` must be an integer Grid", name);
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    if (arg_grid->x_count != x_count || arg_grid->y_count != y_count) {
+      PyErr_Format(
+          PyExc_ValueError, "`%s` grid must be the same size as `grid`", name);
+      Py_DECREF(result);
+      return nullptr;
+    }
+
+    for (Py_ssize_t i = 0; i < x_count * y_count; ++i) {
+      const auto value = Grid_integer_at(arg_grid, i);
+
+      if (value <= 0) {
+        costs[i] = 0;
+      } else if (arg == cost && costs[i] != 0) {
+        costs[i] = value;
+      }
+    }
+  }
+
+  Bitset is_target(x_count * y_count);
+  size_t unique_targets = 0;
+
+  for (const auto cell : sources) {
+    if (!is_target.test(cell)) {
+      is_target.set(cell);
+      unique_targets++;
+    }
+  }
+
+  // Each source gets its own search, and the searches only touch the flattened
+  // copies above so they can run without the GIL.
+  const bool uniform = cost == Py_None;
+
+  Py_BEGIN_ALLOW_THREADS;
+  parallel_for(
+      sources.size(),
+      worker_count(threads),
+      [&]() { return DistanceSearch(costs, x_count, y_count, uniform); },
+      [&](DistanceSearch& search, size_t j) {
+        search.run(sources[j], sources, is_target, unique_targets, out + j * k);
+      });
+  Py_END_ALLOW_THREADS;
+
+  return reinterpret_cast<PyObject*>(result);
+}
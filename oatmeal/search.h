@@ -0,0 +1,60 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * astar(
+ *  grid: Grid,
+ *  start: Point,
+ *  goal: Point,
+ *  cost: Grid
+ *    | WeightedAxes
+ *    | Callable[[Grid, Point, Point], float | None]
+ *    | None = None,
+ *  heuristic: Callable[[Point, Point], float] | str | None = None
+ * ) -> list[Point] | None
+ *
+ * Returns the cheapest path from `start` to `goal` moving in the four cardinal
+ * directions, or `None` if the goal cannot be reached.
+ *
+ * `cost` is either a callable returning the cost of moving between two
+ * adjacent cells (`None` blocks the move), a numeric grid holding the cost of
+ * entering each cell (values <= 0 are impassable), or `None` for a uniform
+ * cost of one per step. It can also be `WeightedAxes` of the same size as the
+ * grid, where a move costs the weight of the column or row it crosses. Only
+ * the callable calls back into Python per edge.
+ *
+ * `heuristic` estimates the remaining cost from a cell to the goal. It may be
+ * a callable, `"manhattan"` for a built in manhattan distance, or `None` to
+ * run as Dijkstra's algorithm. With weighted axes as the cost the manhattan
+ * distance is measured in weighted coordinates.
+ */
+PyObject* astar(PyObject* module, PyObject* args, PyObject* kwds);
+
+/**
+ * pairwise_distances(
+ *  grid: Grid,
+ *  sources: Sequence[Point],
+ *  cost: Grid | WeightedAxes | None = None,
+ *  passable: Grid | None = None,
+ *  row_weights: Sequence[int] | None = None,
+ *  col_weights: Sequence[int] | None = None,
+ *  threads: int = 0
+ * ) -> Grid[int]
+ *
+ * Returns a `k x k` int64 grid holding the cheapest cost of moving between
+ * every pair of the `k` source points, with -1 for pairs that are not
+ * connected. Entry `[Point(i, j)]` is the distance from source `j` to `i`.
+ *
+ * With no `cost` or `passable` grid the cost field is separable and the
+ * distances are computed in closed form from prefix sums of `col_weights`
+ * (the cost of entering each column) and `row_weights` (the cost of entering
+ * each row), which both default to one. Weighted axes given as `cost` supply
+ * both sets of weights at once.
+ *
+ * Otherwise one search runs per source, using a cost grid holding the cost of
+ * entering each cell (<= 0 is impassable) and an optional integer mask of
+ * passable cells. Searches run on `threads` worker threads without holding
+ * the GIL, where zero picks one thread per core.
+ */
+PyObject* pairwise_distances(PyObject* module, PyObject* args, PyObject* kwds);
@@ -0,0 +1,81 @@
+#include "shared_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+//--------------------------------------------------------------------------------------------------
+bool SharedBuffer_open(PyObject* obj, Py_ssize_t item_size, SharedBuffer* out) {
+  PyObject* base = PyMemoryView_FromObject(obj);
+
+  if (base == nullptr) {
+    return false;
+  }
+
+  const auto* view = PyMemoryView_GET_BUFFER(base);
+
+  if (view->len % item_size != 0) {
+    PyErr_Format(
+        PyExc_ValueError,
+        "buffer size %zd is not a multiple of %zd",
+        view->len,
+        item_size);
+    Py_DECREF(base);
+    return false;
+  }
+
+  // Items need at most 8 byte alignment, or less when their size is smaller.
+  const auto address = reinterpret_cast<uintptr_t>(view->buf);
+  const auto align = std::min<uintptr_t>(item_size & -item_size, 8);
+
+  out->size = view->len;
+
+  if (!view->readonly && PyBuffer_IsContiguous(view, 'C') &&
+      address % align == 0) {
+    out->base = base;
+    out->data = static_cast<char*>(view->buf);
+    return true;
+  }
+
+  // Read only buffers such as the bytes of an in band pickle are copied, since
+  // the new owner is free to write to its storage.
+  out->base = nullptr;
+  out->data = static_cast<char*>(PyMem_Malloc(view->len > 0 ? view->len : 1));
+
+  if (out->data == nullptr) {
+    Py_DECREF(base);
+    PyErr_NoMemory();
+    return false;
+  }
+
+  if (PyBuffer_ToContiguous(out->data, view, view->len, 'C') < 0) {
+    PyMem_Free(out->data);
+    out->data = nullptr;
+    Py_DECREF(base);
+    return false;
+  }
+
+  Py_DECREF(base);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void SharedBuffer_free(PyObject* base, void* data) {
+  if (base != nullptr) {
+    Py_DECREF(base);
+  } else {
+    PyMem_Free(data);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* SharedBuffer_pickle(
+    PyObject* exporter,
+    const void* data,
+    Py_ssize_t size,
+    int protocol) {
+  if (protocol >= 5) {
+    return PyPickleBuffer_FromObject(exporter);
+  }
+
+  return PyBytes_FromStringAndSize(static_cast<const char*>(data), size);
+}
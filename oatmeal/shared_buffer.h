@@ -0,0 +1,37 @@
+#pragma once
+
+#include "oatmeal.h"
+
+/**
+ * Storage taken from a bytes like object by a `from_buffer` constructor. A
+ * writable, C contiguous buffer whose memory is aligned for `item_size` is
+ * shared through the memoryview held in `base`, so an out of band pickle
+ * buffer such as shared memory only hands over metadata. Any other buffer is
+ * copied into `PyMem_Malloc` storage and `base` is left null.
+ */
+struct SharedBuffer {
+  PyObject* base = nullptr;
+  char* data = nullptr;
+  Py_ssize_t size = 0;
+};
+
+/**
+ * Take the memory of `obj`. Returns false with an exception set if `obj` does
+ * not support the buffer protocol or its size is not a multiple of
+ * `item_size`.
+ */
+bool SharedBuffer_open(PyObject* obj, Py_ssize_t item_size, SharedBuffer* out);
+
+/** Free `data` if it is owned, or release the memoryview that shares it. */
+void SharedBuffer_free(PyObject* base, void* data);
+
+/**
+ * Buffer argument for pickling `size` bytes of `exporter` at `data`. This is
+ * a `PickleBuffer` of the exporter for protocol 5 and above, so the pickler
+ * may pass it out of band, or a copy of the bytes for older protocols.
+ */
+PyObject* SharedBuffer_pickle(
+    PyObject* exporter,
+    const void* data,
+    Py_ssize_t size,
+    int protocol);
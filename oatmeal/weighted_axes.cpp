@@ -0,0 +1,303 @@
+#include "weighted_axes.h"
+#include "point.h"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <utility>
+
+//--------------------------------------------------------------------------------------------------
+// WeightedAxes python type definition.
+//--------------------------------------------------------------------------------------------------
+PyMethodDef WeightedAxes_Methods[] = {
+    {"position",
+     (PyCFunction)WeightedAxes_position,
+     METH_O,
+     "Weighted coordinates of a cell"},
+    {"distance",
+     (PyCFunction)WeightedAxes_distance_method,
+     METH_VARARGS,
+     "Cost of the cheapest path between two cells"},
+    {"total_distance",
+     (PyCFunction)WeightedAxes_total_distance,
+     METH_O,
+     "Sum of the distances between every pair of points"},
+    {nullptr}};
+
+PyGetSetDef WeightedAxes_GetSet[] = {
+    {"x_count",
+     (getter)WeightedAxes_get_x_count,
+     nullptr,
+     "number of columns",
+     nullptr},
+    {"y_count",
+     (getter)WeightedAxes_get_y_count,
+     nullptr,
+     "number of rows",
+     nullptr},
+    {nullptr}};
+
+PyType_Slot WeightedAxes_Slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(WeightedAxes_dealloc)},
+    {Py_tp_hash, reinterpret_cast<void*>(PyObject_HashNotImplemented)},
+    {Py_tp_doc,
+     const_cast<char*>(PyDoc_STR(
+         "Column and row weights of a grid that is never materialized"))},
+    {Py_tp_methods, WeightedAxes_Methods},
+    {Py_tp_getset, WeightedAxes_GetSet},
+    {Py_tp_init, reinterpret_cast<void*>(WeightedAxes_init)},
+    {Py_tp_new, reinterpret_cast<void*>(WeightedAxes_new)},
+    {0, nullptr}};
+
+PyType_Spec WeightedAxes_Spec = {
+    .name = "oatmeal.WeightedAxes",
+    .basicsize = sizeof(WeightedAxes),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = WeightedAxes_Slots,
+};
+
+namespace {
+  constexpr int64_t kMaxTotal = std::numeric_limits<int64_t>::max();
+
+  /**
+   * Read a sequence of positive weights into inclusive prefix sums, raising
+   * if a weight is not positive or the total overflows.
+   */
+  bool read_positions(
+      PyObject* weights,
+      const char* name,
+      std::vector<int64_t>& out) {
+    PyObject* fast = PySequence_Fast(weights, "weights must be a sequence");
+
+    if (fast == nullptr) {
+      return false;
+    }
+
+    const auto count = PySequence_Fast_GET_SIZE(fast);
+    int64_t total = 0;
+    out.resize(count);
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+      const auto w = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(fast, i));
+
+      if (w == -1 && PyErr_Occurred()) {
+        Py_DECREF(fast);
+        return false;
+      } else if (w <= 0) {
+        PyErr_Format(
+            PyExc_ValueError, "`%s` must all be larger than zero", name);
+        Py_DECREF(fast);
+        return false;
+      } else if (total > kMaxTotal - w) {
+        PyErr_Format(PyExc_OverflowError, "`%s` total overflows int64", name);
+        Py_DECREF(fast);
+        return false;
+      }
+
+      total += w;
+      out[i] = total;
+    }
+
+    Py_DECREF(fast);
+    return true;
+  }
+
+  /** Read a `Point` argument, raising if it is outside of the axes. */
+  bool read_cell(
+      const WeightedAxes* self,
+      PyObject* obj,
+      Py_ssize_t* x,
+      Py_ssize_t* y) {
+    auto* st = Oatmeal_type_state(Py_TYPE(self));
+
+    if (PyObject_TypeCheck(obj, st->point_type) == 0) {
+      PyErr_SetString(PyExc_TypeError, "expected a value of type `Point`");
+      return false;
+    }
+
+    const auto* pt = reinterpret_cast<Point*>(obj);
+    const auto x_count = static_cast<long>(self->x_positions.size());
+    const auto y_count = static_cast<long>(self->y_positions.size());
+
+    if (pt->x < 0 || pt->y < 0 || pt->x >= x_count || pt->y >= y_count) {
+      PyErr_Format(PyExc_ValueError, "point %R is out of bounds", obj);
+      return false;
+    }
+
+    *x = pt->x;
+    *y = pt->y;
+    return true;
+  }
+
+  /**
+   * Add the distance between every pair of `positions` to `total`, sorting
+   * them in place. Returns false if the total overflows.
+   */
+  bool add_pair_distances(std::vector<int64_t>& positions, int64_t* total) {
+    std::sort(positions.begin(), positions.end());
+
+    // `to_earlier` is the summed distance from the current position back to
+    // every earlier one, which grows by the gap times the earlier count.
+    int64_t to_earlier = 0;
+
+    for (size_t i = 1; i < positions.size(); ++i) {
+      const auto gap = positions[i] - positions[i - 1];
+      const auto earlier = static_cast<int64_t>(i);
+
+      if (gap != 0 && earlier > (kMaxTotal - to_earlier) / gap) {
+        return false;
+      }
+
+      to_earlier += gap * earlier;
+
+      if (*total > kMaxTotal - to_earlier) {
+        return false;
+      }
+
+      *total += to_earlier;
+    }
+
+    return true;
+  }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+// WeightedAxes method definitions.
+//--------------------------------------------------------------------------------------------------
+PyObject* WeightedAxes_new(PyTypeObject* type, PyObject*, PyObject*) {
+  auto* self = reinterpret_cast<WeightedAxes*>(type->tp_alloc(type, 0));
+
+  if (self != nullptr) {
+    new (&self->x_positions) std::vector<int64_t>();
+    new (&self->y_positions) std::vector<int64_t>();
+  }
+
+  return reinterpret_cast<PyObject*>(self);
+}
+
+//--------------------------------------------------------------------------------------------------
+int WeightedAxes_init(WeightedAxes* self, PyObject* args, PyObject* kwds) {
+  const char* kwlist[] = {"col_weights", "row_weights", nullptr};
+  PyObject* col_weights = nullptr;
+  PyObject* row_weights = nullptr;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwds,
+          "OO",
+          const_cast<char**>(kwlist),
+          &col_weights,
+          &row_weights)) {
+    return -1;
+  }
+
+  // Read into locals so a failed init leaves the old weights intact.
+  std::vector<int64_t> x_positions;
+  std::vector<int64_t> y_positions;
+
+  if (!read_positions(col_weights, "col_weights", x_positions) ||
+      !read_positions(row_weights, "row_weights", y_positions)) {
+    return -1;
+  }
+
+  self->x_positions = std::move(x_positions);
+  self->y_positions = std::move(y_positions);
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void WeightedAxes_dealloc(PyObject* obj_self) {
+  using Positions = std::vector<int64_t>;
+  auto* self = reinterpret_cast<WeightedAxes*>(obj_self);
+
+  self->x_positions.~Positions();
+  self->y_positions.~Positions();
+  Oatmeal_free(obj_self);
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* WeightedAxes_get_x_count(WeightedAxes* self, void*) {
+  return PyLong_FromSize_t(self->x_positions.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* WeightedAxes_get_y_count(WeightedAxes* self, void*) {
+  return PyLong_FromSize_t(self->y_positions.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* WeightedAxes_position(WeightedAxes* self, PyObject* pt) {
+  Py_ssize_t x = 0;
+  Py_ssize_t y = 0;
+
+  if (!read_cell(self, pt, &x, &y)) {
+    return nullptr;
+  }
+
+  return Point_create(
+      Oatmeal_type_state(Py_TYPE(self)),
+      static_cast<long>(self->x_positions[x]),
+      static_cast<long>(self->y_positions[y]));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* WeightedAxes_distance_method(WeightedAxes* self, PyObject* args) {
+  PyObject* a = nullptr;
+  PyObject* b = nullptr;
+  Py_ssize_t ax = 0;
+  Py_ssize_t ay = 0;
+  Py_ssize_t bx = 0;
+  Py_ssize_t by = 0;
+
+  if (!PyArg_ParseTuple(args, "OO", &a, &b) ||
+      !read_cell(self, a, &ax, &ay) || !read_cell(self, b, &bx, &by)) {
+    return nullptr;
+  }
+
+  return PyLong_FromLongLong(WeightedAxes_distance(self, ax, ay, bx, by));
+}
+
+//--------------------------------------------------------------------------------------------------
+PyObject* WeightedAxes_total_distance(WeightedAxes* self, PyObject* points) {
+  PyObject* iter = PyObject_GetIter(points);
+
+  if (iter == nullptr) {
+    return nullptr;
+  }
+
+  // The two axes are independent, so the total is the sum of the pairwise
+  // gaps between the sorted x positions plus those of the y positions.
+  std::vector<int64_t> xs;
+  std::vector<int64_t> ys;
+
+  while (PyObject* item = PyIter_Next(iter)) {
+    Py_ssize_t x = 0;
+    Py_ssize_t y = 0;
+    const bool ok = read_cell(self, item, &x, &y);
+    Py_DECREF(item);
+
+    if (!ok) {
+      Py_DECREF(iter);
+      return nullptr;
+    }
+
+    xs.push_back(self->x_positions[x]);
+    ys.push_back(self->y_positions[y]);
+  }
+
+  Py_DECREF(iter);
+
+  if (PyErr_Occurred()) {
+    return nullptr;
+  }
+
+  int64_t total = 0;
+
+  if (!add_pair_distances(xs, &total) || !add_pair_distances(ys, &total)) {
+    PyErr_SetString(PyExc_OverflowError, "total distance overflows int64");
+    return nullptr;
+  }
+
+  return PyLong_FromLongLong(total);
+}
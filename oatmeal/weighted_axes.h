@@ -0,0 +1,82 @@
+#pragma once
+
+#include "oatmeal.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Column and row weights of a grid that is never materialized, such as a
+ * grid where one row stands in for a million identical rows. Moving between
+ * two neighbouring columns costs the weight of the one further right, and
+ * moving between two rows the weight of the one further down, so the cost of
+ * any shortest path is the difference of the prefix sums kept per axis.
+ *
+ * `x_positions[x]` is the total weight of columns `0` to `x`, and
+ * `y_positions[y]` the total weight of rows `0` to `y`.
+ */
+typedef struct {
+  PyObject_HEAD std::vector<int64_t> x_positions;
+  std::vector<int64_t> y_positions;
+} WeightedAxes;
+
+/** Python type spec for `WeightedAxes`. */
+extern PyType_Spec WeightedAxes_Spec;
+
+/** Cheapest cost of moving between cells `(ax, ay)` and `(bx, by)`. */
+inline int64_t WeightedAxes_distance(
+    const WeightedAxes* self,
+    Py_ssize_t ax,
+    Py_ssize_t ay,
+    Py_ssize_t bx,
+    Py_ssize_t by) {
+  const auto dx = self->x_positions[ax] - self->x_positions[bx];
+  const auto dy = self->y_positions[ay] - self->y_positions[by];
+  return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+/** __new__(type, *args, **kwds) -> WeightedAxes */
+PyObject* WeightedAxes_new(PyTypeObject* type, PyObject* args, PyObject* kwds);
+
+/**
+ * __init__(self, col_weights: Sequence[int], row_weights: Sequence[int])
+ *
+ * Weigh each column and row of an `len(col_weights)` by `len(row_weights)`
+ * grid. Every weight must be larger than zero, and the total of each axis
+ * must fit in an int64.
+ */
+int WeightedAxes_init(WeightedAxes* self, PyObject* args, PyObject* kwds);
+
+/** Destroy the prefix sums. */
+void WeightedAxes_dealloc(PyObject* self);
+
+/** x_count -> int */
+PyObject* WeightedAxes_get_x_count(WeightedAxes* self, void*);
+
+/** y_count -> int */
+PyObject* WeightedAxes_get_y_count(WeightedAxes* self, void*);
+
+/**
+ * position(self, pt: Point) -> Point
+ *
+ * Weighted coordinates of a cell, which are the total weight of the columns
+ * up to and including `pt.x` and of the rows up to and including `pt.y`.
+ */
+PyObject* WeightedAxes_position(WeightedAxes* self, PyObject* pt);
+
+/**
+ * distance(self, a: Point, b: Point) -> int
+ *
+ * Manhattan distance between two cells in weighted coordinates, which is the
+ * cost of the cheapest path between them.
+ */
+PyObject* WeightedAxes_distance_method(WeightedAxes* self, PyObject* args);
+
+/**
+ * total_distance(self, points: Iterable[Point]) -> int
+ *
+ * Sum of `distance` over every unordered pair of `points`. Each axis is
+ * sorted once, so this takes `O(n log n)` rather than visiting every pair.
+ * Raises OverflowError if the total does not fit in an int64.
+ */
+PyObject* WeightedAxes_total_distance(WeightedAxes* self, PyObject* points);
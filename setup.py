@@ -1,10 +1,41 @@
+import sys
+
 from setuptools import setup, Extension
 
-cpp_args = ["-std=c++20", "-stdlib=libc++", "-mmacosx-version-min=10.7"]
+cpp_args = ["-std=c++20"]
+
+if sys.platform == "darwin":
+    cpp_args += ["-stdlib=libc++", "-mmacosx-version-min=10.7"]
 
 oatmeal_module = Extension(
     "oatmeal",
-    sources=["oatmeal/module.cpp", "oatmeal/oatmeal.cpp", "oatmeal/point.cpp"],
+    sources=[
+        "oatmeal/bfs.cpp",
+        "oatmeal/combinations.cpp",
+        "oatmeal/direction.cpp",
+        "oatmeal/extrapolate.cpp",
+        "oatmeal/grid.cpp",
+        "oatmeal/grid_nd.cpp",
+        "oatmeal/hands.cpp",
+        "oatmeal/int_array.cpp",
+        "oatmeal/interval_map.cpp",
+        "oatmeal/mapped_input.cpp",
+        "oatmeal/module.cpp",
+        "oatmeal/network.cpp",
+        "oatmeal/oatmeal.cpp",
+        "oatmeal/parallel.cpp",
+        "oatmeal/parse.cpp",
+        "oatmeal/pipes.cpp",
+        "oatmeal/point.cpp",
+        "oatmeal/point_array.cpp",
+        "oatmeal/point_nd.cpp",
+        "oatmeal/point_table.cpp",
+        "oatmeal/schematic.cpp",
+        "oatmeal/scratchcards.cpp",
+        "oatmeal/search.cpp",
+        "oatmeal/shared_buffer.cpp",
+        "oatmeal/weighted_axes.cpp",
+    ],
     extra_compile_args=cpp_args,
 )
 
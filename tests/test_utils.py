@@ -1,8 +1,14 @@
 #!/usr/bin/env python3
 
+from concurrent.futures import ThreadPoolExecutor
 from typing import Type
+from advent.cache import SolverCache
+from benchmarks.suite import BenchResult, find_regressions, repeat_cards
+from advent.runner import longest_first, solve_day
 from advent.solver import AdventDaySolver
 from advent.utils import (
+    CARDINAL,
+    DIAGONAL,
     Direction,
     Grid,
     load_input,
@@ -15,11 +21,54 @@ from advent.utils import (
     combinations,
     PriorityQueue,
     astar_search,
+    bfs_distances,
+    cascade_copies,
+    classify_hand,
+    combination_indices,
+    extrapolate_rows,
+    flood_fill,
+    hand_winnings,
+    label_components,
     manhattan_distance,
+    match_counts,
+    pairwise_distances,
+    parse_int_rows,
+    parse_ints,
+    pipe_loop,
+    schematic_parts,
+)
+from oatmeal import (
+    FrozenPoint,
+    Grid3,
+    Grid4,
+    IntArray,
+    IntervalMap,
+    MappedInput,
+    Network,
+    Point,
+    Point2i32,
+    Point2i64,
+    Point3i32,
+    Point3i64,
+    Point4i32,
+    Point4i64,
+    PointArray,
+    PointArray3i32,
+    PointArray3i64,
+    PointMap,
+    PointSet,
+    WeightedAxes,
 )
-from oatmeal import Point
 
 import copy
+import importlib.util
+import itertools
+import oatmeal
+import os
+import pickle
+import random
+import re
+import tempfile
 import typing
 import unittest
 
@@ -72,6 +121,62 @@ class AdventDaySolverTests(unittest.TestCase):
         )
         self.assertEqual("hello", d.secret_token())
 
+    def test_longest_first(self):
+        day1 = AdventDaySolver.get_solver(day=1, year=2023)
+        day2 = AdventDaySolver.get_solver(day=2, year=2023)
+        day4 = AdventDaySolver.get_solver(day=4, year=2023)
+
+        # Days without a timing are assumed to be the slowest.
+        times = {(2023, 1): 5.0, (2023, 4): 9.0}
+        self.assertEqual([day2, day4, day1], longest_first([day1, day2, day4], times))
+
+    def test_solve_day_reports_errors(self):
+        result = solve_day(day=2, year=2022)
+        self.assertIsNone(result.solution)
+        self.assertIn("Traceback", result.error)
+
+    def test_phase_timings(self):
+        class Timed(AdventDaySolver, year=0, day=0, name="", solution=None):
+            def __init__(self, input):
+                super().__init__(input)
+                self.values = [int(x) for x in input]
+
+            def solve_1(self):
+                return sum(self.values)
+
+            def solve(self):
+                with self.timed("extra"):
+                    pass
+                return (self.solve_1(), None)
+
+        class TimedOverride(Timed, year=0, day=0, name="", solution=None):
+            def solve(self):
+                return super().solve()
+
+        d = TimedOverride(["1", "2"])
+        self.assertEqual((3, None), d.solve())
+        self.assertEqual({"parse", "solve", "extra", "part_1"}, d.timings.keys())
+        self.assertTrue(all(t >= 0 for t in d.timings.values()))
+
+        # Nested overrides only count the outermost call.
+        self.assertLessEqual(d.timings["part_1"], d.timings["solve"])
+
+    def test_alloc_stats(self):
+        oatmeal.reset_alloc_stats()
+        points = [Point(i, i) for i in range(4)]
+        del points
+        Point(1, 1)
+        FrozenPoint(2, 2)
+        FrozenPoint(2, 2)
+
+        stats = oatmeal.alloc_stats()
+        self.assertEqual(5, stats["points_created"])
+        self.assertEqual(1, stats["point_free_list_hits"])
+        self.assertGreaterEqual(stats["frozen_point_intern_hits"], 1)
+
+        oatmeal.reset_alloc_stats()
+        self.assertEqual(0, oatmeal.alloc_stats()["points_created"])
+
 
 class TestDirection(unittest.TestCase):
     def test_get_cardinal_directions(self):
@@ -92,6 +197,18 @@ class TestDirection(unittest.TestCase):
         self.assertEqual(Point(-1, 0), Direction.West.to_point())
         self.assertEqual(Point(0, 1), Direction.South.to_point())
 
+    def test_to_point_is_shared_constant(self):
+        self.assertIs(Point.EAST, Direction.East.to_point())
+        self.assertIs(Point.SOUTH, Direction.South.to_point())
+
+        with self.assertRaises(AttributeError):
+            Direction.North.to_point().x = 5
+
+        with self.assertRaises(TypeError):
+            Direction.North.to_point()[1] = 5
+
+        self.assertEqual(Point(0, -1), Point.NORTH)
+
     def test_reverse(self):
         self.assertEqual(Direction.West, Direction.East.reverse())
         self.assertEqual(Direction.South, Direction.North.reverse())
@@ -110,6 +227,45 @@ class TestDirection(unittest.TestCase):
         with self.assertRaises(NotImplementedError):
             Direction.from_point((1, 1))
 
+    def test_diagonals(self):
+        self.assertSequenceEqual(
+            [
+                Direction.NorthEast,
+                Direction.NorthWest,
+                Direction.SouthWest,
+                Direction.SouthEast,
+            ],
+            Direction.diagonal_dirs(),
+        )
+        self.assertIs(Point.NORTH_EAST, Direction.NorthEast.to_point())
+        self.assertEqual(Point(-1, 1), Direction.SouthWest.to_point())
+        self.assertIs(Direction.SouthWest, Direction.NorthEast.reverse())
+        self.assertIs(Direction.NorthWest, Direction.SouthEast.reverse())
+        self.assertTrue(Direction.SouthEast.is_diagonal())
+        self.assertFalse(Direction.South.is_diagonal())
+
+        self.assertIs(
+            Direction.SouthEast, Direction.from_point(Point(1, 1), diagonals=True)
+        )
+        with self.assertRaises(ValueError):
+            Direction.from_point(Point(2, 0), diagonals=True)
+
+    def test_is_int(self):
+        self.assertEqual(2, Direction.West)
+        self.assertEqual(8, 1 << Direction.South)
+        self.assertIs(Direction.North, Direction(1))
+        self.assertEqual("North", Direction.North.name)
+        self.assertEqual(1, Direction.North.value)
+        self.assertEqual("<Direction.West: 2>", repr(Direction.West))
+
+        with self.assertRaises(ValueError):
+            Direction(8)
+
+    def test_pickle(self):
+        for dir in Direction.cardinal_dirs() + Direction.diagonal_dirs():
+            self.assertIs(dir, pickle.loads(pickle.dumps(dir)))
+            self.assertIs(dir, copy.deepcopy(dir))
+
 
 class TestPoint(unittest.TestCase):
     def test_new_points(self):
@@ -185,6 +341,17 @@ class TestPoint(unittest.TestCase):
         self.assertEqual(Point(4, -123), -Point(-4, 123))
         self.assertEqual(Point(4, 123), abs(Point(-4, 123)))
 
+    def test_math_ops_return_new_points(self):
+        # Results recycled from the free list must never alias live points.
+        a = Point(1, 2)
+        results = [a + Point(i, i) for i in range(1000)]
+
+        for i, p in enumerate(results):
+            self.assertEqual(Point(1 + i, 2 + i), p)
+
+        self.assertEqual(len(results), len(set(id(p) for p in results)))
+        self.assertEqual(Point(1, 2), a)
+
     def test_hash(self):
         points = dict()
         points[Point(3, -15)] = "hello"
@@ -197,6 +364,346 @@ class TestPoint(unittest.TestCase):
         self.assertNotIn(Point(3, 15), points)
         self.assertNotIn(Point(16, 7), points)
 
+    def test_hash_spreads_small_coordinates(self):
+        # Neighbouring points such as (0, 1) and (2, 0) used to share a hash.
+        hashes = {hash(Point(x, y)) for x in range(-32, 32) for y in range(-32, 32)}
+        self.assertEqual(64 * 64, len(hashes))
+
+    def test_constructor_arguments(self):
+        self.assertEqual(Point(0, 0), Point())
+        self.assertEqual(Point(3, 0), Point(3))
+        self.assertEqual(Point(3, 4), Point(y=4, x=3))
+        self.assertEqual(Point(3, 4), Point(3, y=4))
+
+        with self.assertRaises(TypeError):
+            Point(1, 2, 3)
+
+        with self.assertRaises(TypeError):
+            Point(1, x=2)
+
+        with self.assertRaises(TypeError):
+            Point(z=2)
+
+        with self.assertRaises(TypeError):
+            Point(1.5, 2)
+
+    def test_set_components(self):
+        p = Point(1, 2)
+        p.x = 5
+        p[1] = 6
+        self.assertEqual(Point(5, 6), p)
+
+        with self.assertRaises(TypeError):
+            p.y = "a"
+
+    def test_pickle(self):
+        p = pickle.loads(pickle.dumps(Point(3, -4)))
+        self.assertIs(Point, type(p))
+        self.assertEqual(Point(3, -4), p)
+
+    def test_unpickle_dict_state(self):
+        p = Point.__new__(Point)
+        p.__setstate__({"x": 1, "y": 2})
+        self.assertEqual(Point(1, 2), p)
+
+        with self.assertRaises(ValueError):
+            p.__setstate__((1, 2))
+
+
+class TestFrozenPoint(unittest.TestCase):
+    def tearDown(self):
+        FrozenPoint.set_intern_window(-64, 256)
+
+    def test_interned_inside_window(self):
+        self.assertIs(FrozenPoint(3, 4), FrozenPoint(y=4, x=3))
+        self.assertIs(Point.EAST, FrozenPoint(1, 0))
+        self.assertIsNot(FrozenPoint(-500, 0), FrozenPoint(-500, 0))
+        self.assertEqual(FrozenPoint(-500, 0), FrozenPoint(-500, 0))
+
+    def test_behaves_like_point(self):
+        f = FrozenPoint(3, 4)
+        self.assertIsInstance(f, Point)
+        self.assertEqual(Point(3, 4), f)
+        self.assertEqual(hash(Point(3, 4)), hash(f))
+        self.assertIn(Point(3, 4), {f})
+        self.assertEqual("FrozenPoint(x=3, y=4)", repr(f))
+
+    def test_operators_follow_left_operand(self):
+        f = FrozenPoint(3, 4)
+        self.assertIs(FrozenPoint(4, 4), f + Point.EAST)
+        self.assertIs(FrozenPoint(-3, -4), -f)
+        self.assertIs(type(Point(3, 4) + Point.EAST), Point)
+        self.assertIs(type(f.clone()), Point)
+
+    def test_immutable(self):
+        f = FrozenPoint(3, 4)
+
+        with self.assertRaises(AttributeError):
+            f.x = 1
+
+        with self.assertRaises(TypeError):
+            f[0] = 1
+
+        self.assertEqual(FrozenPoint(3, 4), f)
+
+    def test_pickle_round_trips_through_intern_table(self):
+        f = FrozenPoint(3, 4)
+        self.assertIs(f, pickle.loads(pickle.dumps(f)))
+
+    def test_intern_window(self):
+        FrozenPoint.set_intern_window(-2, 2)
+        self.assertEqual((-2, 2), FrozenPoint.intern_window())
+        self.assertIs(FrozenPoint(2, -2), FrozenPoint(2, -2))
+        self.assertIsNot(FrozenPoint(3, 0), FrozenPoint(3, 0))
+
+        with self.assertRaises(ValueError):
+            FrozenPoint.set_intern_window(2, -2)
+
+
+class TestPointArray(unittest.TestCase):
+    def test_build_and_index(self):
+        a = PointArray([Point(1, 2), Point(-3, 4)])
+        a.append(Point(5, 6))
+        self.assertEqual(3, len(a))
+        self.assertEqual(Point(-3, 4), a[1])
+        self.assertEqual(Point(5, 6), a[-1])
+        self.assertEqual([Point(1, 2), Point(-3, 4), Point(5, 6)], list(a))
+
+        a[0] = Point(7, 8)
+        self.assertEqual(Point(7, 8), a[0])
+        self.assertEqual(0, len(PointArray()))
+
+    def test_arithmetic(self):
+        a = PointArray([Point(1, -2), Point(-7, 9)])
+        self.assertEqual(PointArray([Point(2, 0), Point(-6, 11)]), a + Point(1, 2))
+        self.assertEqual(PointArray([Point(0, -4), Point(-8, 7)]), a - Point(1, 2))
+        self.assertEqual(PointArray([Point(2, -4), Point(-14, 18)]), a + a)
+        self.assertEqual(PointArray([Point(0, 0), Point(0, 0)]), a - a)
+        self.assertEqual(PointArray([Point(3, -6), Point(-21, 27)]), 3 * a)
+        self.assertEqual(PointArray([Point(3, -6), Point(-21, 27)]), a * 3)
+        self.assertEqual(PointArray([Point(-1, 2), Point(7, -9)]), -a)
+        self.assertEqual(PointArray([Point(1, 2), Point(7, 9)]), abs(a))
+
+    def test_floor_div_and_mod_match_python(self):
+        values = [Point(7, -7), Point(-1, 1), Point(0, 6)]
+        a = PointArray(values)
+        for d in (3, -3):
+            self.assertEqual([Point(p.x // d, p.y // d) for p in values], list(a // d))
+            self.assertEqual([Point(p.x % d, p.y % d) for p in values], list(a % d))
+
+        with self.assertRaises(ZeroDivisionError):
+            a // 0
+
+    def test_divide_smallest_long_by_minus_one(self):
+        a = PointArray([Point(-(2**63), 7)])
+        self.assertEqual([Point(0, 0)], list(a % -1))
+        self.assertEqual([Point(-3, 0)], list(PointArray([Point(3, 0)]) // -1))
+
+        with self.assertRaises(OverflowError):
+            a // -1
+
+    def test_manhattan_distance(self):
+        a = PointArray([Point(0, 0), Point(3, -4)])
+        self.assertEqual([3, 8], a.manhattan_distance(Point(1, 2)))
+        self.assertEqual([0, 14], a.manhattan_distance(-a))
+        self.assertIsInstance(PointArray().manhattan_distance(Point()), IntArray)
+        self.assertEqual(0, len(PointArray().manhattan_distance(Point())))
+
+        far = PointArray([Point(-(2**62), 2**62)])
+        self.assertEqual([2**63 - 1], far.manhattan_distance(Point(2**62 - 1, 2**62)))
+
+        with self.assertRaises(OverflowError):
+            far.manhattan_distance(Point(2**62, 0))
+
+    def test_bounding_box_sort_unique(self):
+        a = PointArray([Point(3, 1), Point(-2, 1), Point(0, -5), Point(3, 1)])
+        self.assertEqual((Point(-2, -5), Point(3, 1)), a.bounding_box())
+        self.assertEqual(
+            PointArray([Point(0, -5), Point(-2, 1), Point(3, 1)]), a.unique()
+        )
+
+        a.sort()
+        self.assertEqual(
+            [Point(0, -5), Point(-2, 1), Point(3, 1), Point(3, 1)], list(a)
+        )
+
+    def test_bad_args(self):
+        a = PointArray([Point(0, 0)])
+
+        with self.assertRaises(TypeError):
+            PointArray([(0, 0)])
+
+        with self.assertRaises(IndexError):
+            a[1]
+
+        with self.assertRaises(TypeError):
+            a[0] = 1
+
+        with self.assertRaises(ValueError):
+            a + PointArray([Point(0, 0), Point(1, 1)])
+
+        with self.assertRaises(TypeError):
+            a * a
+
+        with self.assertRaises(TypeError):
+            a + 1
+
+        with self.assertRaises(ValueError):
+            PointArray().bounding_box()
+
+    def test_buffer_protocol(self):
+        a = PointArray([Point(1, 2), Point(3, 4), Point(5, 6)])
+        m = memoryview(a)
+        self.assertEqual((2, 3), m.shape)
+        self.assertEqual([[1, 3, 5], [2, 4, 6]], m.tolist())
+
+        m[1, 0] = 20
+        self.assertEqual(Point(1, 20), a[0])
+
+        with self.assertRaises(BufferError):
+            a.append(Point(7, 8))
+
+        m.release()
+        a.append(Point(7, 8))
+        self.assertEqual(4, len(a))
+
+    def test_from_buffer(self):
+        a = PointArray([Point(1, 2), Point(3, 4)])
+        self.assertEqual(a, PointArray.from_buffer(bytes(memoryview(a))))
+        self.assertEqual(PointArray(), PointArray.from_buffer(b""))
+
+        with self.assertRaises(ValueError):
+            PointArray.from_buffer(b"abc")
+        with self.assertRaises(TypeError):
+            PointArray.from_buffer([1, 2])
+
+    def test_pickle(self):
+        a = PointArray([Point(1, 2), Point(-3, 4), Point(5, 6)])
+
+        for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+            self.assertEqual(a, pickle.loads(pickle.dumps(a, protocol)))
+
+        self.assertEqual(PointArray(), pickle.loads(pickle.dumps(PointArray())))
+
+    def test_pickle_out_of_band(self):
+        a = PointArray([Point(1, 2), Point(3, 4)])
+        buffers = []
+        data = pickle.dumps(a, protocol=5, buffer_callback=buffers.append)
+
+        # The unpickled array shares the writable buffer it was handed.
+        shared = bytearray(buffers[0].raw())
+        b = pickle.loads(data, buffers=[shared])
+        self.assertEqual(a, b)
+
+        b[0] = Point(9, 9)
+        self.assertEqual(Point(9, 9), PointArray.from_buffer(bytes(shared))[0])
+
+
+class TestPointSet(unittest.TestCase):
+    def test_add_discard_contains(self):
+        s = PointSet([Point(1, 2), Point(1, 2), Point(-3, 0)])
+        self.assertEqual(2, len(s))
+        self.assertIn(Point(1, 2), s)
+        self.assertNotIn(Point(2, 1), s)
+        self.assertNotIn((1, 2), s)
+
+        s.add(Point(2, 1))
+        s.discard(Point(1, 2))
+        s.discard(Point(9, 9))
+        self.assertEqual({Point(2, 1), Point(-3, 0)}, set(s))
+
+        with self.assertRaises(KeyError):
+            s.remove(Point(1, 2))
+
+        s.clear()
+        self.assertEqual(0, len(s))
+
+    def test_many_points_survive_growth_and_removal(self):
+        points = [Point(x, y) for x in range(-40, 40) for y in range(-40, 40)]
+        s = PointSet(points)
+        self.assertEqual(len(points), len(s))
+
+        for pt in points[::2]:
+            s.remove(pt)
+
+        self.assertEqual(set(points[1::2]), set(s))
+        for pt in points[::2]:
+            self.assertNotIn(pt, s)
+
+    def test_bad_args(self):
+        with self.assertRaises(TypeError):
+            PointSet([(0, 0)])
+
+        with self.assertRaises(TypeError):
+            PointSet().add(1)
+
+        s = PointSet([Point(0, 0)])
+        with self.assertRaises(RuntimeError):
+            for pt in s:
+                s.add(Point(1, 1))
+
+
+class TestPointMap(unittest.TestCase):
+    def test_object_values(self):
+        m = PointMap()
+        self.assertEqual("object", m.dtype)
+        m[Point(1, 2)] = "a"
+        m[Point(3, 4)] = ["b"]
+        m[Point(1, 2)] = "c"
+
+        self.assertEqual(2, len(m))
+        self.assertEqual("c", m[Point(1, 2)])
+        self.assertEqual(["b"], m.get(Point(3, 4)))
+        self.assertEqual(None, m.get(Point(5, 5)))
+        self.assertEqual(0, m.get(Point(5, 5), 0))
+        self.assertIn(Point(3, 4), m)
+        self.assertEqual({Point(1, 2), Point(3, 4)}, set(m))
+        self.assertEqual({Point(1, 2): "c", Point(3, 4): ["b"]}, dict(m.items()))
+
+        del m[Point(1, 2)]
+        self.assertEqual([["b"]], list(m.values()))
+
+        with self.assertRaises(KeyError):
+            m[Point(1, 2)]
+
+        with self.assertRaises(KeyError):
+            del m[Point(1, 2)]
+
+    def test_delete_releases_value_after_erasing(self):
+        m = PointMap()
+        seen = []
+
+        class Watcher:
+            def __del__(self):
+                seen.append((Point(0, 0) in m, len(m), m.get(Point(1, 1))))
+
+        m[Point(0, 0)] = Watcher()
+        m[Point(1, 1)] = "kept"
+        del m[Point(0, 0)]
+        self.assertEqual([(False, 1, "kept")], seen)
+
+    def test_inline_int_values(self):
+        m = PointMap(dtype="int64")
+        for x in range(100):
+            m[Point(x, -x)] = x * x
+
+        self.assertEqual(100, len(m))
+        self.assertEqual(81, m[Point(9, -9)])
+        self.assertEqual(sum(x * x for x in range(100)), sum(m.values()))
+
+        with self.assertRaises(TypeError):
+            m[Point(200, 0)] = "x"
+
+        self.assertNotIn(Point(200, 0), m)
+        self.assertEqual(100, len(m))
+
+    def test_bad_args(self):
+        with self.assertRaises(ValueError):
+            PointMap(dtype="float")
+
+        with self.assertRaises(TypeError):
+            PointMap()[(0, 0)] = 1
+
 
 class TestGrid(unittest.TestCase):
     def test_create_grid_from_default_value(self):
@@ -359,6 +866,398 @@ class TestGrid(unittest.TestCase):
         self.assertEqual(3, g.row_count())
         self.assertEqual(3, g.col_count())
 
+    def test_insert_from_callable_and_value(self):
+        g = Grid(2, 2, 0, dtype="int32")
+        g.insert_row(1, 7)
+        g.insert_col(0, lambda: -1)
+        self.assertSequenceEqual([-1, 0, 0, -1, 7, 7, -1, 0, 0], g.cells)
+
+    def test_default_value_is_deep_copied(self):
+        g = Grid(2, 1, {})
+        g[Point(0, 0)]["a"] = 1
+        self.assertSequenceEqual([{"a": 1}, {}], g.cells)
+
+    def test_typed_cells(self):
+        for dtype in ["int8", "int32", "int64"]:
+            g = Grid(3, 2, dtype=dtype)
+            self.assertEqual(dtype, g.dtype)
+            self.assertSequenceEqual([0, 0, 0, 0, 0, 0], g.cells)
+
+            g[Point(2, 1)] = -100
+            self.assertEqual(-100, g[Point(2, 1)])
+
+            with self.assertRaises(TypeError):
+                g[Point(0, 0)] = "x"
+
+        with self.assertRaises(OverflowError):
+            Grid(1, 1, dtype="int8")[Point(0, 0)] = 128
+
+        with self.assertRaises(ValueError):
+            Grid(1, 1, dtype="float")
+
+    def test_char_cells(self):
+        g = Grid(3, 1, ".", dtype="char")
+        g[Point(1, 0)] = "#"
+        self.assertEqual(".#.", str(g))
+
+        with self.assertRaises(TypeError):
+            g[Point(0, 0)] = "ab"
+
+    def test_from_lines(self):
+        g = Grid.from_lines(["ab", "cd", "ef"])
+        self.assertEqual("char", g.dtype)
+        self.assertEqual(2, g.col_count())
+        self.assertEqual(3, g.row_count())
+        self.assertEqual("d", g[Point(1, 1)])
+        self.assertEqual("ab\ncd\nef", str(g))
+
+        with self.assertRaises(ValueError):
+            Grid.from_lines(["ab", "c"])
+
+    def test_buffer_protocol(self):
+        g = Grid(3, 2, [[1, 2, 3], [4, 5, 6]], dtype="int32")
+        m = memoryview(g)
+        self.assertEqual((2, 3), m.shape)
+        self.assertEqual((12, 4), m.strides)
+        self.assertEqual("i", m.format)
+        self.assertEqual([[1, 2, 3], [4, 5, 6]], m.tolist())
+
+        # Writes through the buffer are visible in the grid without a copy.
+        m[1, 2] = -6
+        self.assertEqual(-6, g[Point(2, 1)])
+
+        with self.assertRaises(BufferError):
+            g.insert_row(0, 0)
+
+        m.release()
+        g.insert_row(0, 0)
+        self.assertEqual(3, g.row_count())
+
+    def test_row_and_col_views(self):
+        g = Grid(3, 2, [[1, 2, 3], [4, 5, 6]], dtype="int64")
+        row = g.row_view(1)
+        col = g.col_view(2)
+
+        self.assertEqual([4, 5, 6], row.tolist())
+        self.assertEqual([3, 6], col.tolist())
+        self.assertEqual((24,), col.strides)
+        self.assertFalse(col.contiguous)
+
+        col[0] = 30
+        self.assertEqual(30, g[Point(2, 0)])
+
+        with self.assertRaises(BufferError):
+            g.insert_col(0, 0)
+
+        del row, col
+        g.insert_col(0, 0)
+
+    def test_object_grid_has_no_buffer(self):
+        with self.assertRaises(BufferError):
+            memoryview(Grid(1, 1, None))
+
+        with self.assertRaises(BufferError):
+            Grid(1, 1, None).row_view(0)
+
+    def test_from_buffer(self):
+        g = Grid.from_buffer(bytes([1, 2, 3, 4, 5, 6]), 3, "int8")
+        self.assertEqual((3, 2), (g.x_count, g.y_count))
+        self.assertEqual([1, 2, 3, 4, 5, 6], g.cells)
+
+        # Writable buffers are shared rather than copied.
+        cells = bytearray(b"abcd")
+        g = Grid.from_buffer(cells, 2, "char")
+        g[Point(0, 1)] = "z"
+        self.assertEqual(b"abzd", cells)
+
+        with self.assertRaises(ValueError):
+            Grid.from_buffer(b"abc", 2, "char")
+        with self.assertRaises(ValueError):
+            Grid.from_buffer(b"", 2, "char")
+        with self.assertRaises(ValueError):
+            Grid.from_buffer(b"ab", 1, "object")
+        with self.assertRaises(ValueError):
+            Grid.from_buffer(b"ab", 1, "float")
+
+    def test_pickle(self):
+        grids = [
+            Grid(3, 2, [[1, 2, 3], [4, 5, 6]], dtype="int64"),
+            Grid(2, 2, [[-1, 2], [3, -4]], dtype="int8"),
+            Grid.from_lines(["ab", "cd"]),
+            Grid(2, 1, [["a", (1, 2)]]),
+        ]
+
+        for g in grids:
+            for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+                h = pickle.loads(pickle.dumps(g, protocol))
+                self.assertEqual(g.dtype, h.dtype)
+                self.assertEqual((g.x_count, g.y_count), (h.x_count, h.y_count))
+                self.assertEqual(g.cells, h.cells)
+
+    def test_pickle_out_of_band(self):
+        g = Grid(1000, 10, 7, dtype="int32")
+        buffers = []
+        data = pickle.dumps(g, protocol=5, buffer_callback=buffers.append)
+
+        # Only metadata is pickled, and the cells live in the shared buffer.
+        self.assertLess(len(data), 200)
+        shared = bytearray(buffers[0].raw())
+        h = pickle.loads(data, buffers=[shared])
+        h[Point(0, 0)] = 9
+
+        self.assertEqual(9, memoryview(shared).cast("i")[0])
+        self.assertEqual(7, g[Point(0, 0)])
+
+        h.insert_row(0, 1)
+        self.assertEqual(9, h[Point(0, 1)])
+
+    def test_out_of_bounds(self):
+        g = Grid(2, 3, 0)
+
+        with self.assertRaises(IndexError):
+            g[Point(2, 0)]
+
+        with self.assertRaises(IndexError):
+            g[Point(0, -1)] = 1
+
+    def test_neighbors(self):
+        g = Grid(3, 2, 0)
+
+        self.assertEqual(
+            [(Direction.East, Point(1, 0)), (Direction.South, Point(0, 1))],
+            list(g.neighbors(Point(0, 0))),
+        )
+        self.assertEqual(
+            [
+                (Direction.East, Point(2, 1)),
+                (Direction.North, Point(1, 0)),
+                (Direction.West, Point(0, 1)),
+            ],
+            list(g.neighbors(Point(1, 1))),
+        )
+        self.assertEqual(
+            [(Direction.NorthEast, Point(2, 0)), (Direction.NorthWest, Point(0, 0))],
+            list(g.neighbors(Point(1, 1), DIAGONAL)),
+        )
+        self.assertEqual(5, len(list(g.neighbors(Point(1, 1), CARDINAL | DIAGONAL))))
+
+        for dir, pt in g.neighbors(Point(2, 1), dirs=CARDINAL | DIAGONAL):
+            self.assertEqual(Point(2, 1) + dir.to_point(), pt)
+
+    def test_neighbors_errors(self):
+        g = Grid(3, 2, 0)
+
+        with self.assertRaises(IndexError):
+            g.neighbors(Point(3, 0))
+        with self.assertRaises(TypeError):
+            g.neighbors((0, 0))
+        with self.assertRaises(ValueError):
+            g.neighbors(Point(0, 0), 0)
+        with self.assertRaises(ValueError):
+            g.neighbors(Point(0, 0), 4)
+
+
+class TestPointND(unittest.TestCase):
+    def test_construct_and_index(self):
+        p = Point3i32(1, -2, z=3)
+        self.assertEqual((1, -2, 3), (p.x, p.y, p.z))
+        self.assertEqual([1, -2, 3], [p[0], p[1], p[-1]])
+        self.assertEqual(3, len(p))
+        self.assertEqual(Point4i64(0, 0, 0, 0), Point4i64())
+        self.assertEqual("Point3i32(x=1, y=-2, z=3)", repr(p))
+
+        p.y = 7
+        p[2] = -1
+        self.assertEqual(Point3i32(1, 7, -1), p)
+
+        with self.assertRaises(IndexError):
+            p[3]
+        with self.assertRaises(AttributeError):
+            Point2i32().z
+        with self.assertRaises(TypeError):
+            Point3i32(1, x=2)
+        with self.assertRaises(TypeError):
+            Point3i32(1.5)
+
+    def test_arithmetic_matches_python(self):
+        for cls in (Point2i32, Point2i64, Point3i32, Point3i64, Point4i32):
+            a = cls(*range(7, 7 - 3 * len(cls()), -3))
+            b = cls(*range(-1, len(a) - 1))
+            va, vb = [a[i] for i in range(len(a))], [b[i] for i in range(len(b))]
+
+            self.assertEqual(cls(*[x + y for x, y in zip(va, vb)]), a + b)
+            self.assertEqual(cls(*[x - y for x, y in zip(va, vb)]), a - b)
+            self.assertEqual(cls(*[x * 3 for x in va]), a * 3)
+            self.assertEqual(cls(*[x * 3 for x in va]), 3 * a)
+            self.assertEqual(cls(*[-x for x in va]), -a)
+            self.assertEqual(cls(*[abs(x) for x in va]), abs(a))
+
+            for d in (2, -3):
+                self.assertEqual(cls(*[x // d for x in va]), a // d)
+                self.assertEqual(cls(*[x % d for x in va]), a % d)
+
+            with self.assertRaises(ZeroDivisionError):
+                a // 0
+
+    def test_overflow(self):
+        with self.assertRaises(OverflowError):
+            Point2i32(2**31, 0)
+        with self.assertRaises(OverflowError):
+            Point2i32(2**31 - 1, 0) + Point2i32(1, 0)
+        with self.assertRaises(OverflowError):
+            Point2i64(2**62, 0) * 2
+        with self.assertRaises(OverflowError):
+            -Point2i64(-(2**63), 0)
+        with self.assertRaises(OverflowError):
+            abs(Point2i64(-(2**63), 0))
+        with self.assertRaises(OverflowError):
+            Point2i64(-(2**63), 0) // -1
+        self.assertEqual(Point2i64(0, 0), Point2i64(-(2**63), 0) % -1)
+        self.assertEqual(Point2i64(2**31, 0), Point2i64(2**31 - 1, 0) + Point2i64(1, 0))
+
+    def test_mixed_types_do_not_combine(self):
+        self.assertNotEqual(Point3i32(1, 2, 3), Point3i64(1, 2, 3))
+        self.assertNotEqual(Point2i64(1, 2), Point(1, 2))
+
+        with self.assertRaises(TypeError):
+            Point3i32(1, 2, 3) + Point3i64(1, 2, 3)
+
+    def test_hash_and_pickle(self):
+        points = {Point3i32(*p) for p in itertools.product(range(4), repeat=3)}
+        self.assertEqual(64, len(points))
+        self.assertIn(Point3i32(1, 2, 3), points)
+        self.assertEqual(hash(Point4i64(1, 2, 3, 4)), hash(Point4i64(1, 2, 3, 4)))
+
+        for p in (Point2i32(-5, 9), Point3i64(2**40, 0, -1), Point4i32(1, 2, 3, 4)):
+            self.assertEqual(p, pickle.loads(pickle.dumps(p)))
+            self.assertIs(type(p), type(copy.copy(p)))
+
+
+class TestPointArrayND(unittest.TestCase):
+    def test_build_and_index(self):
+        a = PointArray3i32([Point3i32(1, 2, 3), Point3i64(-4, 5, 6)])
+        a.append(Point3i32(7, 8, -9))
+        self.assertEqual(3, len(a))
+        self.assertEqual(Point3i32(-4, 5, 6), a[1])
+        self.assertEqual(Point3i32(7, 8, -9), a[-1])
+
+        a[0] = Point3i32(0, 0, 0)
+        self.assertEqual(
+            [Point3i32(0, 0, 0), Point3i32(-4, 5, 6), Point3i32(7, 8, -9)], list(a)
+        )
+        self.assertEqual((Point3i32(-4, 0, -9), Point3i32(7, 8, 6)), a.bounding_box())
+
+        with self.assertRaises(TypeError):
+            a.append(Point2i32(1, 2))
+        with self.assertRaises(OverflowError):
+            a.append(Point3i64(2**40, 0, 0))
+        with self.assertRaises(ValueError):
+            PointArray3i32().bounding_box()
+
+    def test_buffer_columns(self):
+        points = [Point3i64(i, -i, 2 * i) for i in range(5)]
+
+        for cls, item_size in ((PointArray3i32, 4), (PointArray3i64, 8)):
+            a = cls(points)
+
+            with memoryview(a) as view:
+                self.assertEqual((3, 5), view.shape)
+                self.assertEqual(item_size, view.itemsize)
+                self.assertEqual(
+                    [[p[axis] for p in points] for axis in range(3)], view.tolist()
+                )
+
+                with self.assertRaises(BufferError):
+                    a.append(Point3i32())
+
+            a.append(Point3i32())
+            self.assertEqual(6, len(a))
+
+    def test_pickle(self):
+        a = PointArray3i32([Point3i32(1, -2, 3), Point3i32(4, 5, -6)])
+        a.append(Point3i32(7, 8, 9))
+
+        for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+            b = pickle.loads(pickle.dumps(a, protocol))
+            self.assertIs(PointArray3i32, type(b))
+            self.assertEqual(list(a), list(b))
+
+        self.assertEqual([], list(pickle.loads(pickle.dumps(PointArray3i64()))))
+
+        with self.assertRaises(ValueError):
+            PointArray3i32.from_buffer(b"abcd")
+
+    def test_pickle_out_of_band(self):
+        a = PointArray3i64([Point3i64(1, 2, 3), Point3i64(4, 5, 6)])
+        buffers = []
+        data = pickle.dumps(a, protocol=5, buffer_callback=buffers.append)
+
+        shared = bytearray(buffers[0].raw())
+        b = pickle.loads(data, buffers=[shared])
+        b[0] = Point3i64(9, 9, 9)
+        self.assertEqual(Point3i64(9, 9, 9), PointArray3i64.from_buffer(shared)[0])
+
+
+class TestGridND(unittest.TestCase):
+    def test_index_by_point(self):
+        g = Grid3(4, 3, 2, dtype="int32")
+        self.assertEqual((4, 3, 2), (g.x_count, g.y_count, g.z_count))
+        self.assertEqual(24, len(g))
+        self.assertEqual("int32", g.dtype)
+
+        g[Point3i32(3, 2, 1)] = 9
+        self.assertEqual(9, g[Point3i64(3, 2, 1)])
+        self.assertEqual(0, g[Point3i32(0, 0, 0)])
+        self.assertIn(Point3i32(3, 2, 1), g)
+        self.assertNotIn(Point3i32(4, 0, 0), g)
+
+        with memoryview(g) as view:
+            self.assertEqual((2, 3, 4), view.shape)
+            self.assertEqual(9, view[1, 2, 3])
+
+        with self.assertRaises(IndexError):
+            g[Point3i32(0, 3, 0)]
+        with self.assertRaises(TypeError):
+            g[Point(0, 0)]
+        with self.assertRaises(ValueError):
+            Grid3(1, 1, 1, dtype="object")
+        with self.assertRaises(ValueError):
+            Grid3(0, 1, 1)
+
+    def test_initial_and_four_dimensions(self):
+        g = Grid4(2, 2, 2, 3, initial=5, dtype="int8")
+        self.assertEqual(3, g.w_count)
+        self.assertEqual([5] * 24, memoryview(g).cast("b").tolist())
+        self.assertEqual(5, g[Point4i32(1, 1, 1, 2)])
+
+    def test_neighbors(self):
+        g = Grid3(3, 3, 3)
+        self.assertEqual(
+            [Point3i32(1, 0, 0), Point3i32(0, 1, 0), Point3i32(0, 0, 1)],
+            g.neighbors(Point3i32(0, 0, 0)),
+        )
+        self.assertEqual(6, len(g.neighbors(Point3i64(1, 1, 1))))
+        self.assertIs(Point3i64, type(g.neighbors(Point3i64(1, 1, 1))[0]))
+
+        with self.assertRaises(IndexError):
+            g.neighbors(Point3i32(3, 0, 0))
+
+    def test_pickle(self):
+        g = Grid3(4, 3, 2, dtype="int32")
+        g[Point3i32(3, 2, 1)] = -9
+        h = Grid4(1, 2, 3, 4, initial=5, dtype="int8")
+
+        for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+            for grid in (g, h):
+                loaded = pickle.loads(pickle.dumps(grid, protocol))
+                self.assertEqual(repr(grid), repr(loaded))
+                self.assertEqual(bytes(memoryview(grid)), bytes(memoryview(loaded)))
+
+        with self.assertRaises(ValueError):
+            Grid3.from_buffer(b"", 1, 1, "int8")
+        with self.assertRaises(ValueError):
+            Grid3.from_buffer(b"abc", 2, 1, "int8")
+
 
 class TestPriorityQueue(unittest.TestCase):
     def test_pop_in_min_order(self):
@@ -450,6 +1349,62 @@ class TestAStar(unittest.TestCase):
         self.assertIsNone(path)
 
 
+    def test_find_shortest_path_with_cost_grid(self):
+        costs = Grid(
+            5,
+            4,
+            [
+                [1, 3, 1, 2, 1],
+                [1, 1, 7, 2, 1],
+                [1, 4, 5, 1, 1],
+                [1, 1, 2, 1, 1],
+            ],
+            dtype="int32",
+        )
+        expected = astar_search(
+            costs, Point(1, 1), Point(3, 2), TestAStar.move_cost, None
+        )
+
+        for heuristic in [None, "manhattan", manhattan_distance]:
+            path = astar_search(costs, Point(1, 1), Point(3, 2), costs, heuristic)
+            self.assertSequenceEqual(expected, path)
+
+    def test_cost_grid_blocks_non_positive_cells(self):
+        costs = Grid(3, 2, [[1, 0, 1], [1, 1, 1]], dtype="int8")
+        path = astar_search(costs, Point(0, 0), Point(2, 0), costs, "manhattan")
+        self.assertSequenceEqual(
+            [Point(0, 0), Point(0, 1), Point(1, 1), Point(2, 1), Point(2, 0)], path
+        )
+
+        costs[Point(1, 1)] = -1
+        self.assertIsNone(astar_search(costs, Point(0, 0), Point(2, 0), costs, None))
+
+    def test_uniform_cost(self):
+        grid = Grid(4, 4, None)
+        path = astar_search(grid, Point(0, 0), Point(3, 2), None, "manhattan")
+        self.assertEqual(6, len(path))
+        self.assertEqual(Point(0, 0), path[0])
+        self.assertEqual(Point(3, 2), path[-1])
+
+    def test_bad_args(self):
+        grid = Grid(2, 2, 1, dtype="int32")
+
+        with self.assertRaises(TypeError):
+            astar_search([[1]], Point(0, 0), Point(1, 1), None, None)
+
+        with self.assertRaises(ValueError):
+            astar_search(grid, Point(0, 0), Point(2, 1), None, None)
+
+        with self.assertRaises(ValueError):
+            astar_search(grid, Point(0, 0), Point(1, 1), lambda g, a, b: 0, None)
+
+        with self.assertRaises(TypeError):
+            astar_search(grid, Point(0, 0), Point(1, 1), lambda g, a, b: "1", None)
+
+        with self.assertRaises(ValueError):
+            astar_search(grid, Point(0, 0), Point(1, 1), Grid(1, 1, 1), None)
+
+
 class TestBFS(unittest.TestCase):
     class FindReachable(BFS[int]):
         def __init__(self, grid: Grid[int], start_pos: Point, target_pos: Point):
@@ -493,6 +1448,736 @@ class TestBFS(unittest.TestCase):
             TestBFS.FindReachable(None, Point(0, 0))
 
 
+class TestBFSKernels(unittest.TestCase):
+    GRID = Grid(
+        5,
+        4,
+        [
+            [0, 1, 0, 0, 0],
+            [0, 1, 0, 1, 0],
+            [1, 0, 1, 1, 0],
+            [0, 0, 1, 0, 0],
+        ],
+        dtype="int8",
+    )
+    OPEN = Grid.from_lines(["..#..", "..#..", "#.###", "....."])
+
+    def test_distances_with_mask_grid(self):
+        open_cells = Grid(5, 4, 0, dtype="int8")
+        for y in range(4):
+            for x in range(5):
+                open_cells[Point(x, y)] = 1 - self.GRID[Point(x, y)]
+
+        d = bfs_distances(self.GRID, Point(2, 0), passable=open_cells)
+        self.assertEqual("int64", d.dtype)
+        self.assertSequenceEqual(
+            [-1, -1, 0, 1, 2, -1, -1, 1, -1, 3, -1, -1, -1, -1, 4, -1, -1, -1, 6, 5],
+            d.cells,
+        )
+
+    def test_distances_with_passable_chars_and_multiple_starts(self):
+        d = bfs_distances(self.OPEN, [Point(0, 0), Point(4, 0)], passable=".")
+        self.assertSequenceEqual([0, 1, -1, 1, 0], list(d.row(0)))
+        self.assertSequenceEqual([5, 4, 5, 6, 7], list(d.row(3)))
+
+    def test_distances_with_predicate(self):
+        d = bfs_distances(self.OPEN, Point(0, 0), passable=lambda c: c != "#")
+        self.assertEqual(7, d[Point(4, 3)])
+        self.assertEqual(-1, d[Point(4, 0)])
+
+    def test_distances_follow_edges(self):
+        # A 2x2 loop of pipes "F7" / "LJ" with one extra dead end cell.
+        e, n, w, s = 1, 2, 4, 8
+        edges = Grid(3, 2, [[e | s, w | s, w], [n | e, n | w, 0]], dtype="int8")
+        d = bfs_distances(edges, Point(0, 0), edges=edges)
+        self.assertSequenceEqual([0, 1, -1, 1, 2, -1], d.cells)
+
+    def test_flood_fill(self):
+        self.assertEqual(4, sum(flood_fill(self.OPEN, Point(4, 1), passable=".")))
+        self.assertEqual(10, sum(flood_fill(self.OPEN, Point(0, 0), passable=".")))
+        self.assertEqual(0, sum(flood_fill(self.OPEN, Point(2, 0), passable=".")))
+
+    def test_label_components(self):
+        labels, count = label_components(self.GRID, passable=self.GRID)
+        self.assertEqual(3, count)
+        self.assertSequenceEqual(
+            [0, 1, 0, 0, 0, 0, 1, 0, 2, 0, 3, 0, 2, 2, 0, 0, 0, 2, 0, 0],
+            labels.cells,
+        )
+
+    def test_bad_args(self):
+        with self.assertRaises(TypeError):
+            bfs_distances(None, Point(0, 0))
+
+        with self.assertRaises(ValueError):
+            bfs_distances(self.GRID, Point(5, 0))
+
+        with self.assertRaises(TypeError):
+            bfs_distances(self.GRID, Point(0, 0), passable=".")
+
+        with self.assertRaises(ValueError):
+            flood_fill(self.GRID, Point(0, 0), passable=Grid(1, 1, 1, dtype="int8"))
+
+
+class TestPairwiseDistances(unittest.TestCase):
+    SOURCES = [Point(0, 0), Point(4, 0), Point(1, 3), Point(3, 1)]
+
+    def test_closed_form(self):
+        d = pairwise_distances(Grid(5, 4), self.SOURCES)
+        self.assertEqual("int64", d.dtype)
+        for j, a in enumerate(self.SOURCES):
+            for i, b in enumerate(self.SOURCES):
+                self.assertEqual(manhattan_distance(a, b), d[Point(i, j)])
+
+    def test_closed_form_with_weights(self):
+        d = pairwise_distances(
+            Grid(5, 4),
+            [Point(0, 0), Point(4, 3)],
+            row_weights=[1, 10, 1, 1],
+            col_weights=[1, 1, 5, 1, 1],
+        )
+        self.assertSequenceEqual([0, 8 + 12, 8 + 12, 0], d.cells)
+
+    def test_matches_bfs_with_passable_mask(self):
+        grid = Grid.from_lines(["..#..", "..#..", "#.###", "....."])
+        mask = Grid(5, 4, lambda: 1, dtype="int8")
+        for pt in [Point(2, 0), Point(2, 1), Point(0, 2), Point(2, 2)]:
+            mask[pt] = 0
+        mask[Point(3, 2)] = mask[Point(4, 2)] = 0
+
+        for threads in (1, 3):
+            d = pairwise_distances(grid, self.SOURCES, passable=mask, threads=threads)
+            for j, a in enumerate(self.SOURCES):
+                steps = bfs_distances(grid, a, passable=".")
+                for i, b in enumerate(self.SOURCES):
+                    self.assertEqual(steps[b], d[Point(i, j)])
+
+    def test_cost_grid(self):
+        cost = Grid(3, 3, [[1, 9, 1], [1, 9, 1], [1, 1, 1]], dtype="int32")
+        d = pairwise_distances(Grid(3, 3), [Point(0, 0), Point(2, 0)], cost=cost)
+        self.assertSequenceEqual([0, 6, 6, 0], d.cells)
+
+        cost[Point(1, 2)] = 0
+        d = pairwise_distances(Grid(3, 3), [Point(0, 0), Point(2, 0)], cost=cost)
+        self.assertSequenceEqual([0, 10, 10, 0], d.cells)
+
+    def test_bad_args(self):
+        grid = Grid(3, 3)
+
+        with self.assertRaises(ValueError):
+            pairwise_distances(grid, [])
+
+        with self.assertRaises(ValueError):
+            pairwise_distances(grid, [Point(3, 0)])
+
+        with self.assertRaises(TypeError):
+            pairwise_distances(grid, [(0, 0)])
+
+        with self.assertRaises(ValueError):
+            pairwise_distances(grid, [Point(0, 0)], row_weights=[1, 1])
+
+        with self.assertRaises(ValueError):
+            pairwise_distances(
+                grid,
+                [Point(0, 0)],
+                cost=Grid(3, 3, 1, dtype="int8"),
+                row_weights=[1, 1, 1],
+            )
+
+        with self.assertRaises(ValueError):
+            pairwise_distances(grid, [Point(0, 0)], col_weights=[1, -7, 1])
+
+        with self.assertRaises(OverflowError):
+            pairwise_distances(
+                grid, [Point(0, 0)], col_weights=[2**62, 2**62, 2**62]
+            )
+
+
+class TestWeightedAxes(unittest.TestCase):
+    COLS = [1, 1, 5, 1, 1]
+    ROWS = [1, 10, 1, 1]
+
+    def setUp(self):
+        self.axes = WeightedAxes(self.COLS, self.ROWS)
+
+    def test_positions_and_distance(self):
+        self.assertEqual(5, self.axes.x_count)
+        self.assertEqual(4, self.axes.y_count)
+        self.assertEqual(Point(1, 1), self.axes.position(Point(0, 0)))
+        self.assertEqual(Point(9, 13), self.axes.position(Point(4, 3)))
+        self.assertEqual(20, self.axes.distance(Point(4, 3), Point(0, 0)))
+        self.assertEqual(
+            20, manhattan_distance(Point(0, 0), Point(4, 3), axes=self.axes)
+        )
+
+    def test_total_distance(self):
+        points = [Point(0, 0), Point(4, 0), Point(1, 3), Point(3, 1), Point(2, 2)]
+        expected = sum(
+            self.axes.distance(a, b) for i, a in enumerate(points) for b in points[i:]
+        )
+        self.assertEqual(expected, self.axes.total_distance(points))
+        self.assertEqual(0, self.axes.total_distance([Point(2, 2)]))
+
+        huge = WeightedAxes([1, 2**62], [1])
+        with self.assertRaises(OverflowError):
+            huge.total_distance([Point(0, 0), Point(1, 0)] * 4)
+
+    def test_matches_pairwise_and_astar(self):
+        sources = [Point(0, 0), Point(4, 3), Point(2, 1)]
+        grid = Grid(5, 4)
+        d = pairwise_distances(grid, sources, cost=self.axes)
+        expected = pairwise_distances(
+            grid, sources, row_weights=self.ROWS, col_weights=self.COLS
+        )
+        self.assertSequenceEqual(expected.cells, d.cells)
+
+        # A* prices each move by the column or row it crosses, so the cheapest
+        # path costs exactly the weighted distance in either direction.
+        for start, goal in [(Point(0, 0), Point(4, 3)), (Point(4, 3), Point(1, 0))]:
+            path = astar_search(grid, start, goal, self.axes, "manhattan")
+            cost = sum(self.axes.distance(a, b) for a, b in zip(path, path[1:]))
+            self.assertEqual(self.axes.distance(start, goal), cost)
+
+    def test_bad_args(self):
+        with self.assertRaises(ValueError):
+            WeightedAxes([1, 0], [1])
+        with self.assertRaises(OverflowError):
+            WeightedAxes([2**62, 2**62], [1])
+        with self.assertRaises(ValueError):
+            self.axes.position(Point(5, 0))
+        with self.assertRaises(TypeError):
+            self.axes.distance((0, 0), Point(0, 0))
+        with self.assertRaises(ValueError):
+            astar_search(Grid(3, 3), Point(0, 0), Point(1, 1), self.axes, None)
+        with self.assertRaises(ValueError):
+            pairwise_distances(
+                Grid(5, 4), [Point(0, 0)], cost=self.axes, passable=Grid(5, 4)
+            )
+
+
+class TestParseInts(unittest.TestCase):
+    def test_digit_runs(self):
+        self.assertEqual(
+            [1, 41, 48, 83, 86], parse_ints("Card 1: 41 48 | 83 86")
+        )
+        self.assertEqual([-5, 3, -4], parse_ints(b"-5 3-4"))
+        self.assertEqual([2, 4, 6, 8], parse_ints("2-4,6-8", signed=False))
+        self.assertEqual([], parse_ints(""))
+
+    def test_long_numbers(self):
+        values = [12345678901234567, -9223372036854775808, 9223372036854775807]
+        self.assertEqual(values, parse_ints(" ".join(str(v) for v in values)))
+        self.assertEqual([7], parse_ints("000000000000000007"))
+
+    def test_overflow(self):
+        with self.assertRaises(OverflowError):
+            parse_ints("9223372036854775808")
+        with self.assertRaises(OverflowError):
+            parse_ints("-9223372036854775809")
+
+    def test_sep(self):
+        self.assertEqual([1, -2, 3], parse_ints("1, -2 ,+3", sep=","))
+        self.assertEqual([], parse_ints("  ", sep=","))
+
+        for text in ["1,,2", "1,a", "1 2", "1,"]:
+            with self.assertRaises(ValueError):
+                parse_ints(text, sep=",")
+
+        with self.assertRaises(ValueError):
+            parse_ints("1 2", sep=" ")
+
+    def test_buffer(self):
+        values = parse_ints("10 -20 30")
+        self.assertIsInstance(values, IntArray)
+
+        view = memoryview(values)
+        self.assertEqual("q", view.format)
+        self.assertEqual((3,), view.shape)
+        self.assertEqual([10, -20, 30], view.tolist())
+
+    def test_int_array(self):
+        values = IntArray([4, 5, 6, 7])
+        self.assertEqual(4, len(values))
+        self.assertEqual(7, values[-1])
+        self.assertEqual(IntArray([5, 7]), values[1::2])
+        self.assertEqual([4, 5, 6, 7], values.tolist())
+
+        values[0] = -1
+        self.assertEqual([-1, 5, 6, 7], values)
+
+        with self.assertRaises(IndexError):
+            values[4]
+
+    def test_rows(self):
+        values, offsets = parse_int_rows(["0 3 6", "", "-5"])
+        self.assertEqual([0, 3, 6, -5], values)
+        self.assertEqual([0, 3, 3, 4], offsets)
+
+        with self.assertRaises(ValueError) as ctx:
+            parse_int_rows(["1", "x"], sep=",")
+        self.assertIn("row 1", str(ctx.exception))
+
+    def test_rows_mapped_input(self):
+        handle, path = tempfile.mkstemp()
+        with os.fdopen(handle, "wb") as file:
+            file.write(b"0 3 6\n1 -3 7\n\n5\n")
+        self.addCleanup(os.remove, path)
+
+        expected = ([0, 3, 6, 1, -3, 7, 5], [0, 3, 6, 6, 7])
+        self.assertEqual(expected, parse_int_rows(MappedInput(path)))
+        self.assertEqual(expected, parse_int_rows(MappedInput(path, stream=True)))
+
+
+class TestExtrapolateRows(unittest.TestCase):
+    def test_extrapolate(self):
+        values, offsets = parse_int_rows(
+            ["0 3 6 9 12 15", "1 3 6 10 15 21", "10 13 16 21 30 45"]
+        )
+        next_values, previous_values = extrapolate_rows(values, offsets)
+        self.assertEqual([18, 28, 68], next_values)
+        self.assertEqual([-3, 0, 5], previous_values)
+
+    def test_short_rows(self):
+        values, offsets = parse_int_rows(["", "0 0", "7", "-4 -2"])
+        next_values, previous_values = extrapolate_rows(values, offsets)
+        self.assertEqual([0, 0, 7, 0], next_values)
+        self.assertEqual([0, 0, 7, -6], previous_values)
+
+    def test_many_rows_in_parallel(self):
+        rows = [[r, 2 * r, 4 * r, 8 * r] for r in range(10_000)]
+        values = IntArray(v for row in rows for v in row)
+        offsets = IntArray(range(0, len(values) + 1, 4))
+        next_values, previous_values = extrapolate_rows(values, offsets, threads=4)
+        self.assertEqual([15 * r for r in range(10_000)], next_values)
+        self.assertEqual([0] * 10_000, previous_values)
+
+    def test_overflow(self):
+        big = 2**62
+        with self.assertRaises(OverflowError):
+            extrapolate_rows(IntArray([big, -big, big]), IntArray([0, 3]))
+        with self.assertRaises(OverflowError):
+            extrapolate_rows(IntArray([2**63 - 2, 2**63 - 1]), IntArray([0, 2]))
+
+    def test_bad_offsets(self):
+        with self.assertRaises(ValueError):
+            extrapolate_rows(IntArray([1, 2]), IntArray([0, 3]))
+        with self.assertRaises(ValueError):
+            extrapolate_rows(IntArray([1, 2]), IntArray([2, 1]))
+        with self.assertRaises(ValueError):
+            extrapolate_rows(IntArray([1, 2]), IntArray())
+
+
+class TestHands(unittest.TestCase):
+    @staticmethod
+    def reference_key(cards, jokers):
+        order = "J23456789TQKA" if jokers else "23456789TJQKA"
+        counts = sorted(
+            (cards.count(c) for c in set(cards) if not (jokers and c == "J")),
+            reverse=True,
+        ) or [0]
+        counts[0] += cards.count("J") if jokers else 0
+        return (counts, [order.index(c) for c in cards])
+
+    def test_classify(self):
+        self.assertEqual(1, classify_hand("23456"))
+        self.assertEqual(2, classify_hand("A23A4"))
+        self.assertEqual(3, classify_hand("23432"))
+        self.assertEqual(4, classify_hand("TTT98"))
+        self.assertEqual(5, classify_hand("23332"))
+        self.assertEqual(6, classify_hand("AA8AA"))
+        self.assertEqual(7, classify_hand("JJJJJ"))
+        self.assertEqual(7, classify_hand("JJJJJ", jokers=True))
+        self.assertEqual(2, classify_hand("2345J", jokers=True))
+        self.assertEqual(5, classify_hand("2233J", jokers=True))
+        self.assertEqual(6, classify_hand("JJ223", jokers=True))
+
+        with self.assertRaises(ValueError):
+            classify_hand("2345")
+        with self.assertRaises(ValueError):
+            classify_hand("2345X")
+
+    def test_winnings_match_reference(self):
+        rng = random.Random(7)
+        lines = [
+            "".join(rng.choice("23456789TJQKA") for _ in range(5))
+            + f" {rng.randint(1, 1000)}"
+            for _ in range(2000)
+        ]
+
+        for jokers in (False, True):
+            # Equal hands keep their input order.
+            ranked = sorted(
+                (self.reference_key(line[:5], jokers), i, int(line[6:]))
+                for i, line in enumerate(lines)
+            )
+            expected = sum(rank * r[2] for rank, r in enumerate(ranked, 1))
+            self.assertEqual(expected, hand_winnings(lines, jokers=jokers))
+            self.assertEqual(
+                expected, hand_winnings([s.encode() for s in lines], jokers=jokers)
+            )
+
+    def test_winnings_mapped_input(self):
+        handle, path = tempfile.mkstemp()
+        with os.fdopen(handle, "wb") as file:
+            file.write(b"32T3K 765\nT55J5 684\nKK677 28\n\nKTJJT 220\nQQQJA 483\n")
+        self.addCleanup(os.remove, path)
+
+        self.assertEqual(6440, hand_winnings(MappedInput(path)))
+        self.assertEqual(5905, hand_winnings(MappedInput(path), jokers=True))
+        self.assertEqual(5905, hand_winnings(MappedInput(path, stream=True), True))
+
+    def test_bad_lines(self):
+        for line in ["32T3K", "32T3 765", "32T3K 7x5", "32T3X 765"]:
+            with self.assertRaises(ValueError):
+                hand_winnings(["KK677 28", line])
+        with self.assertRaises(OverflowError):
+            hand_winnings([f"KK677 {2**62}", f"KK678 {2**62}"])
+        with self.assertRaises(TypeError):
+            hand_winnings([1])
+
+
+class TestScratchcards(unittest.TestCase):
+    SAMPLE = [
+        "Card 1: 41 48 83 86 17 | 83 86  6 31 17  9 48 53",
+        "Card 2: 13 32 20 16 61 | 61 30 68 82 17 32 24 19",
+        "Card 3:  1 21 53 59 44 | 69 82 63 72 16 21 14  1",
+        "",
+        "Card 4: 41 92 73 84 69 | 59 84 76 51 58  5 54 83",
+    ]
+
+    def test_match_counts(self):
+        self.assertEqual([4, 2, 2, 1], list(match_counts(self.SAMPLE)))
+        self.assertEqual(
+            [4, 2, 2, 1], list(match_counts([s.encode() for s in self.SAMPLE]))
+        )
+
+        # Numbers are a set, so repeats only match once.
+        self.assertEqual([2], list(match_counts(["Card 1: 0 127 | 127 127 0 5"])))
+        self.assertEqual([0], list(match_counts(["Card 1: 64 | 63 65"])))
+
+    def test_match_counts_mapped_input(self):
+        handle, path = tempfile.mkstemp()
+        with os.fdopen(handle, "wb") as file:
+            file.write("\n".join(self.SAMPLE).encode() + b"\n")
+        self.addCleanup(os.remove, path)
+
+        self.assertEqual([4, 2, 2, 1], list(match_counts(MappedInput(path))))
+        self.assertEqual(
+            [4, 2, 2, 1], list(match_counts(MappedInput(path, stream=True)))
+        )
+
+    def test_bad_cards(self):
+        for line in ["Card 1 1 2 | 3", "Card 1: 1 2 3", "Card 1: 1 | 2 | 3"]:
+            with self.assertRaisesRegex(ValueError, "row 1"):
+                match_counts(["Card 1: 1 | 1", line])
+        with self.assertRaisesRegex(ValueError, "larger than 127"):
+            match_counts(["Card 1: 128 | 1"])
+        with self.assertRaises(TypeError):
+            match_counts([1])
+
+    def test_cascade_copies(self):
+        copies = cascade_copies(IntArray([4, 2, 2, 1, 0, 0]))
+        self.assertEqual([1, 2, 4, 8, 14, 1], list(copies))
+        self.assertEqual([], list(cascade_copies(IntArray())))
+
+        # Wins past the last card are dropped.
+        self.assertEqual([1, 2, 4], list(cascade_copies(IntArray([5, 5, 5]))))
+
+        with self.assertRaises(ValueError):
+            cascade_copies(IntArray([1, -1]))
+        with self.assertRaises(OverflowError):
+            cascade_copies(IntArray([100] * 100))
+        with self.assertRaises(TypeError):
+            cascade_copies([1, 2])
+
+
+class TestSchematicParts(unittest.TestCase):
+    @staticmethod
+    def reference(lines):
+        """Part and gear ratio sums found with regular expressions."""
+        parts = 0
+        gears = {}
+
+        for y, line in enumerate(lines):
+            for m in re.finditer(r"\d+", line):
+                near = {
+                    (x, ny)
+                    for ny in range(max(y - 1, 0), min(y + 2, len(lines)))
+                    for x in range(max(m.start() - 1, 0), m.end() + 1)
+                    if x < len(lines[ny]) and lines[ny][x] not in ".0123456789"
+                }
+                parts += int(m.group()) if near else 0
+
+                for x, ny in near:
+                    if lines[ny][x] == "*":
+                        gears.setdefault((x, ny), []).append(int(m.group()))
+
+        ratios = sum(g[0] * g[1] for g in gears.values() if len(g) == 2)
+        return (parts, ratios)
+
+    def test_matches_reference(self):
+        rng = random.Random(3)
+        # Wide rows cross several bitmap words and leave a ragged tail.
+        lines = [
+            "".join(rng.choice("..........0123456789*#") for _ in range(150))
+            for _ in range(60)
+        ]
+
+        self.assertEqual(self.reference(lines), schematic_parts(lines))
+        self.assertEqual(
+            self.reference(lines), schematic_parts([s.encode() for s in lines])
+        )
+
+    def test_mapped_input(self):
+        handle, path = tempfile.mkstemp()
+        with os.fdopen(handle, "wb") as file:
+            file.write(b"467..114..\n...*......\n..35..633.\n......#...\n")
+        self.addCleanup(os.remove, path)
+
+        self.assertEqual((467 + 35 + 633, 467 * 35), schematic_parts(MappedInput(path)))
+        self.assertEqual(
+            (467 + 35 + 633, 467 * 35),
+            schematic_parts(MappedInput(path, stream=True)),
+        )
+
+    def test_gears(self):
+        # A gear next to one or three numbers has no ratio.
+        self.assertEqual((7, 0), schematic_parts(["7*"]))
+        self.assertEqual((6, 0), schematic_parts(["1*2", ".3."]))
+        self.assertEqual((0, 0), schematic_parts([]))
+        self.assertEqual((0, 0), schematic_parts(["", "12.."]))
+
+    def test_errors(self):
+        with self.assertRaises(OverflowError):
+            schematic_parts([f"{2**62}*{2**62}"])
+        with self.assertRaises(OverflowError):
+            schematic_parts(["9" * 20 + "#"])
+        with self.assertRaises(TypeError):
+            schematic_parts([1])
+
+
+class TestPipeLoop(unittest.TestCase):
+    SQUARE = [".....", ".S-7.", ".|.|.", ".L-J.", "....."]
+
+    def test_loop(self):
+        for method in ("shoelace", "scanline"):
+            self.assertEqual((8, 1), pipe_loop(self.SQUARE, method=method))
+            self.assertEqual((4, 0), pipe_loop(["S7", "LJ"], method=method))
+            self.assertEqual(
+                (8, 1), pipe_loop([s.encode() for s in self.SQUARE], method=method)
+            )
+
+    def test_methods_match_on_random_loops(self):
+        rng = random.Random(10)
+        checked = 0
+
+        while checked < 20:
+            w, h = rng.randint(1, 8), rng.randint(1, 8)
+            cells = {(rng.randrange(w), rng.randrange(h)) for _ in range(w * h)}
+            lines = self.outline(self.connected_blob(cells), w, h)
+
+            if lines is not None:
+                self.assertEqual(
+                    pipe_loop(lines), pipe_loop(lines, method="scanline"), lines
+                )
+                checked += 1
+
+    @staticmethod
+    def connected_blob(cells):
+        """Cells reachable from the first cell through their edges."""
+        start = min(cells)
+        blob = {start}
+        todo = [start]
+
+        while todo:
+            x, y = todo.pop()
+            for n in ((x + 1, y), (x - 1, y), (x, y + 1), (x, y - 1)):
+                if n in cells and n not in blob:
+                    blob.add(n)
+                    todo.append(n)
+
+        return blob
+
+    @staticmethod
+    def outline(blob, w, h):
+        """Pipe maze on a doubled grid that follows the edges of the blob, with
+        the start at the top left corner of its first cell. Returns None when
+        two cells only touch at a corner, which no pipe can follow."""
+        grid = [["."] * (2 * w + 1) for _ in range(2 * h + 1)]
+        pipes = {"|": "NS", "-": "WE", "L": "NE", "J": "NW", "7": "SW", "F": "SE"}
+
+        for cy in range(h + 1):
+            for cx in range(w + 1):
+                nw, ne = (cx - 1, cy - 1) in blob, (cx, cy - 1) in blob
+                sw, se = (cx - 1, cy) in blob, (cx, cy) in blob
+                walls = (nw != ne, sw != se, nw != sw, ne != se)
+                edges = "".join(d for d, wall in zip("NSWE", walls) if wall)
+
+                if len(edges) == 4:
+                    return None
+
+                for c, pipe_edges in pipes.items():
+                    if edges == pipe_edges:
+                        grid[2 * cy][2 * cx] = c
+                if "E" in edges:
+                    grid[2 * cy][2 * cx + 1] = "-"
+                if "S" in edges:
+                    grid[2 * cy + 1][2 * cx] = "|"
+
+        x, y = min(blob, key=lambda c: (c[1], c[0]))
+        grid[2 * y][2 * x] = "S"
+        return ["".join(row) for row in grid]
+
+    def test_mapped_input(self):
+        handle, path = tempfile.mkstemp()
+        with os.fdopen(handle, "wb") as file:
+            file.write("\n".join(self.SQUARE).encode() + b"\n")
+        self.addCleanup(os.remove, path)
+
+        self.assertEqual((8, 1), pipe_loop(MappedInput(path)))
+        self.assertEqual((8, 1), pipe_loop(MappedInput(path, stream=True)))
+
+    def test_bad_mazes(self):
+        for lines in (
+            [".....", ".S-7x"],
+            [".....", ".S-7"],
+            ["SS"],
+            ["...", ".|."],
+            ["S-7", "|.|", "L-."],
+            ["-S-", ".|."],
+        ):
+            with self.assertRaises(ValueError):
+                pipe_loop(lines)
+        with self.assertRaises(ValueError):
+            pipe_loop(self.SQUARE, method="flood")
+        with self.assertRaises(TypeError):
+            pipe_loop([1])
+
+
+class TestIntervalMap(unittest.TestCase):
+    def setUp(self):
+        # The day 5 sample's seed-to-soil and soil-to-fertilizer maps.
+        self.seed_to_soil = IntervalMap([(98, 50, 2), (50, 52, 48)])
+        self.soil_to_fertilizer = IntervalMap(
+            [(15, 0, 37), (52, 37, 2), (0, 39, 15)]
+        )
+
+    def test_map(self):
+        self.assertEqual(81, self.seed_to_soil.map(79))
+        self.assertEqual(14, self.seed_to_soil.map(14))
+        self.assertEqual(50, self.seed_to_soil.map(98))
+        self.assertEqual(100, self.seed_to_soil.map(100))
+        self.assertEqual(-3, self.seed_to_soil.map(-3))
+
+    def test_items_are_sorted(self):
+        self.assertEqual([(50, 52, 48), (98, 50, 2)], self.seed_to_soil.items())
+        self.assertEqual(2, len(self.seed_to_soil))
+
+    def test_add_rejects_overlap(self):
+        with self.assertRaises(ValueError):
+            self.seed_to_soil.add(60, 0, 5)
+        with self.assertRaises(ValueError):
+            self.seed_to_soil.add(0, 0, -1)
+
+        self.seed_to_soil.add(100, 0, 5)
+        self.assertEqual(2, self.seed_to_soil.map(102))
+
+    def test_map_ranges_splits_at_breakpoints(self):
+        self.assertEqual(
+            [(50, 51), (96, 100)], self.seed_to_soil.map_ranges([(94, 99)])
+        )
+        self.assertEqual(
+            [(10, 20)], self.seed_to_soil.map_ranges([(15, 20), (10, 15)])
+        )
+        self.assertEqual([], self.seed_to_soil.map_ranges([(5, 5)]))
+
+    def test_then(self):
+        chain = self.seed_to_soil.then(self.soil_to_fertilizer)
+
+        for seed in range(-5, 120):
+            expected = self.soil_to_fertilizer.map(self.seed_to_soil.map(seed))
+            self.assertEqual(expected, chain.map(seed))
+
+    def test_then_identity(self):
+        self.assertEqual(self.seed_to_soil, self.seed_to_soil.then(IntervalMap()))
+        self.assertEqual(0, len(IntervalMap([(5, 5, 10)]).then(IntervalMap())))
+
+        # Shifts that cancel out leave nothing behind, but values the first
+        # map passes through unchanged still go through the second.
+        there = IntervalMap([(0, 10, 5)])
+        back = IntervalMap([(10, 0, 5)])
+        self.assertEqual(IntervalMap([(10, 0, 5)]), there.then(back))
+
+    def test_map_many(self):
+        values = IntArray([79, 14, 98, -3])
+        self.assertIs(values, self.seed_to_soil.map_many(values))
+        self.assertEqual([81, 14, 50, -3], values)
+
+        # Writing to `out` leaves the input alone, and a chunked threaded pass
+        # agrees with mapping one value at a time.
+        seeds = IntArray(range(200_000))
+        out = IntArray([0] * len(seeds))
+        self.seed_to_soil.map_many(seeds, out=out, threads=4)
+        self.assertEqual(99, seeds[99])
+        self.assertEqual([self.seed_to_soil.map(s) for s in range(200_000)], out)
+
+    def test_map_many_rejects_bad_buffers(self):
+        with self.assertRaises(TypeError):
+            self.seed_to_soil.map_many(bytearray(8))
+        with self.assertRaises(BufferError):
+            self.seed_to_soil.map_many(b"abcdefgh")
+        with self.assertRaises(ValueError):
+            self.seed_to_soil.map_many(IntArray([1, 2]), out=IntArray([1]))
+
+    def test_map_min(self):
+        self.assertEqual(14, self.seed_to_soil.map_min(IntArray([79, 14, 55])))
+        self.assertEqual(
+            50, self.seed_to_soil.map_min(IntArray(range(98, 200_000)), threads=3)
+        )
+        with self.assertRaises(ValueError):
+            self.seed_to_soil.map_min(IntArray())
+
+
+class TestNetwork(unittest.TestCase):
+    def setUp(self):
+        self.network = Network(
+            "LLR",
+            [("AAA", "BBB", "BBB"), ("BBB", "AAA", "ZZZ"), ("ZZZ", "ZZZ", "ZZZ")],
+        )
+
+    def test_walk(self):
+        self.assertEqual(6, self.network.walk("AAA", "ZZZ"))
+        self.assertEqual(0, self.network.walk("ZZZ", ["ZZZ"]))
+        self.assertEqual(1, self.network.walk("AAA", ["BBB", "ZZZ"]))
+
+        with self.assertRaises(ValueError):
+            self.network.walk("ZZZ", "AAA")
+        with self.assertRaises(KeyError):
+            self.network.walk("QQQ", "ZZZ")
+
+    def test_cycle(self):
+        self.assertEqual((6, 3, [6, 7, 8]), self.network.cycle("AAA", "ZZZ"))
+        self.assertEqual((6, 3, []), self.network.cycle("AAA", []))
+        self.assertEqual((0, 3, [0, 1, 2]), self.network.cycle("ZZZ", "ZZZ"))
+
+    def test_contains(self):
+        self.assertEqual(3, len(self.network))
+        self.assertIn("BBB", self.network)
+        self.assertNotIn("CCC", self.network)
+
+    def test_rejects_bad_input(self):
+        with self.assertRaises(ValueError):
+            Network("LXR", [("AAA", "AAA", "AAA")])
+        with self.assertRaises(ValueError):
+            Network("", [("AAA", "AAA", "AAA")])
+        with self.assertRaises(ValueError):
+            Network("L", [("AAA", "AAA", "BBB")])
+        with self.assertRaises(ValueError):
+            Network("L", [("AAA", "AAA", "AAA"), ("AAA", "AAA", "AAA")])
+        with self.assertRaises(TypeError):
+            Network("L", [("AAA", "AAA")])
+
+
 class TestCountIf(unittest.TestCase):
     def test_empty(self):
         self.assertEqual(0, count_if([], lambda x: False))
@@ -538,6 +2223,296 @@ class TestUtilsModule(unittest.TestCase):
         input = load_input(0, 0)
         self.assertEqual(input, ["hello", "123"])
 
+    def test_load_input_stream(self):
+        self.assertEqual(["hello", "123"], list(load_input(0, 0, stream=True)))
+
+    def test_load_input_missing_file(self):
+        with self.assertRaises(FileNotFoundError):
+            load_input(404, 0)
+
+
+class TestOatmealModule(unittest.TestCase):
+    @staticmethod
+    def new_module():
+        spec = importlib.util.find_spec("oatmeal")
+        module = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(module)
+        return module
+
+    def test_new_module_objects_have_their_own_types(self):
+        # Multi-phase init gives each import its own module object, and the
+        # heap types and constants inside belong to that module alone.
+        module = self.new_module()
+        self.assertIsNot(oatmeal, module)
+        self.assertIsNot(oatmeal.Point, module.Point)
+        self.assertIsNot(oatmeal.Direction, module.Direction)
+        self.assertEqual(module.Point(0, -1), module.Point.NORTH)
+        self.assertIs(module.Direction.North.to_point(), module.Point.NORTH)
+        self.assertEqual(Point(0, -1), oatmeal.Point.NORTH)
+
+    def test_new_module_objects_have_their_own_caches(self):
+        module = self.new_module()
+        window = FrozenPoint.intern_window()
+        module.FrozenPoint.set_intern_window(-2, 2)
+        self.assertEqual((-2, 2), module.FrozenPoint.intern_window())
+        self.assertEqual(window, FrozenPoint.intern_window())
+
+        oatmeal.reset_alloc_stats()
+        module.reset_alloc_stats()
+        module.Point(1, 2)
+        self.assertEqual(1, module.alloc_stats()["points_created"])
+        self.assertEqual(0, oatmeal.alloc_stats()["points_created"])
+
+    def test_sub_interpreter_import(self):
+        try:
+            import _xxsubinterpreters as interpreters
+        except ImportError:
+            self.skipTest("sub-interpreters are not available")
+
+        interp = interpreters.create()
+        self.addCleanup(interpreters.destroy, interp)
+        interpreters.run_string(
+            interp,
+            f"""
+import sys
+sys.path.insert(0, {os.path.dirname(oatmeal.__file__)!r})
+import oatmeal
+grid = oatmeal.Grid(3, 3, ".", dtype="char")
+cells = oatmeal.bfs_distances(grid, oatmeal.Point(0, 0), passable=".").cells
+assert list(cells) == [0, 1, 2, 1, 2, 3, 2, 3, 4]
+assert oatmeal.Direction.East.to_point() is oatmeal.Point.EAST
+""",
+        )
+        self.assertEqual(Point(2, 2), Point(1, 2) + Point.EAST)
+
+    def test_kernels_run_from_many_threads(self):
+        grid = Grid(200, 200, ".", dtype="char")
+        expected = list(bfs_distances(grid, Point(0, 0), passable=".").cells)
+        table = IntervalMap([(0, 1_000_000, 100_000)])
+
+        def run(i):
+            values = IntArray(range(i, 100_000))
+            return (
+                list(bfs_distances(grid, Point(0, 0), passable=".").cells),
+                table.map_min(values, threads=3),
+            )
+
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            results = list(pool.map(run, range(8)))
+
+        for i, (distances, lowest) in enumerate(results):
+            self.assertEqual(expected, distances)
+            self.assertEqual(1_000_000 + i, lowest)
+
+    @unittest.skipUnless(hasattr(os, "fork"), "needs fork")
+    def test_thread_pool_works_after_fork(self):
+        table = IntervalMap([(0, 1_000_000, 100_000)])
+        values = IntArray(range(100_000))
+        self.assertEqual(1_000_000, table.map_min(values, threads=4))
+
+        pid = os.fork()
+
+        if pid == 0:
+            os._exit(0 if table.map_min(values, threads=4) == 1_000_000 else 1)
+
+        _, status = os.waitpid(pid, 0)
+        self.assertEqual(0, os.waitstatus_to_exitcode(status))
+
+
+class TestMappedInput(unittest.TestCase):
+    def write_input(self, data: bytes) -> str:
+        handle, path = tempfile.mkstemp()
+        with os.fdopen(handle, "wb") as file:
+            file.write(data)
+
+        self.addCleanup(os.remove, path)
+        return path
+
+    def test_lines_match_rstripped_file(self):
+        path = self.write_input(b"ab  \r\n\ncd\t\n  x")
+        with open(path, encoding="utf-8") as file:
+            expected = [line.rstrip() for line in file]
+
+        lines = MappedInput(path)
+        self.assertEqual(expected, list(lines))
+        self.assertEqual(lines, expected)
+        self.assertEqual(4, len(lines))
+
+    def test_indexing(self):
+        lines = MappedInput(self.write_input(b"one\ntwo\nthree\n"))
+        self.assertEqual("one", lines[0])
+        self.assertEqual("three", lines[-1])
+        self.assertEqual(["one", "three"], lines[::2])
+
+        with self.assertRaises(IndexError):
+            lines[3]
+
+    def test_pop(self):
+        lines = MappedInput(self.write_input(b"one\ntwo\nthree\n"))
+        self.assertEqual("one", lines.pop(0))
+        self.assertEqual("three", lines.pop())
+        self.assertEqual(["two"], list(lines))
+
+        view = lines.view(0)
+        with self.assertRaises(BufferError):
+            lines.pop()
+
+        view.release()
+        self.assertEqual("two", lines.pop())
+
+    def test_view_is_zero_copy_bytes(self):
+        lines = MappedInput(self.write_input(b"one\ntwo  \n"))
+        view = lines.view(1)
+        self.assertEqual(b"two", bytes(view))
+        self.assertTrue(view.readonly)
+
+        with self.assertRaises(BufferError):
+            lines.close()
+
+        view.release()
+        lines.close()
+        self.assertTrue(lines.closed)
+
+    def test_utf8(self):
+        lines = MappedInput(self.write_input("héllo\n€\n".encode("utf-8")))
+        self.assertEqual(["héllo", "€"], list(lines))
+
+    def test_empty_file(self):
+        lines = MappedInput(self.write_input(b""))
+        self.assertEqual(0, len(lines))
+        self.assertEqual([], list(lines))
+
+    def test_stream(self):
+        lines = MappedInput(self.write_input(b"a\nb\n\nc"), stream=True)
+        self.assertTrue(lines.stream)
+        self.assertEqual(["a", "b", "", "c"], list(lines))
+        self.assertEqual(["a", "b", "", "c"], list(lines))
+
+        with self.assertRaises(TypeError):
+            len(lines)
+        with self.assertRaises(TypeError):
+            lines[0]
+
+    def test_pickles_as_list(self):
+        lines = MappedInput(self.write_input(b"a\nb\n"))
+        self.assertEqual(["a", "b"], pickle.loads(pickle.dumps(lines)))
+
+    def test_closed(self):
+        with MappedInput(self.write_input(b"a\n")) as lines:
+            self.assertEqual(["a"], list(lines))
+
+        with self.assertRaises(ValueError):
+            list(lines)
+
+
+class TestSolverCache(unittest.TestCase):
+    class Summer(AdventDaySolver, year=0, day=0, name="", solution=None):
+        parses = 0
+        solves = 0
+
+        def __init__(self, input):
+            super().__init__(input)
+            type(self).parses += 1
+            self.lines = input
+            rows = [[int(x) for x in line.split()] for line in input]
+            self.grid = Grid(len(rows[0]), len(rows), rows, dtype="int64")
+
+        def solve(self):
+            type(self).solves += 1
+            return (sum(self.grid.cells), len(self.lines))
+
+    class Unpicklable(Summer, year=0, day=0, name="", solution=None):
+        def __init__(self, input):
+            super().__init__(input)
+            self.callback = lambda: None
+
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.dir.cleanup)
+        self.cache = SolverCache(os.path.join(self.dir.name, "cache"))
+        self.input = self.write_input(b"1 2\n3 4\n")
+        self.Summer.parses = self.Summer.solves = 0
+        self.Unpicklable.parses = self.Unpicklable.solves = 0
+
+    def write_input(self, data):
+        path = os.path.join(self.dir.name, "input.txt")
+
+        with open(path, "wb") as f:
+            f.write(data)
+
+        return path
+
+    def test_answers_are_cached(self):
+        self.assertEqual(((10, 2), False), self.cache.solve(self.Summer, self.input))
+        self.assertEqual(((10, 2), True), self.cache.solve(self.Summer, self.input))
+        self.assertEqual((1, 1), (self.Summer.parses, self.Summer.solves))
+
+    def test_parse_state_is_restored(self):
+        self.cache.load_solver(self.Summer, self.input)
+        solver = self.cache.load_solver(self.Summer, self.input)
+
+        self.assertEqual(1, self.Summer.parses)
+        self.assertIsInstance(solver.lines, MappedInput)
+        self.assertIs(solver.input, solver.lines)
+        self.assertEqual([1, 2, 3, 4], solver.grid.cells)
+        self.assertEqual((10, 2), solver.solve())
+
+        # Grid cells are mapped from the cache, and writes stay in memory.
+        solver.grid[Point(0, 0)] = 11
+        again = self.cache.load_solver(self.Summer, self.input)
+        self.assertEqual(1, again.grid[Point(0, 0)])
+
+    def test_key_follows_input(self):
+        key = self.cache.key(self.Summer, self.input)
+        self.assertEqual(key, self.cache.key(self.Summer, self.input))
+        self.assertNotEqual(key, self.cache.key(self.Unpicklable, self.input))
+
+        self.write_input(b"5 6\n")
+        self.assertNotEqual(key, self.cache.key(self.Summer, self.input))
+        self.assertEqual(((11, 1), False), self.cache.solve(self.Summer, self.input))
+
+    def test_unpicklable_state_is_parsed_again(self):
+        self.cache.load_solver(self.Unpicklable, self.input)
+        solver = self.cache.load_solver(self.Unpicklable, self.input)
+
+        self.assertEqual(2, self.Unpicklable.parses)
+        self.assertEqual((10, 2), solver.solve())
+
+
+class TestBenchSuite(unittest.TestCase):
+    def result(self, name, seconds, scale=1):
+        return BenchResult(name, scale, seconds, 1 / seconds, "ops/s", 0)
+
+    def test_regression_threshold(self):
+        baseline = [{"name": "bfs", "scale": 1, "seconds": 1.0}]
+        slow = self.result("bfs", 1.25)
+
+        self.assertEqual([(slow, 1.0)], find_regressions([slow], baseline, 0.2))
+        self.assertEqual([], find_regressions([self.result("bfs", 1.2)], baseline, 0.2))
+        self.assertEqual([], find_regressions([slow], baseline, 0.3))
+
+    def test_missing_baseline_entry_is_skipped(self):
+        baseline = [{"name": "bfs", "scale": 1, "seconds": 1.0}]
+        results = [self.result("astar", 5.0), self.result("bfs", 5.0, scale=10)]
+        self.assertEqual([], find_regressions(results, baseline, 0.2))
+
+    def test_improvement_is_not_a_regression(self):
+        baseline = [{"name": "bfs", "scale": 1, "seconds": 1.0}]
+        self.assertEqual([], find_regressions([self.result("bfs", 0.1)], baseline, 0))
+
+    def test_repeat_cards_keeps_cascade_in_each_block(self):
+        cards = ["Card 1: 1 2 | 1 2", "Card 2: 3 4 | 4 3", "Card 3: 5 | 6"]
+        scaled = repeat_cards(cards, 2)
+
+        # The second card wins a copy past the end of its block, so a losing
+        # card is added before the next block starts.
+        self.assertEqual("Card 5: 1 2 | 1 2", scaled[4])
+        self.assertEqual(8, len(scaled))
+        self.assertEqual(
+            list(cascade_copies(match_counts(cards + cards[2:]))) * 2,
+            list(cascade_copies(match_counts(scaled))),
+        )
+
 
 class TestAllPairs(unittest.TestCase):
     def test_empty_list(self):
@@ -590,6 +2565,48 @@ class TestCombinations(unittest.TestCase):
         with self.assertRaises(TypeError):
             list(combinations(5, "abc"))
 
+    def test_matches_itertools(self):
+        items = list(range(9))
+
+        for k in range(1, 10):
+            self.assertSequenceEqual(
+                [list(c) for c in itertools.combinations(items, k)],
+                list(combinations(k, items)),
+            )
+
+    def test_items_snapshot(self):
+        items = [1, 2, 3]
+        combos = combinations(2, items)
+        items.append(4)
+        self.assertSequenceEqual([[1, 2], [1, 3], [2, 3]], list(combos))
+
+
+class TestCombinationIndices(unittest.TestCase):
+    def test_single_batch(self):
+        batches = list(combination_indices(4, 2))
+        self.assertEqual(1, len(batches))
+        self.assertSequenceEqual(
+            [0, 1, 0, 2, 0, 3, 1, 2, 1, 3, 2, 3], list(batches[0])
+        )
+
+    def test_chunks(self):
+        expected = [i for c in itertools.combinations(range(7), 3) for i in c]
+        batches = list(combination_indices(7, 3, batch=4))
+
+        self.assertSequenceEqual([12] * 8 + [9], [len(b) for b in batches])
+        self.assertSequenceEqual(expected, [i for b in batches for i in b])
+
+    def test_k_larger_than_n(self):
+        self.assertSequenceEqual([], list(combination_indices(2, 3)))
+
+    def test_bad_arguments(self):
+        with self.assertRaises(ValueError):
+            combination_indices(4, 0)
+        with self.assertRaises(ValueError):
+            combination_indices(-1, 2)
+        with self.assertRaises(ValueError):
+            combination_indices(4, 2, batch=0)
+
 
 if __name__ == "__main__":
     unittest.main()